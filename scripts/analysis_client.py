@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+
+# Sends captures to a running `sysid --serve` and prints the results.
+#
+# usage: analysis_client.py [--port N] [--inline] [--settings FILE] CAPTURE...
+
+import argparse
+import json
+import os
+import sys
+import time
+import urllib.error
+import urllib.request
+
+DEFAULT_PORT = 5830
+
+
+def post(url, request):
+    data = json.dumps(request).encode()
+    while True:
+        req = urllib.request.Request(
+            url, data=data, headers={"Content-Type": "application/json"}
+        )
+        try:
+            with urllib.request.urlopen(req) as response:
+                return response.status, json.load(response)
+        except urllib.error.HTTPError as e:
+            # Back off while the server's queue is full
+            if e.code == 503:
+                time.sleep(float(e.headers.get("Retry-After", "1")))
+                continue
+            return e.code, json.load(e)
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--port", type=int, default=DEFAULT_PORT)
+parser.add_argument(
+    "--inline",
+    action="store_true",
+    help="send the contents of the captures instead of their paths",
+)
+parser.add_argument("--settings", help="a JSON file with analysis settings")
+parser.add_argument("captures", nargs="+")
+args = parser.parse_args()
+
+url = f"http://127.0.0.1:{args.port}/analyze"
+settings = None
+if args.settings:
+    with open(args.settings) as settings_file:
+        settings = json.load(settings_file)
+
+failed = False
+for capture in args.captures:
+    if args.inline:
+        with open(capture) as capture_file:
+            request = {"capture": json.load(capture_file)}
+    else:
+        request = {"path": os.path.abspath(capture)}
+    if settings is not None:
+        request["settings"] = settings
+
+    status, result = post(url, request)
+    if status != 200:
+        failed = True
+        print(f"{capture}: {result.get('error')}", file=sys.stderr)
+    else:
+        print(json.dumps(result, indent=2))
+
+sys.exit(1 if failed else 0)
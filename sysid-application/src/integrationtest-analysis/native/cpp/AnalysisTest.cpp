@@ -2,8 +2,10 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
+#include <memory>
 #include <string>
 #include <thread>
 
@@ -46,7 +48,15 @@ class AnalysisTest : public ::testing::Test {
                                            "fast-forward", "fast-backward"};
 
   static void SetUpTestSuite() {
-    m_nt = nt::GetDefaultInstance();
+    // The robot program is installed once for all shards when the tests run
+    // in parallel.
+    if (!std::getenv("SYSID_SIM_INSTALLED")) {
+      InstallSim("sysid-projects:analysis-test");
+    }
+    m_robot = std::make_unique<SimRobot>("sysid-projects:analysis-test",
+                                         GetShardPort());
+
+    m_nt = m_robot->GetInstance();
     m_enable = nt::GetEntry(m_nt, "/SmartDashboard/SysIdRun");
     m_kill = nt::GetEntry(m_nt, "/SmartDashboard/SysIdKill");
     m_overflow = nt::GetEntry(m_nt, "/SmartDashboard/SysIdOverflow");
@@ -56,9 +66,7 @@ class AnalysisTest : public ::testing::Test {
                           unsigned int line,
                           const char* msg) { fmt::print("{}\n", msg); });
 
-    LaunchSim("sysid-projects:analysis-test");
-
-    Connect(m_nt, m_kill);
+    m_robot->Connect();
   }
 
   void UploadJSON(std::string_view path) {
@@ -95,7 +103,11 @@ class AnalysisTest : public ::testing::Test {
 
   void AnalyzeJSON() {
     // Save the JSON and make sure that everything checks out.
-    auto path = m_manager->SaveJSON(EXPAND_STRINGIZE(PROJECT_ROOT_DIR));
+    // Shards save at the same time, so the name of the test keeps the file
+    // names apart.
+    auto path = m_manager->SaveJSON(
+        EXPAND_STRINGIZE(PROJECT_ROOT_DIR),
+        ::testing::UnitTest::GetInstance()->current_test_info()->name());
     try {
       auto analyzerSettings = sysid::AnalysisManager::Settings{};
       analyzerSettings.windowSize = 13;
@@ -161,7 +173,10 @@ class AnalysisTest : public ::testing::Test {
     ASSERT_TRUE(m_manager->GetCurrentDataSize() <= kMaxDataSize);
   }
 
-  static void TearDownTestSuite() { KillNT(m_nt, m_kill); }
+  static void TearDownTestSuite() {
+    m_robot->Kill();
+    m_robot.reset();
+  }
 
   void RunTest(const char* test, double duration) {
     m_manager->BeginTest(test);
@@ -197,13 +212,28 @@ class AnalysisTest : public ::testing::Test {
       auto test = kTests[i];
 
       // Run each test for 3 seconds
+      auto start = wpi::Now();
       RunTest(test, 3);
+      RecordTime(test, start);
     }
   }
 
-  void RunOverflowTest() { RunTest(kTests[0], 25); }
+  // Records how long a test took in the test output.
+  void RecordTime(const char* test, uint64_t start) {
+    double seconds = (wpi::Now() - start) * 1E-6;
+    fmt::print(stderr, "{} took {:.2f} s\n", test, seconds);
+    RecordProperty(fmt::format("{}-seconds", test),
+                   fmt::format("{:.3f}", seconds));
+  }
+
+  void RunOverflowTest() {
+    auto start = wpi::Now();
+    RunTest(kTests[0], 25);
+    RecordTime(kTests[0], start);
+  }
 
  private:
+  static std::unique_ptr<SimRobot> m_robot;
   static NT_Inst m_nt;
 
   static NT_Entry m_enable;
@@ -216,6 +246,7 @@ class AnalysisTest : public ::testing::Test {
   static wpi::Logger m_logger;
 };
 
+std::unique_ptr<SimRobot> AnalysisTest::m_robot;
 NT_Inst AnalysisTest::m_nt;
 
 NT_Entry AnalysisTest::m_enable;
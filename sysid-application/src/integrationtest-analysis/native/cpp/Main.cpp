@@ -2,10 +2,30 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+#include "IntegrationUtils.h"
 #include "gtest/gtest.h"
 
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
+
+  // Each mechanism has its own simulated robot, so the tests run in parallel
+  // shards (one per mechanism by default) unless this is a shard already.
+  size_t jobs = ::testing::UnitTest::GetInstance()->total_test_count();
+  for (int i = 1; i < argc; ++i) {
+    if (std::string_view{argv[i]} == "--jobs" && i + 1 < argc) {
+      jobs = std::max<size_t>(1, std::stoul(argv[++i]));
+    }
+  }
+  if (jobs > 1 && !std::getenv("GTEST_SHARD_INDEX")) {
+    InstallSim("sysid-projects:analysis-test");
+    return RunShards(argv[0], jobs);
+  }
+
   int ret = RUN_ALL_TESTS();
   return ret;
 }
@@ -4,16 +4,24 @@
 
 #include "IntegrationUtils.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 #include <fmt/core.h>
+#include <wpi/fs.h>
 #include <wpi/timestamp.h>
 
 #include "gtest/gtest.h"
 
-void LaunchSim(std::string_view projectDirectory) {
-  // Install the robot program.
+void InstallSim(std::string_view projectDirectory) {
   std::string installCmd =
       fmt::format("cd {}/ && {} :{}:installSimulateNativeRelease -Pintegration",
                   EXPAND_STRINGIZE(PROJECT_ROOT_DIR), LAUNCH, projectDirectory);
@@ -26,6 +34,11 @@ void LaunchSim(std::string_view projectDirectory) {
     fmt::print(stderr, "The robot program could not be installed.\n");
     std::exit(1);
   }
+}
+
+void LaunchSim(std::string_view projectDirectory) {
+  // Install the robot program.
+  InstallSim(projectDirectory);
 
   // Run the robot program.
   std::string runCmd =
@@ -38,7 +51,7 @@ void LaunchSim(std::string_view projectDirectory) {
   // data
   ::testing::internal::CaptureStdout();
 
-  result = std::system(runCmd.c_str());
+  int result = std::system(runCmd.c_str());
 
   // Exit the test if we could not run the robot program.
   if (result != 0) {
@@ -93,3 +106,198 @@ std::string KillNT(NT_Inst nt, NT_Entry kill) {
 
   return capturedStdout;
 }
+
+/**
+ * Returns the directory for the files of the integration tests.
+ */
+static fs::path GetIntegrationDirectory() {
+  return fs::path{EXPAND_STRINGIZE(PROJECT_ROOT_DIR)} / "build" /
+         "integration";
+}
+
+/**
+ * Returns the contents of a file, or an empty string if it can't be read.
+ */
+static std::string ReadFile(const std::string& path) {
+  std::ifstream file{path};
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+/**
+ * Returns the run script of the installed simulation of a robot project.
+ */
+static fs::path FindSimExecutable(std::string_view projectDirectory) {
+  std::string directory{projectDirectory};
+  std::replace(directory.begin(), directory.end(), ':', '/');
+  auto installDirectory = fs::path{EXPAND_STRINGIZE(PROJECT_ROOT_DIR)} /
+                          directory / "build" / "install" / "frcUserProgram";
+#ifdef _WIN32
+  constexpr const char* kName = "frcUserProgram.bat";
+#else
+  constexpr const char* kName = "frcUserProgram";
+#endif
+
+  // The run script is in a directory per platform.
+  std::error_code ec;
+  for (auto&& entry : fs::recursive_directory_iterator{installDirectory, ec}) {
+    const auto& path = entry.path();
+    if (entry.is_regular_file() && path.filename() == kName &&
+        path.parent_path().filename() == "release") {
+      return path;
+    }
+  }
+  fmt::print(stderr, "The robot program isn't installed in {}.\n",
+             installDirectory.string());
+  std::exit(1);
+}
+
+SimRobot::SimRobot(std::string_view projectDirectory, unsigned int port)
+    : m_port{port},
+      m_nt{nt::CreateInstance()},
+      m_kill{nt::GetEntry(m_nt, "/SmartDashboard/SysIdKill")} {
+  auto executable = FindSimExecutable(projectDirectory);
+
+  // Each robot program gets its own working directory, since robot programs
+  // keep files such as networktables.ini in it.
+  auto directory = GetIntegrationDirectory() / fmt::format("robot-{}", port);
+  fs::create_directories(directory);
+  m_outputPath = (directory / "output.txt").string();
+
+#ifdef _WIN32
+  std::string runCmd = fmt::format(
+      "cd /d \"{}\" && set \"SYSID_NT_PORT={}\" && start /b \"\" \"{}\" > "
+      "\"{}\" 2>&1",
+      directory.string(), port, executable.string(), m_outputPath);
+#else
+  std::string runCmd =
+      fmt::format("cd \"{}\" && SYSID_NT_PORT={} \"{}\" > \"{}\" 2>&1 &",
+                  directory.string(), port, executable.string(), m_outputPath);
+#endif
+  fmt::print(stderr, "Executing: {}\n", runCmd);
+
+  if (std::system(runCmd.c_str()) != 0) {
+    fmt::print(stderr, "The robot program could not be started.\n");
+    std::exit(1);
+  }
+}
+
+SimRobot::~SimRobot() {
+  nt::StopClient(m_nt);
+  nt::DestroyInstance(m_nt);
+}
+
+void SimRobot::Connect() {
+  nt::StartClient(m_nt, "localhost", m_port);
+
+  nt::SetEntryValue(m_kill, nt::Value::MakeBoolean(false));
+  nt::Flush(m_nt);
+
+  // Wait for NT to connect or fail it if it times out.
+  auto time = wpi::Now();
+  while (!nt::IsConnected(m_nt)) {
+    if (wpi::Now() - time > 1.5E7) {
+      fmt::print(stderr, "The robot program on port {} crashed\n", m_port);
+      fmt::print(stderr,
+                 "\n******\nRobot Program Captured Output:\n{}\n******\n",
+                 GetOutput());
+      std::exit(1);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  }
+}
+
+std::string SimRobot::Kill() {
+  fmt::print(stderr, "Killing program on port {}\n", m_port);
+  auto time = wpi::Now();
+
+  while (nt::IsConnected(m_nt)) {
+    nt::SetEntryValue(m_kill, nt::Value::MakeBoolean(true));
+    nt::Flush(m_nt);
+    if (wpi::Now() - time > 3E7) {
+      EXPECT_TRUE(false);
+      return GetOutput();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  }
+
+  fmt::print(stderr, "Killed robot program on port {}\n", m_port);
+
+  // Set kill entry to false for future tests
+  nt::SetEntryValue(m_kill, nt::Value::MakeBoolean(false));
+  nt::StopClient(m_nt);
+
+  return GetOutput();
+}
+
+std::string SimRobot::GetOutput() const {
+  return ReadFile(m_outputPath);
+}
+
+unsigned int GetShardPort() {
+  unsigned int shard = 0;
+  if (const char* index = std::getenv("GTEST_SHARD_INDEX")) {
+    shard = std::strtoul(index, nullptr, 10);
+  }
+  // Robot programs serve NT on the default port until they switch to theirs.
+  return NT_DEFAULT_PORT + 1 + shard;
+}
+
+int RunShards(std::string_view executable, size_t shards) {
+  auto directory = GetIntegrationDirectory();
+  fs::create_directories(directory);
+  std::string filter = ::testing::GTEST_FLAG(filter);
+
+  struct Shard {
+    std::string outputPath;
+    int result = 0;
+    double seconds = 0;
+  };
+  std::vector<Shard> results(shards);
+  std::vector<std::thread> threads;
+  auto start = wpi::Now();
+  for (size_t i = 0; i < shards; ++i) {
+    results[i].outputPath =
+        (directory / fmt::format("shard-{}.txt", i)).string();
+#ifdef _WIN32
+    std::string cmd = fmt::format(
+        "set \"GTEST_TOTAL_SHARDS={}\" && set \"GTEST_SHARD_INDEX={}\" && "
+        "set \"GTEST_FILTER={}\" && set \"SYSID_SIM_INSTALLED=1\" && "
+        "\"{}\" > \"{}\" 2>&1",
+        shards, i, filter, executable, results[i].outputPath);
+#else
+    std::string cmd = fmt::format(
+        "GTEST_TOTAL_SHARDS={} GTEST_SHARD_INDEX={} GTEST_FILTER='{}' "
+        "SYSID_SIM_INSTALLED=1 \"{}\" > \"{}\" 2>&1",
+        shards, i, filter, executable, results[i].outputPath);
+#endif
+    threads.emplace_back([&shard = results[i], cmd] {
+      auto shardStart = wpi::Now();
+      shard.result = std::system(cmd.c_str());
+      shard.seconds = (wpi::Now() - shardStart) * 1E-6;
+    });
+  }
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+  double seconds = (wpi::Now() - start) * 1E-6;
+
+  // Print the output of the shards one after the other, then a summary.
+  int failures = 0;
+  for (size_t i = 0; i < shards; ++i) {
+    fmt::print("\n****** Shard {} ******\n{}", i,
+               ReadFile(results[i].outputPath));
+    if (results[i].result != 0) {
+      ++failures;
+    }
+  }
+  fmt::print("\n");
+  for (size_t i = 0; i < shards; ++i) {
+    fmt::print("Shard {}: {} in {:.1f} s\n", i,
+               results[i].result == 0 ? "passed" : "FAILED",
+               results[i].seconds);
+  }
+  fmt::print("{} shards ran in {:.1f} s\n", shards, seconds);
+  return failures == 0 ? 0 : 1;
+}
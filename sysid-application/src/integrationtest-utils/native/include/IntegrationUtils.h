@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <string_view>
 
@@ -13,6 +14,15 @@
 #include "networktables/NetworkTableValue.h"
 #include "sysid/Util.h"
 
+/**
+ * Installs the simulation of a robot project using std::system, exiting if
+ * it fails.
+ *
+ * @param projectDirectory the relative path of the robot project folder from
+ * the root directory.
+ */
+void InstallSim(std::string_view projectDirectory);
+
 /**
  * Launches a robot simulation using std::system
  *
@@ -44,3 +54,73 @@ void Connect(NT_Inst nt, NT_Entry kill);
  * @return captured console output during the robot simulation.
  */
 std::string KillNT(NT_Inst nt, NT_Entry kill);
+
+/**
+ * A simulated robot program that runs its installed executable directly with
+ * its own NT server port and working directory, so that several robots can be
+ * simulated at the same time. The robot program must be installed with
+ * InstallSim() and built with -Pintegration, which makes it serve NT on the
+ * port in the SYSID_NT_PORT environment variable.
+ */
+class SimRobot {
+ public:
+  /**
+   * Launches the robot program.
+   *
+   * @param projectDirectory the relative path of the robot project folder from
+   * the root directory.
+   * @param port the NT server port of the robot program.
+   */
+  SimRobot(std::string_view projectDirectory, unsigned int port);
+
+  ~SimRobot();
+
+  SimRobot(const SimRobot&) = delete;
+  SimRobot& operator=(const SimRobot&) = delete;
+
+  /**
+   * Returns the NT instance that is connected to the robot program.
+   */
+  NT_Inst GetInstance() const { return m_nt; }
+
+  /**
+   * Connects to the robot program and configures the kill entry to not
+   * prematurely kill it, exiting if the robot program doesn't start.
+   */
+  void Connect();
+
+  /**
+   * Kills the robot program.
+   *
+   * @return the console output of the robot program.
+   */
+  std::string Kill();
+
+  /**
+   * Returns the console output of the robot program so far.
+   */
+  std::string GetOutput() const;
+
+ private:
+  unsigned int m_port;
+  std::string m_outputPath;
+  NT_Inst m_nt;
+  NT_Entry m_kill;
+};
+
+/**
+ * Returns the NT port for the simulated robot of this test process. Each shard
+ * of a sharded test run gets its own port.
+ */
+unsigned int GetShardPort();
+
+/**
+ * Runs the tests of this executable in parallel shards, each in its own
+ * process, and prints the output and the time of each shard.
+ *
+ * @param executable the path of this executable (argv[0]).
+ * @param shards the number of shards.
+ *
+ * @return 0 if all shards passed, 1 otherwise.
+ */
+int RunShards(std::string_view executable, size_t shards);
@@ -158,10 +158,14 @@ void Application(std::string_view saveDir) {
     }
 
     bool toCSV = false;
+    bool fromDataLog = false;
     if (ImGui::BeginMenu("JSON Converters")) {
       if (ImGui::MenuItem("JSON to CSV Converter")) {
         toCSV = true;
       }
+      if (ImGui::MenuItem("WPILib Data Log Importer")) {
+        fromDataLog = true;
+      }
 
       ImGui::EndMenu();
     }
@@ -181,6 +185,19 @@ void Application(std::string_view saveDir) {
       ImGui::EndPopup();
     }
 
+    if (fromDataLog) {
+      ImGui::OpenPopup("WPILib Data Log Importer");
+      fromDataLog = false;
+    }
+
+    if (ImGui::BeginPopupModal("WPILib Data Log Importer")) {
+      gJSONConverter->DisplayDataLogImport();
+      if (ImGui::Button("Close")) {
+        ImGui::CloseCurrentPopup();
+      }
+      ImGui::EndPopup();
+    }
+
     if (about) {
       ImGui::OpenPopup("About");
       about = false;
@@ -7,6 +7,12 @@
 #ifndef RUNNING_SYSID_TESTS
 
 void Application(std::string_view saveDir);
+int Watch(int argc, char** argv);
+int Serve(int argc, char** argv);
+int Report(int argc, char** argv);
+int Record(int argc, char** argv);
+int Replay(int argc, char** argv);
+int Regression(int argc, char** argv);
 
 #ifdef _WIN32
 int __stdcall WinMain(void* hInstance, void* hPrevInstance, char* pCmdLine,
@@ -16,6 +22,21 @@ int __stdcall WinMain(void* hInstance, void* hPrevInstance, char* pCmdLine,
 #else
 int main(int argc, char** argv) {
 #endif
+  // Run one of the headless services instead of the GUI.
+  if (argc >= 2 && std::string_view{argv[1]} == "--watch") {
+    return Watch(argc - 2, argv + 2);
+  } else if (argc >= 2 && std::string_view{argv[1]} == "--serve") {
+    return Serve(argc - 2, argv + 2);
+  } else if (argc >= 2 && std::string_view{argv[1]} == "--report") {
+    return Report(argc - 2, argv + 2);
+  } else if (argc >= 2 && std::string_view{argv[1]} == "--record") {
+    return Record(argc - 2, argv + 2);
+  } else if (argc >= 2 && std::string_view{argv[1]} == "--replay") {
+    return Replay(argc - 2, argv + 2);
+  } else if (argc >= 2 && std::string_view{argv[1]} == "--regression") {
+    return Regression(argc - 2, argv + 2);
+  }
+
   std::string_view saveDir;
   if (argc == 2) {
     saveDir = argv[1];
@@ -0,0 +1,91 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef RUNNING_SYSID_TESTS
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <fmt/format.h>
+#include <ntcore_cpp.h>
+#include <wpi/StringExtras.h>
+
+#include "sysid/telemetry/NTRecording.h"
+
+static std::atomic<bool> gStop{false};
+
+static void PrintUsage() {
+  fmt::print(stderr,
+             "usage: sysid --record [--prefix PREFIX] TEAM|ADDRESS FILE\n"
+             "\n"
+             "Records the NetworkTables updates of a robot and the programs "
+             "connected to it\n"
+             "until interrupted, e.g. while the Logger runs the tests.\n");
+}
+
+int Record(int argc, char** argv) {
+  std::string prefix;
+  std::string server;
+  std::string path;
+  for (int i = 0; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--prefix" && i + 1 < argc) {
+      prefix = argv[++i];
+    } else if (arg.empty() || arg[0] == '-') {
+      PrintUsage();
+      return 1;
+    } else if (server.empty()) {
+      server = arg;
+    } else if (path.empty()) {
+      path = arg;
+    } else {
+      PrintUsage();
+      return 1;
+    }
+  }
+  if (path.empty()) {
+    PrintUsage();
+    return 1;
+  }
+
+  auto instance = nt::CreateInstance();
+  nt::SetNetworkIdentity(instance, "sysid-recorder");
+  if (auto team = wpi::parse_integer<unsigned int>(server, 10)) {
+    nt::StartClientTeam(instance, *team, NT_DEFAULT_PORT);
+  } else {
+    nt::StartClient(instance, server.c_str(), NT_DEFAULT_PORT);
+  }
+
+  int status = 0;
+  {
+    sysid::NTRecorder recorder{instance, prefix};
+    std::signal(SIGINT, [](int) { gStop = true; });
+    std::signal(SIGTERM, [](int) { gStop = true; });
+    fmt::print(stderr, "Recording {} until interrupted\n", server);
+    while (!gStop) {
+      recorder.Update();
+      std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    }
+    recorder.Update();
+
+    const auto& recording = recorder.GetRecording();
+    try {
+      sysid::SaveRecording(recording, path);
+      fmt::print(stderr, "Saved {} updates over {:.1f} s to {}\n",
+                 recording.events.size(), recording.GetDuration(), path);
+    } catch (const std::exception& e) {
+      fmt::print(stderr, "{}\n", e.what());
+      status = 1;
+    }
+  }
+  nt::DestroyInstance(instance);
+  return status;
+}
+
+#endif
@@ -0,0 +1,170 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef RUNNING_SYSID_TESTS
+
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <fmt/format.h>
+#include <wpi/Logger.h>
+#include <wpi/fs.h>
+#include <wpi/raw_ostream.h>
+
+#include "sysid/analysis/BatchAnalysis.h"
+#include "sysid/analysis/RegressionSuite.h"
+
+static void PrintUsage() {
+  fmt::print(stderr,
+             "usage: sysid --regression [--baseline FILE] [--update] "
+             "[--no-timings]\n"
+             "                          [--settings FILE] [--repeat N] "
+             "[--time-ratio F]\n"
+             "                          [--output FILE] "
+             "[CAPTURE|DIRECTORY...]\n"
+             "\n"
+             "Runs the synthetic captures and the given captures through the "
+             "analysis and\n"
+             "compares their gains, accuracy, and timings with the baseline. "
+             "--update stores\n"
+             "the results as the baseline instead, without the timings if "
+             "--no-timings is\n"
+             "given. A time ratio of 0 skips the timings.\n");
+}
+
+int Regression(int argc, char** argv) {
+  std::vector<std::string> paths;
+  std::string baselinePath = "sysid-regression.json";
+  std::string outputPath;
+  bool update = false;
+  bool timings = true;
+  int repeats = 3;
+  sysid::BatchSettings settings;
+  sysid::RegressionThresholds thresholds;
+  try {
+    for (int i = 0; i < argc; ++i) {
+      std::string_view arg = argv[i];
+      if (arg == "--baseline" && i + 1 < argc) {
+        baselinePath = argv[++i];
+      } else if (arg == "--update") {
+        update = true;
+      } else if (arg == "--no-timings") {
+        timings = false;
+      } else if (arg == "--settings" && i + 1 < argc) {
+        settings = sysid::LoadBatchSettings(argv[++i]);
+      } else if (arg == "--repeat" && i + 1 < argc) {
+        repeats = std::max(1, std::stoi(argv[++i]));
+      } else if (arg == "--time-ratio" && i + 1 < argc) {
+        thresholds.timeRatio = std::stod(argv[++i]);
+      } else if (arg == "--output" && i + 1 < argc) {
+        outputPath = argv[++i];
+      } else if (arg.empty() || arg[0] == '-') {
+        PrintUsage();
+        return 1;
+      } else if (fs::is_directory(fs::path{arg})) {
+        std::vector<std::string> captures;
+        for (auto&& entry : fs::directory_iterator{fs::path{arg}}) {
+          auto path = entry.path().string();
+          if (entry.is_regular_file() && sysid::IsCapturePath(path)) {
+            captures.emplace_back(std::move(path));
+          }
+        }
+        std::sort(captures.begin(), captures.end());
+        paths.insert(paths.end(), captures.begin(), captures.end());
+      } else {
+        paths.emplace_back(arg);
+      }
+    }
+  } catch (const std::exception& e) {
+    fmt::print(stderr, "{}\n", e.what());
+    return 1;
+  }
+
+  // Only print errors; the results are printed as a table below.
+  wpi::Logger logger;
+  logger.SetLogger([](unsigned int level, const char* file, unsigned int line,
+                      const char* msg) {
+    if (level >= wpi::WPI_LOG_ERROR) {
+      fmt::print(stderr, "ERROR: {}\n", msg);
+    }
+  });
+
+  // The cases run one after the other so that they don't disturb each
+  // other's timings.
+  std::vector<sysid::RegressionResult> results;
+  try {
+    auto corpus = sysid::MakeSyntheticCorpus();
+    for (auto&& path : paths) {
+      corpus.push_back(sysid::LoadRegressionCase(path));
+    }
+    for (auto&& regressionCase : corpus) {
+      fmt::print(stderr, "Running {}\n", regressionCase.name);
+      results.push_back(
+          sysid::RunRegressionCase(regressionCase, settings, repeats, logger));
+    }
+  } catch (const std::exception& e) {
+    fmt::print(stderr, "{}\n", e.what());
+    return 1;
+  }
+
+  if (update) {
+    try {
+      sysid::SaveRegressionResults(results, baselinePath, timings);
+    } catch (const std::exception& e) {
+      fmt::print(stderr, "{}\n", e.what());
+      return 1;
+    }
+    fmt::print("{}\nStored the baseline in {}\n",
+               sysid::FormatRegressionTable(results, {}, thresholds),
+               baselinePath);
+    return 0;
+  }
+
+  std::vector<sysid::RegressionResult> baseline;
+  if (fs::exists(fs::path{baselinePath})) {
+    try {
+      baseline = sysid::LoadRegressionResults(baselinePath);
+    } catch (const std::exception& e) {
+      fmt::print(stderr, "{}\n", e.what());
+      return 1;
+    }
+  }
+
+  auto table = sysid::FormatRegressionTable(results, baseline, thresholds);
+  auto regressions =
+      sysid::CompareToBaseline(results, baseline, thresholds);
+  fmt::print("{}\n", table);
+  for (auto&& regression : regressions) {
+    fmt::print("REGRESSION: {}\n", regression);
+  }
+  if (!outputPath.empty()) {
+    std::error_code ec;
+    wpi::raw_fd_ostream os{outputPath, ec};
+    if (ec) {
+      fmt::print(stderr, "Unable to write {}: {}\n", outputPath,
+                 ec.message());
+      return 1;
+    }
+    os << table;
+    for (auto&& regression : regressions) {
+      os << "\n- " << regression;
+    }
+    os << "\n";
+  }
+
+  // Without a baseline, nothing was checked.
+  if (baseline.empty()) {
+    fmt::print(stderr,
+               "There is no baseline in {}; run with --update to store one\n",
+               baselinePath);
+    return 1;
+  }
+  return regressions.empty() ? 0 : 1;
+}
+
+#endif
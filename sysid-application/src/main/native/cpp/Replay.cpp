@@ -0,0 +1,96 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef RUNNING_SYSID_TESTS
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+#include <ntcore_cpp.h>
+
+#include "sysid/telemetry/NTRecording.h"
+
+static std::atomic<bool> gStop{false};
+
+static void PrintUsage() {
+  fmt::print(stderr,
+             "usage: sysid --replay [--speed FACTOR] [--port PORT] "
+             "[--no-gate] FILE\n"
+             "\n"
+             "Runs a NetworkTables server that publishes the robot updates of "
+             "a recording.\n"
+             "Replaying waits for the Logger to begin each test unless "
+             "--no-gate is given.\n"
+             "A speed of 0 publishes the updates as fast as possible.\n");
+}
+
+int Replay(int argc, char** argv) {
+  double speed = 1.0;
+  unsigned int port = NT_DEFAULT_PORT;
+  bool gate = true;
+  std::string path;
+  try {
+    for (int i = 0; i < argc; ++i) {
+      std::string_view arg = argv[i];
+      if (arg == "--speed" && i + 1 < argc) {
+        speed = std::stod(argv[++i]);
+      } else if (arg == "--port" && i + 1 < argc) {
+        port = std::stoul(argv[++i]);
+      } else if (arg == "--no-gate") {
+        gate = false;
+      } else if (arg.empty() || arg[0] == '-' || !path.empty()) {
+        PrintUsage();
+        return 1;
+      } else {
+        path = arg;
+      }
+    }
+  } catch (const std::exception& e) {
+    fmt::print(stderr, "{}\n", e.what());
+    return 1;
+  }
+  if (path.empty()) {
+    PrintUsage();
+    return 1;
+  }
+
+  sysid::NTRecording recording;
+  try {
+    recording = sysid::LoadRecording(path);
+  } catch (const std::exception& e) {
+    fmt::print(stderr, "{}\n", e.what());
+    return 1;
+  }
+
+  auto instance = nt::CreateInstance();
+  nt::StartServer(instance, "", "", port);
+  {
+    std::vector<std::string> gates;
+    if (gate) {
+      gates.emplace_back("/SmartDashboard/SysIdTestType");
+    }
+    sysid::NTReplayer replayer{instance, recording, gates};
+    std::signal(SIGINT, [](int) { gStop = true; });
+    std::signal(SIGTERM, [](int) { gStop = true; });
+    fmt::print(stderr, "Replaying {:.1f} s of {} on port {}\n",
+               recording.GetDuration(), path, port);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t published = replayer.Run(speed, gStop);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    fmt::print(stderr, "Published {} updates in {:.3f} s ({:.0f} updates/s)\n",
+               published, elapsed.count(), published / elapsed.count());
+  }
+  nt::DestroyInstance(instance);
+  return 0;
+}
+
+#endif
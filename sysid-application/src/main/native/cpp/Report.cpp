@@ -0,0 +1,130 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef RUNNING_SYSID_TESTS
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+#include <wpi/Logger.h>
+#include <wpi/fs.h>
+
+#include "sysid/analysis/BatchAnalysis.h"
+#include "sysid/analysis/ReportGenerator.h"
+#include "sysid/analysis/ResultCache.h"
+
+static void PrintUsage() {
+  fmt::print(stderr,
+             "usage: sysid --report [--format html|md] [--output DIRECTORY] "
+             "[--settings FILE]\n"
+             "                      [--jobs N] [--no-cache] "
+             "CAPTURE|DIRECTORY...\n"
+             "\n"
+             "Writes a report with the gains and charts of each capture. "
+             "Directories are\n"
+             "searched for captures.\n");
+}
+
+int Report(int argc, char** argv) {
+  std::vector<std::string> paths;
+  sysid::BatchSettings settings;
+  settings.cacheDirectory = sysid::GetDefaultCacheDirectory();
+  auto format = sysid::ReportFormat::kHTML;
+  std::string directory;
+  size_t jobs = std::max(1u, std::thread::hardware_concurrency());
+  try {
+    for (int i = 0; i < argc; ++i) {
+      std::string_view arg = argv[i];
+      if (arg == "--format" && i + 1 < argc) {
+        std::string_view name = argv[++i];
+        if (name == "html") {
+          format = sysid::ReportFormat::kHTML;
+        } else if (name == "md") {
+          format = sysid::ReportFormat::kMarkdown;
+        } else {
+          PrintUsage();
+          return 1;
+        }
+      } else if (arg == "--output" && i + 1 < argc) {
+        directory = argv[++i];
+      } else if (arg == "--settings" && i + 1 < argc) {
+        auto cacheDirectory = settings.cacheDirectory;
+        settings = sysid::LoadBatchSettings(argv[++i]);
+        settings.cacheDirectory = cacheDirectory;
+      } else if (arg == "--jobs" && i + 1 < argc) {
+        jobs = std::max<size_t>(1, std::stoul(argv[++i]));
+      } else if (arg == "--no-cache") {
+        settings.cacheDirectory.clear();
+      } else if (arg.empty() || arg[0] == '-') {
+        PrintUsage();
+        return 1;
+      } else if (fs::is_directory(fs::path{arg})) {
+        std::vector<std::string> captures;
+        for (auto&& entry : fs::directory_iterator{fs::path{arg}}) {
+          auto path = entry.path().string();
+          if (entry.is_regular_file() && sysid::IsCapturePath(path)) {
+            captures.emplace_back(std::move(path));
+          }
+        }
+        std::sort(captures.begin(), captures.end());
+        paths.insert(paths.end(), captures.begin(), captures.end());
+      } else {
+        paths.emplace_back(arg);
+      }
+    }
+  } catch (const std::exception& e) {
+    fmt::print(stderr, "{}\n", e.what());
+    return 1;
+  }
+  if (paths.empty()) {
+    PrintUsage();
+    return 1;
+  }
+
+  // Only print errors; the result of each capture is printed below.
+  wpi::Logger logger;
+  logger.SetLogger([](unsigned int level, const char* file, unsigned int line,
+                      const char* msg) {
+    if (level >= wpi::WPI_LOG_ERROR) {
+      fmt::print(stderr, "ERROR: {}\n", msg);
+    }
+  });
+
+  // Captures are independent, so they're split between the jobs.
+  std::atomic<size_t> next{0};
+  std::atomic<int> failures{0};
+  std::mutex outputMutex;
+  auto work = [&] {
+    for (size_t i = next++; i < paths.size(); i = next++) {
+      try {
+        auto report =
+            sysid::WriteReport(paths[i], settings, format, directory, logger);
+        std::scoped_lock lock{outputMutex};
+        fmt::print("{}: {}\n", paths[i], report);
+      } catch (const std::exception& e) {
+        ++failures;
+        std::scoped_lock lock{outputMutex};
+        fmt::print(stderr, "{}: {}\n", paths[i], e.what());
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < std::min(jobs, paths.size()); ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+#endif
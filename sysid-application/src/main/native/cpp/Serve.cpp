@@ -0,0 +1,94 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef RUNNING_SYSID_TESTS
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <fmt/core.h>
+#include <wpi/Logger.h>
+
+#include "sysid/analysis/AnalysisServer.h"
+#include "sysid/analysis/BatchAnalysis.h"
+#include "sysid/analysis/ResultCache.h"
+
+static std::atomic<bool> gStop{false};
+
+static void PrintUsage() {
+  fmt::print(stderr,
+             "usage: sysid --serve [--port N] [--workers N] [--queue N] "
+             "[--settings FILE]\n"
+             "                     [--no-cache]\n"
+             "\n"
+             "Serves analysis requests from other tools on this machine over "
+             "HTTP.\n");
+}
+
+int Serve(int argc, char** argv) {
+  sysid::BatchSettings settings;
+  settings.cacheDirectory = sysid::GetDefaultCacheDirectory();
+  unsigned int port = sysid::AnalysisServer::kDefaultPort;
+  size_t workers = 2;
+  size_t queueCapacity = 16;
+  try {
+    for (int i = 0; i < argc; ++i) {
+      std::string_view arg = argv[i];
+      if (arg == "--settings" && i + 1 < argc) {
+        auto cacheDirectory = settings.cacheDirectory;
+        settings = sysid::LoadBatchSettings(argv[++i]);
+        settings.cacheDirectory = cacheDirectory;
+      } else if (arg == "--port" && i + 1 < argc) {
+        port = std::stoul(argv[++i]);
+      } else if (arg == "--workers" && i + 1 < argc) {
+        workers = std::stoul(argv[++i]);
+      } else if (arg == "--queue" && i + 1 < argc) {
+        queueCapacity = std::stoul(argv[++i]);
+      } else if (arg == "--no-cache") {
+        settings.cacheDirectory.clear();
+      } else {
+        PrintUsage();
+        return 1;
+      }
+    }
+  } catch (const std::exception& e) {
+    fmt::print(stderr, "{}\n", e.what());
+    return 1;
+  }
+
+  wpi::Logger logger;
+  logger.SetLogger([](unsigned int level, const char* file, unsigned int line,
+                      const char* msg) {
+    const char* lvl = "";
+    if (level >= wpi::WPI_LOG_ERROR) {
+      lvl = "ERROR: ";
+    } else if (level >= wpi::WPI_LOG_WARNING) {
+      lvl = "WARNING: ";
+    }
+    fmt::print(stderr, "{}{}\n", lvl, msg);
+  });
+
+  std::optional<sysid::AnalysisServer> server;
+  try {
+    server.emplace(settings, workers, queueCapacity, port, logger);
+  } catch (const std::exception& e) {
+    fmt::print(stderr, "{}\n", e.what());
+    return 1;
+  }
+  std::signal(SIGINT, [](int) { gStop = true; });
+  std::signal(SIGTERM, [](int) { gStop = true; });
+  while (!gStop) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+  }
+  fmt::print(stderr, "Stopping\n");
+  return 0;
+}
+
+#endif
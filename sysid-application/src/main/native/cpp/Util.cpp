@@ -6,43 +6,9 @@
 
 #include <stdexcept>
 
-#include <imgui.h>
 #include <wpi/fs.h>
 #include <wpi/raw_ostream.h>
 
-void sysid::CreateTooltip(const char* text) {
-  ImGui::SameLine();
-  ImGui::TextDisabled(" (?)");
-
-  if (ImGui::IsItemHovered()) {
-    ImGui::BeginTooltip();
-    ImGui::PushTextWrapPos(ImGui::GetFontSize() * 35.0f);
-    ImGui::TextUnformatted(text);
-    ImGui::PopTextWrapPos();
-    ImGui::EndTooltip();
-  }
-}
-
-void sysid::CreateErrorPopup(bool& isError, std::string_view errorMessage) {
-  if (isError) {
-    ImGui::OpenPopup("Exception Caught!");
-  }
-
-  // Handle exceptions.
-  ImGui::SetNextWindowSize(ImVec2(480.f, 0.0f));
-  if (ImGui::BeginPopupModal("Exception Caught!")) {
-    ImGui::PushTextWrapPos(0.0f);
-    ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s",
-                       errorMessage.data());
-    ImGui::PopTextWrapPos();
-    if (ImGui::Button("Close")) {
-      ImGui::CloseCurrentPopup();
-      isError = false;
-    }
-    ImGui::EndPopup();
-  }
-}
-
 std::string sysid::GetAbbreviation(std::string_view unit) {
   if (unit == "Meters") {
     return "m";
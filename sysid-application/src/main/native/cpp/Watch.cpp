@@ -0,0 +1,94 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef RUNNING_SYSID_TESTS
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+#include <wpi/Logger.h>
+
+#include "sysid/analysis/BatchAnalysis.h"
+#include "sysid/analysis/CaptureWatcher.h"
+#include "sysid/analysis/ResultCache.h"
+
+static std::atomic<bool> gStop{false};
+
+static void PrintUsage() {
+  fmt::print(stderr,
+             "usage: sysid --watch [--settings FILE] [--workers N] "
+             "[--no-cache] DIRECTORY...\n"
+             "\n"
+             "Analyzes new captures in the directories as they're written and "
+             "writes\n"
+             "the results next to them, along with a summary of the latest "
+             "results.\n");
+}
+
+int Watch(int argc, char** argv) {
+  std::vector<std::string> directories;
+  sysid::BatchSettings settings;
+  settings.cacheDirectory = sysid::GetDefaultCacheDirectory();
+  size_t workers = 2;
+  try {
+    for (int i = 0; i < argc; ++i) {
+      std::string_view arg = argv[i];
+      if (arg == "--settings" && i + 1 < argc) {
+        auto cacheDirectory = settings.cacheDirectory;
+        settings = sysid::LoadBatchSettings(argv[++i]);
+        settings.cacheDirectory = cacheDirectory;
+      } else if (arg == "--workers" && i + 1 < argc) {
+        workers = std::stoul(argv[++i]);
+      } else if (arg == "--no-cache") {
+        settings.cacheDirectory.clear();
+      } else if (arg.empty() || arg[0] == '-') {
+        PrintUsage();
+        return 1;
+      } else {
+        directories.emplace_back(arg);
+      }
+    }
+  } catch (const std::exception& e) {
+    fmt::print(stderr, "{}\n", e.what());
+    return 1;
+  }
+  if (directories.empty()) {
+    PrintUsage();
+    return 1;
+  }
+
+  wpi::Logger logger;
+  logger.SetLogger([](unsigned int level, const char* file, unsigned int line,
+                      const char* msg) {
+    const char* lvl = "";
+    if (level >= wpi::WPI_LOG_ERROR) {
+      lvl = "ERROR: ";
+    } else if (level >= wpi::WPI_LOG_WARNING) {
+      lvl = "WARNING: ";
+    }
+    fmt::print(stderr, "{}{}\n", lvl, msg);
+  });
+
+  sysid::CaptureWatcher watcher{directories, settings, workers, logger};
+  std::signal(SIGINT, [](int) { gStop = true; });
+  std::signal(SIGTERM, [](int) { gStop = true; });
+  watcher.Start();
+  fmt::print(stderr, "Watching {} for captures\n",
+             fmt::join(directories, ", "));
+  while (!gStop) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+  }
+  fmt::print(stderr, "Stopping\n");
+  watcher.Stop();
+  return 0;
+}
+
+#endif
@@ -6,11 +6,20 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
 #include <functional>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
 #include <stdexcept>
 #include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <fmt/format.h>
@@ -20,10 +29,17 @@
 #include <wpi/StringMap.h>
 #include <wpi/json.h>
 #include <wpi/raw_istream.h>
+#include <wpi/span.h>
 
 #include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/AutoTune.h"
 #include "sysid/analysis/FilteringUtils.h"
 #include "sysid/analysis/JSONConverter.h"
+#include "sysid/analysis/MappedFile.h"
+#include "sysid/analysis/MechanismDescriptor.h"
+#include "sysid/analysis/MotorChannels.h"
+#include "sysid/analysis/ResultCache.h"
+#include "sysid/analysis/Segmentation.h"
 #include "sysid/analysis/Storage.h"
 #include "sysid/analysis/TrackWidthAnalysis.h"
 
@@ -47,8 +63,9 @@ using namespace sysid;
 template <size_t S, size_t Timestamp, size_t Voltage, size_t Position,
           size_t Velocity>
 static std::vector<PreparedData> ConvertToPrepared(
-    const std::vector<std::array<double, S>>& data) {
+    const std::pmr::vector<std::array<double, S>>& data) {
   std::vector<PreparedData> prepared;
+  prepared.reserve(data.size());
   for (int i = 0; i < data.size() - 1; i++) {
     const auto& pt1 = data[i];
     const auto& pt2 = data[i + 1];
@@ -61,25 +78,111 @@ static std::vector<PreparedData> ConvertToPrepared(
 }
 
 /**
- * Concatenates a list of vectors. The contents of the source vectors are copied
- * (not moved) into the new vector. Also sorts the datapoints by timestamp to
- * assist with future simulation.
+ * Concatenates a list of vectors into a vector, replacing its contents but
+ * reusing its capacity. The contents of the source vectors are copied (not
+ * moved) into the vector. Also sorts the datapoints by timestamp to assist
+ * with future simulation.
  *
+ * @param result  The vector to store the concatenated vectors in.
  * @param sources The source vectors.
- * @return The concatenated vector
  */
-template <typename... Sources>
-std::vector<PreparedData> DataConcat(const Sources&... sources) {
-  std::vector<PreparedData> result;
-  (result.insert(result.end(), sources.begin(), sources.end()), ...);
+template <typename Result, typename... Sources>
+static void DataConcat(Result* result, const Sources&... sources) {
+  result->clear();
+  result->reserve((sources.size() + ...));
+  (result->insert(result->end(), sources.begin(), sources.end()), ...);
 
   // Sort data by timestamp to remove the possibility of negative dts in future
   // simulations.
-  std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+  std::sort(result->begin(), result->end(), [](const auto& a, const auto& b) {
     return a.timestamp < b.timestamp;
   });
+}
 
-  return result;
+/**
+ * Concatenates the datasets of two tests into a vector, replacing its contents
+ * but reusing its capacity. The tests are ordered by their first timestamps,
+ * but the points of each test keep their order, so that the runs of a pooled
+ * dataset (e.g. one per swerve module) stay contiguous.
+ *
+ * @param result The vector to store the concatenated tests in.
+ * @param first  The dataset of one test.
+ * @param second The dataset of the other test.
+ */
+static void ConcatTests(std::vector<PreparedData>* result,
+                        wpi::span<const PreparedData> first,
+                        wpi::span<const PreparedData> second) {
+  if (!first.empty() && !second.empty() &&
+      second.front().timestamp < first.front().timestamp) {
+    std::swap(first, second);
+  }
+  result->clear();
+  result->reserve(first.size() + second.size());
+  result->insert(result->end(), first.begin(), first.end());
+  result->insert(result->end(), second.begin(), second.end());
+}
+
+/**
+ * The tests of a capture, which are either rows in the JSON or columns that
+ * are read in place.
+ */
+struct CaptureRows {
+  /**
+   * The JSON of the capture.
+   */
+  const wpi::json& json;
+
+  /**
+   * The columns of each test, in the order of the JSON data keys, or null if
+   * the tests are in the JSON.
+   */
+  const std::array<AnalysisManager::Columns, 4>* columns = nullptr;
+};
+
+/**
+ * Reads the rows of a test from the JSON or its columns.
+ *
+ * @tparam Data The type of a row.
+ *
+ * @param capture  The tests of the capture.
+ * @param key      The key of the test (e.g. "slow-forward").
+ * @param resource The memory resource to allocate the rows from.
+ * @return The rows of the test.
+ */
+template <typename Data>
+static std::pmr::vector<Data> ReadRows(const CaptureRows& capture,
+                                       const char* key,
+                                       std::pmr::memory_resource* resource) {
+  std::pmr::vector<Data> data{resource};
+  if (!capture.columns) {
+    const auto& rows = capture.json.at(key);
+    data.reserve(rows.size());
+    for (auto&& row : rows) {
+      data.push_back(row.get<Data>());
+    }
+    return data;
+  }
+
+  // The columns are gathered straight into the rows that the rest of the
+  // preparation works on.
+  auto test = std::find(std::begin(AnalysisManager::kJsonDataKeys),
+                        std::end(AnalysisManager::kJsonDataKeys),
+                        std::string_view{key}) -
+              std::begin(AnalysisManager::kJsonDataKeys);
+  const auto& columns = (*capture.columns)[test];
+  if (columns.columns.size() < std::tuple_size_v<Data>) {
+    throw std::runtime_error(
+        fmt::format("The {} test needs {} columns, but it has {}", key,
+                    std::tuple_size_v<Data>, columns.columns.size()));
+  }
+  data.resize(columns.size);
+  for (size_t col = 0; col < std::tuple_size_v<Data>; ++col) {
+    const double* column = columns.columns[col];
+    for (size_t row = 0; row < columns.size; ++row) {
+      data[row][col] = column[row];
+    }
+  }
+  return data;
 }
 
 /**
@@ -93,18 +196,16 @@ std::vector<PreparedData> DataConcat(const Sources&... sources) {
  */
 template <size_t S>
 static void CopyRawData(
-    wpi::StringMap<std::vector<std::array<double, S>>>* dataset) {
-  using Data = std::array<double, S>;
+    wpi::StringMap<std::pmr::vector<std::array<double, S>>>* dataset) {
   auto& data = *dataset;
-  // Loads the Raw Data
-  for (auto& it : data) {
-    auto key = it.first();
-    auto& dataset = it.getValue();
-
-    if (!wpi::contains(key, "raw")) {
-      data[fmt::format("raw-{}", key)] = dataset;
-      data[fmt::format("original-raw-{}", key)] = dataset;
-    }
+  // Loads the Raw Data. The copies are allocated from the same memory resource
+  // as the originals.
+  for (auto&& key : AnalysisManager::kJsonDataKeys) {
+    const auto& original = data[key];
+    data.try_emplace(fmt::format("raw-{}", key), original,
+                     original.get_allocator());
+    data.try_emplace(fmt::format("original-raw-{}", key), original,
+                     original.get_allocator());
   }
 }
 
@@ -121,30 +222,35 @@ static void CopyRawData(
  *               storing data for the left side of the drivetrain)
  */
 static void StoreDatasets(wpi::StringMap<Storage>* dataset,
-                          const std::vector<PreparedData>& slowForward,
-                          const std::vector<PreparedData>& slowBackward,
-                          const std::vector<PreparedData>& fastForward,
-                          const std::vector<PreparedData>& fastBackward,
+                          wpi::span<const PreparedData> slowForward,
+                          wpi::span<const PreparedData> slowBackward,
+                          wpi::span<const PreparedData> fastForward,
+                          wpi::span<const PreparedData> fastBackward,
                           std::string_view prefix = "") {
   std::string prefixStr;
   if (prefix != "") {
     prefixStr = fmt::format("{} ", prefix);
   }
 
+  // The data is copied into the existing datasets so that their capacity is
+  // reused when the data is prepared again.
   auto& outputData = *dataset;
-  outputData[prefixStr + "Forward"] = Storage{slowForward, fastForward};
-  outputData[prefixStr + "Backward"] = Storage{slowBackward, slowForward};
-  outputData[prefixStr + "Combined"] =
-      Storage{DataConcat(slowForward, slowBackward),
-              DataConcat(fastForward, fastBackward)};
+  auto& forward = outputData[prefixStr + "Forward"];
+  forward.slow.assign(slowForward.begin(), slowForward.end());
+  forward.fast.assign(fastForward.begin(), fastForward.end());
+  auto& backward = outputData[prefixStr + "Backward"];
+  backward.slow.assign(slowBackward.begin(), slowBackward.end());
+  backward.fast.assign(slowForward.begin(), slowForward.end());
+  auto& combined = outputData[prefixStr + "Combined"];
+  ConcatTests(&combined.slow, slowForward, slowBackward);
+  ConcatTests(&combined.fast, fastForward, fastBackward);
 }
 
 /**
  * Prepares data for general mechanisms (i.e. not drivetrain) and stores them
  * in the analysis manager dataset.
  *
- * @param json     A reference to the JSON containing all of the collected
- *                 data.
+ * @param capture  The tests of the capture.
  * @param settings A reference to the settings being used by the analysis
  *                 manager instance.
  * @param factor   The units per rotation to multiply positions and velocities
@@ -162,17 +268,20 @@ static void StoreDatasets(wpi::StringMap<Storage>* dataset,
  *                    from the start of the test.
  * @param maxStepTime A reference to the maximum duration of the step test
  *                    mainly for use in the GUI
+ * @param resource The memory resource to allocate transient buffers from
  * @param logger A reference to a logger to help with debugging
  */
 static void PrepareGeneralData(
-    const wpi::json& json, AnalysisManager::Settings& settings, double factor,
-    std::string_view unit, wpi::StringMap<Storage>& originalDatasets,
+    const CaptureRows& capture, AnalysisManager::Settings& settings,
+    double factor, std::string_view unit,
+    wpi::StringMap<Storage>& originalDatasets,
     wpi::StringMap<Storage>& rawDatasets,
     wpi::StringMap<Storage>& filteredDatasets,
     std::array<units::second_t, 4>& startTimes, units::second_t& minStepTime,
-    units::second_t& maxStepTime, wpi::Logger& logger) {
+    units::second_t& maxStepTime, std::pmr::memory_resource* resource,
+    wpi::Logger& logger) {
   using Data = std::array<double, 4>;
-  wpi::StringMap<std::vector<Data>> data;
+  wpi::StringMap<std::pmr::vector<Data>> data;
   wpi::StringMap<std::vector<PreparedData>> preparedData;
 
   // Store the raw data columns.
@@ -183,8 +292,9 @@ static void PrepareGeneralData(
 
   WPI_INFO(logger, "{}", "Reading JSON data.");
   // Get the major components from the JSON and store them inside a StringMap.
+  // Any per-motor channels after the first four columns are ignored here.
   for (auto&& key : AnalysisManager::kJsonDataKeys) {
-    data[key] = json.at(key).get<std::vector<Data>>();
+    data.try_emplace(key, ReadRows<Data>(capture, key, resource));
   }
 
   WPI_INFO(logger, "{}", "Preprocessing raw data.");
@@ -245,8 +355,7 @@ static void PrepareGeneralData(
  * Prepares data for angular drivetrain test data and stores them in
  * the analysis manager dataset.
  *
- * @param json       A reference to the JSON containing all of the collected
- *                   data.
+ * @param capture    The tests of the capture.
  * @param settings   A reference to the settings being used by the analysis
  *                   manager instance.
  * @param factor     The units per rotation to multiply positions and velocities
@@ -265,18 +374,20 @@ static void PrepareGeneralData(
  *                    from the start of the test.
  * @param maxStepTime A reference to the maximum duration of the step test
  *                    mainly for use in the GUI
+ * @param resource The memory resource to allocate transient buffers from
  * @param logger A reference to a logger to help with debugging
  */
 static void PrepareAngularDrivetrainData(
-    const wpi::json& json, AnalysisManager::Settings& settings, double factor,
-    std::optional<double>& trackWidth,
+    const CaptureRows& capture, AnalysisManager::Settings& settings,
+    double factor, std::optional<double>& trackWidth,
     wpi::StringMap<Storage>& originalDatasets,
     wpi::StringMap<Storage>& rawDatasets,
     wpi::StringMap<Storage>& filteredDatasets,
     std::array<units::second_t, 4>& startTimes, units::second_t& minStepTime,
-    units::second_t& maxStepTime, wpi::Logger& logger) {
+    units::second_t& maxStepTime, std::pmr::memory_resource* resource,
+    wpi::Logger& logger) {
   using Data = std::array<double, 9>;
-  wpi::StringMap<std::vector<Data>> data;
+  wpi::StringMap<std::pmr::vector<Data>> data;
   wpi::StringMap<std::vector<PreparedData>> preparedData;
 
   // Store the relevant raw data columns.
@@ -291,7 +402,7 @@ static void PrepareAngularDrivetrainData(
   WPI_INFO(logger, "{}", "Reading JSON data.");
   // Get the major components from the JSON and store them inside a StringMap.
   for (auto&& key : AnalysisManager::kJsonDataKeys) {
-    data[key] = json.at(key).get<std::vector<Data>>();
+    data.try_emplace(key, ReadRows<Data>(capture, key, resource));
   }
 
   WPI_INFO(logger, "{}", "Preprocessing raw data.");
@@ -387,8 +498,7 @@ static void PrepareAngularDrivetrainData(
  * Prepares data for linear drivetrain test data and stores them in
  * the analysis manager dataset.
  *
- * @param json     A reference to the JSON containing all of the collected
- *                 data.
+ * @param capture  The tests of the capture.
  * @param settings A reference to the settings being used by the analysis
  *                 manager instance.
  * @param factor   The units per rotation to multiply positions and velocities
@@ -405,17 +515,19 @@ static void PrepareAngularDrivetrainData(
  *                    from the start of the test.
  * @param maxStepTime A reference to the maximum duration of the step test
  *                    mainly for use in the GUI
+ * @param resource The memory resource to allocate transient buffers from
  * @param logger A reference to a logger to help with debugging
  */
 static void PrepareLinearDrivetrainData(
-    const wpi::json& json, AnalysisManager::Settings& settings, double factor,
-    wpi::StringMap<Storage>& originalDatasets,
+    const CaptureRows& capture, AnalysisManager::Settings& settings,
+    double factor, wpi::StringMap<Storage>& originalDatasets,
     wpi::StringMap<Storage>& rawDatasets,
     wpi::StringMap<Storage>& filteredDatasets,
     std::array<units::second_t, 4>& startTimes, units::second_t& minStepTime,
-    units::second_t& maxStepTime, wpi::Logger& logger) {
+    units::second_t& maxStepTime, std::pmr::memory_resource* resource,
+    wpi::Logger& logger) {
   using Data = std::array<double, 9>;
-  wpi::StringMap<std::vector<Data>> data;
+  wpi::StringMap<std::pmr::vector<Data>> data;
   wpi::StringMap<std::vector<PreparedData>> preparedData;
 
   // Store the relevant raw data columns.
@@ -430,7 +542,7 @@ static void PrepareLinearDrivetrainData(
   // Get the major components from the JSON and store them inside a StringMap.
   WPI_INFO(logger, "{}", "Reading JSON data.");
   for (auto&& key : AnalysisManager::kJsonDataKeys) {
-    data[key] = json.at(key).get<std::vector<Data>>();
+    data.try_emplace(key, ReadRows<Data>(capture, key, resource));
   }
 
   // Ensure that voltage and velocity have the same sign. Also multiply
@@ -463,31 +575,40 @@ static void PrepareLinearDrivetrainData(
             data[key]);
   }
 
+  // Concatenates the left and right datasets of a test.
+  auto concat = [&](const auto& left, const auto& right) {
+    std::pmr::vector<PreparedData> result{resource};
+    DataConcat(&result, left, right);
+    return result;
+  };
+
   // Store original data data as variables
-  auto originalSlowForwardLeft = preparedData["left-original-raw-slow-forward"];
-  auto originalSlowForwardRight =
+  const auto& originalSlowForwardLeft =
+      preparedData["left-original-raw-slow-forward"];
+  const auto& originalSlowForwardRight =
       preparedData["right-original-raw-slow-forward"];
-  auto originalSlowBackwardLeft =
+  const auto& originalSlowBackwardLeft =
       preparedData["left-original-raw-slow-backward"];
-  auto originalSlowBackwardRight =
+  const auto& originalSlowBackwardRight =
       preparedData["right-original-raw-slow-backward"];
-  auto originalFastForwardLeft = preparedData["left-original-raw-fast-forward"];
-  auto originalFastForwardRight =
+  const auto& originalFastForwardLeft =
+      preparedData["left-original-raw-fast-forward"];
+  const auto& originalFastForwardRight =
       preparedData["right-original-raw-fast-forward"];
-  auto originalFastBackwardLeft =
+  const auto& originalFastBackwardLeft =
       preparedData["left-original-raw-fast-backward"];
-  auto originalFastBackwardRight =
+  const auto& originalFastBackwardRight =
       preparedData["right-original-raw-fast-backward"];
 
   // Create the distinct raw datasets and store them in our StringMap.
   auto originalSlowForward =
-      DataConcat(originalSlowForwardLeft, originalSlowForwardRight);
+      concat(originalSlowForwardLeft, originalSlowForwardRight);
   auto originalSlowBackward =
-      DataConcat(originalSlowBackwardLeft, originalSlowBackwardRight);
+      concat(originalSlowBackwardLeft, originalSlowBackwardRight);
   auto originalFastForward =
-      DataConcat(originalFastForwardLeft, originalFastForwardRight);
+      concat(originalFastForwardLeft, originalFastForwardRight);
   auto originalFastBackward =
-      DataConcat(originalFastBackwardLeft, originalFastBackwardRight);
+      concat(originalFastBackwardLeft, originalFastBackwardRight);
 
   StoreDatasets(&originalDatasets, originalSlowForward, originalSlowBackward,
                 originalFastForward, originalFastBackward);
@@ -511,30 +632,30 @@ static void PrepareLinearDrivetrainData(
   auto& fastBackwardLeft = preparedData["left-fast-backward"];
   auto& fastBackwardRight = preparedData["right-fast-backward"];
 
-  auto slowForward = DataConcat(slowForwardLeft, slowForwardRight);
-  auto slowBackward = DataConcat(slowBackwardLeft, slowBackwardRight);
-  auto fastForward = DataConcat(fastForwardLeft, fastForwardRight);
-  auto fastBackward = DataConcat(fastBackwardLeft, fastBackwardRight);
+  auto slowForward = concat(slowForwardLeft, slowForwardRight);
+  auto slowBackward = concat(slowBackwardLeft, slowBackwardRight);
+  auto fastForward = concat(fastForwardLeft, fastForwardRight);
+  auto fastBackward = concat(fastBackwardLeft, fastBackwardRight);
 
   WPI_INFO(logger, "{}", "Acceleration filtering.");
   sysid::AccelFilter(&preparedData);
 
   WPI_INFO(logger, "{}", "Storing datasets.");
   // Store raw data as variables
-  auto rawSlowForwardLeft = preparedData["left-raw-slow-forward"];
-  auto rawSlowForwardRight = preparedData["right-raw-slow-forward"];
-  auto rawSlowBackwardLeft = preparedData["left-raw-slow-backward"];
-  auto rawSlowBackwardRight = preparedData["right-raw-slow-backward"];
-  auto rawFastForwardLeft = preparedData["left-raw-fast-forward"];
-  auto rawFastForwardRight = preparedData["right-raw-fast-forward"];
-  auto rawFastBackwardLeft = preparedData["left-raw-fast-backward"];
-  auto rawFastBackwardRight = preparedData["right-raw-fast-backward"];
+  const auto& rawSlowForwardLeft = preparedData["left-raw-slow-forward"];
+  const auto& rawSlowForwardRight = preparedData["right-raw-slow-forward"];
+  const auto& rawSlowBackwardLeft = preparedData["left-raw-slow-backward"];
+  const auto& rawSlowBackwardRight = preparedData["right-raw-slow-backward"];
+  const auto& rawFastForwardLeft = preparedData["left-raw-fast-forward"];
+  const auto& rawFastForwardRight = preparedData["right-raw-fast-forward"];
+  const auto& rawFastBackwardLeft = preparedData["left-raw-fast-backward"];
+  const auto& rawFastBackwardRight = preparedData["right-raw-fast-backward"];
 
   // Create the distinct raw datasets and store them in our StringMap.
-  auto rawSlowForward = DataConcat(rawSlowForwardLeft, rawSlowForwardRight);
-  auto rawSlowBackward = DataConcat(rawSlowBackwardLeft, rawSlowBackwardRight);
-  auto rawFastForward = DataConcat(rawFastForwardLeft, rawFastForwardRight);
-  auto rawFastBackward = DataConcat(rawFastBackwardLeft, rawFastBackwardRight);
+  auto rawSlowForward = concat(rawSlowForwardLeft, rawSlowForwardRight);
+  auto rawSlowBackward = concat(rawSlowBackwardLeft, rawSlowBackwardRight);
+  auto rawFastForward = concat(rawFastForwardLeft, rawFastForwardRight);
+  auto rawFastBackward = concat(rawFastBackwardLeft, rawFastBackwardRight);
 
   StoreDatasets(&rawDatasets, rawSlowForward, rawSlowBackward, rawFastForward,
                 rawFastBackward);
@@ -556,6 +677,451 @@ static void PrepareLinearDrivetrainData(
       rawFastForward.front().timestamp, rawFastBackward.front().timestamp};
 }
 
+/**
+ * Reads the rows of a multi-motor test from the JSON into columns.
+ *
+ * @param rows       The rows of the test.
+ * @param motorCount The number of motors with per-motor channels.
+ * @return The columns of the test.
+ * @throws std::runtime_error if a row doesn't have a column for each channel.
+ */
+static MotorChannelData ReadMotorChannelData(const wpi::json& rows,
+                                             size_t motorCount) {
+  size_t rowSize = 4 + kMotorChannelSize * motorCount;
+  MotorChannelData data;
+  data.columns.resize(rowSize);
+  for (auto&& column : data.columns) {
+    column.reserve(rows.size());
+  }
+  for (auto&& row : rows) {
+    if (row.size() != rowSize) {
+      throw std::runtime_error(
+          fmt::format("Expected {} columns of data for {} motors, but got {}",
+                      rowSize, motorCount, row.size()));
+    }
+    for (size_t col = 0; col < rowSize; ++col) {
+      data.columns[col].push_back(row[col].get<double>());
+    }
+  }
+  return data;
+}
+
+/**
+ * Prepares the per-motor channels of a general mechanism capture and stores
+ * the datasets of each motor in the analysis manager dataset. Each motor's
+ * dataset uses its applied voltage and built-in encoder in place of the
+ * mechanism voltage and encoder.
+ *
+ * @param json     A reference to the JSON containing all of the collected
+ *                 data.
+ * @param settings A reference to the settings being used by the analysis
+ *                 manager instance.
+ * @param factor   The units per rotation to multiply positions and velocities
+ *                 by.
+ * @param unit The name of the unit being used
+ * @param motorCount The number of motors with per-motor channels.
+ * @param originalDatasets A reference to the String Map storing the original
+ *                         datasets (won't be touched in the filtering process)
+ * @param rawDatasets A reference to the String Map storing the raw datasets
+ * @param filteredDatasets A reference to the String Map storing the filtered
+ *                         datasets
+ * @param diagnostics A reference to the vector storing the velocity ratio and
+ *                    mean current of each motor.
+ * @param minStepTime The minimum duration of the step test of the mechanism.
+ * @param maxStepTime The maximum duration of the step test of the mechanism.
+ * @param resource The memory resource to allocate transient buffers from
+ * @param logger A reference to a logger to help with debugging
+ */
+static void PrepareMotorChannelData(
+    const wpi::json& json, AnalysisManager::Settings& settings, double factor,
+    std::string_view unit, size_t motorCount,
+    wpi::StringMap<Storage>& originalDatasets,
+    wpi::StringMap<Storage>& rawDatasets,
+    wpi::StringMap<Storage>& filteredDatasets,
+    std::vector<MotorDiagnostics>& diagnostics, units::second_t minStepTime,
+    units::second_t maxStepTime, std::pmr::memory_resource* resource,
+    wpi::Logger& logger) {
+  using Data = std::array<double, 4>;
+  wpi::StringMap<MotorChannelData> tests;
+  MotorChannelData allTests;
+
+  WPI_INFO(logger, "{}", "Reading motor channel data.");
+  std::vector<size_t> scaledColumns{2, 3};
+  for (size_t motor = 0; motor < motorCount; ++motor) {
+    scaledColumns.push_back(MotorChannelColumn(motor, motorchannel::kPosition));
+    scaledColumns.push_back(MotorChannelColumn(motor, motorchannel::kVelocity));
+  }
+  for (auto&& key : AnalysisManager::kJsonDataKeys) {
+    auto& test = tests[key] = ReadMotorChannelData(json.at(key), motorCount);
+
+    // Multiply positions and velocities by the factor.
+    for (size_t col : scaledColumns) {
+      for (auto&& value : test.columns[col]) {
+        value *= factor;
+      }
+    }
+
+    allTests.columns.resize(test.columns.size());
+    for (size_t col = 0; col < test.columns.size(); ++col) {
+      allTests.columns[col].insert(allTests.columns[col].end(),
+                                   test.columns[col].begin(),
+                                   test.columns[col].end());
+    }
+  }
+
+  // Compare each motor with the mechanism over all tests.
+  diagnostics.assign(motorCount, MotorDiagnostics{});
+  for (size_t motor = 0; motor < motorCount; ++motor) {
+    diagnostics[motor].velocityRatio =
+        CalculateVelocityRatio(allTests, motor, settings.motionThreshold);
+    diagnostics[motor].meanCurrent =
+        CalculateMeanCurrent(allTests, motor, settings.motionThreshold);
+  }
+
+  for (size_t motor = 0; motor < motorCount; ++motor) {
+    WPI_INFO(logger, "Preparing data of motor {}.", motor + 1);
+    size_t posCol = MotorChannelColumn(motor, motorchannel::kPosition);
+    size_t velCol = MotorChannelColumn(motor, motorchannel::kVelocity);
+    size_t voltageCol =
+        MotorChannelColumn(motor, motorchannel::kAppliedVoltage);
+
+    // Ensure that voltage and velocity have the same sign.
+    wpi::StringMap<std::pmr::vector<Data>> data;
+    wpi::StringMap<std::vector<PreparedData>> preparedData;
+    for (auto& it : tests) {
+      const auto& columns = it.getValue().columns;
+      const auto& time = columns[0];
+      const auto& voltage = columns[voltageCol];
+      const auto& position = columns[posCol];
+      const auto& velocity = columns[velCol];
+      auto& dataset = data.try_emplace(it.first(), resource).first->second;
+      dataset.reserve(time.size());
+      for (size_t i = 0; i < time.size(); ++i) {
+        dataset.push_back({time[i], std::copysign(voltage[i], velocity[i]),
+                           position[i], velocity[i]});
+      }
+    }
+
+    CopyRawData(&data);
+    for (auto& it : data) {
+      preparedData[it.first()] = ConvertToPrepared<4, 0, 1, 2, 3>(it.second);
+    }
+
+    auto prefix = fmt::format("Motor {}", motor + 1);
+    StoreDatasets(&originalDatasets, preparedData["original-raw-slow-forward"],
+                  preparedData["original-raw-slow-backward"],
+                  preparedData["original-raw-fast-forward"],
+                  preparedData["original-raw-fast-backward"], prefix);
+
+    // The step test duration of the mechanism is reused so that every motor
+    // is trimmed the same way.
+    sysid::InitialTrimAndFilter(&preparedData, settings, minStepTime,
+                                maxStepTime, unit);
+    sysid::AccelFilter(&preparedData);
+
+    StoreDatasets(&rawDatasets, preparedData["raw-slow-forward"],
+                  preparedData["raw-slow-backward"],
+                  preparedData["raw-fast-forward"],
+                  preparedData["raw-fast-backward"], prefix);
+    StoreDatasets(&filteredDatasets, preparedData["slow-forward"],
+                  preparedData["slow-backward"], preparedData["fast-forward"],
+                  preparedData["fast-backward"], prefix);
+  }
+}
+
+/**
+ * Returns the key of a swerve module's dataset in the prepared data String Map.
+ *
+ * @param module The index of the module.
+ * @param key    The key of the dataset (e.g. "raw-slow-forward").
+ * @return The key of the module's dataset.
+ */
+static std::string ModuleKey(size_t module, std::string_view key) {
+  return fmt::format("module{}-{}", module + 1, key);
+}
+
+/**
+ * Returns the datasets of all swerve modules for a given key.
+ *
+ * @param preparedData The String Map containing the prepared module data.
+ * @param key          The key of the dataset (e.g. "raw-slow-forward").
+ */
+static std::array<const std::vector<PreparedData>*,
+                  analysis::kSwerveModuleCount>
+GetModuleDatasets(wpi::StringMap<std::vector<PreparedData>>& preparedData,
+                  std::string_view key) {
+  std::array<const std::vector<PreparedData>*, analysis::kSwerveModuleCount>
+      modules;
+  for (size_t module = 0; module < modules.size(); ++module) {
+    modules[module] = &preparedData[ModuleKey(module, key)];
+  }
+  return modules;
+}
+
+/**
+ * Compares the timestamp of a data point with a timestamp, for binary searches
+ * of datasets.
+ */
+static bool IsBefore(const PreparedData& pt, units::second_t timestamp) {
+  return pt.timestamp < timestamp;
+}
+
+/**
+ * Returns the timestamp where the runs of the swerve modules start in a pooled
+ * dataset.
+ *
+ * The modules share their timestamps, so every run starts at the first
+ * timestamp that all modules have once each of them has started. That
+ * timestamp marks the start of each run: it's the start time of the test,
+ * where simulations reset the model, and doesn't occur anywhere else in the
+ * pooled dataset. If the modules have no timestamp in common, the runs start
+ * at the latest first timestamp instead.
+ *
+ * @param preparedData The String Map containing the prepared module data.
+ * @param key          The key of the dataset (e.g. "raw-slow-forward").
+ */
+static units::second_t GetModuleRunStart(
+    wpi::StringMap<std::vector<PreparedData>>& preparedData,
+    std::string_view key) {
+  auto modules = GetModuleDatasets(preparedData, key);
+  auto hasTimestamp = [](const std::vector<PreparedData>* dataset,
+                         units::second_t timestamp) {
+    auto it =
+        std::lower_bound(dataset->begin(), dataset->end(), timestamp, IsBefore);
+    return it != dataset->end() && it->timestamp == timestamp;
+  };
+
+  units::second_t start{-std::numeric_limits<double>::infinity()};
+  for (auto dataset : modules) {
+    if (!dataset->empty()) {
+      start = units::math::max(start, dataset->front().timestamp);
+    }
+  }
+
+  auto first = std::find_if(modules.begin(), modules.end(),
+                            [](auto dataset) { return !dataset->empty(); });
+  if (first == modules.end()) {
+    return start;
+  }
+  const auto& dataset = **first;
+  for (auto it = std::lower_bound(dataset.begin(), dataset.end(), start,
+                                  IsBefore);
+       it != dataset.end(); ++it) {
+    if (std::all_of(modules.begin(), modules.end(), [&](auto other) {
+          return other->empty() || hasTimestamp(other, it->timestamp);
+        })) {
+      return it->timestamp;
+    }
+  }
+  return start;
+}
+
+/**
+ * Concatenates the datasets of all swerve modules for a given key into a
+ * single pooled dataset. Each module's data stays a contiguous run, so that
+ * consecutive points belong to the same module except where a run starts.
+ * The runs are trimmed to start at GetModuleRunStart().
+ *
+ * @param preparedData The String Map containing the prepared module data.
+ * @param key          The key of the dataset (e.g. "raw-slow-forward").
+ * @param resource     The memory resource to allocate the pooled dataset from.
+ * @return The pooled dataset.
+ */
+static std::pmr::vector<PreparedData> ConcatModules(
+    wpi::StringMap<std::vector<PreparedData>>& preparedData,
+    std::string_view key, std::pmr::memory_resource* resource) {
+  auto start = GetModuleRunStart(preparedData, key);
+  std::pmr::vector<PreparedData> result{resource};
+  for (auto dataset : GetModuleDatasets(preparedData, key)) {
+    result.insert(
+        result.end(),
+        std::lower_bound(dataset->begin(), dataset->end(), start, IsBefore),
+        dataset->end());
+  }
+  return result;
+}
+
+/**
+ * Stores the pooled datasets of all swerve modules along with the datasets of
+ * each module.
+ *
+ * @param dataset      The Storage String Map that will store the datasets
+ * @param preparedData The String Map containing the prepared module data.
+ * @param prefix       The prefix of the keys to store (e.g. "raw-").
+ * @param resource     The memory resource to allocate the pooled datasets
+ *                     from.
+ */
+static void StoreSwerveDatasets(
+    wpi::StringMap<Storage>* dataset,
+    wpi::StringMap<std::vector<PreparedData>>& preparedData,
+    std::string_view prefix, std::pmr::memory_resource* resource) {
+  auto key = [&](std::string_view test) {
+    return fmt::format("{}{}", prefix, test);
+  };
+
+  StoreDatasets(dataset,
+                ConcatModules(preparedData, key("slow-forward"), resource),
+                ConcatModules(preparedData, key("slow-backward"), resource),
+                ConcatModules(preparedData, key("fast-forward"), resource),
+                ConcatModules(preparedData, key("fast-backward"), resource));
+
+  for (size_t module = 0; module < analysis::kSwerveModuleCount; ++module) {
+    StoreDatasets(dataset, preparedData[ModuleKey(module, key("slow-forward"))],
+                  preparedData[ModuleKey(module, key("slow-backward"))],
+                  preparedData[ModuleKey(module, key("fast-forward"))],
+                  preparedData[ModuleKey(module, key("fast-backward"))],
+                  fmt::format("Module {}", module + 1));
+  }
+}
+
+/**
+ * Prepares data for swerve drive and steer tests and stores them in the
+ * analysis manager dataset. Each module is prepared separately, and the pooled
+ * datasets contain the data of all modules.
+ *
+ * @param capture  The tests of the capture.
+ * @param settings A reference to the settings being used by the analysis
+ *                 manager instance.
+ * @param factor   The units per rotation to multiply positions and velocities
+ *                 by.
+ * @param originalDatasets A reference to the String Map storing the original
+ *                         datasets (won't be touched in the filtering process)
+ * @param rawDatasets A reference to the String Map storing the raw datasets
+ * @param filteredDatasets A reference to the String Map storing the filtered
+ *                         datasets
+ * @param startTimes A reference to an array containing the start times for the
+ *                   4 different tests
+ * @param minStepTime A reference to the minimum duration of the step test as
+ *                    one of the trimming procedures will remove this amount
+ *                    from the start of the test.
+ * @param maxStepTime A reference to the maximum duration of the step test
+ *                    mainly for use in the GUI
+ * @param resource The memory resource to allocate transient buffers from
+ * @param logger A reference to a logger to help with debugging
+ */
+static void PrepareSwerveData(
+    const CaptureRows& capture, AnalysisManager::Settings& settings,
+    double factor, wpi::StringMap<Storage>& originalDatasets,
+    wpi::StringMap<Storage>& rawDatasets,
+    wpi::StringMap<Storage>& filteredDatasets,
+    std::array<units::second_t, 4>& startTimes, units::second_t& minStepTime,
+    units::second_t& maxStepTime, std::pmr::memory_resource* resource,
+    wpi::Logger& logger) {
+  static constexpr size_t kSize = analysis::kSwerveDrive.rawDataSize;
+  using Data = std::array<double, kSize>;
+  wpi::StringMap<std::pmr::vector<Data>> data;
+  wpi::StringMap<std::vector<PreparedData>> preparedData;
+
+  // Store the raw data columns. Each module stores its position and velocity
+  // after the shared timestamp and voltage columns.
+  static constexpr size_t kTimeCol = 0;
+  static constexpr size_t kVoltageCol = 1;
+  static constexpr size_t kFirstModuleCol = 2;
+
+  WPI_INFO(logger, "{}", "Reading JSON data.");
+  // Get the major components from the JSON and store them inside a StringMap.
+  for (auto&& key : AnalysisManager::kJsonDataKeys) {
+    data.try_emplace(key, ReadRows<Data>(capture, key, resource));
+  }
+
+  WPI_INFO(logger, "{}", "Preprocessing raw data.");
+  // Multiply positions and velocities by the factor.
+  for (auto it = data.begin(); it != data.end(); ++it) {
+    for (auto&& pt : it->second) {
+      for (size_t col = kFirstModuleCol; col < kSize; ++col) {
+        pt[col] *= factor;
+      }
+    }
+  }
+
+  WPI_INFO(logger, "{}", "Copying raw data.");
+  CopyRawData(&data);
+
+  WPI_INFO(logger, "{}", "Converting to PreparedData struct.");
+  for (auto& it : data) {
+    auto key = it.first();
+    auto& dataset = it.getValue();
+
+    auto convert = [&](auto module) {
+      constexpr size_t kPosCol = kFirstModuleCol + 2 * decltype(module)::value;
+      auto prepared =
+          ConvertToPrepared<kSize, kTimeCol, kVoltageCol, kPosCol, kPosCol + 1>(
+              dataset);
+
+      // Ensure that voltage and velocity have the same sign. The voltage
+      // column is shared, so this has to happen per module.
+      for (auto& pt : prepared) {
+        pt.voltage = std::copysign(pt.voltage, pt.velocity);
+      }
+      preparedData[ModuleKey(decltype(module)::value, key)] =
+          std::move(prepared);
+    };
+    convert(std::integral_constant<size_t, 0>{});
+    convert(std::integral_constant<size_t, 1>{});
+    convert(std::integral_constant<size_t, 2>{});
+    convert(std::integral_constant<size_t, 3>{});
+  }
+
+  StoreSwerveDatasets(&originalDatasets, preparedData, "original-raw-",
+                      resource);
+
+  WPI_INFO(logger, "{}", "Applying trimming and filtering.");
+  sysid::InitialTrimAndFilter(&preparedData, settings, minStepTime,
+                              maxStepTime);
+
+  WPI_INFO(logger, "{}", "Acceleration filtering.");
+  sysid::AccelFilter(&preparedData);
+
+  WPI_INFO(logger, "{}", "Storing datasets.");
+  StoreSwerveDatasets(&rawDatasets, preparedData, "raw-", resource);
+  StoreSwerveDatasets(&filteredDatasets, preparedData, "", resource);
+
+  startTimes = {GetModuleRunStart(preparedData, "raw-slow-forward"),
+                GetModuleRunStart(preparedData, "raw-slow-backward"),
+                GetModuleRunStart(preparedData, "raw-fast-forward"),
+                GetModuleRunStart(preparedData, "raw-fast-backward")};
+}
+
+// The version of the cached results. This has to be incremented whenever data
+// preparation, auto-tuning, or the layout of the cached results changes, since
+// the cache keys only cover the inputs.
+static constexpr uint32_t kCacheVersion = 3;
+
+static_assert(std::is_trivially_copyable_v<PreparedData>,
+              "Prepared data is cached as raw bytes");
+
+/**
+ * Serializes datasets for the result cache.
+ *
+ * @param writer   The writer of the cache entry.
+ * @param datasets The datasets to write.
+ */
+static void WriteDatasets(CacheWriter& writer,
+                          const wpi::StringMap<Storage>& datasets) {
+  writer.Write<uint64_t>(datasets.size());
+  for (auto&& it : datasets) {
+    writer.WriteString(it.getKey());
+    writer.WriteVector(it.getValue().slow);
+    writer.WriteVector(it.getValue().fast);
+  }
+}
+
+/**
+ * Deserializes datasets that were written by WriteDatasets().
+ *
+ * @param reader   The reader of the cache entry.
+ * @param datasets Where to store the datasets.
+ */
+static void ReadDatasets(CacheReader& reader,
+                         wpi::StringMap<Storage>* datasets) {
+  auto count = reader.Read<uint64_t>();
+  for (uint64_t i = 0; i < count; ++i) {
+    auto& storage = (*datasets)[reader.ReadString()];
+    reader.ReadVector(&storage.slow);
+    reader.ReadVector(&storage.fast);
+  }
+}
+
 AnalysisManager::AnalysisManager(std::string_view path, Settings& settings,
                                  wpi::Logger& logger)
     : m_settings(settings), m_logger(logger) {
@@ -569,6 +1135,7 @@ AnalysisManager::AnalysisManager(std::string_view path, Settings& settings,
     }
 
     is >> m_json;
+    m_path = path;
 
     WPI_INFO(m_logger, "Read {}", path);
   }
@@ -587,14 +1154,92 @@ AnalysisManager::AnalysisManager(std::string_view path, Settings& settings,
     }
 
     is >> m_json;
+    m_path = newPath;
 
     WPI_INFO(m_logger, "Read {}", newPath);
   }
 
   WPI_INFO(m_logger, "Parsing initial data of {}", path);
+  Initialize();
+}
+
+AnalysisManager::AnalysisManager(wpi::json json, Settings& settings,
+                                 wpi::Logger& logger)
+    : m_logger(logger), m_json(std::move(json)), m_settings(settings) {
+  if (m_json.find("sysid") == m_json.end()) {
+    throw std::runtime_error("The JSON doesn't contain sysid data");
+  }
+  Initialize();
+}
+
+AnalysisManager::AnalysisManager(std::string_view test, std::string_view unit,
+                                 double unitsPerRotation,
+                                 std::array<Columns, 4> tests,
+                                 Settings& settings, wpi::Logger& logger)
+    : m_logger(logger),
+      m_json{{"sysid", true},
+             {"test", std::string{test}},
+             {"units", std::string{unit}},
+             {"unitsPerRotation", unitsPerRotation}},
+      m_columns{std::move(tests)},
+      m_settings(settings) {
+  for (auto&& columns : *m_columns) {
+    if (std::find(columns.columns.begin(), columns.columns.end(), nullptr) !=
+        columns.columns.end()) {
+      throw std::runtime_error("A column of the capture is null");
+    }
+  }
+  Initialize();
+}
+
+void AnalysisManager::Initialize() {
   // Get the analysis type from the JSON.
   m_type = sysid::analysis::FromName(m_json.at("test").get<std::string>());
 
+  // Split a continuous capture (e.g. from normal robot operation) into the
+  // four tests. Drivetrains are segmented by the left side.
+  if (m_json.find("continuous") != m_json.end() &&
+      m_json.find(kJsonDataKeys[0]) == m_json.end()) {
+    WPI_INFO(m_logger, "{}", "Segmenting continuous capture");
+    bool isDrivetrain = m_type == analysis::kDrivetrain ||
+                        m_type == analysis::kDrivetrainAngular;
+    SplitContinuousCapture(&m_json, 1, isDrivetrain ? 5 : 3);
+  }
+
+  // Get the datasets that are available for the analysis type. Only linear
+  // drivetrains have left and right datasets, and only swerve drives have
+  // per-module datasets.
+  if (m_type == analysis::kDrivetrain) {
+    m_datasets.assign(std::begin(kDatasets), std::end(kDatasets));
+  } else if (analysis::IsSwerve(m_type)) {
+    m_datasets.assign(std::begin(kSwerveDatasets), std::end(kSwerveDatasets));
+  } else {
+    m_datasets.assign(std::begin(kDatasets), std::begin(kDatasets) + 3);
+  }
+  // Get the number of motors with per-motor channels. Older JSONs don't have
+  // any.
+  m_motorCount = m_json.value<size_t>("motors", 0);
+  if (m_motorCount > 0) {
+    if (m_type == analysis::kDrivetrain ||
+        m_type == analysis::kDrivetrainAngular || analysis::IsSwerve(m_type)) {
+      throw std::runtime_error(
+          "Per-motor channels are only supported for general mechanisms");
+    }
+    for (size_t motor = 0; motor < m_motorCount; ++motor) {
+      for (auto&& dataset : {"Forward", "Backward", "Combined"}) {
+        m_motorDatasets.push_back(
+            fmt::format("Motor {} {}", motor + 1, dataset));
+      }
+    }
+    for (auto&& name : m_motorDatasets) {
+      m_datasets.push_back(name.c_str());
+    }
+  }
+  if (m_settings.dataset < 0 ||
+      m_settings.dataset >= static_cast<int>(m_datasets.size())) {
+    m_settings.dataset = 0;
+  }
+
   // Get the rotation -> output units factor from the JSON.
   m_unit = m_json.at("units").get<std::string>();
   m_factor = m_json.at("unitsPerRotation").get<double>();
@@ -606,31 +1251,437 @@ AnalysisManager::AnalysisManager(std::string_view path, Settings& settings,
   m_minDuration = units::second_t{100000};
 }
 
+void AnalysisManager::SetCacheDirectory(std::string_view directory) {
+  m_cache.emplace(directory);
+
+  // Captures that were read from a file are keyed by the file so that the
+  // parsed JSON doesn't have to be serialized.
+  Fnv1aHash hash;
+  if (m_columns) {
+    hash.AddString(m_json.dump());
+    for (auto&& columns : *m_columns) {
+      hash.AddValue(columns.size);
+      for (auto&& column : columns.columns) {
+        hash.AddBytes(column, columns.size * sizeof(double));
+      }
+    }
+  } else if (m_path.empty()) {
+    hash.AddString(m_json.dump());
+  } else {
+    MappedFile file{m_path};
+    hash.AddBytes(file.data(), file.size());
+  }
+  m_captureHash = hash.Get();
+}
+
 void AnalysisManager::PrepareData() {
   WPI_INFO(m_logger, "Preparing {} data", m_type.name);
+  // The datasets are rebuilt in the current units.
+  m_pendingScale = 1.0;
+  m_feedforwardCache.reset();
+  m_cacheKey.reset();
+  if (m_cache) {
+    m_cacheKey = GetPreparedDataKey();
+    if (LoadCachedData(*m_cacheKey)) {
+      WPI_INFO(m_logger, "{}", "Loaded prepared data from the result cache");
+      return;
+    }
+  }
+  PrepareDatasets(m_settings, m_originalDatasets, m_rawDatasets,
+                  m_filteredDatasets, m_startTimes, m_minDuration,
+                  m_maxDuration, m_trackWidth, m_motorDiagnostics, m_arena,
+                  m_logger);
+  WPI_INFO(m_logger, "{}", "Finished Preparing Data");
+}
+
+void AnalysisManager::PrepareDatasets(
+    Settings& settings, wpi::StringMap<Storage>& originalDatasets,
+    wpi::StringMap<Storage>& rawDatasets,
+    wpi::StringMap<Storage>& filteredDatasets,
+    std::array<units::second_t, 4>& startTimes, units::second_t& minDuration,
+    units::second_t& maxDuration, std::optional<double>& trackWidth,
+    std::vector<MotorDiagnostics>& motorDiagnostics, Arena& arena,
+    wpi::Logger& logger) const {
+  // The transient buffers of the last run are no longer in use.
+  arena.Reset();
+  auto resource = arena.GetResource();
+  CaptureRows capture{m_json, m_columns ? &*m_columns : nullptr};
   if (m_type == analysis::kDrivetrain) {
-    PrepareLinearDrivetrainData(m_json, m_settings, m_factor,
-                                m_originalDatasets, m_rawDatasets,
-                                m_filteredDatasets, m_startTimes, m_minDuration,
-                                m_maxDuration, m_logger);
+    PrepareLinearDrivetrainData(capture, settings, m_factor, originalDatasets,
+                                rawDatasets, filteredDatasets, startTimes,
+                                minDuration, maxDuration, resource, logger);
   } else if (m_type == analysis::kDrivetrainAngular) {
-    PrepareAngularDrivetrainData(m_json, m_settings, m_factor, m_trackWidth,
-                                 m_originalDatasets, m_rawDatasets,
-                                 m_filteredDatasets, m_startTimes,
-                                 m_minDuration, m_maxDuration, m_logger);
+    PrepareAngularDrivetrainData(capture, settings, m_factor, trackWidth,
+                                 originalDatasets, rawDatasets,
+                                 filteredDatasets, startTimes, minDuration,
+                                 maxDuration, resource, logger);
+  } else if (analysis::IsSwerve(m_type)) {
+    PrepareSwerveData(capture, settings, m_factor, originalDatasets,
+                      rawDatasets, filteredDatasets, startTimes, minDuration,
+                      maxDuration, resource, logger);
   } else {
-    PrepareGeneralData(m_json, m_settings, m_factor, m_unit, m_originalDatasets,
-                       m_rawDatasets, m_filteredDatasets, m_startTimes,
-                       m_minDuration, m_maxDuration, m_logger);
+    PrepareGeneralData(capture, settings, m_factor, m_unit, originalDatasets,
+                       rawDatasets, filteredDatasets, startTimes, minDuration,
+                       maxDuration, resource, logger);
+    if (m_motorCount > 0) {
+      PrepareMotorChannelData(m_json, settings, m_factor, m_unit, m_motorCount,
+                              originalDatasets, rawDatasets, filteredDatasets,
+                              motorDiagnostics, minDuration, maxDuration,
+                              resource, logger);
+    }
   }
-  WPI_INFO(m_logger, "{}", "Finished Preparing Data");
+}
+
+uint64_t AnalysisManager::GetPreparedDataKey() const {
+  Fnv1aHash hash;
+  hash.AddValue(kCacheVersion);
+  hash.AddString("prepared data");
+  hash.AddValue(m_captureHash);
+  hash.AddString(m_type.name);
+  hash.AddString(m_unit);
+  hash.AddValue(m_factor);
+  hash.AddValue(m_settings.motionThreshold);
+  hash.AddValue(m_settings.windowSize);
+  hash.AddValue(m_settings.useKalmanSmoother);
+  hash.AddValue(m_settings.stepTestDuration);
+  return hash.Get();
+}
+
+uint64_t AnalysisManager::GetAutoTuneKey() const {
+  Fnv1aHash hash;
+  hash.AddValue(kCacheVersion);
+  hash.AddString("auto-tune");
+  hash.AddValue(m_settings.motionThreshold);
+  hash.AddValue(m_captureHash);
+  hash.AddString(m_type.name);
+  hash.AddString(m_unit);
+  hash.AddValue(m_factor);
+  hash.AddValue(m_settings.windowSize);
+  hash.AddValue(m_settings.useKalmanSmoother);
+  hash.AddValue(m_settings.dataset);
+  for (auto term : GetModelTerms()) {
+    hash.AddValue(term);
+  }
+  hash.AddValue(m_settings.modelTermParameters);
+  return hash.Get();
+}
+
+bool AnalysisManager::LoadCachedData(uint64_t key) {
+  // Read everything into temporaries first, since the entry may turn out to
+  // be truncated halfway through.
+  wpi::StringMap<Storage> originalDatasets;
+  wpi::StringMap<Storage> rawDatasets;
+  wpi::StringMap<Storage> filteredDatasets;
+  std::array<units::second_t, 4> startTimes;
+  units::second_t stepTestDuration;
+  units::second_t minDuration;
+  units::second_t maxDuration;
+  std::optional<double> trackWidth;
+  std::vector<MotorDiagnostics> motorDiagnostics(m_motorCount);
+  std::optional<FeedforwardCache> feedforwardCache;
+  bool loaded = m_cache->Load(key, [&](CacheReader& reader) {
+    ReadDatasets(reader, &originalDatasets);
+    ReadDatasets(reader, &rawDatasets);
+    ReadDatasets(reader, &filteredDatasets);
+    reader.ReadArray(startTimes.data(), startTimes.size());
+    stepTestDuration = reader.Read<units::second_t>();
+    minDuration = reader.Read<units::second_t>();
+    maxDuration = reader.Read<units::second_t>();
+    trackWidth = reader.Read<std::optional<double>>();
+    if (reader.Read<uint64_t>() != motorDiagnostics.size()) {
+      throw std::runtime_error("Mismatched motor count in cache entry");
+    }
+    for (auto&& motor : motorDiagnostics) {
+      motor.velocityRatio = reader.Read<double>();
+      motor.meanCurrent = reader.Read<double>();
+    }
+    if (reader.Read<bool>()) {
+      auto& cache = feedforwardCache.emplace();
+      cache.dataset = reader.Read<int>();
+      reader.ReadVector(&cache.terms);
+      cache.params = reader.Read<ModelTermParameters>();
+      reader.ReadVector(&std::get<0>(cache.gains));
+      std::get<1>(cache.gains) = reader.Read<double>();
+    }
+  });
+  if (!loaded) {
+    return false;
+  }
+
+  m_originalDatasets = std::move(originalDatasets);
+  m_rawDatasets = std::move(rawDatasets);
+  m_filteredDatasets = std::move(filteredDatasets);
+  m_startTimes = startTimes;
+  m_settings.stepTestDuration = stepTestDuration;
+  // The minimum duration is accumulated over all preparations.
+  m_minDuration = units::math::min(m_minDuration, minDuration);
+  m_maxDuration = maxDuration;
+  m_trackWidth = trackWidth;
+  m_motorDiagnostics = std::move(motorDiagnostics);
+  m_feedforwardCache = std::move(feedforwardCache);
+  return true;
+}
+
+void AnalysisManager::StoreCachedData(uint64_t key) {
+  CacheWriter writer;
+  WriteDatasets(writer, m_originalDatasets);
+  WriteDatasets(writer, m_rawDatasets);
+  WriteDatasets(writer, m_filteredDatasets);
+  writer.WriteArray(m_startTimes.data(), m_startTimes.size());
+  writer.Write(m_settings.stepTestDuration);
+  writer.Write(m_minDuration);
+  writer.Write(m_maxDuration);
+  writer.Write(m_trackWidth);
+  writer.Write<uint64_t>(m_motorDiagnostics.size());
+  for (auto&& motor : m_motorDiagnostics) {
+    writer.Write(motor.velocityRatio);
+    writer.Write(motor.meanCurrent);
+  }
+  writer.Write<bool>(m_feedforwardCache.has_value());
+  if (m_feedforwardCache) {
+    const auto& cache = *m_feedforwardCache;
+    writer.Write(cache.dataset);
+    writer.WriteVector(cache.terms);
+    writer.Write(cache.params);
+    writer.WriteVector(std::get<0>(cache.gains));
+    writer.Write(std::get<1>(cache.gains));
+  }
+  if (!m_cache->Store(key, writer)) {
+    WPI_INFO(m_logger, "{}", "Couldn't store results in the result cache");
+  }
+}
+
+AutoTuneResult AnalysisManager::AutoTune() {
+  WPI_INFO(m_logger, "{}", "Auto-tuning motion threshold and test duration");
+  std::optional<uint64_t> autoTuneKey;
+  if (m_cache) {
+    autoTuneKey = GetAutoTuneKey();
+    AutoTuneResult result;
+    if (m_cache->Load(*autoTuneKey, [&](CacheReader& reader) {
+          result = reader.Read<AutoTuneResult>();
+        })) {
+      WPI_INFO(m_logger, "{}", "Loaded auto-tuned settings from the cache");
+      m_settings.motionThreshold = result.motionThreshold;
+      m_settings.stepTestDuration = result.stepTestDuration;
+      PrepareData();
+      return result;
+    }
+  }
+
+  // Prepare the data once to get the original datasets and the range of step
+  // test durations.
+  PrepareData();
+  const auto& original = m_originalDatasets[m_datasets[0]];
+
+  // Estimate the noise floor from the quasistatic tests and the steady-state
+  // onset from the dynamic tests.
+  AutoTuneResult result;
+  double maxVelocity = 0.0;
+  for (auto&& test : SplitTests(original.slow)) {
+    result.velocityNoiseFloor =
+        std::max(result.velocityNoiseFloor, EstimateVelocityNoiseFloor(test));
+    for (auto&& pt : test) {
+      maxVelocity = std::max(maxVelocity, std::abs(pt.velocity));
+    }
+  }
+  for (auto&& test : SplitTests(original.fast)) {
+    if (test.size() < static_cast<size_t>(m_settings.windowSize)) {
+      continue;
+    }
+    const double h = GetMeanTimeDelta(test).value();
+    for (size_t i = 1; i + 1 < test.size(); ++i) {
+      test[i].acceleration = CentralFiniteDifference<2>(
+          [&](size_t j) { return test[j].velocity; }, i, h);
+    }
+    double accelNoise = EstimateAccelNoise(test, m_settings.windowSize);
+    size_t onset = FindSteadyStateOnset(test, accelNoise);
+    result.steadyStateOnset =
+        units::math::max(result.steadyStateOnset,
+                         test[onset].timestamp - test.front().timestamp);
+  }
+
+  struct Candidate {
+    double motionThreshold;
+    units::second_t stepTestDuration;
+    Storage data;
+    double rSquared;
+    double rmse;
+  };
+  constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+  std::vector<Candidate> candidates;
+  auto thresholds = GetMotionThresholdCandidates(
+      result.velocityNoiseFloor, maxVelocity, m_settings.motionThreshold);
+  for (double threshold : thresholds) {
+    for (auto duration : GetStepDurationCandidates(
+             result.steadyStateOnset, m_minDuration, m_maxDuration)) {
+      candidates.push_back({threshold, duration, Storage{}, kNaN, kNaN});
+    }
+  }
+
+  // Runs a function for every candidate in parallel, with an arena per
+  // worker. Logging is disabled since the logger isn't thread-safe.
+  auto forEachCandidate = [&](auto function) {
+    std::atomic<size_t> next{0};
+    auto work = [&] {
+      wpi::Logger logger;
+      Arena arena;
+      for (size_t i = next++; i < candidates.size(); i = next++) {
+        function(candidates[i], arena, logger);
+      }
+    };
+    size_t workers = std::clamp<size_t>(std::thread::hardware_concurrency(), 1,
+                                        candidates.size());
+    std::vector<std::future<void>> futures;
+    for (size_t i = 0; i < workers; ++i) {
+      futures.emplace_back(std::async(std::launch::async, work));
+    }
+    for (auto&& future : futures) {
+      future.get();
+    }
+  };
+
+  // Each candidate prepares its own datasets from a copy of the settings.
+  forEachCandidate([&](Candidate& candidate, Arena& arena,
+                       wpi::Logger& logger) {
+    Settings settings = m_settings;
+    settings.motionThreshold = candidate.motionThreshold;
+    settings.stepTestDuration = candidate.stepTestDuration;
+
+    wpi::StringMap<Storage> originalDatasets;
+    wpi::StringMap<Storage> rawDatasets;
+    wpi::StringMap<Storage> filteredDatasets;
+    std::array<units::second_t, 4> startTimes;
+    units::second_t minDuration;
+    units::second_t maxDuration;
+    std::optional<double> trackWidth;
+    std::vector<MotorDiagnostics> motorDiagnostics;
+    try {
+      PrepareDatasets(settings, originalDatasets, rawDatasets,
+                      filteredDatasets, startTimes, minDuration, maxDuration,
+                      trackWidth, motorDiagnostics, arena, logger);
+      candidate.data =
+          std::move(filteredDatasets[m_datasets[m_settings.dataset]]);
+      candidate.rSquared = std::get<1>(
+          CalculateFeedforward(candidate.data, arena.GetResource()));
+    } catch (const std::exception&) {
+      // Trimming removed too much data, so the candidate is skipped.
+    }
+  });
+
+  // The candidates are compared on the samples that the strictest candidate
+  // keeps, which every other candidate keeps as well. Comparing the r-squared
+  // of each candidate's own fit instead rewards trimming the samples that are
+  // hard to fit, such as the slow ones that Ks is identified from.
+  const Candidate* validation = nullptr;
+  for (auto&& candidate : candidates) {
+    if (std::isnan(candidate.rSquared)) {
+      continue;
+    }
+    if (!validation ||
+        candidate.motionThreshold > validation->motionThreshold ||
+        (candidate.motionThreshold == validation->motionThreshold &&
+         candidate.stepTestDuration < validation->stepTestDuration)) {
+      validation = &candidate;
+    }
+  }
+  if (!validation) {
+    throw std::runtime_error(
+        "Auto-tuning couldn't find a motion threshold and test duration that "
+        "keep enough data to fit");
+  }
+
+  // Cross-validate each candidate: fit it without a fold of the samples, and
+  // predict the voltage of the validation samples in that fold.
+  auto terms = GetModelTerms();
+  forEachCandidate([&](Candidate& candidate, Arena& arena, wpi::Logger&) {
+    if (std::isnan(candidate.rSquared)) {
+      return;
+    }
+    double sum = 0.0;
+    size_t count = 0;
+    try {
+      for (size_t fold = 0; fold < kValidationFolds; ++fold) {
+        arena.Reset();
+        auto gains = std::get<0>(
+            CalculateFeedforward(ExcludeValidationFold(candidate.data, fold),
+                                 arena.GetResource()));
+        for (auto* data : {&validation->data.slow, &validation->data.fast}) {
+          AddVoltageErrors(*data, fold, gains, terms,
+                           m_settings.modelTermParameters, &sum, &count);
+        }
+      }
+    } catch (const std::exception&) {
+      return;
+    }
+    if (count > 0) {
+      candidate.rmse = std::sqrt(sum / count);
+    }
+  });
+
+  // Pick the candidate that predicts the validation samples best. Ties go to
+  // the lower threshold and shorter duration, which come first.
+  const Candidate* best = nullptr;
+  for (auto&& candidate : candidates) {
+    if (candidate.rmse < (best ? best->rmse
+                               : std::numeric_limits<double>::infinity())) {
+      best = &candidate;
+    }
+  }
+  if (!best) {
+    throw std::runtime_error(
+        "Auto-tuning couldn't find a motion threshold and test duration that "
+        "keep enough data to fit");
+  }
+
+  result.motionThreshold = best->motionThreshold;
+  result.stepTestDuration = best->stepTestDuration;
+  result.rSquared = best->rSquared;
+  result.rmse = best->rmse;
+  result.candidates = candidates.size();
+  WPI_INFO(m_logger,
+           "Picked motion threshold {:.4f} and test duration {:.2f} s out of "
+           "{} candidates (validation RMSE {:.4f} V, r-squared {:.4f})",
+           result.motionThreshold, result.stepTestDuration.value(),
+           result.candidates, result.rmse, result.rSquared);
+
+  if (autoTuneKey) {
+    CacheWriter writer;
+    writer.Write(result);
+    m_cache->Store(*autoTuneKey, writer);
+  }
+
+  m_settings.motionThreshold = result.motionThreshold;
+  m_settings.stepTestDuration = result.stepTestDuration;
+  PrepareData();
+  return result;
 }
 
 AnalysisManager::Gains AnalysisManager::Calculate() {
   WPI_INFO(m_logger, "{}", "Calculating Gains");
-  // Calculate feedforward gains from the data.
-  auto ffGains = sysid::CalculateFeedforwardGains(
-      m_filteredDatasets[kDatasets[m_settings.dataset]], m_type);
+  // Rescale the datasets here rather than on first access, since the plots
+  // access them from another thread.
+  ApplyPendingScale();
+
+  // Calculate feedforward gains from the data, unless the last gains were fit
+  // with the same settings (e.g. they were only converted to new units).
+  auto terms = GetModelTerms();
+  const auto& params = m_settings.modelTermParameters;
+  const auto& cache = m_feedforwardCache;
+  bool cached = cache && cache->dataset == m_settings.dataset &&
+                cache->terms == terms &&
+                cache->params.stribeckVelocity == params.stribeckVelocity &&
+                cache->params.backlashWidth == params.backlashWidth;
+  if (!cached) {
+    // The transient buffers of the last run are no longer in use.
+    m_arena.Reset();
+    m_feedforwardCache = FeedforwardCache{
+        m_settings.dataset, terms, params,
+        CalculateFeedforward(GetFilteredData(), m_arena.GetResource())};
+    if (m_cacheKey) {
+      StoreCachedData(*m_cacheKey);
+    }
+  }
+  auto ffGains = m_feedforwardCache->gains;
 
   const auto& Kv = std::get<0>(ffGains)[1];
   const auto& Ka = std::get<0>(ffGains)[2];
@@ -653,15 +1704,196 @@ AnalysisManager::Gains AnalysisManager::Calculate() {
   return {ffGains, fbGains, m_trackWidth};
 }
 
+std::vector<std::tuple<std::vector<double>, double>>
+AnalysisManager::CalculateSwerveModules() {
+  if (!analysis::IsSwerve(m_type)) {
+    return {};
+  }
+
+  WPI_INFO(m_logger, "{}", "Calculating Swerve Module Gains");
+  ApplyPendingScale();
+  std::vector<std::string> names;
+  for (size_t module = 0; module < analysis::kSwerveModuleCount; ++module) {
+    names.push_back(fmt::format("Module {} Combined", module + 1));
+  }
+  return CalculateFeedforwards(names);
+}
+
+std::vector<MotorDiagnostics> AnalysisManager::CalculateMotorChannels() {
+  if (m_motorCount == 0) {
+    return {};
+  }
+
+  WPI_INFO(m_logger, "{}", "Calculating Motor Channel Gains");
+  ApplyPendingScale();
+  std::vector<std::string> names;
+  for (size_t motor = 0; motor < m_motorCount; ++motor) {
+    names.push_back(fmt::format("Motor {} Combined", motor + 1));
+  }
+  auto fits = CalculateFeedforwards(names);
+
+  auto diagnostics = m_motorDiagnostics;
+  for (size_t motor = 0; motor < m_motorCount; ++motor) {
+    std::tie(diagnostics[motor].ffGains, diagnostics[motor].rSquared) =
+        std::move(fits[motor]);
+  }
+  FlagMotorOutliers(&diagnostics);
+  return diagnostics;
+}
+
+std::vector<AnalysisManager::EstimatorDesign>
+AnalysisManager::CalculateEstimators() {
+  WPI_INFO(m_logger, "{}", "Calculating Kalman Filters");
+  ApplyPendingScale();
+  std::vector<EstimatorDesign> estimators;
+  std::vector<std::string> names;
+  for (auto&& name : m_datasets) {
+    if (wpi::ends_with(name, "Combined")) {
+      names.push_back(name);
+      estimators.push_back({name, NoiseCovariances{}, KalmanGains{}});
+    }
+  }
+  auto fits = CalculateFeedforwards(names);
+
+  // The noise is measured against the fit of each dataset, and the Kalman
+  // gains of all datasets are solved in one batch.
+  auto terms = GetModelTerms();
+  std::vector<EstimatorModel> models;
+  for (size_t i = 0; i < estimators.size(); ++i) {
+    const auto& gains = std::get<0>(fits[i]);
+    estimators[i].noise =
+        EstimateNoiseCovariances(m_rawDatasets[names[i]], gains, terms,
+                                 m_settings.modelTermParameters);
+    models.push_back({gains[1], gains[2], estimators[i].noise});
+  }
+  auto kalmanGains =
+      CalculateKalmanGains(m_settings.preset, m_settings.type, models);
+  for (size_t i = 0; i < estimators.size(); ++i) {
+    estimators[i].gains = kalmanGains[i];
+  }
+  return estimators;
+}
+
+std::vector<std::tuple<std::vector<double>, double>>
+AnalysisManager::CalculateFeedforwards(const std::vector<std::string>& names) {
+  // StringMap::operator[] inserts missing entries, so the datasets are looked
+  // up here rather than by the fits, which only read their own dataset.
+  std::vector<std::future<std::tuple<std::vector<double>, double>>> futures;
+  for (auto&& name : names) {
+    const auto& data = m_filteredDatasets[name];
+    futures.emplace_back(std::async(std::launch::async, [this, &data] {
+      return CalculateFeedforward(data);
+    }));
+  }
+
+  std::vector<std::tuple<std::vector<double>, double>> fits;
+  for (auto&& future : futures) {
+    fits.emplace_back(future.get());
+  }
+  return fits;
+}
+
+std::tuple<std::vector<double>, double> AnalysisManager::CalculateFeedforward(
+    const Storage& data, std::pmr::memory_resource* resource) const {
+  auto terms = GetModelTerms();
+  return VisitDescriptor(m_type, [&](auto descriptor) {
+    using Descriptor = decltype(descriptor);
+
+    // The descriptor terms come first in the term list
+    std::vector<ModelTerm> extraTerms{
+        terms.begin() + Descriptor::kTerms.size(), terms.end()};
+    return sysid::CalculateFeedforwardGains<Descriptor>(
+        data, extraTerms, m_settings.modelTermParameters, resource);
+  });
+}
+
+std::vector<ModelTerm> AnalysisManager::GetModelTerms() const {
+  auto terms = GetDefaultModelTerms(m_type);
+  for (auto term : m_settings.modelTerms) {
+    if (std::find(terms.begin(), terms.end(), term) == terms.end()) {
+      terms.push_back(term);
+    }
+  }
+  return terms;
+}
+
 void AnalysisManager::OverrideUnits(std::string_view unit,
                                     double unitsPerRotation) {
+  double ratio = unitsPerRotation / m_factor;
+
+  // The cosine of the position only matters to models with the cosine term
+  // (e.g. arms), and it doesn't change as long as a rotation is the same angle
+  // in both units. Linear units have no angle, so switching between them
+  // never changes it either.
+  auto terms = GetModelTerms();
+  double radians = GetRadiansPerUnit(unit) * unitsPerRotation;
+  double oldRadians = GetRadiansPerUnit(m_unit) * m_factor;
+  bool cosineChanged =
+      std::find(terms.begin(), terms.end(), ModelTerm::kCosine) !=
+          terms.end() &&
+      std::abs(radians - oldRadians) >
+          1E-9 * std::max(std::abs(radians), std::abs(oldRadians));
+
   m_unit = unit;
   m_factor = unitsPerRotation;
-  PrepareData();
+
+  // Negative factors flip the direction of motion, which changes the sign
+  // alignment of the voltages, so the data has to be prepared again.
+  if (!std::isfinite(ratio) || ratio <= 0 || cosineChanged) {
+    PrepareData();
+    return;
+  }
+
+  WPI_INFO(m_logger, "Converting units by a factor of {}", ratio);
+  m_settings.motionThreshold *= ratio;
+  m_settings.lqr.qp *= ratio;
+  m_settings.lqr.qv *= ratio;
+  m_settings.modelTermParameters.stribeckVelocity *= ratio;
+  m_settings.modelTermParameters.backlashWidth *= ratio;
+
+  m_pendingScale *= ratio;
+  // The rescaled datasets no longer match the settings they were cached with.
+  m_cacheKey.reset();
+  if (m_trackWidth) {
+    *m_trackWidth *= ratio;
+  }
+  if (m_type == analysis::kDrivetrainAngular) {
+    // The positions are gyro angles that don't depend on the units, so the
+    // position term doesn't convert like the other terms.
+    m_feedforwardCache.reset();
+  } else if (m_feedforwardCache) {
+    auto& cache = *m_feedforwardCache;
+    cache.params = m_settings.modelTermParameters;
+    ScaleFeedforwardGains(&std::get<0>(cache.gains), cache.terms, ratio);
+  }
 }
 
 void AnalysisManager::ResetUnitsFromJSON() {
-  m_unit = m_json.at("units").get<std::string>();
-  m_factor = m_json.at("unitsPerRotation").get<double>();
-  PrepareData();
+  OverrideUnits(m_json.at("units").get<std::string>(),
+                m_json.at("unitsPerRotation").get<double>());
+}
+
+void AnalysisManager::ApplyPendingScale() {
+  if (m_pendingScale == 1.0) {
+    return;
+  }
+
+  // The positions of angular drivetrain tests are gyro angles.
+  double positionScale =
+      m_type == analysis::kDrivetrainAngular ? 1.0 : m_pendingScale;
+  for (auto* datasets :
+       {&m_originalDatasets, &m_rawDatasets, &m_filteredDatasets}) {
+    for (auto& it : *datasets) {
+      auto& storage = it.getValue();
+      for (auto* data : {&storage.slow, &storage.fast}) {
+        for (auto& pt : *data) {
+          pt.position *= positionScale;
+          pt.velocity *= m_pendingScale;
+          pt.nextVelocity *= m_pendingScale;
+          pt.acceleration *= m_pendingScale;
+        }
+      }
+    }
+  }
+  m_pendingScale = 1.0;
 }
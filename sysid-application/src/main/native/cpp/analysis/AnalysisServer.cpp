@@ -0,0 +1,208 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/AnalysisServer.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fmt/core.h>
+#include <wpi/HttpServerConnection.h>
+#include <wpi/Signal.h>
+#include <wpi/json.h>
+#include <wpi/uv/Error.h>
+#include <wpi/uv/Loop.h>
+#include <wpi/uv/Tcp.h>
+
+using namespace sysid;
+
+/**
+ * Returns the reason phrase of an HTTP status code that the server sends.
+ *
+ * @param status The status code.
+ */
+static std::string_view GetStatusText(int status) {
+  switch (status) {
+    case 200:
+      return "OK";
+    case 400:
+      return "Bad Request";
+    case 404:
+      return "Not Found";
+    case 405:
+      return "Method Not Allowed";
+    case 413:
+      return "Payload Too Large";
+    case 422:
+      return "Unprocessable Entity";
+    case 503:
+      return "Service Unavailable";
+    default:
+      return "Internal Server Error";
+  }
+}
+
+namespace {
+/**
+ * A connection to the server, which reads the body of each request and
+ * responds once the analysis service has run it.
+ */
+class Connection : public wpi::HttpServerConnection,
+                   public std::enable_shared_from_this<Connection> {
+ public:
+  Connection(std::shared_ptr<wpi::uv::Stream> stream,
+             AnalysisService& service, wpi::EventLoopRunner& runner,
+             const bool& closed)
+      : HttpServerConnection{stream},
+        m_service{service},
+        m_runner{runner},
+        m_closed{closed} {
+    m_request.messageBegin.connect([this] {
+      m_body.clear();
+      m_tooLarge = false;
+    });
+    m_request.body.connect([this](std::string_view data, bool) {
+      if (m_body.size() + data.size() > AnalysisServer::kMaxRequestSize) {
+        m_tooLarge = true;
+      } else if (!m_tooLarge) {
+        m_body.append(data);
+      }
+    });
+  }
+
+ protected:
+  void ProcessRequest() override;
+
+ private:
+  /**
+   * Sends a JSON response.
+   *
+   * @param status The HTTP status code.
+   * @param body   The body of the response.
+   */
+  void SendJSON(int status, const wpi::json& body) {
+    // Clients should back off for a moment when the queue is full.
+    SendResponse(status, GetStatusText(status), "application/json",
+                 body.dump(), status == 503 ? "Retry-After: 1\r\n" : "");
+  }
+
+  AnalysisService& m_service;
+  wpi::EventLoopRunner& m_runner;
+  const bool& m_closed;
+  std::string m_body;
+  bool m_tooLarge = false;
+};
+}  // namespace
+
+void Connection::ProcessRequest() {
+  // The service may already be gone once the server is stopping.
+  if (m_closed) {
+    SendJSON(503, {{"error", "The server is stopping"}});
+    return;
+  }
+
+  auto url = m_request.GetUrl();
+  auto method = m_request.GetMethod();
+  if (url == "/status") {
+    if (method != wpi::HTTP_GET) {
+      SendError(405);
+      return;
+    }
+    SendJSON(200, m_service.GetStatus());
+    return;
+  } else if (url != "/analyze") {
+    SendError(404);
+    return;
+  } else if (method != wpi::HTTP_POST) {
+    SendError(405);
+    return;
+  }
+
+  if (m_tooLarge) {
+    SendJSON(413, {{"error", "The request is too large"}});
+    return;
+  }
+  wpi::json request;
+  try {
+    request = wpi::json::parse(m_body);
+  } catch (const wpi::json::exception& e) {
+    SendJSON(400, {{"error", e.what()}});
+    return;
+  }
+  m_body.clear();
+
+  // The response is sent from the event loop once a worker is done, unless
+  // the client closed the connection in the meantime.
+  std::weak_ptr<Connection> connection = shared_from_this();
+  m_service.Submit(
+      std::move(request),
+      [connection, &runner = m_runner](AnalysisService::Response response) {
+        runner.ExecAsync([connection, response = std::move(response)](
+                             wpi::uv::Loop&) {
+          if (auto self = connection.lock()) {
+            self->SendJSON(response.status, response.body);
+          }
+        });
+      });
+}
+
+AnalysisServer::AnalysisServer(BatchSettings defaults, size_t workers,
+                               size_t queueCapacity, unsigned int port,
+                               wpi::Logger& logger)
+    : m_service{std::make_unique<AnalysisService>(
+          std::move(defaults), workers, queueCapacity, logger)} {
+  std::string error;
+  m_runner.ExecSync([&](wpi::uv::Loop& loop) {
+    auto tcp = wpi::uv::Tcp::Create(loop);
+    if (!tcp) {
+      error = "Unable to create a socket";
+      return;
+    }
+
+    // Only errors while setting up the socket are reported.
+    wpi::sig::ScopedConnection errorConnection =
+        tcp->error.connect_connection(
+            [&](wpi::uv::Error e) { error = e.str(); });
+    tcp->Bind("127.0.0.1", port);
+    tcp->Listen([this, server = tcp.get()] {
+      auto stream = server->Accept();
+      if (!stream) {
+        return;
+      }
+      auto connection = std::make_shared<Connection>(stream, *m_service,
+                                                     m_runner, m_closed);
+      stream->SetData(connection);
+    });
+    if (!error.empty()) {
+      tcp->Close();
+    } else {
+      m_listener = tcp;
+    }
+  });
+  if (!error.empty()) {
+    throw std::runtime_error(
+        fmt::format("Unable to listen on port {}: {}", port, error));
+  }
+  WPI_INFO(logger, "Listening on 127.0.0.1:{}", port);
+}
+
+AnalysisServer::~AnalysisServer() {
+  // Stop accepting connections and dispatching requests on the loop, so
+  // nothing reaches the service while it's destroyed.
+  m_runner.ExecSync([this](wpi::uv::Loop&) {
+    m_closed = true;
+    if (m_listener) {
+      m_listener->Close();
+      m_listener.reset();
+    }
+  });
+
+  // The service waits for its running requests, whose responses are still
+  // sent through the loop.
+  m_service.reset();
+  m_runner.Stop();
+}
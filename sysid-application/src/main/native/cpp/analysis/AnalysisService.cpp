@@ -0,0 +1,146 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/AnalysisService.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <wpi/json.h>
+
+#include "sysid/analysis/BatchAnalysis.h"
+
+using namespace sysid;
+
+/**
+ * Returns a response with an error.
+ *
+ * @param status  The HTTP status code.
+ * @param message The error message.
+ */
+static AnalysisService::Response MakeError(int status,
+                                           std::string_view message) {
+  return {status, {{"error", message}}};
+}
+
+AnalysisService::AnalysisService(BatchSettings defaults, size_t workers,
+                                 size_t queueCapacity, wpi::Logger& logger)
+    : m_defaults{std::move(defaults)},
+      m_queueCapacity{queueCapacity},
+      m_logger{logger} {
+  for (size_t i = 0; i < std::max<size_t>(workers, 1); ++i) {
+    m_workers.emplace_back([this] { Work(); });
+  }
+}
+
+AnalysisService::~AnalysisService() {
+  decltype(m_queue) queue;
+  {
+    std::scoped_lock lock{m_mutex};
+    m_stopping = true;
+    queue.swap(m_queue);
+  }
+  m_queueChanged.notify_all();
+  for (auto&& worker : m_workers) {
+    worker.join();
+  }
+  for (auto&& [request, callback] : queue) {
+    callback(MakeError(503, "The analysis service is shutting down"));
+  }
+}
+
+void AnalysisService::Submit(wpi::json request, Callback callback) {
+  {
+    std::scoped_lock lock{m_mutex};
+    if (!m_stopping && m_queue.size() < m_queueCapacity) {
+      m_queue.emplace_back(std::move(request), std::move(callback));
+      m_queueChanged.notify_one();
+      return;
+    }
+    ++m_rejected;
+  }
+  callback(MakeError(503, "The analysis queue is full"));
+}
+
+wpi::json AnalysisService::GetStatus() {
+  std::scoped_lock lock{m_mutex};
+  return {{"queued", m_queue.size()},
+          {"active", m_active},
+          {"workers", m_workers.size()},
+          {"queueCapacity", m_queueCapacity},
+          {"completed", m_completed},
+          {"rejected", m_rejected}};
+}
+
+void AnalysisService::Work() {
+  // The workers log through the shared logger one at a time.
+  wpi::Logger logger;
+  logger.SetLogger([this](unsigned int level, const char* file,
+                          unsigned int line, const char* msg) {
+    std::scoped_lock lock{m_logMutex};
+    m_logger.DoLog(level, file, line, msg);
+  });
+  logger.set_min_level(m_logger.min_level());
+
+  for (;;) {
+    std::pair<wpi::json, Callback> request;
+    {
+      std::unique_lock lock{m_mutex};
+      m_queueChanged.wait(lock,
+                          [&] { return m_stopping || !m_queue.empty(); });
+      if (m_stopping) {
+        return;
+      }
+      request = std::move(m_queue.front());
+      m_queue.pop_front();
+      ++m_active;
+    }
+
+    // The request is counted as completed before the client gets its
+    // response so that the status it asks for next includes it.
+    auto response = Handle(request.first, logger);
+    {
+      std::scoped_lock lock{m_mutex};
+      ++m_completed;
+    }
+    request.second(std::move(response));
+
+    std::scoped_lock lock{m_mutex};
+    --m_active;
+  }
+}
+
+AnalysisService::Response AnalysisService::Handle(const wpi::json& request,
+                                                  wpi::Logger& logger) {
+  BatchSettings settings;
+  try {
+    if (!request.is_object()) {
+      throw std::runtime_error("The request has to be a JSON object");
+    }
+    settings = request.contains("settings")
+                   ? ParseBatchSettings(request.at("settings"), m_defaults)
+                   : m_defaults;
+  } catch (const std::exception& e) {
+    return MakeError(400, e.what());
+  }
+
+  try {
+    if (request.contains("path")) {
+      auto path = request.at("path").get<std::string>();
+      WPI_INFO(logger, "Analyzing {}", path);
+      return {200, AnalyzeCapture(path, settings, logger)};
+    } else if (request.contains("capture")) {
+      WPI_INFO(logger, "{}", "Analyzing a capture from a request");
+      return {200,
+              AnalyzeCaptureData(request.at("capture"), settings, logger)};
+    }
+  } catch (const std::exception& e) {
+    WPI_ERROR(logger, "Unable to analyze the capture: {}", e.what());
+    return MakeError(422, e.what());
+  }
+  return MakeError(400, "The request needs a \"path\" or a \"capture\"");
+}
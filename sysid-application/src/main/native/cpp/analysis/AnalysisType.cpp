@@ -19,5 +19,11 @@ AnalysisType sysid::analysis::FromName(std::string_view name) {
   if (name == "Arm") {
     return sysid::analysis::kArm;
   }
+  if (name == "Swerve Drive") {
+    return sysid::analysis::kSwerveDrive;
+  }
+  if (name == "Swerve Steer") {
+    return sysid::analysis::kSwerveSteer;
+  }
   return sysid::analysis::kSimple;
 }
@@ -0,0 +1,55 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/Arena.h"
+
+#include <memory>
+#include <memory_resource>
+
+using namespace sysid;
+
+Arena::Arena(size_t capacity) {
+  if (capacity > 0) {
+    m_block = std::make_unique<std::byte[]>(capacity);
+    m_capacity = capacity;
+  }
+  CreateResource();
+}
+
+void Arena::Reset() {
+  // Everything allocated from the heap was allocated by the monotonic
+  // resource, which frees it all here.
+  m_resource.reset();
+  if (m_heap.bytes > 0) {
+    m_capacity += m_heap.bytes;
+    m_block = std::make_unique<std::byte[]>(m_capacity);
+  }
+  m_heap.allocations = 0;
+  m_heap.bytes = 0;
+  CreateResource();
+}
+
+void Arena::CreateResource() {
+  if (m_block) {
+    m_resource.emplace(m_block.get(), m_capacity, &m_heap);
+  } else {
+    m_resource.emplace(&m_heap);
+  }
+}
+
+void* Arena::HeapResource::do_allocate(size_t bytes, size_t alignment) {
+  ++allocations;
+  this->bytes += bytes;
+  return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void Arena::HeapResource::do_deallocate(void* p, size_t bytes,
+                                        size_t alignment) {
+  std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool Arena::HeapResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
@@ -0,0 +1,257 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/AutoTune.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+using namespace sysid;
+
+// The multiples of the velocity noise floor that are tried as motion
+// thresholds.
+static constexpr double kThresholdMultiples[] = {1.5, 2, 3, 4, 6, 8, 12};
+
+// The number of steady-state samples (on average) after which the transient
+// of a dynamic test is considered over.
+static constexpr double kSettledSamples = 20;
+
+// The multiples of the steady-state onset that are tried as step test
+// durations.
+static constexpr double kDurationMultiples[] = {1, 1.5, 2, 3, 4};
+
+// How long each cross-validation block is before the next fold takes over.
+static constexpr units::second_t kValidationBlock = 250_ms;
+
+/**
+ * Returns the median of a vector, reordering it.
+ *
+ * @param values The values.
+ * @return The median, or zero if there are no values.
+ */
+static double Median(std::vector<double>* values) {
+  if (values->empty()) {
+    return 0.0;
+  }
+  auto middle = values->begin() + values->size() / 2;
+  std::nth_element(values->begin(), middle, values->end());
+  return *middle;
+}
+
+std::vector<std::vector<PreparedData>> sysid::SplitTests(
+    const std::vector<PreparedData>& data) {
+  std::vector<std::vector<PreparedData>> tests;
+  for (size_t i = 0; i < data.size(); ++i) {
+    auto dt = i > 0 ? data[i].timestamp - data[i - 1].timestamp : 0_s;
+    if (i == 0 || dt <= 0_s || dt > 500_ms) {
+      tests.emplace_back();
+    }
+    tests.back().push_back(data[i]);
+  }
+  return tests;
+}
+
+double sysid::EstimateVelocityNoiseFloor(
+    const std::vector<PreparedData>& data) {
+  if (data.size() < 3) {
+    return 0.0;
+  }
+
+  double maxVelocity = 0.0;
+  for (auto&& pt : data) {
+    maxVelocity = std::max(maxVelocity, std::abs(pt.velocity));
+  }
+
+  // Changes this small are rounding error rather than quantization.
+  const double epsilon = 1e-9 * maxVelocity;
+  std::vector<double> steps;
+  for (size_t i = 1; i < data.size(); ++i) {
+    double step = std::abs(data[i].velocity - data[i - 1].velocity);
+    if (step > epsilon) {
+      steps.push_back(step);
+    }
+  }
+  double quantum = 0.0;
+  if (!steps.empty()) {
+    auto percentile = steps.begin() + steps.size() / 10;
+    std::nth_element(steps.begin(), percentile, steps.end());
+    quantum = *percentile;
+  }
+
+  // The second difference of white noise with standard deviation σ has a
+  // standard deviation of √6 σ, and 1.4826 scales the MAD of a normal
+  // distribution to its standard deviation.
+  std::vector<double> differences;
+  differences.reserve(data.size() - 2);
+  for (size_t i = 1; i + 1 < data.size(); ++i) {
+    differences.push_back(std::abs(data[i + 1].velocity -
+                                   2 * data[i].velocity +
+                                   data[i - 1].velocity));
+  }
+  double sigma = 1.4826 * Median(&differences) / std::sqrt(6.0);
+
+  return std::max(quantum, sigma);
+}
+
+double sysid::EstimateAccelNoise(const std::vector<PreparedData>& data,
+                                 int window) {
+  size_t step = window / 2;
+  if (data.size() <= 2 * step) {
+    return 0.0;
+  }
+
+  // Deviations from a centered moving average, like GetAccelNoiseFloor(), but
+  // with the median absolute deviation so that spikes don't inflate it.
+  std::vector<double> deviations;
+  deviations.reserve(data.size() - 2 * step);
+  double sum = 0.0;
+  for (size_t i = 0; i < 2 * step; ++i) {
+    sum += data[i].acceleration;
+  }
+  for (size_t i = step; i + step < data.size(); ++i) {
+    sum += data[i + step].acceleration;
+    deviations.push_back(
+        std::abs(data[i].acceleration - sum / (2 * step + 1)));
+    sum -= data[i - step].acceleration;
+  }
+  return 1.4826 * Median(&deviations);
+}
+
+size_t sysid::FindSteadyStateOnset(const std::vector<PreparedData>& data,
+                                   double accelNoise) {
+  if (data.empty()) {
+    return 0;
+  }
+
+  // The transient can't end before the peak acceleration. Only acceleration
+  // in the direction of motion counts, so that stopping abruptly (e.g. at a
+  // hard stop) isn't the peak.
+  double direction = 0.0;
+  for (auto&& pt : data) {
+    direction += pt.velocity;
+  }
+  direction = std::copysign(1.0, direction);
+  auto peak = std::max_element(
+      data.begin(), data.end(), [&](const auto& a, const auto& b) {
+        return direction * a.acceleration < direction * b.acceleration;
+      });
+  size_t begin = peak - data.begin();
+
+  const double variance = accelNoise * accelNoise;
+  double cost = 0.0;
+  double maxCost = 0.0;
+  size_t onset = begin;
+  for (size_t i = begin; i < data.size(); ++i) {
+    cost += data[i].acceleration * data[i].acceleration - 2 * variance;
+    if (cost > maxCost) {
+      maxCost = cost;
+      onset = i + 1;
+    } else if (cost < maxCost - kSettledSamples * variance) {
+      // Stop once the mechanism has clearly settled, so that later events
+      // (e.g. hitting a hard stop) aren't mistaken for the transient.
+      break;
+    }
+  }
+  return std::min(onset, data.size() - 1);
+}
+
+std::vector<double> sysid::GetMotionThresholdCandidates(double noiseFloor,
+                                                        double maxVelocity,
+                                                        double configured) {
+  // Noise-free data still needs a threshold to remove samples at rest.
+  noiseFloor = std::max(noiseFloor, 1e-3 * maxVelocity);
+  const double maxThreshold = kMaxQuasistaticTrim * maxVelocity;
+
+  std::vector<double> candidates;
+  for (double multiple : kThresholdMultiples) {
+    double threshold = multiple * noiseFloor;
+    if (threshold > maxThreshold) {
+      break;
+    }
+    candidates.push_back(threshold);
+  }
+  if (configured > 0 &&
+      std::find(candidates.begin(), candidates.end(), configured) ==
+          candidates.end()) {
+    candidates.insert(
+        std::upper_bound(candidates.begin(), candidates.end(), configured),
+        configured);
+  }
+  if (candidates.empty()) {
+    // Only happens without a configured threshold.
+    candidates.push_back(maxThreshold);
+  }
+  return candidates;
+}
+
+std::vector<units::second_t> sysid::GetStepDurationCandidates(
+    units::second_t onset, units::second_t minDuration,
+    units::second_t maxDuration) {
+  std::vector<units::second_t> candidates;
+  for (double multiple : kDurationMultiples) {
+    auto duration = std::min(multiple * onset, maxDuration);
+    // Durations at or below the minimum are replaced by the default.
+    if (duration > minDuration &&
+        (candidates.empty() || duration - candidates.back() > 10_ms)) {
+      candidates.push_back(duration);
+    }
+  }
+  if (candidates.empty() || maxDuration - candidates.back() > 10_ms) {
+    candidates.push_back(maxDuration);
+  }
+  return candidates;
+}
+
+size_t sysid::GetValidationFold(units::second_t timestamp) {
+  auto block = static_cast<int64_t>(
+      std::floor(timestamp.value() / kValidationBlock.value()));
+  return static_cast<size_t>(block % static_cast<int64_t>(kValidationFolds) +
+                             kValidationFolds) %
+         kValidationFolds;
+}
+
+Storage sysid::ExcludeValidationFold(const Storage& data, size_t fold) {
+  Storage training;
+  for (auto&& [source, destination] :
+       {std::pair{&data.slow, &training.slow},
+        std::pair{&data.fast, &training.fast}}) {
+    destination->reserve(source->size());
+    std::copy_if(source->begin(), source->end(),
+                 std::back_inserter(*destination), [&](const auto& pt) {
+                   return GetValidationFold(pt.timestamp) != fold;
+                 });
+  }
+  return training;
+}
+
+void sysid::AddVoltageErrors(const std::vector<PreparedData>& data,
+                             size_t fold, const std::vector<double>& gains,
+                             const std::vector<ModelTerm>& terms,
+                             const ModelTermParameters& params, double* sum,
+                             size_t* count) {
+  if (data.empty()) {
+    return;
+  }
+  Eigen::VectorXd termVoltages =
+      CalculateTermVoltages(terms, gains.data() + 3, data, params);
+  for (size_t i = 0; i < data.size(); ++i) {
+    const auto& pt = data[i];
+    if (GetValidationFold(pt.timestamp) != fold) {
+      continue;
+    }
+    double predicted = gains[0] * std::copysign(1.0, pt.velocity) +
+                       gains[1] * pt.velocity + gains[2] * pt.acceleration +
+                       termVoltages(i);
+    double error = pt.voltage - predicted;
+    *sum += error * error;
+    ++*count;
+  }
+}
@@ -0,0 +1,287 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/BatchAnalysis.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <wpi/StringExtras.h>
+#include <wpi/fs.h>
+#include <wpi/json.h>
+#include <wpi/raw_istream.h>
+
+#include "sysid/analysis/AnalysisManager.h"
+#include "sysid/analysis/FeedbackControllerPreset.h"
+#include "sysid/analysis/ModelTerms.h"
+
+using namespace sysid;
+
+// The suffix that replaces ".json" in the names of result files.
+static constexpr std::string_view kResultSuffix = ".results.json";
+
+// The name of the summary of the captures in a directory.
+static constexpr std::string_view kSummaryName = "sysid-summary.json";
+
+/**
+ * The gain presets by the names that the analyzer lists them with.
+ */
+static const std::pair<const char*, FeedbackControllerPreset> kPresets[] = {
+    {"Default", presets::kDefault},
+    {"WPILib (2020-)", presets::kWPILibNew},
+    {"WPILib (Pre-2020)", presets::kWPILibOld},
+    {"CANCoder", presets::kCTRECANCoder},
+    {"CTRE", presets::kCTREDefault},
+    {"REV Brushless Encoder Port", presets::kREVNEOBuiltIn},
+    {"REV Brushed Encoder Port", presets::kREVNonNEO},
+    {"REV Data Port", presets::kREVNonNEO},
+    {"Venom", presets::kVenom}};
+
+BatchSettings sysid::ParseBatchSettings(const wpi::json& json,
+                                        BatchSettings defaults) {
+  if (!json.is_object()) {
+    throw std::runtime_error("The settings have to be a JSON object");
+  }
+
+  auto settings = std::move(defaults);
+  auto& analysis = settings.analysis;
+  if (json.contains("preset")) {
+    auto name = json.at("preset").get<std::string>();
+    auto preset = std::find_if(std::begin(kPresets), std::end(kPresets),
+                               [&](auto& p) { return name == p.first; });
+    if (preset == std::end(kPresets)) {
+      throw std::runtime_error(fmt::format("Unknown gain preset: {}", name));
+    }
+    analysis.preset = preset->second;
+  }
+  if (json.contains("loopType")) {
+    auto type = json.at("loopType").get<std::string>();
+    if (type == "Position") {
+      analysis.type = FeedbackControllerLoopType::kPosition;
+    } else if (type == "Velocity") {
+      analysis.type = FeedbackControllerLoopType::kVelocity;
+    } else {
+      throw std::runtime_error(fmt::format("Unknown loop type: {}", type));
+    }
+  }
+  if (json.contains("lqr")) {
+    const auto& lqr = json.at("lqr");
+    analysis.lqr.qp = lqr.value("qp", analysis.lqr.qp);
+    analysis.lqr.qv = lqr.value("qv", analysis.lqr.qv);
+    analysis.lqr.r = lqr.value("r", analysis.lqr.r);
+  }
+  settings.autoTune = json.value("autoTune", settings.autoTune);
+  analysis.motionThreshold =
+      json.value("motionThreshold", analysis.motionThreshold);
+  analysis.stepTestDuration = units::second_t{
+      json.value("stepTestDuration", analysis.stepTestDuration.value())};
+  analysis.windowSize = json.value("windowSize", analysis.windowSize);
+  analysis.useKalmanSmoother =
+      json.value("useKalmanSmoother", analysis.useKalmanSmoother);
+  settings.dataset = json.value("dataset", settings.dataset);
+  if (json.contains("modelTerms")) {
+    analysis.modelTerms.clear();
+    for (auto&& name : json.at("modelTerms")) {
+      auto term =
+          std::find_if(std::begin(kModelTerms), std::end(kModelTerms),
+                       [&](auto t) { return GetGainName(t) == name; });
+      if (term == std::end(kModelTerms)) {
+        throw std::runtime_error(
+            fmt::format("Unknown model term: {}", name.get<std::string>()));
+      }
+      analysis.modelTerms.push_back(*term);
+    }
+  }
+  // Non-positive shape parameters make the Stribeck column zero and the
+  // backlash column a copy of the Ks one, so the fit would be singular.
+  auto& params = analysis.modelTermParameters;
+  params.stribeckVelocity =
+      json.value("stribeckVelocity", params.stribeckVelocity);
+  if (!(params.stribeckVelocity > 0)) {
+    throw std::runtime_error(
+        fmt::format("The Stribeck velocity has to be positive: {}",
+                    params.stribeckVelocity));
+  }
+  params.backlashWidth = json.value("backlashWidth", params.backlashWidth);
+  if (!(params.backlashWidth > 0)) {
+    throw std::runtime_error(fmt::format(
+        "The backlash width has to be positive: {}", params.backlashWidth));
+  }
+  analysis.convertGainsToEncTicks =
+      json.value("convertGainsToEncTicks", analysis.convertGainsToEncTicks);
+  analysis.cpr = json.value("cpr", analysis.cpr);
+  analysis.gearing = json.value("gearing", analysis.gearing);
+  return settings;
+}
+
+BatchSettings sysid::LoadBatchSettings(std::string_view path) {
+  wpi::json json;
+  {
+    std::error_code ec;
+    wpi::raw_fd_istream is{path, ec};
+    if (ec) {
+      throw std::runtime_error(fmt::format("Unable to read: {}", path));
+    }
+    is >> json;
+  }
+  return ParseBatchSettings(json);
+}
+
+/**
+ * Returns the feedforward gains by name.
+ *
+ * @param gains The gains in the order of the model terms.
+ * @param terms The extra model terms after Ks, Kv, and Ka.
+ */
+static wpi::json NameGains(const std::vector<double>& gains,
+                           const std::vector<ModelTerm>& terms) {
+  wpi::json named = {{"Ks", gains[0]}, {"Kv", gains[1]}, {"Ka", gains[2]}};
+  for (size_t i = 0; i < terms.size(); ++i) {
+    named[std::string{GetGainName(terms[i])}] = gains[3 + i];
+  }
+  return named;
+}
+
+AnalysisManager::Gains sysid::RunAnalysis(
+    AnalysisManager& manager, AnalysisManager::Settings& analysisSettings,
+    const BatchSettings& settings, wpi::Logger& logger,
+    AnalysisTimings* timings) {
+  if (!settings.cacheDirectory.empty()) {
+    manager.SetCacheDirectory(settings.cacheDirectory);
+  }
+
+  const auto& datasets = manager.GetDatasets();
+  auto dataset = std::find_if(datasets.begin(), datasets.end(), [&](auto d) {
+    return settings.dataset == d;
+  });
+  if (dataset == datasets.end()) {
+    throw std::runtime_error(fmt::format(
+        "{} doesn't have a {} dataset", manager.GetAnalysisType().name,
+        settings.dataset));
+  }
+  analysisSettings.dataset = dataset - datasets.begin();
+
+  using Clock = std::chrono::steady_clock;
+  auto start = Clock::now();
+  if (settings.autoTune) {
+    try {
+      manager.AutoTune();
+    } catch (const std::exception& e) {
+      // Fall back to the given settings, like the analyzer does.
+      WPI_INFO(logger, "Auto-tuning failed: {}", e.what());
+      manager.PrepareData();
+    }
+  } else {
+    manager.PrepareData();
+  }
+  auto prepared = Clock::now();
+  auto gains = manager.Calculate();
+  if (timings) {
+    timings->prepare = std::chrono::duration<double>{prepared - start}.count();
+    timings->calculate =
+        std::chrono::duration<double>{Clock::now() - prepared}.count();
+  }
+  return gains;
+}
+
+/**
+ * Analyzes a capture the way the analyzer does when it's opened.
+ *
+ * @param manager          The analysis manager of the capture.
+ * @param analysisSettings The settings that the manager was constructed with.
+ * @param settings         The batch settings.
+ * @param logger           The logger instance to use for log data.
+ */
+static wpi::json Analyze(AnalysisManager& manager,
+                         AnalysisManager::Settings& analysisSettings,
+                         const BatchSettings& settings, wpi::Logger& logger) {
+  auto gains = RunAnalysis(manager, analysisSettings, settings, logger);
+  auto terms = manager.GetModelTerms();
+  bool isPosition =
+      analysisSettings.type == FeedbackControllerLoopType::kPosition;
+
+  wpi::json result = {
+      {"test", std::string{manager.GetAnalysisType().name}},
+      {"units", std::string{manager.GetUnit()}},
+      {"unitsPerRotation", manager.GetFactor()},
+      {"dataset", settings.dataset},
+      {"motionThreshold", analysisSettings.motionThreshold},
+      {"stepTestDuration", analysisSettings.stepTestDuration.value()},
+      {"feedforward", NameGains(std::get<0>(gains.ffGains), terms)},
+      {"rSquared", std::get<1>(gains.ffGains)},
+      {"loopType", isPosition ? "Position" : "Velocity"},
+      {"feedback", {{"Kp", gains.fbGains.Kp}, {"Kd", gains.fbGains.Kd}}}};
+  if (gains.trackWidth) {
+    result["trackWidth"] = *gains.trackWidth;
+  }
+  for (auto&& [moduleGains, rSquared] : manager.CalculateSwerveModules()) {
+    wpi::json module = {{"feedforward", NameGains(moduleGains, terms)},
+                        {"rSquared", rSquared}};
+    result["modules"].push_back(module);
+  }
+  for (auto&& motor : manager.CalculateMotorChannels()) {
+    wpi::json diagnostics = {{"feedforward", NameGains(motor.ffGains, terms)},
+                             {"rSquared", motor.rSquared},
+                             {"velocityRatio", motor.velocityRatio},
+                             {"meanCurrent", motor.meanCurrent},
+                             {"slipping", motor.slipping},
+                             {"mismatched", motor.mismatched}};
+    result["motors"].push_back(diagnostics);
+  }
+  for (auto&& [dataset, noise, kalmanGains] : manager.CalculateEstimators()) {
+    wpi::json estimator = {
+        {"dataset", dataset},
+        {"noise",
+         {{"process", noise.process},
+          {"position", noise.position},
+          {"velocity", noise.velocity}}},
+        {"kalman",
+         {{"position", kalmanGains.position},
+          {"velocity", kalmanGains.velocity}}}};
+    result["estimators"].push_back(estimator);
+  }
+  return result;
+}
+
+wpi::json sysid::AnalyzeCapture(std::string_view path,
+                                const BatchSettings& settings,
+                                wpi::Logger& logger) {
+  auto analysisSettings = settings.analysis;
+  AnalysisManager manager{path, analysisSettings, logger};
+  auto result = Analyze(manager, analysisSettings, settings, logger);
+  result["capture"] = fs::path{path}.filename().string();
+  return result;
+}
+
+wpi::json sysid::AnalyzeCaptureData(wpi::json capture,
+                                    const BatchSettings& settings,
+                                    wpi::Logger& logger) {
+  auto analysisSettings = settings.analysis;
+  AnalysisManager manager{std::move(capture), analysisSettings, logger};
+  return Analyze(manager, analysisSettings, settings, logger);
+}
+
+std::string sysid::GetResultPath(std::string_view capturePath) {
+  if (wpi::ends_with(capturePath, ".json")) {
+    capturePath.remove_suffix(5);
+  }
+  return fmt::format("{}{}", capturePath, kResultSuffix);
+}
+
+std::string sysid::GetSummaryPath(std::string_view directory) {
+  return (fs::path{directory} / kSummaryName).string();
+}
+
+bool sysid::IsCapturePath(std::string_view path) {
+  auto filename = fs::path{path}.filename().string();
+  return wpi::ends_with(filename, ".json") &&
+         !wpi::ends_with(filename, kResultSuffix) && filename != kSummaryName;
+}
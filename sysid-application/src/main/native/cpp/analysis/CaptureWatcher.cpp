@@ -0,0 +1,345 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/CaptureWatcher.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <ctime>
+#include <exception>
+#include <map>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fmt/chrono.h>
+#include <fmt/core.h>
+#include <wpi/fs.h>
+#include <wpi/json.h>
+#include <wpi/raw_istream.h>
+
+#include "sysid/Util.h"
+#include "sysid/analysis/BatchAnalysis.h"
+
+using namespace sysid;
+
+// How often directories are checked for new captures when they're polled, and
+// how often the watcher checks whether it's being stopped.
+static constexpr std::chrono::milliseconds kPollPeriod{500};
+
+/**
+ * Returns whether a capture doesn't have results or has results that are older
+ * than the capture.
+ *
+ * @param path The path of the capture.
+ */
+static bool NeedsAnalysis(const fs::path& path) {
+  std::error_code ec;
+  auto resultTime = fs::last_write_time(GetResultPath(path.string()), ec);
+  if (ec) {
+    return true;
+  }
+  return resultTime < fs::last_write_time(path, ec);
+}
+
+/**
+ * Writes a JSON file, replacing it atomically so that readers never see a
+ * partially written file.
+ *
+ * @param path The path of the file.
+ * @param json The contents of the file.
+ */
+static void WriteJSON(const std::string& path, const wpi::json& json) {
+  auto tempPath = path + ".tmp";
+  sysid::SaveFile(json.dump(2), fs::path{tempPath});
+  fs::rename(tempPath, path);
+}
+
+CaptureWatcher::CaptureWatcher(std::vector<std::string> directories,
+                               BatchSettings settings, size_t workers,
+                               wpi::Logger& logger)
+    : m_directories{std::move(directories)},
+      m_settings{std::move(settings)},
+      m_workerCount{workers > 0 ? workers : 1},
+      m_logger{logger} {}
+
+CaptureWatcher::~CaptureWatcher() {
+  Stop();
+}
+
+void CaptureWatcher::Start() {
+  {
+    std::scoped_lock lock{m_mutex};
+    m_stopping = false;
+  }
+#ifdef __linux__
+  // Watch before scanning so that captures written in between aren't missed.
+  // Captures are queued once they're closed after writing or moved into the
+  // directory, so partially written captures are never analyzed.
+  m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_inotify >= 0) {
+    for (auto&& directory : m_directories) {
+      int wd = inotify_add_watch(m_inotify, directory.c_str(),
+                                 IN_CLOSE_WRITE | IN_MOVED_TO);
+      if (wd >= 0) {
+        m_watches[wd] = directory;
+      }
+    }
+  }
+#endif
+  Scan();
+  m_watcher = std::thread{[this] { Watch(); }};
+  for (size_t i = 0; i < m_workerCount; ++i) {
+    m_workers.emplace_back([this] { Work(); });
+  }
+}
+
+void CaptureWatcher::Stop() {
+  {
+    std::scoped_lock lock{m_mutex};
+    m_stopping = true;
+    m_queue.clear();
+    m_pending.clear();
+  }
+  m_queueChanged.notify_all();
+  if (m_watcher.joinable()) {
+    m_watcher.join();
+  }
+  for (auto&& worker : m_workers) {
+    worker.join();
+  }
+  m_workers.clear();
+  m_idle.notify_all();
+}
+
+void CaptureWatcher::WaitUntilIdle() {
+  std::unique_lock lock{m_mutex};
+  m_idle.wait(lock, [&] {
+    return m_stopping || (m_queue.empty() && m_active == 0);
+  });
+}
+
+size_t CaptureWatcher::GetAnalyzedCount() {
+  std::scoped_lock lock{m_mutex};
+  return m_analyzed;
+}
+
+void CaptureWatcher::Scan() {
+  for (auto&& directory : m_directories) {
+    std::error_code ec;
+    for (auto&& file : fs::directory_iterator{directory, ec}) {
+      auto path = file.path().string();
+      if (file.is_regular_file(ec) && IsCapturePath(path) &&
+          NeedsAnalysis(file.path())) {
+        Enqueue(path);
+      }
+    }
+    if (ec) {
+      std::scoped_lock lock{m_logMutex};
+      WPI_ERROR(m_logger, "Unable to read {}: {}", directory, ec.message());
+    }
+  }
+}
+
+void CaptureWatcher::Watch() {
+#ifdef __linux__
+  if (m_inotify < 0) {
+    Poll();
+    return;
+  }
+
+  alignas(inotify_event) char buffer[4096];
+  pollfd pfd{m_inotify, POLLIN, 0};
+  for (;;) {
+    {
+      std::scoped_lock lock{m_mutex};
+      if (m_stopping) {
+        break;
+      }
+    }
+    if (poll(&pfd, 1, kPollPeriod.count()) <= 0) {
+      continue;
+    }
+    ssize_t size;
+    while ((size = read(m_inotify, buffer, sizeof(buffer))) > 0) {
+      for (char* ptr = buffer; ptr < buffer + size;) {
+        auto event = reinterpret_cast<const inotify_event*>(ptr);
+        ptr += sizeof(inotify_event) + event->len;
+        auto directory = m_watches.find(event->wd);
+        if (event->len == 0 || directory == m_watches.end()) {
+          continue;
+        }
+        auto path = (fs::path{directory->second} / event->name).string();
+        if (IsCapturePath(path)) {
+          Enqueue(path);
+        }
+      }
+    }
+  }
+  close(m_inotify);
+  m_inotify = -1;
+  m_watches.clear();
+#else
+  Poll();
+#endif
+}
+
+void CaptureWatcher::Poll() {
+  // The sizes and modification times of the captures in the last poll. A
+  // capture is only queued once they stop changing, so that partially
+  // written captures aren't analyzed.
+  std::map<std::string, std::pair<uintmax_t, fs::file_time_type>> last;
+  for (;;) {
+    {
+      std::unique_lock lock{m_mutex};
+      if (m_queueChanged.wait_for(lock, kPollPeriod,
+                                  [&] { return m_stopping; })) {
+        break;
+      }
+    }
+
+    std::map<std::string, std::pair<uintmax_t, fs::file_time_type>> current;
+    for (auto&& directory : m_directories) {
+      std::error_code ec;
+      for (auto&& file : fs::directory_iterator{directory, ec}) {
+        auto path = file.path().string();
+        if (!file.is_regular_file(ec) || !IsCapturePath(path)) {
+          continue;
+        }
+        auto state = std::pair{file.file_size(ec), file.last_write_time(ec)};
+        if (!ec) {
+          auto previous = last.find(path);
+          if (previous != last.end() && previous->second == state &&
+              NeedsAnalysis(file.path())) {
+            Enqueue(path);
+          }
+          current.emplace(path, state);
+        }
+      }
+    }
+    last = std::move(current);
+  }
+}
+
+void CaptureWatcher::Work() {
+  // The workers log through the shared logger one at a time.
+  wpi::Logger logger;
+  logger.SetLogger([this](unsigned int level, const char* file,
+                          unsigned int line, const char* msg) {
+    std::scoped_lock lock{m_logMutex};
+    m_logger.DoLog(level, file, line, msg);
+  });
+  logger.set_min_level(m_logger.min_level());
+
+  for (;;) {
+    std::string path;
+    {
+      std::unique_lock lock{m_mutex};
+      m_queueChanged.wait(lock,
+                          [&] { return m_stopping || !m_queue.empty(); });
+      if (m_stopping) {
+        return;
+      }
+      path = std::move(m_queue.front());
+      m_queue.pop_front();
+      ++m_active;
+    }
+
+    Analyze(path, logger);
+
+    {
+      std::scoped_lock lock{m_mutex};
+      --m_active;
+      ++m_analyzed;
+      m_pending.erase(path);
+    }
+    m_idle.notify_all();
+  }
+}
+
+void CaptureWatcher::Enqueue(const std::string& path) {
+  {
+    std::scoped_lock lock{m_mutex};
+    if (m_stopping || !m_pending.insert(path).second) {
+      return;
+    }
+    m_queue.push_back(path);
+  }
+  // The poller waits on the same condition, so all threads are woken.
+  m_queueChanged.notify_all();
+}
+
+void CaptureWatcher::Analyze(const std::string& path, wpi::Logger& logger) {
+  WPI_INFO(logger, "Analyzing {}", path);
+  auto start = std::chrono::steady_clock::now();
+  wpi::json result;
+  try {
+    result = AnalyzeCapture(path, m_settings, logger);
+    const auto& ff = result.at("feedforward");
+    WPI_INFO(logger,
+             "Analyzed {} in {:.2f} s: Ks {:.4f}, Kv {:.4f}, Ka {:.4f} "
+             "(r-squared {:.4f})",
+             path,
+             std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           start)
+                 .count(),
+             ff.at("Ks").get<double>(), ff.at("Kv").get<double>(),
+             ff.at("Ka").get<double>(), result.at("rSquared").get<double>());
+  } catch (const std::exception& e) {
+    // The error is written as the result so that the capture isn't analyzed
+    // again until it changes.
+    WPI_ERROR(logger, "Unable to analyze {}: {}", path, e.what());
+    result = {{"capture", fs::path{path}.filename().string()},
+              {"error", e.what()}};
+  }
+  result["analyzed"] =
+      fmt::format("{:%Y-%m-%d %H:%M:%S}", fmt::localtime(std::time(nullptr)));
+
+  try {
+    WriteJSON(GetResultPath(path), result);
+    UpdateSummary(path, result);
+  } catch (const std::exception& e) {
+    WPI_ERROR(logger, "Unable to write the results of {}: {}", path, e.what());
+  }
+}
+
+void CaptureWatcher::UpdateSummary(const std::string& path,
+                                   const wpi::json& result) {
+  std::scoped_lock lock{m_summaryMutex};
+  auto summaryPath = GetSummaryPath(fs::path{path}.parent_path().string());
+
+  // Start over if the summary is missing or unreadable.
+  wpi::json summary;
+  {
+    std::error_code ec;
+    wpi::raw_fd_istream is{summaryPath, ec};
+    if (!ec) {
+      try {
+        is >> summary;
+      } catch (const wpi::json::exception&) {
+        summary = wpi::json{};
+      }
+    }
+  }
+  if (!summary.is_object() || !summary["captures"].is_array()) {
+    summary = {{"captures", wpi::json::array()}};
+  }
+
+  // The latest results come first, and each capture is only listed once.
+  auto& captures = summary["captures"];
+  wpi::json updated = wpi::json::array({result});
+  for (auto&& entry : captures) {
+    if (updated.size() < kSummarySize &&
+        entry.value("capture", "") != result.at("capture")) {
+      updated.push_back(entry);
+    }
+  }
+  captures = std::move(updated);
+  WriteJSON(summaryPath, summary);
+}
@@ -0,0 +1,305 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/DataLogImporter.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/core.h>
+#include <wpi/Logger.h>
+#include <wpi/StringExtras.h>
+#include <wpi/fs.h>
+#include <wpi/json.h>
+
+#include "sysid/Util.h"
+#include "sysid/analysis/MappedFile.h"
+
+using namespace sysid;
+
+// The header of a data log is "WPILOG", a 2-byte version, and the 4-byte
+// length of the extra header string.
+static constexpr std::string_view kMagic = "WPILOG";
+static constexpr size_t kHeaderSize = 12;
+static constexpr uint16_t kMajorVersion = 1;
+
+// Control record types.
+static constexpr uint8_t kControlStart = 0;
+static constexpr uint8_t kControlFinish = 1;
+
+/**
+ * Reads a little-endian unsigned integer of up to 8 bytes.
+ *
+ * @param data The first byte of the integer.
+ * @param size The number of bytes in the integer.
+ */
+static uint64_t ReadInteger(const uint8_t* data, size_t size) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < size; ++i) {
+    value |= static_cast<uint64_t>(data[i]) << (8 * i);
+  }
+  return value;
+}
+
+/**
+ * Reads a string that is prefixed by its 4-byte length from a control record.
+ *
+ * @param data The payload of the control record.
+ * @param size The size of the payload.
+ * @param pos  The position of the length, which is advanced past the string.
+ */
+static std::string ReadString(const uint8_t* data, size_t size, size_t* pos) {
+  if (*pos + 4 > size) {
+    throw std::runtime_error("Truncated control record in data log");
+  }
+  size_t length = ReadInteger(data + *pos, 4);
+  *pos += 4;
+  if (length > size - *pos) {
+    throw std::runtime_error("Truncated control record in data log");
+  }
+  std::string str{reinterpret_cast<const char*>(data + *pos), length};
+  *pos += length;
+  return str;
+}
+
+DataLogReader::DataLogReader(std::string_view path)
+    : m_path{path}, m_file{std::make_unique<MappedFile>(path)} {
+  const uint8_t* data = m_file->data();
+  size_t size = m_file->size();
+  if (size < kHeaderSize ||
+      std::memcmp(data, kMagic.data(), kMagic.size()) != 0) {
+    throw std::runtime_error(
+        fmt::format("{} is not a WPILib data log", m_path));
+  }
+
+  uint16_t version = ReadInteger(data + 6, 2);
+  if ((version >> 8) != kMajorVersion) {
+    throw std::runtime_error(fmt::format(
+        "{} has unsupported data log version {}.{}", m_path, version >> 8,
+        version & 0xff));
+  }
+
+  size_t extraHeader = ReadInteger(data + 8, 4);
+  if (extraHeader > size - kHeaderSize) {
+    throw std::runtime_error(fmt::format("{} has a truncated header", m_path));
+  }
+  m_pos = kHeaderSize + extraHeader;
+}
+
+DataLogReader::~DataLogReader() = default;
+
+bool DataLogReader::Next(DataLogRecord* record) {
+  const uint8_t* data = m_file->data();
+  size_t size = m_file->size();
+
+  while (m_pos < size) {
+    // The first byte holds the lengths of the variable-length fields that
+    // follow it.
+    uint8_t lengths = data[m_pos];
+    size_t idLength = (lengths & 0x3) + 1;
+    size_t sizeLength = ((lengths >> 2) & 0x3) + 1;
+    size_t timestampLength = ((lengths >> 4) & 0x7) + 1;
+    size_t headerLength = 1 + idLength + sizeLength + timestampLength;
+    if (headerLength > size - m_pos) {
+      throw std::runtime_error(
+          fmt::format("{} ends with a truncated record", m_path));
+    }
+
+    const uint8_t* field = data + m_pos + 1;
+    auto id = static_cast<uint32_t>(ReadInteger(field, idLength));
+    field += idLength;
+    size_t payloadSize = ReadInteger(field, sizeLength);
+    field += sizeLength;
+    auto timestamp =
+        static_cast<int64_t>(ReadInteger(field, timestampLength));
+    if (payloadSize > size - m_pos - headerLength) {
+      throw std::runtime_error(
+          fmt::format("{} ends with a truncated record", m_path));
+    }
+
+    const uint8_t* payload = data + m_pos + headerLength;
+    m_pos += headerLength + payloadSize;
+
+    if (id == 0) {
+      HandleControlRecord(payload, payloadSize);
+      continue;
+    }
+
+    auto entry = m_entries.find(id);
+    if (entry == m_entries.end()) {
+      continue;
+    }
+    *record = DataLogRecord{&entry->second, timestamp, payload, payloadSize};
+    return true;
+  }
+  return false;
+}
+
+void DataLogReader::HandleControlRecord(const uint8_t* data, size_t size) {
+  if (size < 5) {
+    throw std::runtime_error(
+        fmt::format("{} contains a truncated control record", m_path));
+  }
+
+  auto id = static_cast<uint32_t>(ReadInteger(data + 1, 4));
+  if (data[0] == kControlStart) {
+    size_t pos = 5;
+    auto name = ReadString(data, size, &pos);
+    auto type = ReadString(data, size, &pos);
+    m_entries[id] = DataLogEntry{id, std::move(name), std::move(type)};
+  } else if (data[0] == kControlFinish) {
+    m_entries.erase(id);
+  }
+  // Metadata records don't affect the data.
+}
+
+bool DataLogReader::IsNumeric(std::string_view type) {
+  return type == "double" || type == "float" || type == "int64" ||
+         type == "boolean";
+}
+
+double DataLogReader::GetNumber(const DataLogRecord& record) {
+  const auto& type = record.entry->type;
+  if (type == "double" && record.size == 8) {
+    uint64_t bits = ReadInteger(record.data, 8);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  } else if (type == "float" && record.size == 4) {
+    auto bits = static_cast<uint32_t>(ReadInteger(record.data, 4));
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  } else if (type == "int64" && record.size == 8) {
+    return static_cast<double>(
+        static_cast<int64_t>(ReadInteger(record.data, 8)));
+  } else if (type == "boolean" && record.size == 1) {
+    return record.data[0] != 0 ? 1.0 : 0.0;
+  }
+  throw std::runtime_error(
+      fmt::format("Unable to read {} record of size {} from entry {}", type,
+                  record.size, record.entry->name));
+}
+
+std::vector<std::string> sysid::GetTelemetryColumns(const AnalysisType& type) {
+  if (type == analysis::kDrivetrain || type == analysis::kDrivetrainAngular) {
+    return {"Left Voltage",  "Right Voltage",  "Left Position",
+            "Right Position", "Left Velocity", "Right Velocity",
+            "Gyro Angle",     "Gyro Rate"};
+  }
+  if (analysis::IsSwerve(type)) {
+    std::vector<std::string> columns{"Voltage"};
+    for (size_t i = 1; i <= analysis::kSwerveModuleCount; ++i) {
+      columns.push_back(fmt::format("Module {} Position", i));
+      columns.push_back(fmt::format("Module {} Velocity", i));
+    }
+    return columns;
+  }
+  return {"Voltage", "Position", "Velocity"};
+}
+
+std::vector<DataLogEntry> sysid::ListDataLogEntries(std::string_view path) {
+  DataLogReader reader{path};
+  std::vector<DataLogEntry> entries;
+  std::unordered_map<std::string, bool> listed;
+
+  DataLogRecord record;
+  while (reader.Next(&record)) {
+    const auto& entry = *record.entry;
+    if (DataLogReader::IsNumeric(entry.type) &&
+        listed.emplace(entry.name, true).second) {
+      entries.push_back(entry);
+    }
+  }
+  return entries;
+}
+
+std::vector<std::vector<double>> sysid::ReadDataLogCapture(
+    std::string_view path, const std::vector<std::string>& entries) {
+  if (entries.empty()) {
+    throw std::runtime_error("No data log entries were selected");
+  }
+
+  std::unordered_map<std::string_view, size_t> columns;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    columns.emplace(entries[i], i);
+  }
+
+  std::vector<double> latest(entries.size());
+  std::vector<bool> logged(entries.size(), false);
+  size_t loggedCount = 0;
+  std::vector<std::vector<double>> rows;
+
+  DataLogReader reader{path};
+  DataLogRecord record;
+  while (reader.Next(&record)) {
+    auto column = columns.find(record.entry->name);
+    if (column == columns.end()) {
+      continue;
+    }
+
+    size_t col = column->second;
+    latest[col] = DataLogReader::GetNumber(record);
+    if (!logged[col]) {
+      logged[col] = true;
+      ++loggedCount;
+    }
+
+    // The voltage is the clock of the capture.
+    if (col == 0 && loggedCount == entries.size()) {
+      std::vector<double> row;
+      row.reserve(entries.size() + 1);
+      row.push_back(record.timestamp * 1E-6);
+      row.insert(row.end(), latest.begin(), latest.end());
+      rows.emplace_back(std::move(row));
+    }
+  }
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (!logged[i]) {
+      throw std::runtime_error(fmt::format(
+          "The data log doesn't contain any {} records", entries[i]));
+    }
+  }
+  return rows;
+}
+
+std::string sysid::ImportDataLog(std::string_view path,
+                                 const DataLogImportSettings& settings,
+                                 wpi::Logger& logger) {
+  if (settings.entries.size() != settings.type.rawDataSize - 1) {
+    throw std::runtime_error(
+        fmt::format("{} captures need {} data log entries, but {} were given",
+                    settings.type.name, settings.type.rawDataSize - 1,
+                    settings.entries.size()));
+  }
+
+  auto rows = ReadDataLogCapture(path, settings.entries);
+  if (rows.empty()) {
+    throw std::runtime_error(
+        fmt::format("{} doesn't contain any samples", path));
+  }
+  WPI_INFO(logger, "Read {} samples from {}", rows.size(), path);
+
+  wpi::json json;
+  json["continuous"] = rows;
+  json["units"] = settings.units;
+  json["unitsPerRotation"] = settings.unitsPerRotation;
+  json["test"] = settings.type.name;
+  json["sysid"] = true;
+
+  // Write the new file next to the log.
+  if (wpi::ends_with(path, ".wpilog")) {
+    path.remove_suffix(std::string_view{".wpilog"}.size());
+  }
+  std::string loc = fmt::format("{}.json", path);
+
+  sysid::SaveFile(json.dump(), fs::path{loc});
+
+  WPI_INFO(logger, "Wrote new JSON to: {}", loc);
+  return loc;
+}
@@ -4,6 +4,12 @@
 
 #include "sysid/analysis/FeedbackAnalysis.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <utility>
+
 #include <frc/controller/LinearQuadraticRegulator.h>
 #include <frc/system/LinearSystem.h>
 #include <frc/system/plant/LinearSystemId.h>
@@ -76,3 +82,206 @@ FeedbackGains sysid::CalculateVelocityFeedbackGains(
               (preset.outputVelocityTimeFactor * encFactor),
           0.0};
 }
+
+// The smallest fraction of the variance of its residuals that each noise
+// variance is given.
+static constexpr double kMinVarianceFraction = 1E-3;
+
+// How far the sample that continues a sample may be from it. The pooled
+// samples of a drivetrain's two sides are interleaved, so the next sample of
+// the same side can be up to three samples later. Swerve modules are pooled
+// as contiguous runs.
+static constexpr size_t kMaxChainGap = 3;
+
+/**
+ * Returns the variance of a set of values and the covariance of the pairs of
+ * consecutive values.
+ *
+ * @param values The values.
+ * @param pairs  The indices of the pairs of consecutive values.
+ */
+static std::tuple<double, double> Autocovariance(
+    const std::vector<double>& values,
+    const std::vector<std::pair<size_t, size_t>>& pairs) {
+  if (values.size() < 2) {
+    return {0.0, 0.0};
+  }
+  double mean = 0.0;
+  for (double value : values) {
+    mean += value;
+  }
+  mean /= values.size();
+
+  double variance = 0.0;
+  for (double value : values) {
+    variance += (value - mean) * (value - mean);
+  }
+  variance /= values.size() - 1;
+
+  double covariance = 0.0;
+  for (auto&& [i, j] : pairs) {
+    covariance += (values[i] - mean) * (values[j] - mean);
+  }
+  if (!pairs.empty()) {
+    covariance /= pairs.size();
+  }
+  return {variance, covariance};
+}
+
+NoiseCovariances sysid::EstimateNoiseCovariances(
+    const Storage& data, const std::vector<double>& gains,
+    const std::vector<ModelTerm>& terms, const ModelTermParameters& params) {
+  double Ks = gains[0];
+  double Kv = gains[1];
+  double Ka = gains[2];
+
+  // The residuals of each link between a sample and the one that continues
+  // it, and the pairs of consecutive links.
+  std::vector<double> velocityResiduals;
+  std::vector<double> positionResiduals;
+  std::vector<std::pair<size_t, size_t>> pairs;
+  double decaySum = 0.0;
+  double dtSum = 0.0;
+
+  for (const auto* dataset : {&data.slow, &data.fast}) {
+    const auto& points = *dataset;
+    Eigen::VectorXd termVoltages =
+        CalculateTermVoltages(terms, gains.data() + 3, points, params);
+
+    // The link that ends at each sample, if any.
+    constexpr size_t kNoLink = std::numeric_limits<size_t>::max();
+    std::vector<size_t> endingAt(points.size(), kNoLink);
+    for (size_t i = 0; i < points.size(); ++i) {
+      const auto& pt = points[i];
+      double dt = pt.dt.value();
+      size_t end = std::min(points.size(), i + 1 + kMaxChainGap);
+      for (size_t j = i + 1; j < end; ++j) {
+        const auto& next = points[j];
+        double gap = (next.timestamp - pt.timestamp).value();
+        if (std::abs(gap - dt) > 1E-9 || next.velocity != pt.nextVelocity) {
+          continue;
+        }
+
+        // The friction is discontinuous where the direction changes.
+        if (dt <= 0.0 || (pt.velocity > 0) != (next.velocity > 0)) {
+          break;
+        }
+
+        // The velocity decays exponentially towards its steady state with the
+        // voltage that's left after friction and the other terms.
+        double decay = Ka > 1E-7 ? std::exp(-Kv / Ka * dt) : 0.0;
+        double response = Kv > 1E-7 ? (1 - decay) / Kv : dt / Ka;
+        double voltage = pt.voltage - Ks * std::copysign(1.0, pt.velocity) -
+                         termVoltages(i);
+        velocityResiduals.push_back(next.velocity -
+                                    (decay * pt.velocity + response * voltage));
+        positionResiduals.push_back(next.position - pt.position -
+                                    dt * (pt.velocity + next.velocity) / 2);
+        decaySum += decay;
+        dtSum += dt;
+
+        size_t link = velocityResiduals.size() - 1;
+        if (endingAt[i] != kNoLink) {
+          pairs.emplace_back(endingAt[i], link);
+        }
+        endingAt[j] = link;
+        break;
+      }
+    }
+  }
+
+  NoiseCovariances noise;
+  size_t count = velocityResiduals.size();
+  if (count < 2) {
+    return noise;
+  }
+  double decay = decaySum / count;
+  double dt = dtSum / count;
+
+  // r_k = w_k + n_k+1 − A n_k, so Var(r) = q + (1 + A²) σₙ² and
+  // Cov(r_k, r_k+1) = −A σₙ². Without dynamics (A = 0), the two can't be
+  // told apart, and the residuals are split evenly.
+  auto [velocityVariance, velocityCovariance] =
+      Autocovariance(velocityResiduals, pairs);
+  double minVelocityVariance = kMinVarianceFraction * velocityVariance;
+  double velocity = decay > 1E-3 ? -velocityCovariance / decay
+                                 : velocityVariance / 2;
+  noise.velocity = std::max(velocity, minVelocityVariance);
+  double process =
+      std::max(velocityVariance - (1 + decay * decay) * noise.velocity,
+               minVelocityVariance);
+  noise.process = process / dt;
+
+  // d_k = m_k+1 − m_k + (dt / 2)(n_k + n_k+1) for the position noise m, so
+  // Cov(d_k, d_k+1) = −σₘ² + (dt² / 4) σₙ².
+  auto [positionVariance, positionCovariance] =
+      Autocovariance(positionResiduals, pairs);
+  double position = dt * dt / 4 * noise.velocity - positionCovariance;
+  noise.position = std::max(
+      position, std::max(kMinVarianceFraction * positionVariance, 1E-12));
+  return noise;
+}
+
+std::vector<KalmanGains> sysid::CalculateKalmanGains(
+    const FeedbackControllerPreset& preset, FeedbackControllerLoopType type,
+    const std::vector<EstimatorModel>& models) {
+  double T = preset.period.value();
+
+  // Position loops with a state for the velocity need two-state filters, and
+  // the others only need one state. Each kind is solved as a batch.
+  std::vector<detail::KalmanProblem<1>> scalarProblems;
+  std::vector<detail::KalmanProblem<2>> problems;
+  std::vector<bool> isScalar;
+  for (const auto& model : models) {
+    const auto& noise = model.noise;
+    double decay = model.Ka > 1E-7 ? std::exp(-model.Kv / model.Ka * T) : 0.0;
+
+    if (type == FeedbackControllerLoopType::kVelocity) {
+      scalarProblems.push_back({Eigen::Matrix<double, 1, 1>{decay},
+                                Eigen::Matrix<double, 1, 1>{1.0},
+                                Eigen::Matrix<double, 1, 1>{noise.process * T},
+                                noise.velocity});
+      isScalar.push_back(true);
+    } else if (model.Ka <= 1E-7) {
+      // The velocity is an input, so the position integrates its noise.
+      scalarProblems.push_back(
+          {Eigen::Matrix<double, 1, 1>{1.0}, Eigen::Matrix<double, 1, 1>{1.0},
+           Eigen::Matrix<double, 1, 1>{noise.process * T * T * T / 3},
+           noise.position});
+      isScalar.push_back(true);
+    } else {
+      // The velocity disturbances are white noise that the position
+      // integrates.
+      double rate = model.Kv / model.Ka;
+      double integral = rate > 1E-9 ? (1 - decay) / rate : T;
+      detail::KalmanProblem<2> problem;
+      problem.A << 1, integral, 0, decay;
+      problem.C << 1, 0;
+      problem.Q << T * T * T / 3, T * T / 2, T * T / 2, T;
+      problem.Q *= noise.process;
+      problem.R = noise.position;
+      problems.push_back(problem);
+      isScalar.push_back(false);
+    }
+  }
+
+  auto scalarGains = detail::SolveKalmanGains(scalarProblems);
+  auto vectorGains = detail::SolveKalmanGains(problems);
+
+  std::vector<KalmanGains> gains;
+  auto scalar = scalarGains.begin();
+  auto vector = vectorGains.begin();
+  for (bool s : isScalar) {
+    if (!s) {
+      gains.push_back({(*vector)(0), (*vector)(1)});
+      ++vector;
+    } else if (type == FeedbackControllerLoopType::kVelocity) {
+      gains.push_back({0.0, (*scalar)(0)});
+      ++scalar;
+    } else {
+      gains.push_back({(*scalar)(0), 0.0});
+      ++scalar;
+    }
+  }
+  return gains;
+}
@@ -15,6 +15,8 @@
 #include <wpi/StringExtras.h>
 #include <wpi/numbers>
 
+#include "sysid/analysis/KalmanSmoother.h"
+
 using namespace sysid;
 
 /**
@@ -58,11 +60,13 @@ static bool IsFiltered(std::string_view key) {
  * Fills in the rest of the PreparedData Structs for a PreparedData Vector.
  *
  * @param data A reference to a vector of the raw data.
- * @param unit The units that the data is in (rotations, radians, or degrees)
- *             for arm mechanisms.
+ * @param radiansPerUnit The number of radians per unit of position for arm
+ *                       mechanisms, or zero if the unit isn't angular.
+ * @param smoothed True if the acceleration has already been estimated by the
+ *                 Kalman smoother, in which case it is kept.
  */
 static void PrepareMechData(std::vector<PreparedData>* data,
-                            std::string_view unit = "") {
+                            double radiansPerUnit, bool smoothed = false) {
   constexpr size_t kOrder = 2;
   constexpr size_t kWindow = kOrder + 1;
 
@@ -70,25 +74,35 @@ static void PrepareMechData(std::vector<PreparedData>* data,
 
   const double h = GetMeanTimeDelta(*data).value();
 
+  // The smoother estimates every point, so only the finite difference needs to
+  // skip the edges.
+  size_t edge = smoothed ? 0 : kWindow / 2;
+
   // Compute acceleration and add it to the vector.
-  for (size_t i = kWindow / 2; i < data->size() - kWindow / 2; ++i) {
+  for (size_t i = edge; i < data->size() - edge; ++i) {
     auto& pt = data->at(i);
 
-    pt.acceleration = CentralFiniteDifference<kOrder>(
-        [&](size_t i) { return data->at(i).velocity; }, i, h);
+    if (!smoothed) {
+      pt.acceleration = CentralFiniteDifference<kOrder>(
+          [&](size_t i) { return data->at(i).velocity; }, i, h);
+    }
 
     // Calculates the cosine of the position data for single jointed arm
     // analysis
-    double cos = 0.0;
-    if (unit == "Radians") {
-      cos = std::cos(pt.position);
-    } else if (unit == "Degrees") {
-      cos = std::cos(pt.position * wpi::numbers::pi / 180.0);
-    } else if (unit == "Rotations") {
-      cos = std::cos(pt.position * 2 * wpi::numbers::pi);
-    }
-    pt.cos = cos;
+    pt.cos = radiansPerUnit != 0.0 ? std::cos(pt.position * radiansPerUnit)
+                                   : 0.0;
+  }
+}
+
+double sysid::GetRadiansPerUnit(std::string_view unit) {
+  if (unit == "Radians") {
+    return 1.0;
+  } else if (unit == "Degrees") {
+    return wpi::numbers::pi / 180.0;
+  } else if (unit == "Rotations") {
+    return 2 * wpi::numbers::pi;
   }
+  return 0.0;
 }
 
 units::second_t sysid::TrimStepVoltageData(std::vector<PreparedData>* data,
@@ -97,12 +111,19 @@ units::second_t sysid::TrimStepVoltageData(std::vector<PreparedData>* data,
                                            units::second_t maxStepTime) {
   auto firstTimestamp = data->at(0).timestamp;
 
-  // Trim data before max acceleration
+  // Trim data before max acceleration in the direction of motion, since a
+  // mechanism that hits a hard stop decelerates harder than it accelerated.
+  double direction = std::copysign(
+      1.0, std::accumulate(data->begin(), data->end(), 0.0,
+                           [](double sum, const PreparedData& pt) {
+                             return sum + pt.velocity;
+                           }));
   data->erase(data->begin(),
-              std::max_element(
-                  data->begin(), data->end(), [](const auto& a, const auto& b) {
-                    return std::abs(a.acceleration) < std::abs(b.acceleration);
-                  }));
+              std::max_element(data->begin(), data->end(),
+                               [&](const auto& a, const auto& b) {
+                                 return direction * a.acceleration <
+                                        direction * b.acceleration;
+                               }));
 
   minStepTime = std::min(data->at(0).timestamp - firstTimestamp, minStepTime);
 
@@ -156,34 +177,36 @@ double sysid::GetAccelNoiseFloor(const std::vector<PreparedData>& data,
   return std::sqrt(sum / (data.size() - step));
 }
 
-units::second_t sysid::GetMeanTimeDelta(const std::vector<PreparedData>& data) {
-  std::vector<units::second_t> dts;
-
+/**
+ * Adds the valid time deltas of a dataset to a running sum and count.
+ *
+ * @param data  The dataset.
+ * @param sum   The sum of the time deltas.
+ * @param count The number of time deltas.
+ */
+static void AccumulateTimeDeltas(const std::vector<PreparedData>& data,
+                                 units::second_t* sum, size_t* count) {
   for (const auto& pt : data) {
     if (pt.dt > 0_s && pt.dt < 500_ms) {
-      dts.emplace_back(pt.dt);
+      *sum += pt.dt;
+      ++*count;
     }
   }
+}
 
-  return std::accumulate(dts.begin(), dts.end(), 0_s) / dts.size();
+units::second_t sysid::GetMeanTimeDelta(const std::vector<PreparedData>& data) {
+  units::second_t sum = 0_s;
+  size_t count = 0;
+  AccumulateTimeDeltas(data, &sum, &count);
+  return sum / count;
 }
 
 units::second_t sysid::GetMeanTimeDelta(const Storage& data) {
-  std::vector<units::second_t> dts;
-
-  for (const auto& pt : data.slow) {
-    if (pt.dt > 0_s && pt.dt < 500_ms) {
-      dts.emplace_back(pt.dt);
-    }
-  }
-
-  for (const auto& pt : data.fast) {
-    if (pt.dt > 0_s && pt.dt < 500_ms) {
-      dts.emplace_back(pt.dt);
-    }
-  }
-
-  return std::accumulate(dts.begin(), dts.end(), 0_s) / dts.size();
+  units::second_t sum = 0_s;
+  size_t count = 0;
+  AccumulateTimeDeltas(data.slow, &sum, &count);
+  AccumulateTimeDeltas(data.fast, &sum, &count);
+  return sum / count;
 }
 
 void sysid::ApplyMedianFilter(std::vector<PreparedData>* data, int window) {
@@ -261,6 +284,7 @@ void sysid::InitialTrimAndFilter(
     AnalysisManager::Settings& settings, units::second_t& minStepTime,
     units::second_t& maxStepTime, std::string_view unit) {
   auto& preparedData = *data;
+  const double radiansPerUnit = GetRadiansPerUnit(unit);
 
   // Find the maximum Step Test Duration of the dynamic tests
   maxStepTime = GetMaxTime(preparedData);
@@ -286,13 +310,19 @@ void sysid::InitialTrimAndFilter(
       }
     }
 
-    // Apply Median filter
-    if (IsFiltered(key)) {
+    // Apply Median filter, or estimate velocity and acceleration together
+    // with the Kalman smoother. Datasets that are too short to estimate the
+    // smoother noise from fall back to the median filter.
+    bool smoothed = settings.useKalmanSmoother && IsFiltered(key) &&
+                    dataset.size() >= kMinSmootherSamples;
+    if (smoothed) {
+      ApplyKalmanSmoother(&dataset);
+    } else if (IsFiltered(key)) {
       ApplyMedianFilter(&dataset, settings.windowSize);
     }
 
     // Recalculate Accel and Cosine
-    PrepareMechData(&dataset, unit);
+    PrepareMechData(&dataset, radiansPerUnit, smoothed);
 
     // Trims filtered Dynamic Test Data
     if (IsFiltered(key) && wpi::contains(key, "fast")) {
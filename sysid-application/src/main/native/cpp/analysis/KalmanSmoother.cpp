@@ -0,0 +1,338 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/KalmanSmoother.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Cholesky>
+#include <Eigen/Core>
+#include <Eigen/LU>
+#include <wpi/span.h>
+
+using namespace sysid;
+
+using StateVector = Eigen::Vector3d;
+using StateMatrix = Eigen::Matrix3d;
+using OutputVector = Eigen::Vector2d;
+using OutputMatrix = Eigen::Matrix2d;
+
+/**
+ * The smallest measurement standard deviation that will be used. This keeps the
+ * innovation covariance invertible for noiseless (e.g. simulated) data.
+ */
+static constexpr double kMinStdDev = 1e-6;
+
+/**
+ * The range of jerk densities that is searched when estimating the noise, as
+ * powers of ten relative to the density at which the jerk of one time step is
+ * as large as the velocity noise, and the width that the search narrows the
+ * range down to.
+ */
+static constexpr double kMinJerkExponent = -8.0;
+static constexpr double kMaxJerkExponent = 2.0;
+static constexpr double kJerkExponentTolerance = 0.5;
+
+/**
+ * The likelihood of a jerk density is computed on at most this many blocks of
+ * this many consecutive samples, spread over the dataset, so that estimating
+ * the noise costs about as much as smoothing a short dataset.
+ */
+static constexpr size_t kLikelihoodBlocks = 4;
+static constexpr size_t kLikelihoodBlockSize = 128;
+
+/**
+ * The voltage change, as a fraction of the largest voltage in the dataset, that
+ * is treated as a step input. The acceleration can jump at a step (e.g. at the
+ * start of a dynamic test), which white jerk can't model.
+ */
+static constexpr double kVoltageStepFraction = 0.25;
+
+/**
+ * Returns the median of a list of values.
+ *
+ * @param values The values. They are reordered.
+ */
+static double Median(std::vector<double>* values) {
+  auto& v = *values;
+  auto mid = v.begin() + v.size() / 2;
+  std::nth_element(v.begin(), mid, v.end());
+  return *mid;
+}
+
+/**
+ * Estimates the standard deviation of white noise from its finite differences.
+ * The median absolute deviation is used so that the occasional large jump
+ * (e.g. at the start of a dynamic test) doesn't inflate the estimate. If most
+ * differences are zero (quantized encoders), the RMS is used instead.
+ *
+ * @param differences The finite differences. They are reordered.
+ * @param gain        The sum of the squared finite difference coefficients,
+ *                    i.e. the variance gain of the difference operator.
+ */
+static double EstimateStdDev(std::vector<double>* differences, double gain) {
+  if (differences->empty()) {
+    return kMinStdDev;
+  }
+
+  double sumSq = 0.0;
+  for (double d : *differences) {
+    sumSq += d * d;
+  }
+  double rms = std::sqrt(sumSq / differences->size());
+
+  for (auto& d : *differences) {
+    d = std::abs(d);
+  }
+  // 1.4826 converts the median absolute deviation to a standard deviation for
+  // normally distributed data.
+  double stdDev = 1.4826 * Median(differences);
+  if (stdDev == 0.0) {
+    stdDev = rms;
+  }
+  return std::max(stdDev / std::sqrt(gain), kMinStdDev);
+}
+
+/**
+ * The estimates of the forward (filtering) pass that the backward pass needs.
+ */
+struct ForwardEstimates {
+  std::vector<StateVector> predictedStates;
+  std::vector<StateMatrix> predictedCovs;
+  std::vector<StateVector> filteredStates;
+  std::vector<StateMatrix> filteredCovs;
+  std::vector<StateMatrix> transitions;
+};
+
+/**
+ * Runs the constant-acceleration Kalman filter forward over a dataset.
+ *
+ * @param data      The dataset.
+ * @param noise     The noise parameters of the model.
+ * @param estimates Where to store the estimates for the backward pass, or
+ *                  nullptr if they aren't needed.
+ * @return The log-likelihood of the measurements (up to a constant).
+ */
+static double FilterForward(wpi::span<const PreparedData> data,
+                            const SmootherNoise& noise,
+                            ForwardEstimates* estimates) {
+  const size_t n = data.size();
+  const double q = noise.jerk;
+
+  Eigen::Matrix<double, 2, 3> H;
+  H << 1, 0, 0, 0, 1, 0;
+  OutputMatrix R = OutputVector{noise.position * noise.position,
+                                noise.velocity * noise.velocity}
+                       .asDiagonal();
+
+  // The initial acceleration (and the acceleration after a voltage step) is
+  // unknown, so its variance is set from the largest velocity change in the
+  // dataset.
+  double accelScale = 0.0;
+  double maxVoltage = 0.0;
+  for (size_t i = 1; i < n; ++i) {
+    double dt = (data[i].timestamp - data[i - 1].timestamp).value();
+    if (dt > 0) {
+      accelScale = std::max(
+          accelScale, std::abs(data[i].velocity - data[i - 1].velocity) / dt);
+    }
+    maxVoltage = std::max(maxVoltage, std::abs(data[i].voltage));
+  }
+  double accelVariance = accelScale * accelScale + 1.0;
+
+  if (estimates) {
+    estimates->predictedStates.resize(n);
+    estimates->predictedCovs.resize(n);
+    estimates->filteredStates.resize(n);
+    estimates->filteredCovs.resize(n);
+    estimates->transitions.resize(n);
+  }
+
+  StateVector x{data[0].position, data[0].velocity, 0.0};
+  StateMatrix P = StateVector{R(0, 0), R(1, 1), accelVariance}.asDiagonal();
+  double logLikelihood = 0.0;
+
+  for (size_t i = 0; i < n; ++i) {
+    // Predict with the constant-acceleration model. The first sample uses the
+    // initial estimate directly.
+    StateMatrix F = StateMatrix::Identity();
+    if (i > 0) {
+      double dt = std::max(
+          (data[i].timestamp - data[i - 1].timestamp).value(), 0.0);
+      double dt2 = dt * dt;
+      double dt3 = dt2 * dt;
+      F(0, 1) = dt;
+      F(0, 2) = dt2 / 2.0;
+      F(1, 2) = dt;
+
+      StateMatrix Q;
+      Q << dt3 * dt2 / 20.0, dt2 * dt2 / 8.0, dt3 / 6.0,  //
+          dt2 * dt2 / 8.0, dt3 / 3.0, dt2 / 2.0,          //
+          dt3 / 6.0, dt2 / 2.0, dt;
+      x = F * x;
+      P = F * P * F.transpose() + q * Q;
+      if (std::abs(data[i].voltage - data[i - 1].voltage) >
+          kVoltageStepFraction * maxVoltage) {
+        P(2, 2) += accelVariance;
+      }
+    }
+    if (estimates) {
+      estimates->transitions[i] = F;
+      estimates->predictedStates[i] = x;
+      estimates->predictedCovs[i] = P;
+    }
+
+    // Correct with the position and velocity measurements.
+    OutputVector y{data[i].position, data[i].velocity};
+    OutputVector innovation = y - H * x;
+    OutputMatrix S = H * P * H.transpose() + R;
+    OutputMatrix SInv = S.inverse();
+    logLikelihood -= 0.5 * (std::log(S.determinant()) +
+                            innovation.dot(SInv * innovation));
+
+    Eigen::Matrix<double, 3, 2> K = P * H.transpose() * SInv;
+    x += K * innovation;
+    P = (StateMatrix::Identity() - K * H) * P;
+    P = (P + P.transpose()) / 2.0;
+
+    if (estimates) {
+      estimates->filteredStates[i] = x;
+      estimates->filteredCovs[i] = P;
+    }
+  }
+
+  return logLikelihood;
+}
+
+/**
+ * Returns the log-likelihood of the measurements for the given noise
+ * parameters, from a bounded number of samples of the dataset.
+ *
+ * @param data  The dataset.
+ * @param noise The noise parameters of the model.
+ */
+static double GetLogLikelihood(const std::vector<PreparedData>& data,
+                               const SmootherNoise& noise) {
+  if (data.size() <= kLikelihoodBlocks * kLikelihoodBlockSize) {
+    return FilterForward(data, noise, nullptr);
+  }
+  double logLikelihood = 0.0;
+  const size_t stride =
+      (data.size() - kLikelihoodBlockSize) / (kLikelihoodBlocks - 1);
+  for (size_t block = 0; block < kLikelihoodBlocks; ++block) {
+    logLikelihood += FilterForward(
+        wpi::span{data}.subspan(block * stride, kLikelihoodBlockSize), noise,
+        nullptr);
+  }
+  return logLikelihood;
+}
+
+SmootherNoise sysid::EstimateSmootherNoise(
+    const std::vector<PreparedData>& data) {
+  if (data.size() < kMinSmootherSamples) {
+    throw std::runtime_error(
+        "At least four samples are needed to estimate the smoother noise");
+  }
+
+  std::vector<double> dts;
+  for (size_t i = 1; i < data.size(); ++i) {
+    double dt = (data[i].timestamp - data[i - 1].timestamp).value();
+    if (dt > 0) {
+      dts.push_back(dt);
+    }
+  }
+  if (dts.empty()) {
+    throw std::runtime_error("The dataset timestamps are not increasing");
+  }
+  double h = Median(&dts);
+
+  // Second differences of velocity and third differences of position cancel
+  // constant acceleration, so they're dominated by measurement noise. Their
+  // variance gains are 1² + 2² + 1² = 6 and 1² + 3² + 3² + 1² = 20.
+  std::vector<double> velocityDiffs;
+  std::vector<double> positionDiffs;
+  for (size_t i = 1; i + 1 < data.size(); ++i) {
+    velocityDiffs.push_back(data[i + 1].velocity - 2 * data[i].velocity +
+                            data[i - 1].velocity);
+    if (i + 2 < data.size()) {
+      positionDiffs.push_back(data[i + 2].position - 3 * data[i + 1].position +
+                              3 * data[i].position - data[i - 1].position);
+    }
+  }
+
+  SmootherNoise noise;
+  noise.velocity = EstimateStdDev(&velocityDiffs, 6.0);
+  noise.position = EstimateStdDev(&positionDiffs, 20.0);
+
+  // The jerk is rarely visible above the noise in a single time step, so its
+  // density is picked by maximum likelihood instead, with a golden-section
+  // search over its logarithm. That takes nine forward passes over the
+  // sampled blocks.
+  double scale = noise.velocity * noise.velocity / (h * h * h);
+  auto logLikelihood = [&](double exponent) {
+    SmootherNoise candidate = noise;
+    candidate.jerk = scale * std::pow(10.0, exponent);
+    return GetLogLikelihood(data, candidate);
+  };
+  const double invPhi = (std::sqrt(5.0) - 1.0) / 2.0;
+  double lower = kMinJerkExponent;
+  double upper = kMaxJerkExponent;
+  double left = upper - invPhi * (upper - lower);
+  double right = lower + invPhi * (upper - lower);
+  double leftValue = logLikelihood(left);
+  double rightValue = logLikelihood(right);
+  while (upper - lower > kJerkExponentTolerance) {
+    if (leftValue >= rightValue) {
+      upper = right;
+      right = left;
+      rightValue = leftValue;
+      left = upper - invPhi * (upper - lower);
+      leftValue = logLikelihood(left);
+    } else {
+      lower = left;
+      left = right;
+      leftValue = rightValue;
+      right = lower + invPhi * (upper - lower);
+      rightValue = logLikelihood(right);
+    }
+  }
+  noise.jerk = scale * std::pow(10.0, leftValue >= rightValue ? left : right);
+  return noise;
+}
+
+void sysid::ApplyKalmanSmoother(std::vector<PreparedData>* data,
+                                const SmootherNoise& noise) {
+  auto& dataset = *data;
+  if (dataset.empty()) {
+    return;
+  }
+
+  ForwardEstimates estimates;
+  FilterForward(dataset, noise, &estimates);
+
+  // Rauch–Tung–Striebel backward pass. Only the smoothed means are needed, so
+  // the smoothed covariances aren't propagated.
+  const size_t n = dataset.size();
+  StateVector smoothed = estimates.filteredStates[n - 1];
+  dataset[n - 1].velocity = smoothed(1);
+  dataset[n - 1].acceleration = smoothed(2);
+  for (size_t i = n - 1; i-- > 0;) {
+    // C = P(i|i) Fᵀ P(i+1|i)⁻¹. The fixed-size inverse of a 3x3 matrix is
+    // cheaper than a decomposition.
+    StateMatrix C = estimates.filteredCovs[i] *
+                    estimates.transitions[i + 1].transpose() *
+                    estimates.predictedCovs[i + 1].inverse();
+    smoothed = estimates.filteredStates[i] +
+               C * (smoothed - estimates.predictedStates[i + 1]);
+    dataset[i].velocity = smoothed(1);
+    dataset[i].acceleration = smoothed(2);
+  }
+}
+
+void sysid::ApplyKalmanSmoother(std::vector<PreparedData>* data) {
+  ApplyKalmanSmoother(data, EstimateSmootherNoise(*data));
+}
@@ -0,0 +1,100 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <stdexcept>
+
+#include <fmt/core.h>
+#include <wpi/fs.h>
+
+using namespace sysid;
+
+MappedFile::MappedFile(std::string_view path, bool sequential) {
+  fs::path file{path};
+#ifdef _WIN32
+  HANDLE handle =
+      CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error(fmt::format("Unable to read: {}", path));
+  }
+  m_file = handle;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(handle, &size)) {
+    CloseHandle(handle);
+    throw std::runtime_error(fmt::format("Unable to read: {}", path));
+  }
+  m_size = static_cast<size_t>(size.QuadPart);
+  if (m_size == 0) {
+    return;
+  }
+  m_mapping =
+      CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (m_mapping) {
+    m_data = static_cast<const uint8_t*>(
+        MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+  }
+  if (!m_data) {
+    if (m_mapping) {
+      CloseHandle(m_mapping);
+    }
+    CloseHandle(handle);
+    throw std::runtime_error(fmt::format("Unable to map: {}", path));
+  }
+#else
+  m_fd = open(file.c_str(), O_RDONLY);
+  if (m_fd < 0) {
+    throw std::runtime_error(fmt::format("Unable to read: {}", path));
+  }
+  struct stat info;
+  if (fstat(m_fd, &info) != 0) {
+    close(m_fd);
+    throw std::runtime_error(fmt::format("Unable to read: {}", path));
+  }
+  m_size = static_cast<size_t>(info.st_size);
+  if (m_size == 0) {
+    return;
+  }
+  void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+  if (data == MAP_FAILED) {
+    close(m_fd);
+    throw std::runtime_error(fmt::format("Unable to map: {}", path));
+  }
+  m_data = static_cast<const uint8_t*>(data);
+
+  if (sequential) {
+    madvise(data, m_size, MADV_SEQUENTIAL);
+  }
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+  if (m_data) {
+    UnmapViewOfFile(m_data);
+  }
+  if (m_mapping) {
+    CloseHandle(m_mapping);
+  }
+  CloseHandle(m_file);
+#else
+  if (m_data) {
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+  }
+  close(m_fd);
+#endif
+}
@@ -0,0 +1,142 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/ModelTerms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "sysid/analysis/MechanismDescriptor.h"
+
+using namespace sysid;
+
+static_assert(sizeof(PreparedData) % sizeof(double) == 0,
+              "PreparedData must be viewable as a strided array of doubles");
+
+/**
+ * A read-only view of one field of a PreparedData vector as an Eigen column.
+ */
+using Column = Eigen::Map<const Eigen::VectorXd, 0, Eigen::InnerStride<>>;
+
+/**
+ * Returns a strided column view of one field of a dataset without copying it.
+ *
+ * @param data  The dataset.
+ * @param field The field to view.
+ */
+static Column GetColumn(const std::vector<PreparedData>& data,
+                        double PreparedData::*field) {
+  static constexpr Eigen::Index kStride = sizeof(PreparedData) / sizeof(double);
+  if (data.empty()) {
+    return Column{nullptr, 0, Eigen::InnerStride<>{kStride}};
+  }
+  return Column{&(data.front().*field), static_cast<Eigen::Index>(data.size()),
+                Eigen::InnerStride<>{kStride}};
+}
+
+std::string_view sysid::GetGainName(ModelTerm term) {
+  switch (term) {
+    case ModelTerm::kGravity:
+      return "Kg";
+    case ModelTerm::kCosine:
+      return "Kcos";
+    case ModelTerm::kStribeck:
+      return "Kstribeck";
+    case ModelTerm::kDrag:
+      return "Kdrag";
+    case ModelTerm::kBacklash:
+      return "Kbacklash";
+    case ModelTerm::kPosition:
+      return "Kx";
+  }
+  throw std::runtime_error("Unknown model term");
+}
+
+void sysid::ScaleFeedforwardGains(std::vector<double>* gains,
+                                  const std::vector<ModelTerm>& terms,
+                                  double ratio) {
+  auto& K = *gains;
+  if (K.size() > 1) {
+    K[1] /= ratio;
+  }
+  if (K.size() > 2) {
+    K[2] /= ratio;
+  }
+  for (size_t i = 0; i < terms.size() && 3 + i < K.size(); ++i) {
+    K[3 + i] /= std::pow(ratio, GetModelTermUnitPower(terms[i]));
+  }
+}
+
+std::vector<ModelTerm> sysid::GetDefaultModelTerms(const AnalysisType& type) {
+  return VisitDescriptor(type, [](auto descriptor) {
+    const auto& terms = decltype(descriptor)::kTerms;
+    return std::vector<ModelTerm>{terms.begin(), terms.end()};
+  });
+}
+
+void sysid::EvaluateModelTerm(ModelTerm term,
+                              const std::vector<PreparedData>& data,
+                              const ModelTermParameters& params,
+                              Eigen::Ref<Eigen::VectorXd> out) {
+  auto velocity = GetColumn(data, &PreparedData::velocity).array();
+  auto sgn = velocity.unaryExpr([](double v) { return std::copysign(1.0, v); });
+
+  switch (term) {
+    case ModelTerm::kGravity:
+      out.setOnes();
+      break;
+    case ModelTerm::kCosine:
+      out = GetColumn(data, &PreparedData::cos);
+      break;
+    case ModelTerm::kStribeck:
+      if (params.stribeckVelocity > 0) {
+        out = (sgn * (-(velocity / params.stribeckVelocity).square()).exp())
+                  .matrix();
+      } else {
+        out.setZero();
+      }
+      break;
+    case ModelTerm::kDrag:
+      out = (velocity * velocity.abs()).matrix();
+      break;
+    case ModelTerm::kBacklash: {
+      // The play operator is a recurrence, so it can't be vectorized. The
+      // output follows the position changes while inside the band and
+      // saturates at ±1 once the gear teeth are engaged.
+      double halfWidth = params.backlashWidth / 2.0;
+      if (halfWidth <= 0) {
+        out = sgn.matrix();
+        break;
+      }
+      double play = 0.0;
+      for (size_t i = 0; i < data.size(); ++i) {
+        if (i > 0) {
+          play = std::clamp(play + data[i].position - data[i - 1].position,
+                            -halfWidth, halfWidth);
+        }
+        out(i) = play / halfWidth;
+      }
+      break;
+    }
+    case ModelTerm::kPosition:
+      out = GetColumn(data, &PreparedData::position);
+      break;
+  }
+}
+
+Eigen::VectorXd sysid::CalculateTermVoltages(
+    const std::vector<ModelTerm>& terms, const double* gains,
+    const std::vector<PreparedData>& data, const ModelTermParameters& params) {
+  Eigen::VectorXd voltages = Eigen::VectorXd::Zero(data.size());
+  Eigen::VectorXd column(data.size());
+  for (size_t i = 0; i < terms.size(); ++i) {
+    EvaluateModelTerm(terms[i], data, params, column);
+    voltages += gains[i] * column;
+  }
+  return voltages;
+}
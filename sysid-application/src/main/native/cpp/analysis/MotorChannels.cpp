@@ -0,0 +1,105 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/MotorChannels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace sysid;
+
+// The mechanism velocity column of general mechanism data.
+static constexpr size_t kVelCol = 3;
+
+double sysid::CalculateVelocityRatio(const MotorChannelData& data,
+                                     size_t motor, double threshold) {
+  const auto& velocity = data.columns[kVelCol];
+  const auto& motorVelocity =
+      data.columns[MotorChannelColumn(motor, motorchannel::kVelocity)];
+
+  // Least-squares slope through the origin of motor velocity vs. mechanism
+  // velocity.
+  double num = 0.0;
+  double den = 0.0;
+  for (size_t i = 0; i < velocity.size(); ++i) {
+    if (std::abs(velocity[i]) > threshold) {
+      num += motorVelocity[i] * velocity[i];
+      den += velocity[i] * velocity[i];
+    }
+  }
+  return den > 0.0 ? num / den : 0.0;
+}
+
+double sysid::CalculateMeanCurrent(const MotorChannelData& data, size_t motor,
+                                   double threshold) {
+  const auto& velocity = data.columns[kVelCol];
+  const auto& current =
+      data.columns[MotorChannelColumn(motor, motorchannel::kCurrent)];
+
+  double sum = 0.0;
+  size_t count = 0;
+  for (size_t i = 0; i < velocity.size(); ++i) {
+    if (std::abs(velocity[i]) > threshold) {
+      sum += std::abs(current[i]);
+      ++count;
+    }
+  }
+  return count > 0 ? sum / count : 0.0;
+}
+
+/**
+ * Returns the median of a list of values.
+ */
+static double Median(std::vector<double> values) {
+  auto mid = values.begin() + values.size() / 2;
+  std::nth_element(values.begin(), mid, values.end());
+  if (values.size() % 2 == 1) {
+    return *mid;
+  }
+  return (*mid + *std::max_element(values.begin(), mid)) / 2.0;
+}
+
+/**
+ * Returns whether a value deviates from a reference by more than a relative
+ * tolerance. Nothing deviates from a zero reference, since that means the
+ * channel wasn't measured.
+ */
+static bool Deviates(double value, double reference, double tolerance) {
+  return reference != 0.0 &&
+         std::abs(value - reference) > tolerance * std::abs(reference);
+}
+
+void sysid::FlagMotorOutliers(std::vector<MotorDiagnostics>* motors,
+                              const MotorOutlierTolerances& tolerances) {
+  auto& diagnostics = *motors;
+  if (diagnostics.size() < 2) {
+    return;
+  }
+
+  std::vector<double> ratios;
+  std::vector<double> Kvs;
+  std::vector<double> currents;
+  for (auto&& motor : diagnostics) {
+    ratios.push_back(motor.velocityRatio);
+    // Each motor is fit against its own encoder, so Kv is scaled back to
+    // mechanism units first. Otherwise a slipping motor would also skew the
+    // Kv median.
+    Kvs.push_back(motor.ffGains.size() > 1
+                      ? motor.ffGains[1] * motor.velocityRatio
+                      : 0.0);
+    currents.push_back(motor.meanCurrent);
+  }
+
+  double medianRatio = Median(ratios);
+  double medianKv = Median(Kvs);
+  double medianCurrent = Median(currents);
+  for (size_t i = 0; i < diagnostics.size(); ++i) {
+    auto& motor = diagnostics[i];
+    motor.slipping =
+        Deviates(ratios[i], medianRatio, tolerances.velocityRatio);
+    motor.mismatched = Deviates(Kvs[i], medianKv, tolerances.Kv) ||
+                       Deviates(currents[i], medianCurrent, tolerances.current);
+  }
+}
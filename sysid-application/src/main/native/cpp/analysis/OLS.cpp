@@ -4,19 +4,32 @@
 
 #include "sysid/analysis/OLS.h"
 
+#include <cassert>
+#include <stdexcept>
 #include <tuple>
 #include <vector>
 
 #include <Eigen/Cholesky>
 #include <Eigen/Core>
+#include <Eigen/QR>
 
 using namespace sysid;
 
-std::tuple<std::vector<double>, double> sysid::OLS(
-    const std::vector<double>& data, size_t independentVariables) {
-  // Perform some quick sanity checks regarding the size of the vector.
-  assert(data.size() % (independentVariables + 1) == 0);
-
+// The smallest pivot, relative to the largest one, of the scaled normal
+// equations at which the columns of the design matrix are still considered
+// independent.
+static constexpr double kRankTolerance = 1E-10;
+
+/**
+ * Performs ordinary least squares on a design matrix and dependent variable.
+ *
+ * @param X The design matrix (one row per observation).
+ * @param y The dependent variable (one row per observation).
+ */
+template <typename DerivedX, typename DerivedY>
+static std::tuple<std::vector<double>, double> SolveOLS(
+    const Eigen::MatrixBase<DerivedX>& X,
+    const Eigen::MatrixBase<DerivedY>& y) {
   // The linear model can be written as follows:
   // y = Xβ + u, where y is the dependent observed variable, X is the matrix
   // of independent variables, β is a vector of coefficients, and u is a
@@ -25,6 +38,62 @@ std::tuple<std::vector<double>, double> sysid::OLS(
   // We want to minimize u² = uᵀu = (y - Xβ)ᵀ(y - Xβ).
   // β = (XᵀX)⁻¹Xᵀy
 
+  // Get the number of elements and coefficients.
+  size_t n = X.rows();
+  size_t p = X.cols();
+
+  // Calculate b = β that minimizes uᵀu. If the columns are linearly dependent
+  // (e.g. a model term that duplicates another one), XᵀX is singular and the
+  // coefficients aren't unique, so the fit fails instead of returning
+  // arbitrary ones. The rank is checked with the columns scaled to unit norm
+  // so that it doesn't depend on their units.
+  Eigen::MatrixXd XtX = X.transpose() * X;
+  Eigen::VectorXd norms = XtX.diagonal().cwiseSqrt();
+  if ((norms.array() == 0.0).any()) {
+    throw std::runtime_error(
+        "An independent variable is always zero, so the coefficients can't "
+        "be determined");
+  }
+  Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr{
+      norms.cwiseInverse().asDiagonal() * XtX *
+      norms.cwiseInverse().asDiagonal()};
+  qr.setThreshold(kRankTolerance);
+  if (qr.rank() < static_cast<Eigen::Index>(p)) {
+    throw std::runtime_error(
+        "The independent variables are linearly dependent, so the "
+        "coefficients can't be determined");
+  }
+  auto llt = XtX.llt();
+  if (llt.info() != Eigen::Success) {
+    throw std::runtime_error("The least-squares problem is singular");
+  }
+  Eigen::MatrixXd b = llt.solve(X.transpose() * y);
+
+  // We will now calculate R² or the coefficient of determination, which
+  // tells us how much of the total variation (variation in y) can be
+  // explained by the regression model.
+
+  // We will first calculate the sum of the squares of the error, or the
+  // variation in error (SSE). The residuals are evaluated lazily so that no
+  // temporary with one row per observation is allocated.
+  double SSE = (y - X.lazyProduct(b)).squaredNorm();
+
+  // Now we will calculate the total variation in y, known as SSTO.
+  double SSTO = ((y.transpose() * y) - (1 / n) * (y.transpose() * y)).value();
+
+  double rSquared = (SSTO - SSE) / SSTO;
+  // The adjustment is undefined without more observations than coefficients.
+  double adjRSquared =
+      n > p ? 1 - (1 - rSquared) * ((n - 1.0) / (n - p)) : rSquared;
+
+  return {{b.data(), b.data() + b.rows()}, adjRSquared};
+}
+
+std::tuple<std::vector<double>, double> sysid::OLS(
+    const std::vector<double>& data, size_t independentVariables) {
+  // Perform some quick sanity checks regarding the size of the vector.
+  assert(data.size() % (independentVariables + 1) == 0);
+
   // Get the number of elements.
   size_t n = data.size() / (independentVariables + 1);
 
@@ -40,22 +109,12 @@ std::tuple<std::vector<double>, double> sysid::OLS(
   Eigen::Map<const Eigen::MatrixXd, 0, Eigen::Stride<1, Eigen::Dynamic>> X(
       data.data() + 1, rows, cols, Eigen::Stride<1, Eigen::Dynamic>(1, strd));
 
-  // Calculate b = β that minimizes uᵀu.
-  Eigen::MatrixXd b = (X.transpose() * X).llt().solve(X.transpose() * y);
-
-  // We will now calculate R² or the coefficient of determination, which
-  // tells us how much of the total variation (variation in y) can be
-  // explained by the regression model.
-
-  // We will first calculate the sum of the squares of the error, or the
-  // variation in error (SSE).
-  double SSE = (y - X * b).squaredNorm();
-
-  // Now we will calculate the total variation in y, known as SSTO.
-  double SSTO = ((y.transpose() * y) - (1 / n) * (y.transpose() * y)).value();
-
-  double rSquared = (SSTO - SSE) / SSTO;
-  double adjRSquared = 1 - (1 - rSquared) * ((n - 1.0) / (n - 3));
+  return SolveOLS(X, y);
+}
 
-  return {{b.data(), b.data() + b.rows()}, adjRSquared};
+std::tuple<std::vector<double>, double> sysid::OLS(
+    const Eigen::Ref<const Eigen::MatrixXd>& X,
+    const Eigen::Ref<const Eigen::VectorXd>& y) {
+  assert(X.rows() == y.rows());
+  return SolveOLS(X, y);
 }
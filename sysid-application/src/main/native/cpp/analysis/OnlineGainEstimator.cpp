@@ -0,0 +1,256 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/OnlineGainEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <Eigen/Cholesky>
+
+#include "sysid/analysis/FilteringUtils.h"
+
+using namespace sysid;
+
+/**
+ * Evaluates a pointwise model term for a single point.
+ */
+static double EvaluatePointwiseTerm(ModelTerm term, const PreparedData& pt) {
+  switch (term) {
+    case ModelTerm::kGravity:
+      return EvaluateModelTerm<ModelTerm::kGravity>(pt);
+    case ModelTerm::kCosine:
+      return EvaluateModelTerm<ModelTerm::kCosine>(pt);
+    case ModelTerm::kDrag:
+      return EvaluateModelTerm<ModelTerm::kDrag>(pt);
+    default:
+      return EvaluateModelTerm<ModelTerm::kPosition>(pt);
+  }
+}
+
+OnlineGainEstimator::OnlineGainEstimator(const AnalysisType& type,
+                                         double unitsPerRotation,
+                                         std::string_view units,
+                                         int windowSize,
+                                         double motionThreshold)
+    : m_type{type},
+      m_unitsPerRotation{unitsPerRotation},
+      m_units{units},
+      m_radiansPerUnit{GetRadiansPerUnit(units)},
+      m_windowSize{windowSize},
+      m_motionThreshold{motionThreshold},
+      m_terms{GetDefaultModelTerms(type)} {
+  // Drivetrain sides and swerve modules are separate channels of the same
+  // model. The angular drivetrain uses its wheel velocities, which are close
+  // to the gyro rate times half the trackwidth that the analysis uses.
+  std::vector<ChannelColumns> columns;
+  if (type == analysis::kDrivetrain || type == analysis::kDrivetrainAngular) {
+    columns = {{1, 3, 5}, {2, 4, 6}};
+    m_directional = true;
+  } else if (analysis::IsSwerve(type)) {
+    for (size_t module = 0; module < analysis::kSwerveModuleCount; ++module) {
+      columns.push_back({1, 2 + 2 * module, 3 + 2 * module});
+    }
+    m_directional = true;
+  } else {
+    columns = {{1, 2, 3}};
+  }
+  for (auto&& channel : columns) {
+    m_channels.emplace_back(channel, windowSize);
+  }
+
+  Reset();
+}
+
+void OnlineGainEstimator::Reset() {
+  BeginRun();
+  auto size = static_cast<Eigen::Index>(3 + m_terms.size());
+  m_XtX = Eigen::MatrixXd::Zero(size, size);
+  m_Xty = Eigen::VectorXd::Zero(size);
+  m_yty = 0.0;
+  m_points = 0;
+}
+
+void OnlineGainEstimator::BeginRun() {
+  for (auto&& channel : m_channels) {
+    channel.filter.Reset();
+    channel.primed = false;
+    channel.raw.clear();
+    channel.filtered.clear();
+  }
+  m_hasLast = false;
+}
+
+void OnlineGainEstimator::AddSamples(wpi::span<const double> values,
+                                     size_t rowSize) {
+  if (rowSize < m_type.rawDataSize) {
+    return;
+  }
+  for (size_t i = 0; i + rowSize <= values.size(); i += rowSize) {
+    const double* row = values.data() + i;
+    double timestamp = row[0];
+    if (m_hasLast && (timestamp <= m_lastTimestamp ||
+                      timestamp - m_lastTimestamp > kMaxPeriod)) {
+      BeginRun();
+    }
+    m_hasLast = true;
+    m_lastTimestamp = timestamp;
+
+    for (auto&& channel : m_channels) {
+      AddPoint(channel, timestamp, row);
+    }
+  }
+}
+
+void OnlineGainEstimator::AddSamples(
+    const std::vector<std::vector<double>>& rows) {
+  for (auto&& row : rows) {
+    AddSamples(row, row.size());
+  }
+}
+
+void OnlineGainEstimator::AddPoint(Channel& channel, double timestamp,
+                                   const double* row) {
+  PreparedData pt{units::second_t{timestamp}, row[channel.columns.voltage],
+                  row[channel.columns.position] * m_unitsPerRotation,
+                  row[channel.columns.velocity] * m_unitsPerRotation};
+
+  // Load the median filter with the first velocity for accurate initial
+  // behavior, like the analysis does.
+  size_t step = m_windowSize / 2;
+  if (!channel.primed) {
+    for (size_t i = 0; i < step; ++i) {
+      channel.filter.Calculate(pt.velocity);
+    }
+    channel.primed = true;
+  }
+
+  // The median is the filtered velocity of the point in the middle of the
+  // window.
+  channel.raw.push_back(pt);
+  double median = channel.filter.Calculate(pt.velocity);
+  if (channel.raw.size() <= step) {
+    return;
+  }
+  auto filtered = channel.raw.front();
+  channel.raw.pop_front();
+  filtered.velocity = median;
+
+  channel.filtered.push_back(filtered);
+  if (channel.filtered.size() == 3) {
+    Accumulate(channel.filtered[0], channel.filtered[1], channel.filtered[2]);
+    channel.filtered.pop_front();
+  }
+}
+
+void OnlineGainEstimator::Accumulate(const PreparedData& prev,
+                                     PreparedData pt,
+                                     const PreparedData& next) {
+  double span = (next.timestamp - prev.timestamp).value();
+  if (span <= 0.0) {
+    return;
+  }
+  pt.acceleration = (next.velocity - prev.velocity) / span;
+
+  // Skip the points that the analysis trims or filters out.
+  if (std::abs(pt.voltage) <= 0 ||
+      std::abs(pt.velocity) < m_motionThreshold || pt.acceleration == 0.0) {
+    return;
+  }
+  if (m_directional) {
+    pt.voltage = std::copysign(pt.voltage, pt.velocity);
+  }
+  pt.cos = m_radiansPerUnit != 0.0 ? std::cos(pt.position * m_radiansPerUnit)
+                                   : 0.0;
+
+  Eigen::VectorXd x(m_XtX.rows());
+  x(0) = pt.velocity;
+  x(1) = pt.voltage;
+  x(2) = std::copysign(1.0, pt.velocity);
+  for (size_t j = 0; j < m_terms.size(); ++j) {
+    x(3 + j) = EvaluatePointwiseTerm(m_terms[j], pt);
+  }
+
+  m_XtX.selfadjointView<Eigen::Lower>().rankUpdate(x);
+  m_Xty += x * pt.acceleration;
+  m_yty += pt.acceleration * pt.acceleration;
+  ++m_points;
+}
+
+OnlineGainEstimator::Estimate OnlineGainEstimator::GetEstimate() const {
+  Estimate estimate;
+  estimate.points = m_points;
+
+  // Wait for a few points per coefficient, and for the points to excite every
+  // coefficient (e.g. both directions for the gravity term).
+  auto size = m_XtX.rows();
+  if (m_points < static_cast<size_t>(2 * size)) {
+    return estimate;
+  }
+  Eigen::MatrixXd XtX = m_XtX.selfadjointView<Eigen::Lower>();
+  Eigen::LDLT<Eigen::MatrixXd> ldlt{XtX};
+  if (ldlt.info() != Eigen::Success || !ldlt.isPositive() ||
+      ldlt.rcond() < 1e-12) {
+    return estimate;
+  }
+
+  Eigen::VectorXd coeffs = ldlt.solve(m_Xty);
+  double alpha = coeffs(0);  // -Kv/Ka
+  double beta = coeffs(1);   // 1/Ka
+  double gamma = coeffs(2);  // -Ks/Ka
+  if (beta == 0.0) {
+    return estimate;
+  }
+
+  // The residual sum of squares follows from the normal equations.
+  double rss = std::max(m_yty - coeffs.dot(m_Xty), 0.0);
+  double variance = rss / (m_points - size);
+  Eigen::MatrixXd covariance =
+      variance * ldlt.solve(Eigen::MatrixXd::Identity(size, size));
+
+  // Propagate the covariance of the coefficients to the gains with the
+  // Jacobian of the gains with respect to the coefficients.
+  double beta2 = beta * beta;
+  Eigen::MatrixXd J = Eigen::MatrixXd::Zero(size, size);
+  J(0, 1) = gamma / beta2;
+  J(0, 2) = -1 / beta;
+  J(1, 0) = -1 / beta;
+  J(1, 1) = alpha / beta2;
+  J(2, 1) = -1 / beta2;
+  estimate.gains = {-gamma / beta, -alpha / beta, 1 / beta};
+  for (Eigen::Index j = 3; j < size; ++j) {
+    double delta = coeffs(j);  // -K/Ka
+    J(j, 1) = delta / beta2;
+    J(j, j) = -1 / beta;
+    estimate.gains.push_back(-delta / beta);
+  }
+
+  Eigen::VectorXd gainVariance =
+      (J * covariance * J.transpose()).diagonal();
+  for (Eigen::Index j = 0; j < size; ++j) {
+    estimate.stddevs.push_back(std::sqrt(std::max(gainVariance(j), 0.0)));
+  }
+  return estimate;
+}
+
+std::vector<std::string> OnlineGainEstimator::GetGainNames() const {
+  std::vector<std::string> names{"Ks", "Kv", "Ka"};
+  for (auto&& term : m_terms) {
+    names.emplace_back(GetGainName(term));
+  }
+  return names;
+}
+
+bool OnlineGainEstimator::IsConverged(double tolerance) const {
+  auto estimate = GetEstimate();
+  if (estimate.gains.empty()) {
+    return false;
+  }
+  for (size_t i : {1, 2}) {
+    if (2 * estimate.stddevs[i] > tolerance * std::abs(estimate.gains[i])) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,499 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/RegressionSuite.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+#include <fmt/format.h>
+#include <units/time.h>
+#include <units/voltage.h>
+#include <wpi/StringMap.h>
+#include <wpi/fs.h>
+#include <wpi/raw_istream.h>
+#include <wpi/raw_ostream.h>
+
+#include "sysid/analysis/AnalysisManager.h"
+#include "sysid/analysis/MechanismDescriptor.h"
+#include "sysid/analysis/ModelTerms.h"
+
+using namespace sysid;
+
+static constexpr int kResultsVersion = 1;
+
+// The period of the synthetic captures in seconds.
+static constexpr double kSyntheticPeriod = 0.005;
+
+// The magnitude below which gains are compared absolutely rather than
+// relatively, so that gains that are almost zero don't fail on rounding.
+static constexpr double kMinGain = 1E-3;
+
+wpi::json sysid::MakeSyntheticCapture(const AnalysisType& type,
+                                      const std::vector<double>& gains,
+                                      std::string_view units, double noise,
+                                      unsigned int seed) {
+  bool drivetrain = type == analysis::kDrivetrain;
+  if (!drivetrain && type != analysis::kSimple &&
+      type != analysis::kElevator && type != analysis::kArm) {
+    throw std::runtime_error(
+        fmt::format("Can't simulate a {} capture", type.name));
+  }
+
+  return VisitDescriptor(type, [&](auto descriptor) {
+    using Descriptor = decltype(descriptor);
+    if (gains.size() != Descriptor::kGainCount) {
+      throw std::runtime_error(
+          fmt::format("A {} capture needs {} gains, not {}", type.name,
+                      Descriptor::kGainCount, gains.size()));
+    }
+    auto sim = Descriptor::MakeSim(gains);
+
+    // The noise is made from the raw output of the generator, which is the
+    // same on every platform unlike the standard distributions.
+    std::mt19937 generator{seed};
+    auto sample = [&] {
+      return noise * (2.0 * generator() / std::mt19937::max() - 1.0);
+    };
+
+    wpi::json json = {{"sysid", true},
+                      {"test", std::string{type.name}},
+                      {"units", units},
+                      {"unitsPerRotation", 1.0}};
+    double startTime = 0.0;
+    for (std::string key : AnalysisManager::kJsonDataKeys) {
+      bool fast = key.find("fast") != std::string::npos;
+      double sign = key.find("backward") != std::string::npos ? -1.0 : 1.0;
+      std::vector<std::vector<double>> rows;
+      sim.Reset();
+      startTime += 100.0;
+      for (int i = 0; i < (fast ? 600 : 2400); ++i) {
+        double t = i * kSyntheticPeriod;
+        double voltage = sign * (fast ? 7.0 : 0.25 * t);
+        double position = sim.GetPosition();
+        double velocity = sim.GetVelocity();
+        if (noise > 0) {
+          position = std::round(position * 4096) / 4096;
+          velocity += sample();
+        }
+        if (drivetrain) {
+          rows.push_back({startTime + t, voltage, voltage, position, position,
+                          velocity, velocity, 0.0, 0.0});
+        } else {
+          rows.push_back({startTime + t, voltage, position, velocity});
+        }
+        sim.Update(units::volt_t{voltage}, units::second_t{kSyntheticPeriod});
+      }
+      json[key] = rows;
+    }
+    return json;
+  });
+}
+
+/**
+ * Returns a synthetic regression case.
+ */
+static RegressionCase MakeSyntheticCase(std::string name,
+                                        const AnalysisType& type,
+                                        const std::vector<double>& gains,
+                                        std::string_view units,
+                                        double noise = 0,
+                                        unsigned int seed = 1) {
+  std::map<std::string, double> truth = {
+      {"Ks", gains[0]}, {"Kv", gains[1]}, {"Ka", gains[2]}};
+  auto terms = GetDefaultModelTerms(type);
+  for (size_t i = 0; i < terms.size(); ++i) {
+    truth[std::string{GetGainName(terms[i])}] = gains[3 + i];
+  }
+  return {std::move(name),
+          MakeSyntheticCapture(type, gains, units, noise, seed),
+          std::move(truth)};
+}
+
+std::vector<RegressionCase> sysid::MakeSyntheticCorpus() {
+  std::vector<RegressionCase> corpus;
+  corpus.push_back(MakeSyntheticCase("simple", analysis::kSimple,
+                                     {0.5, 2.0, 0.3}, "Rotations"));
+  corpus.push_back(MakeSyntheticCase("simple-noisy", analysis::kSimple,
+                                     {0.5, 2.0, 0.3}, "Rotations", 0.02));
+  corpus.push_back(MakeSyntheticCase("simple-high-ks", analysis::kSimple,
+                                     {1.0, 1.8, 0.35}, "Rotations"));
+  corpus.push_back(MakeSyntheticCase("simple-high-ks-noisy", analysis::kSimple,
+                                     {1.5, 1.8, 0.35}, "Rotations", 0.02, 4));
+  corpus.push_back(MakeSyntheticCase("drivetrain", analysis::kDrivetrain,
+                                     {0.6, 1.8, 0.35}, "Meters"));
+  corpus.push_back(MakeSyntheticCase("drivetrain-noisy",
+                                     analysis::kDrivetrain,
+                                     {0.6, 1.8, 0.35}, "Meters", 0.01, 2));
+  corpus.push_back(MakeSyntheticCase("drivetrain-high-ks",
+                                     analysis::kDrivetrain, {1.2, 2.0, 0.3},
+                                     "Meters"));
+  corpus.push_back(MakeSyntheticCase("drivetrain-high-ks-noisy",
+                                     analysis::kDrivetrain, {1.5, 2.0, 0.3},
+                                     "Meters", 0.01, 5));
+  corpus.push_back(MakeSyntheticCase("elevator", analysis::kElevator,
+                                     {0.5, 1.5, 0.2, 0.3}, "Meters"));
+  corpus.push_back(MakeSyntheticCase("arm", analysis::kArm,
+                                     {0.5, 1.0, 0.1, 0.6}, "Radians"));
+  corpus.push_back(MakeSyntheticCase("arm-noisy", analysis::kArm,
+                                     {0.5, 1.0, 0.1, 0.6}, "Radians", 0.02,
+                                     3));
+  return corpus;
+}
+
+RegressionCase sysid::LoadRegressionCase(std::string_view path) {
+  RegressionCase regressionCase;
+  regressionCase.name = fs::path{path}.filename().string();
+  {
+    std::error_code ec;
+    wpi::raw_fd_istream is{path, ec};
+    if (ec) {
+      throw std::runtime_error(fmt::format("Unable to read: {}", path));
+    }
+    try {
+      is >> regressionCase.capture;
+    } catch (const wpi::json::exception& e) {
+      throw std::runtime_error(
+          fmt::format("Unable to parse {}: {}", path, e.what()));
+    }
+  }
+  if (regressionCase.capture.contains("truth")) {
+    for (auto&& [name, value] : regressionCase.capture.at("truth").items()) {
+      regressionCase.truth[name] = value.get<double>();
+    }
+  }
+  return regressionCase;
+}
+
+/**
+ * Adds the squared errors of the velocity simulated with the feedforward
+ * model against the velocity of the tests, like the analyzer's RMSE.
+ *
+ * @param data       The raw data of the tests.
+ * @param startTimes The start times of the tests, where the model is reset.
+ * @param model      The simulation model.
+ * @param sum        The sum of the squared errors.
+ * @param count      The number of errors.
+ */
+template <typename Model>
+static void AddSquaredErrors(const std::vector<PreparedData>& data,
+                             const std::array<units::second_t, 4>& startTimes,
+                             Model model, double* sum, size_t* count) {
+  if (data.empty()) {
+    return;
+  }
+  model.Reset(data[0].position, data[0].velocity);
+  for (size_t i = 1; i < data.size(); ++i) {
+    const auto& now = data[i];
+    const auto& pre = data[i - 1];
+    if (std::find(startTimes.begin(), startTimes.end(), now.timestamp) !=
+        startTimes.end()) {
+      model.Reset(now.position, now.velocity);
+      continue;
+    }
+    model.Update(units::volt_t{pre.voltage}, pre.dt);
+    double error = model.GetVelocity() - now.velocity;
+    *sum += error * error;
+    ++*count;
+  }
+}
+
+RegressionResult sysid::RunRegressionCase(const RegressionCase& regressionCase,
+                                          const BatchSettings& settings,
+                                          int repeats, wpi::Logger& logger) {
+  using Clock = std::chrono::steady_clock;
+  constexpr double kInf = std::numeric_limits<double>::infinity();
+
+  // Cached results would skip the stages that are being timed.
+  auto batchSettings = settings;
+  batchSettings.cacheDirectory.clear();
+
+  // Loading includes parsing the capture, like opening a file does.
+  auto text = regressionCase.capture.dump();
+
+  RegressionResult result;
+  result.name = regressionCase.name;
+  result.load = kInf;
+  result.timings = {kInf, kInf};
+  for (int i = 0; i < std::max(repeats, 1); ++i) {
+    auto analysisSettings = batchSettings.analysis;
+    auto start = Clock::now();
+    AnalysisManager manager{wpi::json::parse(text), analysisSettings, logger};
+    std::chrono::duration<double> load = Clock::now() - start;
+    result.load = std::min(result.load, load.count());
+
+    AnalysisTimings timings;
+    auto gains = RunAnalysis(manager, analysisSettings, batchSettings, logger,
+                             &timings);
+    result.timings.prepare = std::min(result.timings.prepare, timings.prepare);
+    result.timings.calculate =
+        std::min(result.timings.calculate, timings.calculate);
+    if (i > 0) {
+      continue;
+    }
+
+    const auto& ffGains = std::get<0>(gains.ffGains);
+    auto terms = manager.GetModelTerms();
+    result.gains = {{"Ks", ffGains[0]}, {"Kv", ffGains[1]}, {"Ka", ffGains[2]}};
+    for (size_t j = 0; j < terms.size(); ++j) {
+      result.gains[std::string{GetGainName(terms[j])}] = ffGains[3 + j];
+    }
+
+    result.gainError = regressionCase.truth.empty()
+                           ? std::numeric_limits<double>::quiet_NaN()
+                           : 0.0;
+    for (auto&& [name, value] : regressionCase.truth) {
+      auto gain = result.gains.find(name);
+      if (gain == result.gains.end()) {
+        throw std::runtime_error(
+            fmt::format("{} wasn't identified, so it can't be compared with "
+                        "its true value",
+                        name));
+      }
+      result.gainError =
+          std::max(result.gainError, std::abs(gain->second - value) /
+                                         std::max(std::abs(value), kMinGain));
+    }
+
+    const auto& [rawSlow, rawFast] = manager.GetRawData();
+    auto startTimes = manager.GetStartTimes();
+    double sum = 0;
+    size_t count = 0;
+    VisitDescriptor(manager.GetAnalysisType(), [&](auto descriptor) {
+      auto sim = decltype(descriptor)::MakeSim(ffGains);
+      AddSquaredErrors(rawSlow, startTimes, sim, &sum, &count);
+      AddSquaredErrors(rawFast, startTimes, sim, &sum, &count);
+    });
+    result.rmse = count > 0 ? std::sqrt(sum / count) : 0.0;
+  }
+  return result;
+}
+
+std::vector<std::string> sysid::CompareResult(
+    const RegressionResult& result, const RegressionResult& baseline,
+    const RegressionThresholds& thresholds) {
+  std::vector<std::string> regressions;
+  for (auto&& [name, value] : baseline.gains) {
+    auto gain = result.gains.find(name);
+    if (gain == result.gains.end()) {
+      regressions.push_back(fmt::format("{} is no longer identified", name));
+    } else if (!(std::abs(gain->second - value) <=
+                 thresholds.gainChange * std::max(std::abs(value), kMinGain))) {
+      regressions.push_back(fmt::format("{} changed from {:.6g} to {:.6g}",
+                                        name, value, gain->second));
+    }
+  }
+
+  // Comparisons are written so that NaN results fail.
+  if (!std::isnan(baseline.gainError) &&
+      !(result.gainError <= baseline.gainError + thresholds.gainError)) {
+    regressions.push_back(fmt::format("The gain error rose from {:.3f}% to "
+                                      "{:.3f}%",
+                                      baseline.gainError * 100,
+                                      result.gainError * 100));
+  }
+  if (!(result.rmse <= baseline.rmse * (1 + thresholds.rmse))) {
+    regressions.push_back(fmt::format("The RMSE rose from {:.6g} to {:.6g}",
+                                      baseline.rmse, result.rmse));
+  }
+
+  if (thresholds.timeRatio > 0) {
+    auto checkTime = [&](std::string_view stage, double time,
+                         double baselineTime) {
+      if (!std::isnan(baselineTime) &&
+          time > baselineTime * thresholds.timeRatio + thresholds.timeSlack) {
+        regressions.push_back(
+            fmt::format("{} took {:.1f} ms instead of {:.1f} ms", stage,
+                        time * 1000, baselineTime * 1000));
+      }
+    };
+    // Baselines without timings only check the accuracy.
+    checkTime("Loading", result.load, baseline.load);
+    checkTime("Preparing", result.timings.prepare, baseline.timings.prepare);
+    checkTime("Calculating", result.timings.calculate,
+              baseline.timings.calculate);
+  }
+  return regressions;
+}
+
+/**
+ * Returns the results by case name.
+ */
+static wpi::StringMap<const RegressionResult*> IndexResults(
+    const std::vector<RegressionResult>& results) {
+  wpi::StringMap<const RegressionResult*> index;
+  for (auto&& result : results) {
+    index[result.name] = &result;
+  }
+  return index;
+}
+
+std::vector<std::string> sysid::CompareToBaseline(
+    const std::vector<RegressionResult>& results,
+    const std::vector<RegressionResult>& baseline,
+    const RegressionThresholds& thresholds) {
+  auto baselineIndex = IndexResults(baseline);
+  auto resultIndex = IndexResults(results);
+  std::vector<std::string> regressions;
+  for (auto&& result : results) {
+    auto it = baselineIndex.find(result.name);
+    if (it == baselineIndex.end()) {
+      continue;
+    }
+    for (auto&& regression : CompareResult(result, *it->second, thresholds)) {
+      regressions.push_back(fmt::format("{}: {}", result.name, regression));
+    }
+  }
+  for (auto&& result : baseline) {
+    if (resultIndex.count(result.name) == 0) {
+      regressions.push_back(fmt::format("{}: wasn't run", result.name));
+    }
+  }
+  return regressions;
+}
+
+std::string sysid::FormatRegressionTable(
+    const std::vector<RegressionResult>& results,
+    const std::vector<RegressionResult>& baseline,
+    const RegressionThresholds& thresholds) {
+  auto baselineIndex = IndexResults(baseline);
+  std::string table =
+      "| Case | Gain Error | RMSE | Load (ms) | Prepare (ms) | Calculate (ms) "
+      "| Status |\n"
+      "| --- | --- | --- | --- | --- | --- | --- |\n";
+
+  // Each metric is followed by its baseline value in parentheses.
+  for (auto&& result : results) {
+    auto it = baselineIndex.find(result.name);
+    const RegressionResult* base =
+        it != baselineIndex.end() ? it->second : nullptr;
+    auto cell = [&](double value, double baseValue, auto&& format) {
+      std::string text = std::isnan(value) ? "-" : format(value);
+      if (base) {
+        text += fmt::format(" ({})",
+                            std::isnan(baseValue) ? "-" : format(baseValue));
+      }
+      return text;
+    };
+    auto percent = [](double value) {
+      return fmt::format("{:.3f}%", value * 100);
+    };
+    auto rmse = [](double value) { return fmt::format("{:.4g}", value); };
+    auto ms = [](double value) { return fmt::format("{:.1f}", value * 1000); };
+
+    std::string status = "new";
+    if (base) {
+      status =
+          CompareResult(result, *base, thresholds).empty() ? "ok" : "REGRESSED";
+    }
+    table += fmt::format(
+        "| {} | {} | {} | {} | {} | {} | {} |\n", result.name,
+        cell(result.gainError, base ? base->gainError : 0, percent),
+        cell(result.rmse, base ? base->rmse : 0, rmse),
+        cell(result.load, base ? base->load : 0, ms),
+        cell(result.timings.prepare, base ? base->timings.prepare : 0, ms),
+        cell(result.timings.calculate, base ? base->timings.calculate : 0,
+             ms),
+        status);
+  }
+  return table;
+}
+
+wpi::json sysid::ToJSON(const std::vector<RegressionResult>& results,
+                        bool timings) {
+  wpi::json json;
+  json["sysidRegression"] = kResultsVersion;
+  auto& array = json["results"] = wpi::json::array();
+  for (auto&& result : results) {
+    wpi::json item = {
+        {"name", result.name}, {"gains", result.gains}, {"rmse", result.rmse}};
+    if (timings) {
+      item["load"] = result.load;
+      item["prepare"] = result.timings.prepare;
+      item["calculate"] = result.timings.calculate;
+    }
+    if (std::isnan(result.gainError)) {
+      item["gainError"] = nullptr;
+    } else {
+      item["gainError"] = result.gainError;
+    }
+    array.push_back(std::move(item));
+  }
+  return json;
+}
+
+std::vector<RegressionResult> sysid::RegressionResultsFromJSON(
+    const wpi::json& json) {
+  if (!json.is_object() || !json.contains("sysidRegression")) {
+    throw std::runtime_error("The JSON isn't a set of regression results");
+  }
+  if (auto version = json.at("sysidRegression").get<int>();
+      version != kResultsVersion) {
+    throw std::runtime_error(
+        fmt::format("Unsupported regression results version {}", version));
+  }
+  std::vector<RegressionResult> results;
+  try {
+    for (auto&& item : json.at("results")) {
+      RegressionResult result;
+      result.name = item.at("name").get<std::string>();
+      result.gains = item.at("gains").get<std::map<std::string, double>>();
+      const auto& gainError = item.at("gainError");
+      result.gainError = gainError.is_null()
+                             ? std::numeric_limits<double>::quiet_NaN()
+                             : gainError.get<double>();
+      result.rmse = item.at("rmse").get<double>();
+      auto time = [&](const char* key) {
+        return item.contains(key) ? item.at(key).get<double>()
+                                  : std::numeric_limits<double>::quiet_NaN();
+      };
+      result.load = time("load");
+      result.timings.prepare = time("prepare");
+      result.timings.calculate = time("calculate");
+      results.push_back(std::move(result));
+    }
+  } catch (const wpi::json::exception& e) {
+    throw std::runtime_error(
+        fmt::format("The regression results are malformed: {}", e.what()));
+  }
+  return results;
+}
+
+void sysid::SaveRegressionResults(const std::vector<RegressionResult>& results,
+                                  std::string_view path, bool timings) {
+  std::error_code ec;
+  wpi::raw_fd_ostream os{path, ec};
+  if (ec) {
+    throw std::runtime_error(
+        fmt::format("Unable to write {}: {}", path, ec.message()));
+  }
+  os << ToJSON(results, timings).dump(2);
+  os.flush();
+}
+
+std::vector<RegressionResult> sysid::LoadRegressionResults(
+    std::string_view path) {
+  std::error_code ec;
+  wpi::raw_fd_istream is{path, ec};
+  if (ec) {
+    throw std::runtime_error(
+        fmt::format("Unable to read {}: {}", path, ec.message()));
+  }
+  wpi::json json;
+  try {
+    is >> json;
+  } catch (const wpi::json::exception& e) {
+    throw std::runtime_error(
+        fmt::format("Unable to parse {}: {}", path, e.what()));
+  }
+  return RegressionResultsFromJSON(json);
+}
@@ -0,0 +1,380 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/ReportGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+#include <fmt/format.h>
+#include <units/time.h>
+#include <wpi/StringExtras.h>
+#include <wpi/fs.h>
+
+#include "sysid/Util.h"
+#include "sysid/analysis/FilteringUtils.h"
+#include "sysid/analysis/MechanismDescriptor.h"
+#include "sysid/analysis/ModelTerms.h"
+
+using namespace sysid;
+
+/**
+ * Simulates the velocity of each test from its first point with the
+ * feedforward model, like the analyzer does.
+ *
+ * @param data       The raw data of the tests.
+ * @param startTimes The start times of the tests, where the model is reset.
+ * @param model      The simulation model.
+ * @return The simulated velocity of each test.
+ */
+template <typename Model>
+static std::vector<std::vector<ChartPoint>> SimulateVelocity(
+    const std::vector<PreparedData>& data,
+    const std::array<units::second_t, 4>& startTimes, Model model) {
+  std::vector<std::vector<ChartPoint>> tests;
+  if (data.empty()) {
+    return tests;
+  }
+  tests.emplace_back();
+  tests.back().push_back({data[0].timestamp.value(), data[0].velocity});
+  model.Reset(data[0].position, data[0].velocity);
+  for (size_t i = 1; i < data.size(); ++i) {
+    const auto& now = data[i];
+    const auto& pre = data[i - 1];
+    if (std::find(startTimes.begin(), startTimes.end(), now.timestamp) !=
+        startTimes.end()) {
+      tests.emplace_back();
+      model.Reset(now.position, now.velocity);
+      continue;
+    }
+    model.Update(units::volt_t{pre.voltage}, pre.dt);
+    tests.back().push_back({now.timestamp.value(), model.GetVelocity()});
+  }
+  return tests;
+}
+
+/**
+ * Returns the timesteps of a dataset in milliseconds, leaving out the steps
+ * between tests.
+ *
+ * @param data       The dataset.
+ * @param startTimes The start times of the tests.
+ */
+static std::vector<ChartPoint> GetTimesteps(
+    const std::vector<PreparedData>& data,
+    const std::array<units::second_t, 4>& startTimes) {
+  std::vector<ChartPoint> points;
+  for (size_t i = 1; i < data.size(); ++i) {
+    if (data[i].dt > 0_s &&
+        std::find(startTimes.begin(), startTimes.end(), data[i].timestamp) ==
+            startTimes.end()) {
+      points.push_back({data[i].timestamp.value(),
+                        units::millisecond_t{data[i].dt}.value()});
+    }
+  }
+  return points;
+}
+
+/**
+ * Returns the points of a dataset, e.g. its velocity over time.
+ *
+ * @param data The dataset.
+ * @param x    The x value of a data point.
+ * @param y    The y value of a data point.
+ */
+template <typename X, typename Y>
+static std::vector<ChartPoint> GetPoints(const std::vector<PreparedData>& data,
+                                         X&& x, Y&& y) {
+  std::vector<ChartPoint> points;
+  points.reserve(data.size());
+  for (auto&& pt : data) {
+    points.push_back({x(pt), y(pt)});
+  }
+  return points;
+}
+
+std::vector<SvgChart> sysid::MakeReportCharts(
+    AnalysisManager& manager, const AnalysisManager::Gains& gains,
+    const AnalysisManager::Settings& settings) {
+  const auto& [slow, fast] = manager.GetFilteredData();
+  const auto& [rawSlow, rawFast] = manager.GetRawData();
+  auto startTimes = manager.GetStartTimes();
+  const auto& ffGains = std::get<0>(gains.ffGains);
+  auto terms = manager.GetModelTerms();
+  double Ks = ffGains[0];
+  double Kv = ffGains[1];
+  double Ka = ffGains[2];
+
+  auto abbreviation = GetAbbreviation(manager.GetUnit());
+  auto velocityLabel = fmt::format("Velocity ({} / s)", abbreviation);
+  auto accelerationLabel = fmt::format("Acceleration ({} / s^2)", abbreviation);
+
+  // The voltage contributed by the extra model terms (e.g. Kg or Kcos).
+  Eigen::VectorXd slowTermVoltages = CalculateTermVoltages(
+      terms, ffGains.data() + 3, slow, settings.modelTermParameters);
+  Eigen::VectorXd fastTermVoltages = CalculateTermVoltages(
+      terms, ffGains.data() + 3, fast, settings.modelTermParameters);
+
+  auto time = [](const PreparedData& pt) { return pt.timestamp.value(); };
+  auto velocity = [](const PreparedData& pt) { return pt.velocity; };
+  auto acceleration = [](const PreparedData& pt) { return pt.acceleration; };
+
+  std::vector<SvgChart> charts;
+
+  // The portion of the voltage that the fit attributes to velocity (or
+  // acceleration) against the velocity (or acceleration), with the fit.
+  {
+    auto& chart =
+        charts.emplace_back(kChartTitles[0], "Velocity-Portion Voltage (V)",
+                            "Quasistatic " + velocityLabel);
+    std::vector<ChartPoint> points;
+    for (size_t i = 0; i < slow.size(); ++i) {
+      points.push_back({slow[i].voltage - std::copysign(Ks, slow[i].velocity) -
+                            Ka * slow[i].acceleration - slowTermVoltages(i),
+                        slow[i].velocity});
+    }
+    chart.AddScatter("Filtered Data", points);
+    if (!slow.empty()) {
+      auto [min, max] = std::minmax_element(
+          slow.begin(), slow.end(),
+          [](auto& a, auto& b) { return a.velocity < b.velocity; });
+      chart.AddLine("Fit", {{Kv * min->velocity, min->velocity},
+                            {Kv * max->velocity, max->velocity}});
+    }
+  }
+  {
+    auto& chart = charts.emplace_back(kChartTitles[1],
+                                      "Acceleration-Portion Voltage (V)",
+                                      "Dynamic " + accelerationLabel);
+    std::vector<ChartPoint> points;
+    for (size_t i = 0; i < fast.size(); ++i) {
+      points.push_back({fast[i].voltage - std::copysign(Ks, fast[i].velocity) -
+                            Kv * fast[i].velocity - fastTermVoltages(i),
+                        fast[i].acceleration});
+    }
+    chart.AddScatter("Filtered Data", points);
+    if (!fast.empty()) {
+      auto [min, max] = std::minmax_element(
+          fast.begin(), fast.end(),
+          [](auto& a, auto& b) { return a.acceleration < b.acceleration; });
+      chart.AddLine("Fit", {{Ka * min->acceleration, min->acceleration},
+                            {Ka * max->acceleration, max->acceleration}});
+    }
+  }
+
+  // The time domain charts, with the simulated velocity.
+  std::vector<std::vector<ChartPoint>> slowSim;
+  std::vector<std::vector<ChartPoint>> fastSim;
+  VisitDescriptor(manager.GetAnalysisType(), [&](auto descriptor) {
+    auto sim = decltype(descriptor)::MakeSim(ffGains);
+    slowSim = SimulateVelocity(rawSlow, startTimes, sim);
+    fastSim = SimulateVelocity(rawFast, startTimes, sim);
+  });
+  auto addTimeChart = [&](const char* title, const std::string& label,
+                          const std::vector<PreparedData>& raw,
+                          const std::vector<PreparedData>& filtered,
+                          auto&& value,
+                          const std::vector<std::vector<ChartPoint>>* sim) {
+    auto& chart = charts.emplace_back(title, "Time (s)", label);
+    chart.AddScatter("Raw Data", GetPoints(raw, time, value));
+    chart.AddScatter("Filtered Data", GetPoints(filtered, time, value));
+    if (sim) {
+      for (auto&& test : *sim) {
+        chart.AddLine("Simulation", test);
+      }
+    }
+  };
+  addTimeChart(kChartTitles[2], velocityLabel, rawSlow, slow, velocity,
+               &slowSim);
+  addTimeChart(kChartTitles[3], accelerationLabel, rawSlow, slow,
+               acceleration, nullptr);
+  addTimeChart(kChartTitles[4], velocityLabel, rawFast, fast, velocity,
+               &fastSim);
+  addTimeChart(kChartTitles[5], accelerationLabel, rawFast, fast, acceleration,
+               nullptr);
+
+  {
+    auto& chart = charts.emplace_back(kChartTitles[6], "Time (s)",
+                                      "Timestep (ms)");
+    auto slowSteps = GetTimesteps(slow, startTimes);
+    auto fastSteps = GetTimesteps(fast, startTimes);
+    slowSteps.insert(slowSteps.end(), fastSteps.begin(), fastSteps.end());
+    chart.AddScatter("Timesteps", slowSteps);
+    if (!slow.empty() && !fast.empty()) {
+      units::millisecond_t mean = GetMeanTimeDelta(manager.GetFilteredData());
+      double start = std::min(slow.front().timestamp, fast.front().timestamp)
+                         .value();
+      double end =
+          std::max(slow.back().timestamp, fast.back().timestamp).value();
+      chart.AddLine("Mean", {{start, mean.value()}, {end, mean.value()}});
+    }
+  }
+
+  // The voltage that the model doesn't explain, which should look like noise.
+  auto addResidualChart = [&](std::string_view test,
+                              const std::vector<PreparedData>& data,
+                              const Eigen::VectorXd& termVoltages) {
+    auto& chart = charts.emplace_back(
+        fmt::format("{} Voltage Residuals vs. Time", test), "Time (s)",
+        "Residual (V)");
+    std::vector<ChartPoint> points;
+    for (size_t i = 0; i < data.size(); ++i) {
+      double predicted = std::copysign(Ks, data[i].velocity) +
+                         Kv * data[i].velocity + Ka * data[i].acceleration +
+                         termVoltages(i);
+      points.push_back(
+          {data[i].timestamp.value(), data[i].voltage - predicted});
+    }
+    chart.AddScatter("Residuals", points);
+  };
+  addResidualChart("Quasistatic", slow, slowTermVoltages);
+  addResidualChart("Dynamic", fast, fastTermVoltages);
+  return charts;
+}
+
+std::string sysid::GetReportPath(std::string_view path, ReportFormat format,
+                                 std::string_view directory) {
+  auto name = fs::path{path}.filename().string();
+  std::string_view stem = name;
+  if (wpi::ends_with(stem, ".json")) {
+    stem.remove_suffix(5);
+  }
+  auto filename = fmt::format(
+      "{}.report.{}", stem, format == ReportFormat::kHTML ? "html" : "md");
+  auto parent = directory.empty() ? fs::path{path}.parent_path()
+                                  : fs::path{directory};
+  return (parent / filename).string();
+}
+
+/**
+ * Escapes text for HTML.
+ *
+ * @param text The text.
+ */
+static std::string EscapeHTML(std::string_view text) {
+  std::string escaped;
+  for (char c : text) {
+    switch (c) {
+      case '<':
+        escaped += "&lt;";
+        break;
+      case '>':
+        escaped += "&gt;";
+        break;
+      case '&':
+        escaped += "&amp;";
+        break;
+      default:
+        escaped += c;
+    }
+  }
+  return escaped;
+}
+
+/**
+ * Writes a file through a temporary file so that readers never see a
+ * partial file.
+ *
+ * @param path     The path of the file.
+ * @param contents The contents of the file.
+ */
+static void WriteFile(const fs::path& path, std::string_view contents) {
+  auto tempPath = path;
+  tempPath += ".tmp";
+  SaveFile(contents, tempPath);
+  fs::rename(tempPath, path);
+}
+
+std::string sysid::WriteReport(std::string_view path,
+                               const BatchSettings& settings,
+                               ReportFormat format, std::string_view directory,
+                               wpi::Logger& logger) {
+  auto analysisSettings = settings.analysis;
+  AnalysisManager manager{path, analysisSettings, logger};
+  auto gains = RunAnalysis(manager, analysisSettings, settings, logger);
+  auto charts = MakeReportCharts(manager, gains, analysisSettings);
+
+  // The rows of the summary table.
+  auto unit = std::string{manager.GetUnit()};
+  std::vector<std::pair<std::string, std::string>> rows = {
+      {"Test", std::string{manager.GetAnalysisType().name}},
+      {"Dataset", settings.dataset},
+      {"Units", unit}};
+  const auto& ffGains = std::get<0>(gains.ffGains);
+  auto terms = manager.GetModelTerms();
+  static constexpr const char* kGainNames[] = {"Ks", "Kv", "Ka"};
+  for (size_t i = 0; i < ffGains.size(); ++i) {
+    rows.emplace_back(i < 3 ? kGainNames[i] : GetGainName(terms[i - 3]),
+                      fmt::format("{:.6g}", ffGains[i]));
+  }
+  rows.emplace_back("r-squared",
+                    fmt::format("{:.6g}", std::get<1>(gains.ffGains)));
+  bool isPosition =
+      analysisSettings.type == FeedbackControllerLoopType::kPosition;
+  rows.emplace_back("Loop Type", isPosition ? "Position" : "Velocity");
+  rows.emplace_back("Kp", fmt::format("{:.6g}", gains.fbGains.Kp));
+  rows.emplace_back("Kd", fmt::format("{:.6g}", gains.fbGains.Kd));
+  if (gains.trackWidth) {
+    rows.emplace_back("Track Width", fmt::format("{:.6g}", *gains.trackWidth));
+  }
+  rows.emplace_back(
+      "Motion Threshold",
+      fmt::format("{:.4g} {} / s", analysisSettings.motionThreshold,
+                  GetAbbreviation(unit)));
+  rows.emplace_back(
+      "Step Test Duration",
+      fmt::format("{:.4g} s", analysisSettings.stepTestDuration.value()));
+
+  auto reportPath = fs::path{GetReportPath(path, format, directory)};
+  auto name = fs::path{path}.filename().string();
+  fs::create_directories(reportPath.parent_path());
+  fmt::memory_buffer report;
+  auto out = std::back_inserter(report);
+  if (format == ReportFormat::kHTML) {
+    fmt::format_to(
+        out,
+        "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n"
+        "<title>SysId Report: {0}</title>\n"
+        "<style>body{{font-family:sans-serif;margin:2em}}"
+        "table{{border-collapse:collapse;margin-bottom:1em}}"
+        "td,th{{border:1px solid #ccc;padding:4px 8px;text-align:left}}"
+        "svg{{margin:4px}}</style>\n"
+        "</head>\n<body>\n<h1>SysId Report: {0}</h1>\n<table>\n",
+        EscapeHTML(name));
+    for (auto&& [label, value] : rows) {
+      fmt::format_to(out, "<tr><th>{}</th><td>{}</td></tr>\n",
+                     EscapeHTML(label), EscapeHTML(value));
+    }
+    fmt::format_to(out, "</table>\n<div>\n");
+    for (auto&& chart : charts) {
+      fmt::format_to(out, "{}", chart.Render());
+    }
+    fmt::format_to(out, "</div>\n</body>\n</html>\n");
+  } else {
+    // The charts are written to a directory next to the report.
+    auto chartDirectory = reportPath;
+    chartDirectory.replace_extension();
+    fs::create_directories(chartDirectory);
+    fmt::format_to(out, "# SysId Report: {}\n\n| | |\n|---|---|\n", name);
+    for (auto&& [label, value] : rows) {
+      fmt::format_to(out, "| {} | {} |\n", label, value);
+    }
+    fmt::format_to(out, "\n## Charts\n\n");
+    for (size_t i = 0; i < charts.size(); ++i) {
+      auto chartName = fmt::format("chart-{}.svg", i + 1);
+      WriteFile(chartDirectory / chartName, charts[i].Render());
+      fmt::format_to(out, "![{}]({}/{})\n\n", charts[i].GetTitle(),
+                     chartDirectory.filename().string(), chartName);
+    }
+  }
+  WriteFile(reportPath, fmt::to_string(report));
+  return reportPath.string();
+}
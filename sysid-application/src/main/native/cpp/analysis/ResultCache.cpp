@@ -0,0 +1,222 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/ResultCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fmt/core.h>
+#include <wpi/fs.h>
+#include <wpi/raw_ostream.h>
+
+#include "sysid/analysis/MappedFile.h"
+
+using namespace sysid;
+
+// Values are padded to this many bytes.
+static constexpr size_t kAlignment = 8;
+
+/**
+ * The header of a cache entry file, which is followed by the serialized entry.
+ */
+struct EntryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+  uint64_t key;
+  uint64_t size;
+  uint64_t checksum;
+};
+
+static_assert(sizeof(EntryHeader) % kAlignment == 0,
+              "The entry has to start aligned");
+
+static constexpr char kMagic[8] = "SYSIDRC";
+
+// The version of the file format. This has to be incremented whenever the
+// header changes; changes to the contents of entries are handled by the keys.
+static constexpr uint32_t kVersion = 1;
+
+static constexpr std::string_view kExtension = ".sysidcache";
+
+void Fnv1aHash::AddBytes(const void* data, size_t size) {
+  auto bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    m_hash ^= bytes[i];
+    m_hash *= 0x100000001b3;
+  }
+}
+
+void CacheWriter::Append(const void* data, size_t size) {
+  m_data.append(static_cast<const char*>(data), size);
+  m_data.resize((m_data.size() + kAlignment - 1) / kAlignment * kAlignment);
+}
+
+std::string CacheReader::ReadString() {
+  auto size = Read<uint64_t>();
+  if (size > m_size - m_pos) {
+    throw std::runtime_error("Truncated cache entry");
+  }
+  auto data = reinterpret_cast<const char*>(Consume(size));
+  return std::string{data, size};
+}
+
+const uint8_t* CacheReader::Consume(size_t size) {
+  const uint8_t* data = m_data + m_pos;
+  m_pos = std::min(m_size,
+                   (m_pos + size + kAlignment - 1) / kAlignment * kAlignment);
+  return data;
+}
+
+/**
+ * Returns the checksum of a serialized entry.
+ *
+ * @param data The serialized entry.
+ * @param size The size of the entry in bytes.
+ */
+static uint64_t Checksum(const void* data, size_t size) {
+  Fnv1aHash hash;
+  hash.AddBytes(data, size);
+  return hash.Get();
+}
+
+ResultCache::ResultCache(std::string_view directory, uintmax_t maxSize)
+    : m_directory{directory}, m_maxSize{maxSize} {}
+
+bool ResultCache::Load(uint64_t key,
+                       const std::function<void(CacheReader&)>& read) {
+  auto path = GetPath(key);
+  std::error_code ec;
+  if (!fs::exists(path, ec)) {
+    return false;
+  }
+
+  try {
+    MappedFile file{path};
+    EntryHeader header;
+    if (file.size() < sizeof(header)) {
+      throw std::runtime_error("Truncated cache entry");
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.version != kVersion || header.headerSize != sizeof(header) ||
+        header.key != key) {
+      throw std::runtime_error("Unsupported cache entry");
+    }
+    const uint8_t* data = file.data() + sizeof(header);
+    if (header.size != file.size() - sizeof(header) ||
+        header.checksum != Checksum(data, header.size)) {
+      throw std::runtime_error("Corrupt cache entry");
+    }
+    CacheReader reader{data, header.size};
+    read(reader);
+  } catch (const std::runtime_error&) {
+    // The entry is useless, so it's removed to make room for a new one.
+    fs::remove(path, ec);
+    return false;
+  }
+
+  // Mark the entry as recently used so that it's evicted last.
+  fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+  return true;
+}
+
+bool ResultCache::Store(uint64_t key, const CacheWriter& entry) {
+  std::error_code ec;
+  fs::create_directories(m_directory, ec);
+  if (ec) {
+    return false;
+  }
+
+  auto contents = entry.GetData();
+  EntryHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.headerSize = sizeof(header);
+  header.key = key;
+  header.size = contents.size();
+  header.checksum = Checksum(contents.data(), contents.size());
+
+  // Write to a temporary file first so that other processes never see a
+  // partially written entry.
+  auto path = GetPath(key);
+  auto tempPath = fmt::format(
+      "{}.{}.tmp", path,
+      std::chrono::steady_clock::now().time_since_epoch().count());
+  {
+    wpi::raw_fd_ostream os{tempPath, ec};
+    if (ec) {
+      return false;
+    }
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    os.write(contents.data(), contents.size());
+  }
+  if (fs::file_size(tempPath, ec) != sizeof(header) + contents.size()) {
+    fs::remove(tempPath, ec);
+    return false;
+  }
+  fs::rename(tempPath, path, ec);
+  if (ec) {
+    // The entry may be mapped by another process on Windows.
+    fs::remove(tempPath, ec);
+    return false;
+  }
+
+  Prune();
+  return true;
+}
+
+std::string ResultCache::GetPath(uint64_t key) const {
+  return (fs::path{m_directory} / fmt::format("{:016x}{}", key, kExtension))
+      .string();
+}
+
+void ResultCache::Prune() {
+  struct Entry {
+    fs::path path;
+    fs::file_time_type lastUsed;
+    uintmax_t size;
+  };
+  std::vector<Entry> entries;
+  uintmax_t totalSize = 0;
+
+  std::error_code ec;
+  for (auto&& file : fs::directory_iterator{m_directory, ec}) {
+    if (file.path().extension() != kExtension) {
+      continue;
+    }
+    Entry entry{file.path(), file.last_write_time(ec), file.file_size(ec)};
+    if (!ec) {
+      totalSize += entry.size;
+      entries.emplace_back(std::move(entry));
+    }
+  }
+
+  std::sort(entries.begin(), entries.end(), [](auto& a, auto& b) {
+    return a.lastUsed < b.lastUsed;
+  });
+  for (auto&& entry : entries) {
+    if (totalSize <= m_maxSize) {
+      break;
+    }
+    if (fs::remove(entry.path, ec)) {
+      totalSize -= entry.size;
+    }
+  }
+}
+
+std::string sysid::GetDefaultCacheDirectory() {
+  std::error_code ec;
+  auto directory = fs::temp_directory_path(ec);
+  if (ec) {
+    directory = fs::current_path(ec);
+  }
+  return (directory / "sysid-cache").string();
+}
@@ -0,0 +1,280 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/Segmentation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <wpi/StringMap.h>
+
+#include "sysid/analysis/AnalysisManager.h"
+
+using namespace sysid;
+
+static constexpr size_t kTimeCol = 0;
+
+/**
+ * A running least-squares fit of a line to the voltage of a segment. Times are
+ * stored relative to the start of the segment to keep the sums well
+ * conditioned on long captures.
+ */
+struct LineFit {
+  double t0 = 0.0;
+  double n = 0.0;
+  double st = 0.0;
+  double sv = 0.0;
+  double stt = 0.0;
+  double stv = 0.0;
+
+  void Reset(double start) { *this = LineFit{start}; }
+
+  void Add(double t, double v) {
+    t -= t0;
+    n += 1;
+    st += t;
+    sv += v;
+    stt += t * t;
+    stv += t * v;
+  }
+
+  double Slope() const {
+    double denominator = n * stt - st * st;
+    if (n < 2 || denominator <= 1e-12) {
+      return 0.0;
+    }
+    return (n * stv - st * sv) / denominator;
+  }
+
+  double Predict(double t) const {
+    if (n == 0) {
+      return 0.0;
+    }
+    double slope = Slope();
+    return (sv - slope * st) / n + slope * (t - t0);
+  }
+};
+
+const char* Segment::GetKey() const {
+  if (type == SegmentType::kQuasistatic) {
+    return forward ? "slow-forward" : "slow-backward";
+  } else {
+    return forward ? "fast-forward" : "fast-backward";
+  }
+}
+
+/**
+ * Classifies a voltage segment as a test, and ends it early if the mechanism
+ * stops.
+ *
+ * @param rows         The rows of the capture.
+ * @param voltageCol   The column of the voltage.
+ * @param velocityCol  The column of the velocity.
+ * @param lowerBound   The earliest row that a test may start at.
+ * @param begin        The first row of the segment.
+ * @param end          One past the last row of the segment.
+ * @param fit          The voltage fit of the segment.
+ * @param restVelocity The largest velocity that is considered to be at rest.
+ * @param settings     The segmentation thresholds.
+ * @param segments     Where to store the segment if it is a test.
+ */
+static void ClassifySegment(const std::vector<std::vector<double>>& rows,
+                            size_t voltageCol, size_t velocityCol,
+                            size_t lowerBound, size_t begin, size_t end,
+                            const LineFit& fit, double restVelocity,
+                            const SegmentationSettings& settings,
+                            std::vector<Segment>* segments) {
+  if (end - begin < 2) {
+    return;
+  }
+
+  double startTime = rows[begin][kTimeCol];
+  double duration = rows[end - 1][kTimeCol] - startTime;
+  double startVoltage = fit.Predict(startTime);
+  double endVoltage = fit.Predict(rows[end - 1][kTimeCol]);
+  double slope = fit.Slope();
+  double previousVoltage = begin > 0 ? rows[begin - 1][voltageCol] : 0.0;
+
+  Segment segment{SegmentType::kDynamic, true, begin, end};
+  if (std::abs(startVoltage) >= settings.minStepVoltage &&
+      std::abs(previousVoltage) <= settings.restVoltage &&
+      std::abs(slope) * duration <=
+          settings.maxStepDrift * std::abs(startVoltage)) {
+    segment.type = SegmentType::kDynamic;
+    segment.forward = startVoltage > 0;
+  } else if (std::abs(startVoltage) <= settings.restVoltage &&
+             std::abs(slope) >= settings.minRampRate &&
+             std::abs(slope) <= settings.maxRampRate &&
+             std::signbit(slope) == std::signbit(endVoltage)) {
+    segment.type = SegmentType::kQuasistatic;
+    segment.forward = slope > 0;
+
+    // A slow ramp only deviates from the preceding segment once it has risen
+    // past the voltage tolerance, so start the test where the fitted ramp
+    // crosses zero instead.
+    double zeroTime = startTime - startVoltage / slope;
+    while (segment.begin > lowerBound &&
+           rows[segment.begin - 1][kTimeCol] >= zeroTime) {
+      --segment.begin;
+    }
+  } else {
+    return;
+  }
+
+  // Every test starts with the mechanism at rest.
+  if (std::abs(rows[segment.begin][velocityCol]) > restVelocity) {
+    return;
+  }
+
+  // End the test once the mechanism has moved and then stopped again, or
+  // moves against the voltage. The mechanism must have clearly left rest
+  // before it can stop, so that noise around a slow ramp's velocity doesn't
+  // end the test.
+  bool moving = false;
+  for (size_t i = segment.begin; i < end; ++i) {
+    double velocity = rows[i][velocityCol];
+    bool against = segment.forward ? velocity < 0 : velocity > 0;
+    if (against && std::abs(velocity) > restVelocity) {
+      segment.end = i;
+      break;
+    }
+    if (std::abs(velocity) > 2 * restVelocity) {
+      moving = true;
+    } else if (moving && std::abs(velocity) <= restVelocity) {
+      segment.end = i;
+      break;
+    }
+  }
+
+  double minDuration = segment.type == SegmentType::kDynamic
+                           ? settings.minStepDuration
+                           : settings.minRampDuration;
+  if (segment.end > segment.begin &&
+      rows[segment.end - 1][kTimeCol] - rows[segment.begin][kTimeCol] >=
+          minDuration) {
+    segments->push_back(segment);
+  }
+}
+
+std::vector<Segment> sysid::SegmentCapture(
+    const std::vector<std::vector<double>>& rows, size_t voltageCol,
+    size_t velocityCol, const SegmentationSettings& settings) {
+  std::vector<Segment> segments;
+  if (rows.empty()) {
+    return segments;
+  }
+
+  size_t width = std::max(voltageCol, velocityCol) + 1;
+  double maxVelocity = 0.0;
+  for (auto&& row : rows) {
+    if (row.size() < width) {
+      throw std::runtime_error(fmt::format(
+          "Continuous capture rows need at least {} columns", width));
+    }
+    maxVelocity = std::max(maxVelocity, std::abs(row[velocityCol]));
+  }
+  double restVelocity = settings.restVelocityFraction * maxVelocity;
+
+  // Tests may extend back into the previous segment, but not past it.
+  size_t lowerBound = 0;
+  size_t begin = 0;
+  size_t outliers = 0;
+  size_t biasStart = 0;
+  size_t biasRun = 0;
+  bool biasPositive = false;
+  LineFit fit;
+  fit.Reset(rows[0][kTimeCol]);
+
+  for (size_t i = 0; i < rows.size(); ++i) {
+    double t = rows[i][kTimeCol];
+    double voltage = rows[i][voltageCol];
+    double predicted = fit.Predict(t);
+    double residual = voltage - predicted;
+    double tolerance =
+        std::max(settings.voltageTolerance,
+                 settings.relativeVoltageTolerance * std::abs(predicted));
+
+    // A slow ramp out of a long segment tilts the fit enough to stay within
+    // the tolerance, but leaves the residuals biased to one side.
+    if (fit.n >= 1 && std::abs(residual) > settings.biasFraction * tolerance) {
+      if (biasRun == 0 || biasPositive != (residual > 0)) {
+        biasStart = i;
+        biasRun = 0;
+        biasPositive = residual > 0;
+      }
+      ++biasRun;
+    } else {
+      biasRun = 0;
+    }
+
+    size_t changePoint = i + 1;
+    if (fit.n >= 1 && std::abs(residual) > tolerance) {
+      // Outliers aren't added to the fit unless they start a new segment.
+      if (++outliers < settings.breakSamples &&
+          biasRun < settings.biasSamples) {
+        continue;
+      }
+      changePoint = std::min(i + 1 - outliers, biasStart);
+    } else if (biasRun >= settings.biasSamples) {
+      changePoint = biasStart;
+    } else {
+      outliers = 0;
+      fit.Add(t, voltage);
+      continue;
+    }
+
+    ClassifySegment(rows, voltageCol, velocityCol, lowerBound, begin,
+                    changePoint, fit, restVelocity, settings, &segments);
+
+    lowerBound = std::max(begin, segments.empty() ? 0 : segments.back().end);
+    begin = changePoint;
+    fit.Reset(rows[begin][kTimeCol]);
+    for (size_t j = begin; j <= i; ++j) {
+      fit.Add(rows[j][kTimeCol], rows[j][voltageCol]);
+    }
+    outliers = 0;
+    biasRun = 0;
+  }
+  ClassifySegment(rows, voltageCol, velocityCol, lowerBound, begin,
+                  rows.size(), fit, restVelocity, settings, &segments);
+
+  return segments;
+}
+
+void sysid::SplitContinuousCapture(wpi::json* json, size_t voltageCol,
+                                   size_t velocityCol,
+                                   const SegmentationSettings& settings) {
+  auto& capture = *json;
+  auto rows = capture.at("continuous").get<std::vector<std::vector<double>>>();
+  auto segments = SegmentCapture(rows, voltageCol, velocityCol, settings);
+
+  // Sort the tests of each kind from longest to shortest so that the longest
+  // is used for the analysis.
+  wpi::StringMap<std::vector<Segment>> tests;
+  for (auto&& segment : segments) {
+    tests[segment.GetKey()].push_back(segment);
+  }
+  for (auto&& key : AnalysisManager::kJsonDataKeys) {
+    auto& found = tests[key];
+    if (found.empty()) {
+      throw std::runtime_error(
+          fmt::format("The continuous capture doesn't contain a {} test", key));
+    }
+    std::stable_sort(found.begin(), found.end(),
+                     [](const auto& a, const auto& b) {
+                       return a.end - a.begin > b.end - b.begin;
+                     });
+
+    for (size_t i = 0; i < found.size(); ++i) {
+      std::string name = i == 0 ? key : fmt::format("{}-{}", key, i + 1);
+      capture[name] = std::vector<std::vector<double>>(
+          rows.begin() + found[i].begin, rows.begin() + found[i].end);
+    }
+  }
+  capture.erase("continuous");
+}
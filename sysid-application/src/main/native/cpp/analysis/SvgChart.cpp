@@ -0,0 +1,293 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/SvgChart.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <iterator>
+#include <tuple>
+#include <utility>
+
+#include <fmt/format.h>
+
+using namespace sysid;
+
+// The colors of the series, in the order of their names.
+static constexpr const char* kColors[] = {"#1f77b4", "#ff7f0e", "#2ca02c",
+                                          "#d62728", "#9467bd", "#8c564b"};
+
+// The space around the plot area for the title, tick labels, and axis labels.
+static constexpr double kMarginLeft = 72;
+static constexpr double kMarginRight = 16;
+static constexpr double kMarginTop = 32;
+static constexpr double kMarginBottom = 48;
+
+// The number of ticks to aim for on each axis.
+static constexpr int kTickCount = 6;
+
+std::vector<ChartPoint> sysid::DecimatePoints(
+    const std::vector<ChartPoint>& points, size_t maxPoints, bool isLine) {
+  if (points.size() <= maxPoints) {
+    return points;
+  }
+
+  std::vector<ChartPoint> decimated;
+  decimated.reserve(maxPoints);
+  if (!isLine || maxPoints < 4) {
+    double stride = static_cast<double>(points.size()) / maxPoints;
+    for (size_t i = 0; i < maxPoints; ++i) {
+      decimated.push_back(points[static_cast<size_t>(i * stride)]);
+    }
+    return decimated;
+  }
+
+  // Keep the endpoints, and the lowest and highest points of each bucket in
+  // between.
+  size_t buckets = (maxPoints - 2) / 2;
+  double bucketSize = static_cast<double>(points.size() - 2) / buckets;
+  decimated.push_back(points.front());
+  for (size_t bucket = 0; bucket < buckets; ++bucket) {
+    auto begin = points.begin() + 1 + static_cast<size_t>(bucket * bucketSize);
+    auto end = points.begin() + 1 +
+               std::min(static_cast<size_t>((bucket + 1) * bucketSize),
+                        points.size() - 2);
+    if (begin >= end) {
+      continue;
+    }
+    auto [min, max] = std::minmax_element(
+        begin, end, [](auto& a, auto& b) { return a[1] < b[1]; });
+    if (min > max) {
+      std::swap(min, max);
+    }
+    decimated.push_back(*min);
+    if (max != min) {
+      decimated.push_back(*max);
+    }
+  }
+  decimated.push_back(points.back());
+  return decimated;
+}
+
+/**
+ * Escapes text for XML.
+ *
+ * @param text The text.
+ */
+static std::string EscapeXML(std::string_view text) {
+  std::string escaped;
+  for (char c : text) {
+    switch (c) {
+      case '<':
+        escaped += "&lt;";
+        break;
+      case '>':
+        escaped += "&gt;";
+        break;
+      case '&':
+        escaped += "&amp;";
+        break;
+      case '"':
+        escaped += "&quot;";
+        break;
+      default:
+        escaped += c;
+    }
+  }
+  return escaped;
+}
+
+/**
+ * Returns a tick step of 1, 2, or 5 times a power of ten that splits a range
+ * into about the given number of ticks.
+ *
+ * @param range The range of the axis.
+ * @param ticks The number of ticks.
+ */
+static double GetTickStep(double range, int ticks) {
+  double rough = range / ticks;
+  double magnitude = std::pow(10.0, std::floor(std::log10(rough)));
+  double normalized = rough / magnitude;
+  if (normalized < 1.5) {
+    return magnitude;
+  } else if (normalized < 3.5) {
+    return 2 * magnitude;
+  } else if (normalized < 7.5) {
+    return 5 * magnitude;
+  }
+  return 10 * magnitude;
+}
+
+/**
+ * Returns the range of an axis with some padding, so that the data doesn't
+ * touch the frame.
+ *
+ * @param min The smallest value of the data.
+ * @param max The largest value of the data.
+ */
+static std::pair<double, double> GetAxisRange(double min, double max) {
+  if (min > max) {
+    return {0.0, 1.0};
+  } else if (min == max) {
+    double pad = min == 0.0 ? 1.0 : std::abs(min) / 2;
+    return {min - pad, max + pad};
+  }
+  double pad = (max - min) * 0.05;
+  return {min - pad, max + pad};
+}
+
+SvgChart::SvgChart(std::string title, std::string xLabel, std::string yLabel)
+    : m_title{std::move(title)},
+      m_xLabel{std::move(xLabel)},
+      m_yLabel{std::move(yLabel)} {}
+
+void SvgChart::AddScatter(std::string_view name,
+                          const std::vector<ChartPoint>& points) {
+  m_series.push_back(
+      {std::string{name}, false, DecimatePoints(points, kMaxPoints, false)});
+}
+
+void SvgChart::AddLine(std::string_view name,
+                       const std::vector<ChartPoint>& points) {
+  m_series.push_back(
+      {std::string{name}, true, DecimatePoints(points, kMaxPoints, true)});
+}
+
+std::string SvgChart::Render(int width, int height) const {
+  // Fit the axes to the finite points.
+  double inf = std::numeric_limits<double>::infinity();
+  double xMin = inf, xMax = -inf, yMin = inf, yMax = -inf;
+  for (auto&& series : m_series) {
+    for (auto&& [x, y] : series.points) {
+      if (std::isfinite(x) && std::isfinite(y)) {
+        xMin = std::min(xMin, x);
+        xMax = std::max(xMax, x);
+        yMin = std::min(yMin, y);
+        yMax = std::max(yMax, y);
+      }
+    }
+  }
+  std::tie(xMin, xMax) = GetAxisRange(xMin, xMax);
+  std::tie(yMin, yMax) = GetAxisRange(yMin, yMax);
+
+  double left = kMarginLeft;
+  double right = width - kMarginRight;
+  double top = kMarginTop;
+  double bottom = height - kMarginBottom;
+  auto toX = [&](double x) {
+    return left + (x - xMin) / (xMax - xMin) * (right - left);
+  };
+  auto toY = [&](double y) {
+    return bottom - (y - yMin) / (yMax - yMin) * (bottom - top);
+  };
+
+  fmt::memory_buffer svg;
+  auto out = std::back_inserter(svg);
+  fmt::format_to(out,
+                 "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"{0}\" "
+                 "height=\"{1}\" viewBox=\"0 0 {0} {1}\" "
+                 "font-family=\"sans-serif\" font-size=\"11\">\n"
+                 "<rect width=\"{0}\" height=\"{1}\" fill=\"white\"/>\n",
+                 width, height);
+  fmt::format_to(out,
+                 "<text x=\"{}\" y=\"20\" text-anchor=\"middle\" "
+                 "font-size=\"13\" font-weight=\"bold\">{}</text>\n",
+                 (left + right) / 2, EscapeXML(m_title));
+
+  // Draw the grid and the tick labels.
+  auto drawTicks = [&](double min, double max, bool isX) {
+    double step = GetTickStep(max - min, kTickCount);
+    int decimals = std::max(0, -static_cast<int>(std::floor(std::log10(step))));
+    for (double tick = std::ceil(min / step) * step; tick <= max;
+         tick += step) {
+      // Avoid labels like "-0" and "0.30000000000000004".
+      double value = std::round(tick / step) * step;
+      auto label = fmt::format("{:.{}f}", value == 0.0 ? 0.0 : value, decimals);
+      if (isX) {
+        double x = toX(value);
+        fmt::format_to(out,
+                       "<line x1=\"{0:.1f}\" y1=\"{1:.1f}\" x2=\"{0:.1f}\" "
+                       "y2=\"{2:.1f}\" stroke=\"#e5e5e5\"/>\n"
+                       "<text x=\"{0:.1f}\" y=\"{3:.1f}\" "
+                       "text-anchor=\"middle\">{4}</text>\n",
+                       x, top, bottom, bottom + 15, label);
+      } else {
+        double y = toY(value);
+        fmt::format_to(out,
+                       "<line x1=\"{0:.1f}\" y1=\"{1:.1f}\" x2=\"{2:.1f}\" "
+                       "y2=\"{1:.1f}\" stroke=\"#e5e5e5\"/>\n"
+                       "<text x=\"{3:.1f}\" y=\"{4:.1f}\" "
+                       "text-anchor=\"end\">{5}</text>\n",
+                       left, y, right, left - 6, y + 4, label);
+      }
+    }
+  };
+  drawTicks(xMin, xMax, true);
+  drawTicks(yMin, yMax, false);
+  fmt::format_to(out,
+                 "<rect x=\"{:.1f}\" y=\"{:.1f}\" width=\"{:.1f}\" "
+                 "height=\"{:.1f}\" fill=\"none\" stroke=\"#444\"/>\n",
+                 left, top, right - left, bottom - top);
+  fmt::format_to(out,
+                 "<text x=\"{:.1f}\" y=\"{}\" text-anchor=\"middle\">"
+                 "{}</text>\n"
+                 "<text transform=\"translate(16,{:.1f}) rotate(-90)\" "
+                 "text-anchor=\"middle\">{}</text>\n",
+                 (left + right) / 2, height - 10, EscapeXML(m_xLabel),
+                 (top + bottom) / 2, EscapeXML(m_yLabel));
+
+  // Draw the series. Points are drawn as round dots on a single path, which
+  // keeps the document small.
+  std::vector<std::string_view> names;
+  for (auto&& series : m_series) {
+    auto name = std::find(names.begin(), names.end(), series.name);
+    if (name == names.end()) {
+      name = names.insert(names.end(), series.name);
+    }
+    const char* color = kColors[(name - names.begin()) % std::size(kColors)];
+
+    bool connect = false;
+    fmt::format_to(out, "<path fill=\"none\" stroke=\"{}\" ", color);
+    if (series.isLine) {
+      fmt::format_to(out, "stroke-width=\"1.5\" d=\"");
+    } else {
+      fmt::format_to(out, "stroke-width=\"3\" stroke-linecap=\"round\" d=\"");
+    }
+    for (auto&& [x, y] : series.points) {
+      if (!std::isfinite(x) || !std::isfinite(y)) {
+        connect = false;
+        continue;
+      }
+      if (series.isLine) {
+        fmt::format_to(out, "{}{:.1f} {:.1f}", connect ? "L" : "M", toX(x),
+                       toY(y));
+        connect = true;
+      } else {
+        fmt::format_to(out, "M{:.1f} {:.1f}h0", toX(x), toY(y));
+      }
+    }
+    fmt::format_to(out, "\"/>\n");
+  }
+
+  // Draw the legend in the top right corner of the plot area.
+  for (size_t i = 0; i < names.size(); ++i) {
+    double y = top + 14 + 14 * i;
+    fmt::format_to(out,
+                   "<rect x=\"{:.1f}\" y=\"{:.1f}\" width=\"10\" "
+                   "height=\"3\" fill=\"{}\"/>\n"
+                   "<text x=\"{:.1f}\" y=\"{:.1f}\" text-anchor=\"end\">"
+                   "{}</text>\n",
+                   right - 16, y - 4, kColors[i % std::size(kColors)],
+                   right - 20, y, EscapeXML(names[i]));
+  }
+  if (names.empty()) {
+    fmt::format_to(out,
+                   "<text x=\"{:.1f}\" y=\"{:.1f}\" text-anchor=\"middle\" "
+                   "fill=\"#888\">No data</text>\n",
+                   (left + right) / 2, (top + bottom) / 2);
+  }
+  fmt::format_to(out, "</svg>\n");
+  return fmt::to_string(svg);
+}
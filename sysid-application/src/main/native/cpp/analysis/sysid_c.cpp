@@ -0,0 +1,192 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/analysis/sysid_c.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <fmt/core.h>
+#include <wpi/Logger.h>
+#include <wpi/json.h>
+
+#include "sysid/analysis/AnalysisManager.h"
+#include "sysid/analysis/BatchAnalysis.h"
+#include "sysid/analysis/ModelTerms.h"
+
+using namespace sysid;
+
+// The sizes of the structs in the first version of the API, up to the end of
+// their last field. Callers that were built against it keep working as fields
+// are added, so these must not change.
+static constexpr size_t kMinSettingsSize =
+    offsetof(SysId_Settings, useKalmanSmoother) + sizeof(int);
+static constexpr size_t kMinResultSize =
+    offsetof(SysId_Result, stepTestDuration) + sizeof(double);
+
+// The message of the last error on each thread.
+static thread_local std::string gLastError;
+
+/**
+ * Converts C settings to batch settings, which validates them the same way as
+ * the settings of the other headless interfaces.
+ *
+ * @param settings The C settings.
+ */
+static BatchSettings ToBatchSettings(const SysId_Settings& settings) {
+  wpi::json json = {
+      {"loopType",
+       settings.loopType == SYSID_LOOP_POSITION ? "Position" : "Velocity"},
+      {"lqr",
+       {{"qp", settings.lqrQp}, {"qv", settings.lqrQv}, {"r", settings.lqrR}}},
+      {"autoTune", settings.autoTune != 0},
+      {"motionThreshold", settings.motionThreshold},
+      {"stepTestDuration", settings.stepTestDuration},
+      {"windowSize", settings.windowSize},
+      {"useKalmanSmoother", settings.useKalmanSmoother != 0}};
+  if (settings.preset) {
+    json["preset"] = settings.preset;
+  }
+  if (settings.dataset) {
+    json["dataset"] = settings.dataset;
+  }
+  return ParseBatchSettings(json);
+}
+
+/**
+ * Returns the default settings.
+ */
+static SysId_Settings GetDefaultSettings() {
+  BatchSettings defaults;
+  const auto& analysis = defaults.analysis;
+  SysId_Settings settings{};
+  settings.structSize = sizeof(SysId_Settings);
+  settings.loopType = analysis.type == FeedbackControllerLoopType::kPosition
+                          ? SYSID_LOOP_POSITION
+                          : SYSID_LOOP_VELOCITY;
+  settings.lqrQp = analysis.lqr.qp;
+  settings.lqrQv = analysis.lqr.qv;
+  settings.lqrR = analysis.lqr.r;
+  settings.autoTune = defaults.autoTune;
+  settings.motionThreshold = analysis.motionThreshold;
+  settings.stepTestDuration = analysis.stepTestDuration.value();
+  settings.windowSize = analysis.windowSize;
+  settings.useKalmanSmoother = analysis.useKalmanSmoother;
+  return settings;
+}
+
+extern "C" {
+
+int SysId_GetAPIVersion(void) {
+  return SYSID_API_VERSION;
+}
+
+void SysId_InitSettings(struct SysId_Settings* settings, size_t structSize) {
+  if (!settings || structSize < sizeof(uint32_t)) {
+    return;
+  }
+  // Callers that were built against an older header have smaller structs.
+  auto defaults = GetDefaultSettings();
+  std::memcpy(settings, &defaults, std::min(structSize, sizeof(defaults)));
+  settings->structSize = static_cast<uint32_t>(structSize);
+}
+
+int SysId_Analyze(const char* test, const char* unit, double unitsPerRotation,
+                  const struct SysId_Test tests[4],
+                  const struct SysId_Settings* settings,
+                  struct SysId_Result* result) {
+  gLastError.clear();
+  if (!test || !unit || !tests || !result) {
+    gLastError = "The test, unit, tests, and result can't be null";
+    return SYSID_INVALID_ARGUMENT;
+  }
+  if (result->structSize < kMinResultSize ||
+      (settings && settings->structSize < kMinSettingsSize)) {
+    gLastError = "The struct sizes aren't set";
+    return SYSID_INVALID_ARGUMENT;
+  }
+
+  // Fields that the caller doesn't know about keep their defaults.
+  auto cSettings = GetDefaultSettings();
+  if (settings) {
+    std::memcpy(&cSettings, settings,
+                std::min<size_t>(settings->structSize, sizeof(cSettings)));
+  }
+
+  BatchSettings batchSettings;
+  std::array<AnalysisManager::Columns, 4> columns;
+  try {
+    batchSettings = ToBatchSettings(cSettings);
+    for (size_t i = 0; i < columns.size(); ++i) {
+      const auto& cTest = tests[i];
+      const char* key = AnalysisManager::kJsonDataKeys[i];
+      if (cTest.columnCount > 0 && !cTest.columns) {
+        throw std::invalid_argument(
+            fmt::format("The columns of the {} test are null", key));
+      } else if (cTest.size < 2) {
+        throw std::invalid_argument(
+            fmt::format("The {} test needs at least two rows", key));
+      }
+      columns[i].columns.assign(cTest.columns,
+                                cTest.columns + cTest.columnCount);
+      columns[i].size = cTest.size;
+    }
+  } catch (const std::exception& e) {
+    gLastError = e.what();
+    return SYSID_INVALID_ARGUMENT;
+  }
+
+  SysId_Result output{};
+  try {
+    // Nothing is logged; errors are reported through the return value.
+    wpi::Logger logger;
+    auto analysisSettings = batchSettings.analysis;
+    AnalysisManager manager{test, unit, unitsPerRotation, std::move(columns),
+                            analysisSettings, logger};
+    auto gains = RunAnalysis(manager, analysisSettings, batchSettings, logger);
+
+    const auto& ffGains = std::get<0>(gains.ffGains);
+    auto terms = manager.GetModelTerms();
+    if (ffGains.size() > SYSID_MAX_GAINS) {
+      throw std::runtime_error("There are too many feedforward gains");
+    }
+    static constexpr const char* kGainNames[] = {"Ks", "Kv", "Ka"};
+    output.gainCount = ffGains.size();
+    for (size_t i = 0; i < ffGains.size(); ++i) {
+      output.gains[i] = ffGains[i];
+      // The gain names are string literals.
+      output.gainNames[i] =
+          i < 3 ? kGainNames[i] : GetGainName(terms[i - 3]).data();
+    }
+    output.rSquared = std::get<1>(gains.ffGains);
+    output.kp = gains.fbGains.Kp;
+    output.kd = gains.fbGains.Kd;
+    output.trackWidth =
+        gains.trackWidth.value_or(std::numeric_limits<double>::quiet_NaN());
+    output.motionThreshold = analysisSettings.motionThreshold;
+    output.stepTestDuration = analysisSettings.stepTestDuration.value();
+  } catch (const std::exception& e) {
+    gLastError = e.what();
+    return SYSID_ANALYSIS_FAILED;
+  }
+
+  output.structSize = result->structSize;
+  std::memcpy(result, &output,
+              std::min<size_t>(result->structSize, sizeof(output)));
+  return SYSID_OK;
+}
+
+const char* SysId_GetLastError(void) {
+  return gLastError.c_str();
+}
+
+}  // extern "C"
@@ -70,6 +70,7 @@ wpi::json ConfigManager::Generate(size_t occupied) {
   json["velocity measurement period"] = m_config.period;
 
   json["is drivetrain"] = m_config.isDrive;
+  json["log motor channels"] = m_config.logMotorChannels && !m_config.isDrive;
 
   // Return JSON.
   return json;
@@ -161,6 +162,9 @@ void ConfigManager::ReadJSON(std::string_view path) {
   m_config.period = json_file.at("velocity measurement period").get<int>();
 
   m_config.isDrive = json_file.at("is drivetrain").get<bool>();
+
+  // Older configs don't have per-motor channels.
+  m_config.logMotorChannels = json_file.value("log motor channels", false);
 }
 
 void ConfigManager::SaveJSON(std::string_view path, size_t occupied) {
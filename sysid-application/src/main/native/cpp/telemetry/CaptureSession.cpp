@@ -0,0 +1,129 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/telemetry/CaptureSession.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <ntcore_cpp.h>
+#include <wpi/StringExtras.h>
+
+using namespace sysid;
+
+CaptureSession::CaptureSession(std::string_view name, wpi::Logger& logger)
+    : m_name{name},
+      m_logger{logger},
+      m_instance{nt::CreateInstance()},
+      m_ownsInstance{true} {
+  nt::SetNetworkIdentity(m_instance, "sysid");
+  Start();
+}
+
+CaptureSession::CaptureSession(std::string_view name, wpi::Logger& logger,
+                               NT_Inst instance)
+    : m_name{name},
+      m_logger{logger},
+      m_instance{instance},
+      m_ownsInstance{false} {
+  Start();
+}
+
+CaptureSession::~CaptureSession() {
+  m_running = false;
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+  m_manager.reset();
+  if (m_ownsInstance) {
+    nt::DestroyInstance(m_instance);
+  }
+}
+
+void CaptureSession::Start() {
+  m_threadLogger.SetLogger([this](unsigned int level, const char* file,
+                                  unsigned int line, const char* msg) {
+    std::scoped_lock lock{m_logMutex};
+    m_logs.push_back({level, file, line, msg});
+  });
+  m_threadLogger.set_min_level(m_logger.min_level());
+  Reset();
+
+  m_thread = std::thread{[this] {
+    auto next = std::chrono::steady_clock::now();
+    while (m_running) {
+      {
+        std::scoped_lock lock{m_mutex};
+        m_manager->Update();
+      }
+      next += kUpdatePeriod;
+      std::this_thread::sleep_until(next);
+    }
+  }};
+}
+
+void CaptureSession::Connect(std::string_view server) {
+  if (!m_ownsInstance) {
+    throw std::logic_error{"The NT instance of the session is shared"};
+  }
+  m_server = server;
+  nt::StopClient(m_instance);
+  if (auto team = wpi::parse_integer<unsigned int>(server, 10)) {
+    nt::StartClientTeam(m_instance, *team, NT_DEFAULT_PORT);
+  } else {
+    nt::StartClient(m_instance, m_server.c_str(), NT_DEFAULT_PORT);
+  }
+}
+
+bool CaptureSession::IsConnected() const {
+  return nt::IsConnected(m_instance);
+}
+
+size_t CaptureSession::GetCompletedTests() const {
+  size_t completed = 0;
+  for (auto test :
+       {"slow-forward", "slow-backward", "fast-forward", "fast-backward"}) {
+    if (m_manager->HasRunTest(test)) {
+      ++completed;
+    }
+  }
+  // A test that is still running has been registered already.
+  if (m_manager->IsActive()) {
+    --completed;
+  }
+  return completed;
+}
+
+void CaptureSession::Reset() {
+  m_settings = TelemetryManager::Settings{};
+  m_manager = std::make_unique<TelemetryManager>(m_settings, m_threadLogger,
+                                                 m_instance);
+  m_manager->RegisterDisplayCallback(
+      [this](auto message) { m_message = message; });
+  m_message.clear();
+}
+
+std::string CaptureSession::SaveJSON(std::string_view location) {
+  // Only keep characters that are safe in file names.
+  std::string name = m_name;
+  std::replace_if(
+      name.begin(), name.end(),
+      [](unsigned char c) { return !std::isalnum(c) && c != '-' && c != '_'; },
+      '-');
+  return m_manager->SaveJSON(location, name);
+}
+
+void CaptureSession::Update() {
+  std::vector<LogMessage> logs;
+  {
+    std::scoped_lock lock{m_logMutex};
+    logs.swap(m_logs);
+  }
+  for (auto&& log : logs) {
+    auto msg = fmt::format("{}: {}", m_name, log.msg);
+    m_logger.DoLog(log.level, log.file, log.line, msg.c_str());
+  }
+}
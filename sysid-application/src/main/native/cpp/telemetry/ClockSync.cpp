@@ -0,0 +1,64 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/telemetry/ClockSync.h"
+
+#include <algorithm>
+
+using namespace sysid;
+
+void ClockSync::AddSample(const Sample& sample) {
+  if (sample.GetRoundTrip() < 0) {
+    return;
+  }
+  m_samples.push_back(sample);
+
+  auto begin = m_samples.end() -
+               std::min<ptrdiff_t>(m_samples.size(), kWindowSize);
+  auto best = std::min_element(begin, m_samples.end(), [](auto& a, auto& b) {
+    return a.GetRoundTrip() < b.GetRoundTrip();
+  });
+
+  double maxRoundTrip = 0;
+  double sumRoundTrip = 0;
+  for (auto it = begin; it != m_samples.end(); ++it) {
+    maxRoundTrip = std::max(maxRoundTrip, it->GetRoundTrip());
+    sumRoundTrip += it->GetRoundTrip();
+  }
+
+  m_estimate = Estimate{
+      units::second_t{best->robotTime -
+                      (best->hostSend + best->hostReceive) / 2},
+      units::second_t{best->GetRoundTrip()},
+      units::second_t{sumRoundTrip / (m_samples.end() - begin)},
+      units::second_t{maxRoundTrip}};
+}
+
+std::optional<units::second_t> ClockSync::ToRobotTime(
+    units::second_t hostTime) const {
+  if (!m_estimate) {
+    return std::nullopt;
+  }
+  return hostTime + m_estimate->offset;
+}
+
+void ClockSync::Reset() {
+  m_samples.clear();
+  m_estimate.reset();
+}
+
+wpi::json ClockSync::ToJSON() const {
+  wpi::json json;
+  if (m_estimate) {
+    json["offset"] = m_estimate->offset.value();
+    json["minRoundTrip"] = m_estimate->minRoundTrip.value();
+    json["meanRoundTrip"] = m_estimate->meanRoundTrip.value();
+    json["maxRoundTrip"] = m_estimate->maxRoundTrip.value();
+  }
+  auto& samples = json["samples"] = wpi::json::array();
+  for (auto&& sample : m_samples) {
+    samples.push_back({sample.hostSend, sample.robotTime, sample.hostReceive});
+  }
+  return json;
+}
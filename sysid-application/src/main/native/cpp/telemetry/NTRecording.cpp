@@ -0,0 +1,292 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/telemetry/NTRecording.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <fmt/format.h>
+#include <wpi/Base64.h>
+#include <wpi/raw_istream.h>
+#include <wpi/raw_ostream.h>
+#include <wpi/timestamp.h>
+
+using namespace sysid;
+
+static constexpr int kRecordingVersion = 1;
+
+static wpi::json ValueToJSON(const nt::Value& value) {
+  switch (value.type()) {
+    case NT_BOOLEAN:
+      return {{"type", "boolean"}, {"value", value.GetBoolean()}};
+    case NT_DOUBLE:
+      return {{"type", "double"}, {"value", value.GetDouble()}};
+    case NT_STRING:
+      return {{"type", "string"}, {"value", value.GetString()}};
+    case NT_RAW: {
+      std::string encoded;
+      wpi::Base64Encode(value.GetRaw(), &encoded);
+      return {{"type", "raw"}, {"value", encoded}};
+    }
+    case NT_BOOLEAN_ARRAY: {
+      auto array = value.GetBooleanArray();
+      std::vector<bool> values(array.begin(), array.end());
+      return {{"type", "boolean[]"}, {"value", values}};
+    }
+    case NT_DOUBLE_ARRAY: {
+      auto array = value.GetDoubleArray();
+      std::vector<double> values(array.begin(), array.end());
+      return {{"type", "double[]"}, {"value", values}};
+    }
+    case NT_STRING_ARRAY: {
+      auto array = value.GetStringArray();
+      std::vector<std::string> values(array.begin(), array.end());
+      return {{"type", "string[]"}, {"value", values}};
+    }
+    default:
+      return nullptr;
+  }
+}
+
+static std::shared_ptr<nt::Value> ValueFromJSON(const wpi::json& json) {
+  auto type = json.at("type").get<std::string>();
+  const auto& value = json.at("value");
+  if (type == "boolean") {
+    return nt::Value::MakeBoolean(value.get<bool>());
+  } else if (type == "double") {
+    return nt::Value::MakeDouble(value.get<double>());
+  } else if (type == "string") {
+    return nt::Value::MakeString(value.get<std::string>());
+  } else if (type == "raw") {
+    std::string decoded;
+    wpi::Base64Decode(value.get<std::string>(), &decoded);
+    return nt::Value::MakeRaw(decoded);
+  } else if (type == "boolean[]") {
+    auto values = value.get<std::vector<bool>>();
+    std::vector<int> ints(values.begin(), values.end());
+    return nt::Value::MakeBooleanArray(ints);
+  } else if (type == "double[]") {
+    return nt::Value::MakeDoubleArray(value.get<std::vector<double>>());
+  } else if (type == "string[]") {
+    return nt::Value::MakeStringArray(value.get<std::vector<std::string>>());
+  }
+  throw std::runtime_error{fmt::format("Unknown value type {}", type)};
+}
+
+wpi::json sysid::ToJSON(const NTRecording& recording) {
+  wpi::json json;
+  json["sysidRecording"] = kRecordingVersion;
+  auto& events = json["events"] = wpi::json::array();
+  for (auto&& event : recording.events) {
+    auto value = ValueToJSON(*event.value);
+    if (value.is_null()) {
+      continue;
+    }
+    value["time"] = event.time;
+    value["name"] = event.name;
+    value["local"] = event.local;
+    value["initial"] = event.initial;
+    events.push_back(std::move(value));
+  }
+  return json;
+}
+
+NTRecording sysid::NTRecordingFromJSON(const wpi::json& json) {
+  if (!json.is_object() || !json.contains("sysidRecording")) {
+    throw std::runtime_error{"The JSON isn't an NT recording"};
+  }
+  if (auto version = json.at("sysidRecording").get<int>();
+      version != kRecordingVersion) {
+    throw std::runtime_error{
+        fmt::format("Unsupported NT recording version {}", version)};
+  }
+  NTRecording recording;
+  try {
+    for (auto&& event : json.at("events")) {
+      recording.events.push_back({event.at("time").get<double>(),
+                                  event.at("name").get<std::string>(),
+                                  ValueFromJSON(event),
+                                  event.value("local", false),
+                                  event.value("initial", false)});
+    }
+  } catch (const wpi::json::exception& e) {
+    throw std::runtime_error{
+        fmt::format("The NT recording is malformed: {}", e.what())};
+  }
+  std::stable_sort(
+      recording.events.begin(), recording.events.end(),
+      [](const auto& a, const auto& b) { return a.time < b.time; });
+  return recording;
+}
+
+void sysid::SaveRecording(const NTRecording& recording,
+                          std::string_view path) {
+  std::error_code ec;
+  wpi::raw_fd_ostream os{path, ec};
+  if (ec) {
+    throw std::runtime_error{
+        fmt::format("Unable to write {}: {}", path, ec.message())};
+  }
+  os << ToJSON(recording);
+  os.flush();
+}
+
+NTRecording sysid::LoadRecording(std::string_view path) {
+  std::error_code ec;
+  wpi::raw_fd_istream is{path, ec};
+  if (ec) {
+    throw std::runtime_error{
+        fmt::format("Unable to read {}: {}", path, ec.message())};
+  }
+  wpi::json json;
+  try {
+    is >> json;
+  } catch (const wpi::json::exception& e) {
+    throw std::runtime_error{
+        fmt::format("Unable to parse {}: {}", path, e.what())};
+  }
+  return NTRecordingFromJSON(json);
+}
+
+NTRecorder::NTRecorder(NT_Inst instance, std::string_view prefix)
+    : m_poller{nt::CreateEntryListenerPoller(instance)},
+      m_start{wpi::Now() * 1E-6} {
+  nt::AddPolledEntryListener(m_poller, prefix,
+                             NT_NOTIFY_IMMEDIATE | NT_NOTIFY_NEW |
+                                 NT_NOTIFY_UPDATE | NT_NOTIFY_LOCAL);
+  Update();
+}
+
+NTRecorder::~NTRecorder() {
+  nt::DestroyEntryListenerPoller(m_poller);
+}
+
+void NTRecorder::Update() {
+  bool timedOut = false;
+  for (auto&& event : nt::PollEntryListener(m_poller, 0, &timedOut)) {
+    if (!event.value) {
+      continue;
+    }
+    bool initial = event.flags & NT_NOTIFY_IMMEDIATE;
+
+    // Values carry the time at which they were set or arrived, which is more
+    // precise than the time at which they are polled. Initial values were set
+    // before the recording started.
+    double time = 0;
+    if (!initial) {
+      uint64_t change = event.value->last_change();
+      time = (change != 0 ? change : wpi::Now()) * 1E-6 - m_start;
+    }
+    if (!m_recording.events.empty()) {
+      time = std::max(time, m_recording.events.back().time);
+    }
+    m_recording.events.push_back({time, event.name, event.value,
+                                  (event.flags & NT_NOTIFY_LOCAL) != 0,
+                                  initial});
+  }
+}
+
+NTReplayer::NTReplayer(NT_Inst instance, const NTRecording& recording,
+                       std::vector<std::string> gates)
+    : m_instance{instance},
+      m_recording{recording},
+      m_gates{std::move(gates)},
+      m_gatePoller{nt::CreateEntryListenerPoller(instance)} {
+  for (auto&& gate : m_gates) {
+    nt::AddPolledEntryListener(
+        m_gatePoller, nt::GetEntry(m_instance, gate),
+        NT_NOTIFY_NEW | NT_NOTIFY_UPDATE | NT_NOTIFY_LOCAL);
+  }
+}
+
+NTReplayer::~NTReplayer() {
+  nt::DestroyEntryListenerPoller(m_gatePoller);
+}
+
+bool NTReplayer::IsGate(const std::string& name) const {
+  return std::find(m_gates.begin(), m_gates.end(), name) != m_gates.end();
+}
+
+bool NTReplayer::Publish(const NTRecordedEvent& event) {
+  if (event.local || IsGate(event.name)) {
+    return false;
+  }
+  auto& entry = m_entries[event.name];
+  if (entry == 0) {
+    entry = nt::GetEntry(m_instance, event.name);
+  }
+  // Entries may have been created with another type on the instance.
+  nt::SetEntryTypeValue(entry, event.value);
+  return true;
+}
+
+size_t NTReplayer::PublishUntil(double time) {
+  size_t published = 0;
+  for (; !IsDone() && m_recording.events[m_next].time <= time; ++m_next) {
+    if (Publish(m_recording.events[m_next])) {
+      ++published;
+    }
+  }
+  if (published > 0) {
+    nt::Flush(m_instance);
+  }
+  return published;
+}
+
+bool NTReplayer::PassGate(const std::string& name) {
+  bool timedOut = false;
+  for (auto&& event : nt::PollEntryListener(m_gatePoller, 0, &timedOut)) {
+    ++m_gateUpdates[event.name];
+  }
+  auto& updates = m_gateUpdates[name];
+  if (updates == 0) {
+    return false;
+  }
+  --updates;
+  return true;
+}
+
+size_t NTReplayer::Run(double speed, const std::atomic<bool>& stop) {
+  using Clock = std::chrono::steady_clock;
+  if (IsDone()) {
+    return 0;
+  }
+
+  // The wall time at which the first update of this run is published. Waiting
+  // for gates moves it back.
+  auto start = Clock::now();
+  double first = m_recording.events[m_next].time;
+  size_t published = 0;
+  while (!IsDone() && !stop) {
+    const auto& event = m_recording.events[m_next];
+    if (event.local && !event.initial && IsGate(event.name)) {
+      auto waitStart = Clock::now();
+      while (!PassGate(event.name)) {
+        if (stop) {
+          return published;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+      }
+      start += Clock::now() - waitStart;
+    }
+
+    if (speed > 0) {
+      std::this_thread::sleep_until(
+          start + std::chrono::duration_cast<Clock::duration>(
+                      std::chrono::duration<double>{(event.time - first) /
+                                                    speed}));
+    }
+    if (Publish(event)) {
+      nt::Flush(m_instance);
+      ++published;
+    }
+    ++m_next;
+  }
+  return published;
+}
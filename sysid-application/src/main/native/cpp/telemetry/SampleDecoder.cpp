@@ -0,0 +1,146 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/telemetry/SampleDecoder.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+using namespace sysid;
+
+// The column types of the format (see SampleColumnType in the sysid library).
+static constexpr uint8_t kTimestamp = 0;
+static constexpr uint8_t kVoltage = 1;
+static constexpr uint8_t kScaled = 2;
+
+static constexpr uint8_t kVersion = 1;
+static constexpr double kTimestampQuantum = 1e-6;
+static constexpr double kVoltageQuantum = 1e-3;
+
+namespace {
+/**
+ * Reads packed samples from a byte stream.
+ */
+class Reader {
+ public:
+  explicit Reader(std::string_view data)
+      : m_it{reinterpret_cast<const uint8_t*>(data.data())},
+        m_end{m_it + data.size()} {}
+
+  bool AtEnd() const { return m_it == m_end; }
+
+  uint8_t ReadByte() {
+    if (m_it == m_end) {
+      throw std::runtime_error{"Packed samples end in the middle of a value"};
+    }
+    return *m_it++;
+  }
+
+  int64_t ReadVarint() {
+    uint64_t zigzag = 0;
+    for (int shift = 0;; shift += 7) {
+      if (shift >= 64) {
+        throw std::runtime_error{"Packed samples contain an invalid varint"};
+      }
+      uint8_t byte = ReadByte();
+      zigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        break;
+      }
+    }
+    return static_cast<int64_t>(zigzag >> 1) ^
+           -static_cast<int64_t>(zigzag & 1);
+  }
+
+  int16_t ReadInt16() {
+    uint16_t low = ReadByte();
+    uint16_t high = ReadByte();
+    return static_cast<int16_t>(low | (high << 8));
+  }
+
+  double ReadDouble() {
+    static_assert(std::numeric_limits<double>::is_iec559);
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+      bits |= static_cast<uint64_t>(ReadByte()) << (8 * i);
+    }
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+ private:
+  const uint8_t* m_it;
+  const uint8_t* m_end;
+};
+}  // namespace
+
+DecodedSamples sysid::DecodeSamples(std::string_view data) {
+  Reader reader{data};
+  if (reader.ReadByte() != 'S' || reader.ReadByte() != 'Y') {
+    throw std::runtime_error{"Data isn't packed samples"};
+  }
+  if (auto version = reader.ReadByte(); version != kVersion) {
+    throw std::runtime_error{
+        fmt::format("Packed samples have unsupported version {}", version)};
+  }
+
+  DecodedSamples samples;
+  samples.columns = reader.ReadByte();
+  std::vector<uint8_t> types(samples.columns);
+  std::vector<double> quanta(samples.columns);
+  for (size_t i = 0; i < samples.columns; ++i) {
+    types[i] = reader.ReadByte();
+    if (types[i] == kTimestamp) {
+      quanta[i] = kTimestampQuantum;
+    } else if (types[i] == kVoltage) {
+      quanta[i] = kVoltageQuantum;
+    } else if (types[i] == kScaled) {
+      quanta[i] = reader.ReadDouble();
+    } else {
+      throw std::runtime_error{
+          fmt::format("Packed samples have unknown column type {}", types[i])};
+    }
+  }
+  if (samples.columns == 0) {
+    return samples;
+  }
+
+  // Parse the integers of every sample. Each sample takes at least a byte per
+  // column, which bounds the number of samples.
+  std::vector<int64_t> ints;
+  ints.reserve(data.size());
+  while (!reader.AtEnd()) {
+    for (size_t i = 0; i < samples.columns; ++i) {
+      ints.push_back(types[i] == kVoltage ? reader.ReadInt16()
+                                          : reader.ReadVarint());
+    }
+  }
+
+  // Accumulate the changes into values, then scale them.
+  size_t size = ints.size() / samples.columns;
+  for (size_t i = 0; i < samples.columns; ++i) {
+    if (types[i] == kVoltage) {
+      continue;
+    }
+    int64_t value = 0;
+    for (size_t row = 0; row < size; ++row) {
+      value += ints[row * samples.columns + i];
+      ints[row * samples.columns + i] = value;
+    }
+  }
+  samples.values.resize(ints.size());
+  for (size_t row = 0; row < size; ++row) {
+    const int64_t* in = ints.data() + row * samples.columns;
+    double* out = samples.values.data() + row * samples.columns;
+    for (size_t i = 0; i < samples.columns; ++i) {
+      out[i] = in[i] * quanta[i];
+    }
+  }
+  return samples;
+}
@@ -22,6 +22,8 @@
 
 #include "sysid/Util.h"
 #include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/MotorChannels.h"
+#include "sysid/telemetry/SampleDecoder.h"
 
 using namespace sysid;
 
@@ -31,27 +33,48 @@ TelemetryManager::TelemetryManager(const Settings& settings,
       m_logger(logger),
       m_inst(instance),
       m_poller(nt::CreateEntryListenerPoller(m_inst)),
+      m_pongPoller(nt::CreateEntryListenerPoller(m_inst)),
+      m_chunkPoller(nt::CreateEntryListenerPoller(m_inst)),
       m_voltageCommand(
           nt::GetEntry(m_inst, "/SmartDashboard/SysIdVoltageCommand")),
       m_testType(nt::GetEntry(m_inst, "/SmartDashboard/SysIdTestType")),
       m_rotate(nt::GetEntry(m_inst, "/SmartDashboard/SysIdRotate")),
       m_telemetry(nt::GetEntry(m_inst, "/SmartDashboard/SysIdTelemetry")),
+      m_telemetryPacked(
+          nt::GetEntry(m_inst, "/SmartDashboard/SysIdTelemetryPacked")),
+      m_packedRequest(nt::GetEntry(m_inst, "/SmartDashboard/SysIdPacked")),
+      m_telemetryChunk(
+          nt::GetEntry(m_inst, "/SmartDashboard/SysIdTelemetryChunk")),
+      m_streamRequest(nt::GetEntry(m_inst, "/SmartDashboard/SysIdStream")),
       m_overflow(nt::GetEntry(m_inst, "/SmartDashboard/SysIdOverflow")),
+      m_sending(nt::GetEntry(m_inst, "/SmartDashboard/SysIdSending")),
       m_telemetryOld(nt::GetEntry(m_inst, "/robot/telemetry")),
       m_mechanism(nt::GetEntry(m_inst, "/SmartDashboard/SysIdTest")),
       m_mechError(nt::GetEntry(m_inst, "/SmartDashboard/SysIdWrongMech")),
-      m_fieldInfo(nt::GetEntry(m_inst, "/FMSInfo/FMSControlData")) {
+      m_motorCountEntry(
+          nt::GetEntry(m_inst, "/SmartDashboard/SysIdMotorCount")),
+      m_fieldInfo(nt::GetEntry(m_inst, "/FMSInfo/FMSControlData")),
+      m_ping(nt::GetEntry(m_inst, "/SmartDashboard/SysIdPing")),
+      m_pong(nt::GetEntry(m_inst, "/SmartDashboard/SysIdPong")) {
   // Add listeners for our readable entries.
   nt::AddPolledEntryListener(m_poller, m_telemetry, kNTFlags);
+  nt::AddPolledEntryListener(m_poller, m_telemetryPacked, kNTFlags);
   nt::AddPolledEntryListener(m_poller, m_overflow, kNTFlags);
+  nt::AddPolledEntryListener(m_poller, m_sending, kNTFlags);
   nt::AddPolledEntryListener(m_poller, m_mechError, kNTFlags);
   nt::AddPolledEntryListener(m_poller, m_fieldInfo, kNTFlags);
+  nt::AddPolledEntryListener(m_pongPoller, m_pong,
+                             NT_NOTIFY_NEW | NT_NOTIFY_UPDATE);
+  nt::AddPolledEntryListener(m_chunkPoller, m_telemetryChunk,
+                             NT_NOTIFY_NEW | NT_NOTIFY_UPDATE);
   nt::AddPolledEntryListener(m_poller, m_telemetryOld,
                              NT_NOTIFY_NEW | NT_NOTIFY_UPDATE);
 }
 
 TelemetryManager::~TelemetryManager() {
   nt::DestroyEntryListenerPoller(m_poller);
+  nt::DestroyEntryListenerPoller(m_pongPoller);
+  nt::DestroyEntryListenerPoller(m_chunkPoller);
 }
 
 void TelemetryManager::BeginTest(std::string_view name) {
@@ -65,6 +88,15 @@ void TelemetryManager::BeginTest(std::string_view name) {
   m_tests.push_back(std::string{name});
   m_isRunningTest = true;
 
+  // The tests of a mechanism refine the same live estimate.
+  if (!m_liveEstimator.IsConfiguredFor(m_settings.mechanism,
+                                       m_settings.unitsPerRotation,
+                                       m_settings.units)) {
+    m_liveEstimator = OnlineGainEstimator{
+        m_settings.mechanism, m_settings.unitsPerRotation, m_settings.units};
+  }
+  m_liveEstimator.BeginRun();
+
   // Set the Voltage Command Entry
   nt::SetEntryValue(
       m_voltageCommand,
@@ -84,6 +116,11 @@ void TelemetryManager::BeginTest(std::string_view name) {
                     nt::Value::MakeString(m_settings.mechanism.name));
   // Clear the telemetry entry
   nt::SetEntryValue(m_telemetry, nt::Value::MakeString(""));
+  nt::SetEntryValue(m_telemetryPacked, nt::Value::MakeRaw(""));
+  // Ask for packed samples, and for streamed samples during the test
+  nt::SetEntryValue(m_packedRequest, nt::Value::MakeBoolean(true));
+  nt::SetEntryValue(m_telemetryChunk, nt::Value::MakeDoubleArray({}));
+  nt::SetEntryValue(m_streamRequest, nt::Value::MakeBoolean(true));
   // Set Overflow to False
   nt::SetEntryValue(m_overflow, nt::Value::MakeBoolean(false));
   // Set Mechanism Error to False
@@ -114,6 +151,33 @@ void TelemetryManager::EndTest() {
   // Disable the running flag and store the data in the JSON.
   m_isRunningTest = false;
   m_data[m_tests.back()] = m_params.data;
+  if (!m_params.data.empty()) {
+    m_motorCount = m_params.motorCount;
+
+    // Robot programs that don't stream their samples only update the live
+    // estimate at the end of each test.
+    if (m_params.streamed == 0) {
+      m_liveEstimator.BeginRun();
+      m_liveEstimator.AddSamples(m_params.data);
+    }
+
+    // Store when the test was enabled, disabled, and received in robot time so
+    // that they can be lined up with the data.
+    auto enable =
+        m_clockSync.ToRobotTime(units::second_t{m_params.enableStart});
+    auto disable =
+        m_clockSync.ToRobotTime(units::second_t{m_params.disableStart});
+    auto receive =
+        m_clockSync.ToRobotTime(units::second_t{m_params.receiveTime});
+    if (enable && disable && receive) {
+      m_events[m_tests.back()] = {{"enable", enable->value()},
+                                  {"disable", disable->value()},
+                                  {"receive", receive->value()}};
+      WPI_INFO(m_logger,
+               "The {} test data arrived {:.3f} s after its last sample.",
+               m_tests.back(), receive->value() - m_params.data.back()[0]);
+    }
+  }
 
   // Call the cancellation callbacks.
   for (auto&& func : m_callbacks) {
@@ -142,6 +206,15 @@ void TelemetryManager::EndTest() {
             "The left and right encoders traveled {} {} and {} {} "
             "respectively.\nThe gyro angle delta was {} degrees.",
             p, units, s, units, g * 180.0 / wpi::numbers::pi);
+      } else if (analysis::IsSwerve(m_settings.mechanism)) {
+        msg = "The module encoders traveled";
+        for (size_t i = 0; i < analysis::kSwerveModuleCount; ++i) {
+          size_t col = 2 + 2 * i;
+          double p = (m_params.data.back()[col] - m_params.data.front()[col]) *
+                     m_settings.unitsPerRotation;
+          msg += fmt::format("{} {} {}", i == 0 ? "" : ",", p, units);
+        }
+        msg += " respectively.";
       } else {
         double p = (m_params.data.back()[2] - m_params.data.front()[2]) *
                    m_settings.unitsPerRotation;
@@ -170,13 +243,23 @@ void TelemetryManager::EndTest() {
 }
 
 void TelemetryManager::Update() {
+  UpdateClockSync();
+
+  // Add the samples that are streamed during a test to the live estimate. The
+  // chunks that arrive between tests are stale.
+  bool timedOut = false;
+  for (auto&& event : nt::PollEntryListener(m_chunkPoller, 0, &timedOut)) {
+    if (m_isRunningTest && event.value && event.value->IsDoubleArray()) {
+      AddChunk(event.value->GetDoubleArray());
+    }
+  }
+
   // If there is no test running, these is nothing to update.
   if (!m_isRunningTest) {
     return;
   }
 
   // Update the NT entries that we're reading.
-  bool timedOut = false;
   for (auto&& event : nt::PollEntryListener(m_poller, 0, &timedOut)) {
     // Get the FMS Control Word.
     if (event.entry == m_fieldInfo && event.value && event.value->IsDouble()) {
@@ -191,10 +274,23 @@ void TelemetryManager::Update() {
         nt::SetEntryValue(m_telemetry, nt::Value::MakeString(""));
       }
     }
+    // Get the packed samples, which robot programs send if asked to.
+    if (event.entry == m_telemetryPacked && event.value &&
+        event.value->IsRaw()) {
+      std::string value{event.value->GetRaw()};
+      if (!value.empty()) {
+        m_params.packed = std::move(value);
+        nt::SetEntryValue(m_telemetryPacked, nt::Value::MakeRaw(""));
+      }
+    }
     // Get the overflow flag
     if (event.entry == m_overflow && event.value && event.value->IsBoolean()) {
       m_params.overflow = event.value->GetBoolean();
     }
+    // Get whether the robot program is still sending the data
+    if (event.entry == m_sending && event.value && event.value->IsBoolean()) {
+      m_params.sending = event.value->GetBoolean();
+    }
     // Get the mechanism error flag
     if (event.entry == m_mechError && event.value && event.value->IsBoolean()) {
       m_params.mechError = event.value->GetBoolean();
@@ -243,58 +339,173 @@ void TelemetryManager::Update() {
     nt::Flush(m_inst);
 
     // We have the data that we need, so we can parse it and end the test.
-    if (!m_params.raw.empty()) {
-      // Clean up the string -- remove spaces if there are any.
-      m_params.raw.erase(
-          std::remove_if(m_params.raw.begin(), m_params.raw.end(), ::isspace),
-          m_params.raw.end());
-
-      // Split the string into individual components.
-      wpi::SmallVector<std::string_view, 16> res;
-      wpi::split(m_params.raw, res, ',');
-
-      // Convert each string to double.
-      std::vector<double> values;
-      values.reserve(res.size());
-      for (auto&& str : res) {
-        values.push_back(wpi::parse_float<double>(str).value());
+    if (!m_params.raw.empty() || !m_params.packed.empty()) {
+      m_params.receiveTime = now;
+
+      size_t rowSize = GetRowSize();
+
+      if (!m_params.packed.empty()) {
+        try {
+          auto samples = DecodeSamples(m_params.packed);
+          if (samples.columns != rowSize) {
+            throw std::runtime_error{
+                fmt::format("The samples have {} columns instead of {}.",
+                            samples.columns, rowSize)};
+          }
+          for (auto it = samples.values.begin(); it != samples.values.end();
+               it += rowSize) {
+            m_params.data.emplace_back(it, it + rowSize);
+          }
+        } catch (const std::exception& e) {
+          WPI_ERROR(m_logger, "Unable to decode the packed data: {}",
+                    e.what());
+        }
+      } else {
+        // Clean up the string -- remove spaces if there are any.
+        m_params.raw.erase(std::remove_if(m_params.raw.begin(),
+                                          m_params.raw.end(), ::isspace),
+                           m_params.raw.end());
+
+        // Split the string into individual components.
+        wpi::SmallVector<std::string_view, 16> res;
+        wpi::split(m_params.raw, res, ',');
+
+        // Convert each string to double.
+        std::vector<double> values;
+        values.reserve(res.size());
+        for (auto&& str : res) {
+          values.push_back(wpi::parse_float<double>(str).value());
+        }
+
+        // Add the values to our result vector.
+        for (size_t i = 0; i < values.size() - rowSize; i += rowSize) {
+          std::vector<double> d(rowSize);
+
+          std::copy_n(std::make_move_iterator(values.begin() + i), rowSize,
+                      d.begin());
+          m_params.data.push_back(std::move(d));
+        }
       }
 
-      // Add the values to our result vector.
-      for (size_t i = 0; i < values.size() - m_settings.mechanism.rawDataSize;
-           i += m_settings.mechanism.rawDataSize) {
-        std::vector<double> d(m_settings.mechanism.rawDataSize);
-
-        std::copy_n(std::make_move_iterator(values.begin() + i),
-                    m_settings.mechanism.rawDataSize, d.begin());
-        m_params.data.push_back(std::move(d));
+      if (!m_params.data.empty()) {
+        WPI_INFO(m_logger,
+                 "Received data with size: {} for the {} test in {} seconds.",
+                 m_params.data.size(), m_tests.back(),
+                 m_params.data.back()[0] - m_params.data.front()[0]);
       }
-
-      WPI_INFO(m_logger,
-               "Received data with size: {} for the {} test in {} seconds.",
-               m_params.data.size(), m_tests.back(),
-               m_params.data.back()[0] - m_params.data.front()[0]);
       EndTest();
     }
 
-    // If we timed out, end the test and let the user know.
-    if (now - m_params.disableStart > 5) {
-      WPI_WARNING(m_logger, "{}",
-                  "TelemetryManager did not receieve data 5 seconds after "
-                  "completing the test...");
+    // If we timed out, end the test and let the user know. Robot programs
+    // that send the data in the background report while they're sending it,
+    // which can take longer for large tests.
+    double waited = now - m_params.disableStart;
+    if (m_isRunningTest && waited > kDataTimeout &&
+        (!m_params.sending || waited > kSendingTimeout)) {
+      WPI_WARNING(m_logger,
+                  "TelemetryManager did not receieve data {} seconds after "
+                  "completing the test...",
+                  waited);
       EndTest();
     }
   }
 }
 
-std::string TelemetryManager::SaveJSON(std::string_view location) {
+size_t TelemetryManager::GetRowSize() {
+  // General mechanisms may record the channels of every motor after the
+  // mechanism data.
+  size_t rowSize = m_settings.mechanism.rawDataSize;
+  m_params.motorCount = 0;
+  auto motorCount = nt::GetEntryValue(m_motorCountEntry);
+  const auto& mechanism = m_settings.mechanism;
+  bool isGeneral = mechanism == analysis::kElevator ||
+                   mechanism == analysis::kArm ||
+                   mechanism == analysis::kSimple;
+  if (isGeneral && motorCount && motorCount->IsDouble()) {
+    m_params.motorCount = motorCount->GetDouble();
+    rowSize += kMotorChannelSize * m_params.motorCount;
+  }
+  return rowSize;
+}
+
+void TelemetryManager::AddChunk(wpi::span<const double> chunk) {
+  if (chunk.size() < 2) {
+    return;
+  }
+  size_t rowSize = GetRowSize();
+  auto first = static_cast<size_t>(chunk[0]);
+  auto values = chunk.subspan(1);
+  if (values.size() % rowSize != 0) {
+    WPI_WARNING(m_logger,
+                "A streamed chunk has {} values, which isn't a multiple of {}.",
+                values.size(), rowSize);
+    return;
+  }
+
+  // NetworkTables only keeps the latest value of an entry, so chunks can be
+  // lost. The samples after a lost chunk start a new run.
+  if (first != m_params.streamed) {
+    m_liveEstimator.BeginRun();
+  }
+  m_liveEstimator.AddSamples(values, rowSize);
+  m_params.streamed = first + values.size() / rowSize;
+}
+
+void TelemetryManager::UpdateClockSync() {
+  // Send a ping to the robot periodically.
+  double now = wpi::Now() * 1E-6;
+  if (nt::IsConnected(m_inst) &&
+      now - m_lastPing >= ClockSync::kPingPeriod.value()) {
+    m_lastPing = now;
+    ++m_pingSequence;
+    m_pings.emplace_back(m_pingSequence, now);
+    if (m_pings.size() > kMaxPendingPings) {
+      m_pings.erase(m_pings.begin());
+    }
+    nt::SetEntryValue(m_ping, nt::Value::MakeDouble(m_pingSequence));
+    nt::Flush(m_inst);
+  }
+
+  // Match the echoes, which hold the sequence number and the robot time, with
+  // their pings.
+  bool timedOut = false;
+  for (auto&& event : nt::PollEntryListener(m_pongPoller, 0, &timedOut)) {
+    if (!event.value || !event.value->IsDoubleArray()) {
+      continue;
+    }
+    auto echo = event.value->GetDoubleArray();
+    if (echo.size() < 2) {
+      continue;
+    }
+    auto ping = std::find_if(m_pings.begin(), m_pings.end(),
+                             [&](auto& p) { return p.first == echo[0]; });
+    if (ping != m_pings.end()) {
+      m_clockSync.AddSample(
+          {ping->second, echo[1], event.value->last_change() * 1E-6});
+      m_pings.erase(m_pings.begin(), ping + 1);
+    }
+  }
+}
+
+std::string TelemetryManager::SaveJSON(std::string_view location,
+                                       std::string_view name) {
   m_data["test"] = m_settings.mechanism.name;
   m_data["units"] = m_settings.units;
   m_data["unitsPerRotation"] = m_settings.unitsPerRotation;
   m_data["sysid"] = true;
+  if (m_motorCount > 0) {
+    m_data["motors"] = m_motorCount;
+  }
+  if (!m_clockSync.GetSamples().empty()) {
+    m_data["clockSync"] = m_clockSync.ToJSON();
+  }
+  if (!m_events.empty()) {
+    m_data["events"] = m_events;
+  }
 
-  std::string loc = fmt::format("{}/sysid_data{:%Y%m%d-%H%M%S}.json", location,
-                                fmt::localtime(std::time(nullptr)));
+  std::string loc = fmt::format("{}/sysid_data{:%Y%m%d-%H%M%S}{}{}.json",
+                                location, fmt::localtime(std::time(nullptr)),
+                                name.empty() ? "" : "-", name);
 
   sysid::SaveFile(m_data.dump(2), fs::path{loc});
   WPI_INFO(m_logger, "Wrote JSON to: {}", loc);
@@ -5,6 +5,7 @@
 #include "sysid/view/Analyzer.h"
 
 #include <algorithm>
+#include <cmath>
 #include <exception>
 #include <thread>
 
@@ -24,6 +25,8 @@
 #include "sysid/analysis/ArmSim.h"
 #include "sysid/analysis/ElevatorSim.h"
 #include "sysid/analysis/FeedbackControllerPreset.h"
+#include "sysid/analysis/ModelTerms.h"
+#include "sysid/analysis/ResultCache.h"
 #include "sysid/analysis/SimpleMotorSim.h"
 
 using namespace sysid;
@@ -88,8 +91,9 @@ void Analyzer::Display() {
   // button. Also show the units and the units per rotation.
   if (m_manager) {
     ImGui::SetNextItemWidth(ImGui::GetFontSize() * 15);
-    if (ImGui::Combo("Dataset", &m_settings.dataset, AnalysisManager::kDatasets,
-                     m_type == analysis::kDrivetrain ? 9 : 3)) {
+    const auto& datasets = m_manager->GetDatasets();
+    if (ImGui::Combo("Dataset", &m_settings.dataset, datasets.data(),
+                     datasets.size())) {
       m_enabled = true;
       Calculate();
       PrepareGraphs();
@@ -152,6 +156,7 @@ void Analyzer::Display() {
           m_manager->OverrideUnits(m_unit, m_factor);
           m_enabled = true;
           Calculate();
+          PrepareGraphs();
         } catch (const std::exception& e) {
           ex = true;
           m_exception = e.what();
@@ -167,8 +172,10 @@ void Analyzer::Display() {
     ImGui::SameLine();
     if (ImGui::Button("Reset Units from JSON")) {
       m_manager->ResetUnitsFromJSON();
+      m_unit = m_manager->GetUnit();
       m_enabled = true;
       Calculate();
+      PrepareGraphs();
     }
   }
 
@@ -184,6 +191,13 @@ void Analyzer::Display() {
       ImGui::Text("Please Select a JSON File");
     } else {
       DisplayFeedforwardGains();
+      DisplayModelTerms();
+      if (analysis::IsSwerve(m_type)) {
+        DisplaySwerveModules();
+      }
+      if (m_manager->GetMotorCount() > 0) {
+        DisplayMotorChannels();
+      }
       ImGui::SetNextWindowSize(ImVec2(m_plot.kCombinedPlotSize * 4 + 50,
                                       m_plot.kCombinedPlotSize * 2 + 25),
                                ImGuiCond_Once);
@@ -433,6 +447,9 @@ void Analyzer::Display() {
                    40.0f);
       ShowLQRParam("Max Control Effort (V)", &m_settings.lqr.r, 0.1f, 12.0f,
                    false);
+
+      ImGui::Spacing();
+      DisplayKalmanFilters();
     }
   }
 
@@ -459,10 +476,13 @@ void Analyzer::SelectFile() {
     try {
       m_manager =
           std::make_unique<AnalysisManager>(m_location, m_settings, m_logger);
+      m_manager->SetCacheDirectory(sysid::GetDefaultCacheDirectory());
       m_type = m_manager->GetAnalysisType();
       m_factor = m_manager->GetFactor();
       m_unit = m_manager->GetUnit();
-      RefreshInformation();
+      AutoTune();
+      Calculate();
+      PrepareGraphs();
       ConfigParamsOnFileSelect();
     } catch (const wpi::json::exception& e) {
       HandleJSONError(e);
@@ -485,6 +505,23 @@ void Analyzer::PrepareData() {
   }
 }
 
+void Analyzer::AutoTune() {
+  WPI_INFO(m_logger, "{}", "Auto-Tuning Parameters.");
+  if (!m_enabled) {
+    WPI_INFO(m_logger, "{}", "Returning early for auto-tuning.");
+    return;
+  }
+  try {
+    m_manager->AutoTune();
+    m_stepTestDuration = m_settings.stepTestDuration.to<float>();
+  } catch (const wpi::json::exception& e) {
+    HandleJSONError(e);
+  } catch (const std::exception& e) {
+    WPI_INFO(m_logger, "Auto-tuning failed: {}", e.what());
+    PrepareData();
+  }
+}
+
 void Analyzer::Calculate() {
   WPI_INFO(m_logger, "{}", "Calculating Gains.");
   if (!m_enabled) {
@@ -494,7 +531,11 @@ void Analyzer::Calculate() {
   try {
     const auto& [ff, fb, trackWidth] = m_manager->Calculate();
     m_ff = std::get<0>(ff);
+    m_modelTerms = m_manager->GetModelTerms();
     m_rSquared = std::get<1>(ff);
+    m_moduleGains = m_manager->CalculateSwerveModules();
+    m_motorDiagnostics = m_manager->CalculateMotorChannels();
+    m_estimators = m_manager->CalculateEstimators();
     m_Kp = fb.Kp;
     m_Kd = fb.Kd;
     m_trackWidth = trackWidth;
@@ -537,7 +578,8 @@ void Analyzer::PrepareGraphs() {
     m_dataThread = std::thread([&] {
       m_plot.SetData(m_manager->GetRawData(), m_manager->GetFilteredData(),
                      m_manager->GetUnit(), m_ff, m_manager->GetStartTimes(),
-                     m_type, m_abortDataPrep);
+                     m_type, m_modelTerms, m_settings.modelTermParameters,
+                     m_abortDataPrep);
     });
   } catch (const std::exception& e) {
     HandleGeneralError(e);
@@ -582,17 +624,22 @@ void Analyzer::DisplayFeedforwardGains(bool combined) {
     DisplayGain(gainNames[i], &m_ff[i]);
   }
 
-  SetPosition(beginX, beginY, 0, 3);
+  // Show the gains of the extra model terms (e.g. Kg or Kcos)
+  int row = 3;
+  for (size_t i = 0; i < m_modelTerms.size() && 3 + i < m_ff.size(); ++i) {
+    SetPosition(beginX, beginY, 0, row++);
+    DisplayGain(GetGainName(m_modelTerms[i]).data(), &m_ff[3 + i]);
+  }
 
-  if (m_type == analysis::kElevator) {
-    DisplayGain("Kg", &m_ff[3]);
-  } else if (m_type == analysis::kArm) {
-    DisplayGain("Kcos", &m_ff[3]);
-  } else if (m_trackWidth) {
+  if (m_trackWidth) {
+    SetPosition(beginX, beginY, 0, row++);
     DisplayGain("Track Width", &*m_trackWidth);
   }
 
-  SetPosition(beginX, beginY, 0, 4);
+  // Leave a gap for simple mechanisms so the diagnostics line up
+  row = std::max(row, 4);
+
+  SetPosition(beginX, beginY, 0, row++);
   DisplayGain("Acceleration r-squared", &m_rSquared);
 
   if (!combined) {
@@ -602,7 +649,7 @@ void Analyzer::DisplayFeedforwardGains(bool combined) {
         "so this is generally quite small.");
   }
 
-  SetPosition(beginX, beginY, 0, 5);
+  SetPosition(beginX, beginY, 0, row++);
   DisplayGain("Sim velocity r-squared", m_plot.GetSimRSquared());
 
   if (!combined) {
@@ -612,7 +659,7 @@ void Analyzer::DisplayFeedforwardGains(bool combined) {
         "is pretty close to 1 for a decent fit.");
   }
 
-  SetPosition(beginX, beginY, 0, 6);
+  SetPosition(beginX, beginY, 0, row);
   DisplayGain("Sim RMSE", m_plot.GetRMSE());
 
   if (!combined) {
@@ -651,6 +698,19 @@ void Analyzer::DisplayFeedforwardGains(bool combined) {
       "The number of samples in the velocity median "
       "filter's sliding window.");
 
+  if (!combined) {
+    ImGui::SameLine();
+    if (ImGui::Checkbox("Kalman Smoother", &m_settings.useKalmanSmoother)) {
+      m_enabled = true;
+      RefreshInformation();
+    }
+
+    CreateTooltip(
+        "Estimates velocity and acceleration with a constant-acceleration "
+        "Kalman filter and smoother instead of the median filter and finite "
+        "differences. The noise parameters are estimated from each test.");
+  }
+
   // Wait for enter before refresh so decimal inputs like "0.2" don't
   // prematurely refresh with a velocity threshold of "0".
   SetPosition(beginX, beginY, horizontalSpacing, combined ? 1 : 2);
@@ -666,6 +726,22 @@ void Analyzer::DisplayFeedforwardGains(bool combined) {
 
   CreateTooltip("Velocity data below this threshold will be ignored.");
 
+  if (!combined) {
+    ImGui::SameLine();
+    if (ImGui::Button("Auto-Tune")) {
+      m_enabled = true;
+      AutoTune();
+      Calculate();
+      PrepareGraphs();
+    }
+
+    CreateTooltip(
+        "Picks the velocity threshold and test duration that fit the data "
+        "best, starting from the estimated encoder noise and the time the "
+        "mechanism takes to reach a steady velocity. This is done when a "
+        "file is opened.");
+  }
+
   SetPosition(beginX, beginY, horizontalSpacing, combined ? 2 : 3);
   ImGui::SetNextItemWidth(ImGui::GetFontSize() * 4);
   if (!combined) {
@@ -683,6 +759,216 @@ void Analyzer::DisplayFeedforwardGains(bool combined) {
     std::string message = fmt::format("{:.2f} of {:.2f}", m_stepTestDuration,
                                       m_manager->GetMaxDuration());
     ImGui::InputText("Duration (s)", &message, ImGuiInputTextFlags_ReadOnly);
-    SetPosition(beginX, beginY, 0, 12);
+    SetPosition(beginX, beginY, 0, row + 6);
   }
 }
+
+void Analyzer::DisplayModelTerms() {
+  if (!ImGui::TreeNode("Model Terms")) {
+    return;
+  }
+
+  auto defaultTerms = GetDefaultModelTerms(m_type);
+  bool changed = false;
+  for (auto term : kModelTerms) {
+    // Terms implied by the analysis type are always identified.
+    if (std::find(defaultTerms.begin(), defaultTerms.end(), term) !=
+        defaultTerms.end()) {
+      continue;
+    }
+
+    auto& terms = m_settings.modelTerms;
+    auto it = std::find(terms.begin(), terms.end(), term);
+    bool selected = it != terms.end();
+    if (ImGui::Checkbox(GetGainName(term).data(), &selected)) {
+      if (selected) {
+        terms.push_back(term);
+      } else {
+        terms.erase(it);
+      }
+      changed = true;
+    }
+  }
+  CreateTooltip(
+      "Extra terms of the feedforward model to identify.\n\n"
+      "Kg: constant gravity (V = Kg).\n"
+      "Kcos: arm gravity (V = Kcos * cos(angle)).\n"
+      "Kstribeck: breakaway friction that decays with velocity "
+      "(V = Kstribeck * sgn(v) * exp(-(v / vs)^2)).\n"
+      "Kdrag: quadratic drag (V = Kdrag * v * |v|).\n"
+      "Kbacklash: friction that only acts once the backlash is taken up.\n"
+      "Kx: position-dependent gravity, e.g. from counterweights or springs "
+      "(V = Kx * x).");
+
+  ImGui::SetNextItemWidth(ImGui::GetFontSize() * 4);
+  double stribeckVelocity = m_settings.modelTermParameters.stribeckVelocity;
+  if (ImGui::InputDouble("Stribeck Velocity", &stribeckVelocity, 0.0, 0.0,
+                         "%.3f", ImGuiInputTextFlags_EnterReturnsTrue) &&
+      stribeckVelocity > 0) {
+    m_settings.modelTermParameters.stribeckVelocity = stribeckVelocity;
+    changed = true;
+  }
+  CreateTooltip(
+      "The velocity (units/s) at which the Stribeck friction has decayed to "
+      "1/e of its peak.");
+
+  ImGui::SetNextItemWidth(ImGui::GetFontSize() * 4);
+  double backlashWidth = m_settings.modelTermParameters.backlashWidth;
+  if (ImGui::InputDouble("Backlash Width", &backlashWidth, 0.0, 0.0, "%.4f",
+                         ImGuiInputTextFlags_EnterReturnsTrue) &&
+      backlashWidth > 0) {
+    m_settings.modelTermParameters.backlashWidth = backlashWidth;
+    changed = true;
+  }
+  CreateTooltip("The total width (units) of the backlash dead-band.");
+
+  if (changed) {
+    m_enabled = true;
+    Calculate();
+    PrepareGraphs();
+  }
+  ImGui::TreePop();
+}
+
+void Analyzer::DisplaySwerveModules() {
+  if (m_moduleGains.empty() || !ImGui::TreeNode("Module Comparison")) {
+    return;
+  }
+
+  double pooledKv = m_ff[1];
+  static constexpr const char* kHeaders[] = {"Module", "Ks",        "Kv",
+                                              "Ka",     "r-squared", "Kv Dev."};
+  if (ImGui::BeginTable("Modules", IM_ARRAYSIZE(kHeaders),
+                        ImGuiTableFlags_Borders |
+                            ImGuiTableFlags_SizingFixedFit)) {
+    for (auto&& header : kHeaders) {
+      ImGui::TableSetupColumn(header);
+    }
+    ImGui::TableHeadersRow();
+
+    auto displayRow = [&](const std::string& name,
+                          const std::vector<double>& gains, double rSquared) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(name.c_str());
+      for (size_t i = 0; i < 3; ++i) {
+        ImGui::TableNextColumn();
+        ImGui::Text("%.4g", gains[i]);
+      }
+      ImGui::TableNextColumn();
+      ImGui::Text("%.4g", rSquared);
+      ImGui::TableNextColumn();
+      ImGui::Text("%+.1f%%", (gains[1] - pooledKv) / pooledKv * 100.0);
+    };
+
+    for (size_t i = 0; i < m_moduleGains.size(); ++i) {
+      const auto& [gains, rSquared] = m_moduleGains[i];
+      displayRow(fmt::format("Module {}", i + 1), gains, rSquared);
+    }
+    displayRow("Pooled", m_ff, m_rSquared);
+    ImGui::EndTable();
+  }
+  CreateTooltip(
+      "The feedforward gains of each swerve module fit separately, compared "
+      "with the gains fit to the pooled data of all modules. A module with a "
+      "large Kv deviation may have a mechanical issue or a different gearing.");
+  ImGui::TreePop();
+}
+
+void Analyzer::DisplayKalmanFilters() {
+  if (m_estimators.empty() || !ImGui::TreeNode("Kalman Filter")) {
+    return;
+  }
+
+  static constexpr const char* kHeaders[] = {
+      "Dataset",        "Process Noise", "Position Noise",
+      "Velocity Noise", "K (Position)",  "K (Velocity)"};
+  if (ImGui::BeginTable("Estimators", IM_ARRAYSIZE(kHeaders),
+                        ImGuiTableFlags_Borders |
+                            ImGuiTableFlags_SizingFixedFit)) {
+    for (auto&& header : kHeaders) {
+      ImGui::TableSetupColumn(header);
+    }
+    ImGui::TableHeadersRow();
+
+    for (auto&& [dataset, noise, gains] : m_estimators) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(dataset.c_str());
+      for (double variance : {noise.process, noise.position, noise.velocity}) {
+        ImGui::TableNextColumn();
+        ImGui::Text("%.4g", std::sqrt(variance));
+      }
+      ImGui::TableNextColumn();
+      ImGui::Text("%.4g", gains.position);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.4g", gains.velocity);
+    }
+    ImGui::EndTable();
+  }
+  CreateTooltip(
+      "A steady-state Kalman filter for each dataset, designed for the loop "
+      "type and controller period above. The noise is measured from how far "
+      "the raw data strays from the feedforward model, as standard "
+      "deviations: the process noise in units/s per square root of a second, "
+      "and the measurement noise in units and units/s.
+
+"
+      "Each period, add the gains times the measurement error (measured minus "
+      "predicted) to the predicted position and velocity. Position loops "
+      "measure the position, and velocity loops measure the velocity.");
+  ImGui::TreePop();
+}
+
+void Analyzer::DisplayMotorChannels() {
+  if (m_motorDiagnostics.empty() || !ImGui::TreeNode("Motor Comparison")) {
+    return;
+  }
+
+  static constexpr const char* kHeaders[] = {
+      "Motor",       "Ks",           "Kv",    "Ka", "r-squared",
+      "Speed Ratio", "Current (A)", "Status"};
+  if (ImGui::BeginTable("Motors", IM_ARRAYSIZE(kHeaders),
+                        ImGuiTableFlags_Borders |
+                            ImGuiTableFlags_SizingFixedFit)) {
+    for (auto&& header : kHeaders) {
+      ImGui::TableSetupColumn(header);
+    }
+    ImGui::TableHeadersRow();
+
+    for (size_t i = 0; i < m_motorDiagnostics.size(); ++i) {
+      const auto& motor = m_motorDiagnostics[i];
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text("Motor %zu", i + 1);
+      for (size_t j = 0; j < 3; ++j) {
+        ImGui::TableNextColumn();
+        ImGui::Text("%.4g", motor.ffGains[j]);
+      }
+      ImGui::TableNextColumn();
+      ImGui::Text("%.4g", motor.rSquared);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", motor.velocityRatio);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", motor.meanCurrent);
+      ImGui::TableNextColumn();
+      if (motor.slipping) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Slipping");
+      } else if (motor.mismatched) {
+        ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.2f, 1.0f), "Mismatched");
+      } else {
+        ImGui::TextUnformatted("OK");
+      }
+    }
+    ImGui::EndTable();
+  }
+  CreateTooltip(
+      "The feedforward gains of each motor fit with its own applied voltage "
+      "and built-in encoder.\n\n"
+      "Speed Ratio: the motor velocity divided by the mechanism velocity. A "
+      "motor whose ratio differs from the others is slipping (e.g. a loose "
+      "pulley or a sheared key).\n"
+      "Mismatched: the motor's Kv or current differs from the others (e.g. a "
+      "damaged motor or a different controller configuration).");
+  ImGui::TreePop();
+}
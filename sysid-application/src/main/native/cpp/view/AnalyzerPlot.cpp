@@ -10,6 +10,7 @@
 #include <thread>
 #include <vector>
 
+#include <Eigen/Core>
 #include <fmt/format.h>
 #include <imgui.h>
 #include <implot.h>
@@ -19,10 +20,9 @@
 #include "sysid/Util.h"
 #include "sysid/analysis/AnalysisManager.h"
 #include "sysid/analysis/AnalysisType.h"
-#include "sysid/analysis/ArmSim.h"
-#include "sysid/analysis/ElevatorSim.h"
 #include "sysid/analysis/FilteringUtils.h"
-#include "sysid/analysis/SimpleMotorSim.h"
+#include "sysid/analysis/MechanismDescriptor.h"
+#include "sysid/analysis/ModelTerms.h"
 
 using namespace sysid;
 
@@ -160,7 +160,10 @@ void AnalyzerPlot::SetData(const Storage& rawData, const Storage& filteredData,
                            std::string_view unit,
                            const std::vector<double>& ffGains,
                            const std::array<units::second_t, 4>& startTimes,
-                           AnalysisType type, std::atomic<bool>& abort) {
+                           AnalysisType type,
+                           const std::vector<ModelTerm>& terms,
+                           const ModelTermParameters& params,
+                           std::atomic<bool>& abort) {
   auto& [slow, fast] = filteredData;
   auto& [rawSlow, rawFast] = rawData;
   const auto& Ks = ffGains[0];
@@ -202,6 +205,13 @@ void AnalyzerPlot::SetData(const Storage& rawData, const Storage& filteredData,
 
   units::second_t dtMean = GetMeanTimeDelta(filteredData);
 
+  // Calculate the voltage contributed by the extra model terms (e.g. Kg or
+  // Kcos) for every point up front.
+  Eigen::VectorXd slowTermVoltages =
+      CalculateTermVoltages(terms, ffGains.data() + 3, slow, params);
+  Eigen::VectorXd fastTermVoltages =
+      CalculateTermVoltages(terms, ffGains.data() + 3, fast, params);
+
   // Populate quasistatic time-domain graphs and quasistatic velocity vs.
   // velocity-portion voltage graph.
 
@@ -211,15 +221,7 @@ void AnalyzerPlot::SetData(const Storage& rawData, const Storage& filteredData,
     }
     // Calculate portion of voltage that corresponds to change in velocity.
     double Vportion = slow[i].voltage - std::copysign(Ks, slow[i].velocity) -
-                      Ka * slow[i].acceleration;
-
-    if (type == analysis::kElevator) {
-      const auto& Kg = ffGains[3];
-      Vportion -= Kg;
-    } else if (type == analysis::kArm) {
-      const auto& Kcos = ffGains[3];
-      Vportion -= Kcos * slow[i].cos;
-    }
+                      Ka * slow[i].acceleration - slowTermVoltages(i);
 
     // Calculate points to show the line of best fit.
     m_KvFit[0] = ImPlotPoint(Kv * slowMinElement, slowMinElement);
@@ -255,15 +257,7 @@ void AnalyzerPlot::SetData(const Storage& rawData, const Storage& filteredData,
     }
     // Calculate portion of voltage that corresponds to change in acceleration.
     double Vportion = fast[i].voltage - std::copysign(Ks, fast[i].velocity) -
-                      Kv * fast[i].velocity;
-
-    if (type == analysis::kElevator) {
-      const auto& Kg = ffGains[3];
-      Vportion -= Kg;
-    } else if (type == analysis::kArm) {
-      const auto& Kcos = ffGains[3];
-      Vportion -= Kcos * fast[i].cos;
-    }
+                      Kv * fast[i].velocity - fastTermVoltages(i);
 
     // Calculate points to show the line of best fit.
     m_KaFit[0] = ImPlotPoint(Ka * fastMinElement, fastMinElement);
@@ -306,24 +300,12 @@ void AnalyzerPlot::SetData(const Storage& rawData, const Storage& filteredData,
   SetRawTimeData(rawSlow, rawFast, abort);
 
   // Populate Simulated Time Series Data.
-  if (type == analysis::kElevator) {
-    const auto& Kg = ffGains[3];
-    m_quasistaticSim = PopulateTimeDomainSim(
-        rawSlow, startTimes, fastStep, sysid::ElevatorSim{Ks, Kv, Ka, Kg});
-    m_dynamicSim = PopulateTimeDomainSim(rawFast, startTimes, fastStep,
-                                         sysid::ElevatorSim{Ks, Kv, Ka, Kg});
-  } else if (type == analysis::kArm) {
-    const auto& Kcos = ffGains[3];
-    m_quasistaticSim = PopulateTimeDomainSim(rawSlow, startTimes, fastStep,
-                                             sysid::ArmSim{Ks, Kv, Ka, Kcos});
-    m_dynamicSim = PopulateTimeDomainSim(rawFast, startTimes, fastStep,
-                                         sysid::ArmSim{Ks, Kv, Ka, Kcos});
-  } else {
-    m_quasistaticSim = PopulateTimeDomainSim(rawSlow, startTimes, fastStep,
-                                             sysid::SimpleMotorSim{Ks, Kv, Ka});
-    m_dynamicSim = PopulateTimeDomainSim(rawFast, startTimes, fastStep,
-                                         sysid::SimpleMotorSim{Ks, Kv, Ka});
-  }
+  VisitDescriptor(type, [&](auto descriptor) {
+    auto sim = decltype(descriptor)::MakeSim(ffGains);
+    m_quasistaticSim =
+        PopulateTimeDomainSim(rawSlow, startTimes, fastStep, sim);
+    m_dynamicSim = PopulateTimeDomainSim(rawFast, startTimes, fastStep, sim);
+  });
 
   // RMSE = std::sqrt(sum((x_i - x^_i)^2) / N) where sum represents the sum of
   // all time series points, x_i represents the velocity at a timestep, x^_i
@@ -366,6 +366,14 @@ void Generator::Display() {
     m_isSparkMaxBrushed = mc[i] == sysid::motorcontroller::kSPARKMAXBrushed;
   }
 
+  if (!drive) {
+    ImGui::Checkbox("Log Motor Channels", &m_settings.logMotorChannels);
+    CreateTooltip(
+        "Logs the built-in encoder, current, and applied voltage of every "
+        "motor alongside the mechanism encoder so that each motor can be "
+        "analyzed separately (e.g. to detect mismatched or slipping motors).");
+  }
+
   // Add section for encoders.
   ImGui::Separator();
   ImGui::Spacing();
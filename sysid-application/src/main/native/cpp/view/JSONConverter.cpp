@@ -6,12 +6,19 @@
 #include "sysid/view/JSONConverter.h"
 
 #include <exception>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <imgui.h>
 #include <portable-file-dialogs.h>
+#include <wpi/numbers>
 #include <wpi/timestamp.h>
 
 #include "sysid/Util.h"
+#include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/DataLogImporter.h"
+#include "sysid/view/Logger.h"
 
 using namespace sysid;
 
@@ -62,3 +69,104 @@ void JSONConverter::DisplayConverter(
 void JSONConverter::DisplayCSVConvert() {
   DisplayConverter("Select SysId JSON", sysid::ToCSV);
 }
+
+void JSONConverter::DisplayDataLogImport() {
+  if (ImGui::Button("Select WPILib Data Log")) {
+    m_logOpener = std::make_unique<pfd::open_file>(
+        "Select WPILib Data Log", "",
+        std::vector<std::string>{"WPILib Data Log", "*.wpilog"});
+  }
+
+  if (m_logOpener && m_logOpener->ready()) {
+    if (!m_logOpener->result().empty()) {
+      m_logLocation = m_logOpener->result()[0];
+      m_logEntries.clear();
+      m_selectedEntries.clear();
+      try {
+        for (auto&& entry : sysid::ListDataLogEntries(m_logLocation)) {
+          m_logEntries.push_back(entry.name);
+        }
+      } catch (const std::exception& e) {
+        ImGui::OpenPopup("Exception Caught!");
+        m_exception = e.what();
+        m_logLocation.clear();
+      }
+    }
+    m_logOpener.reset();
+  }
+
+  if (!m_logLocation.empty()) {
+    ImGui::Text("%s", m_logLocation.c_str());
+
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 12);
+    ImGui::Combo("Mechanism", &m_selectedType, Logger::kTypes,
+                 IM_ARRAYSIZE(Logger::kTypes));
+    auto type = analysis::FromName(Logger::kTypes[m_selectedType]);
+
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 12);
+    ImGui::Combo("Unit Type", &m_selectedUnit, kUnits, IM_ARRAYSIZE(kUnits));
+
+    // Rotational units have fixed units per rotation.
+    std::string_view unit = kUnits[m_selectedUnit];
+    if (unit == "Degrees") {
+      m_unitsPerRotation = 360.0;
+    } else if (unit == "Radians") {
+      m_unitsPerRotation = 2 * wpi::numbers::pi;
+    } else if (unit == "Rotations") {
+      m_unitsPerRotation = 1.0;
+    }
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 12);
+    ImGui::InputDouble("Units Per Rotation", &m_unitsPerRotation, 0.0, 0.0,
+                       "%.4f");
+
+    // Map an entry of the log to each column of the telemetry format.
+    auto columns = GetTelemetryColumns(type);
+    m_selectedEntries.resize(columns.size(), 0);
+    for (size_t i = 0; i < columns.size(); ++i) {
+      ImGui::SetNextItemWidth(ImGui::GetFontSize() * 16);
+      ImGui::Combo(
+          columns[i].c_str(), &m_selectedEntries[i],
+          [](void* data, int idx, const char** out) {
+            *out = static_cast<std::vector<std::string>*>(data)
+                       ->at(idx)
+                       .c_str();
+            return true;
+          },
+          &m_logEntries, static_cast<int>(m_logEntries.size()));
+    }
+
+    if (ImGui::Button("Import") && !m_logEntries.empty()) {
+      DataLogImportSettings settings{type, kUnits[m_selectedUnit],
+                                     m_unitsPerRotation};
+      for (size_t i = 0; i < columns.size(); ++i) {
+        settings.entries.push_back(m_logEntries[m_selectedEntries[i]]);
+      }
+      try {
+        ImportDataLog(m_logLocation, settings, m_logger);
+        m_timestamp = wpi::Now() * 1E-6;
+      } catch (const std::exception& e) {
+        ImGui::OpenPopup("Exception Caught!");
+        m_exception = e.what();
+      }
+    }
+
+    if (wpi::Now() * 1E-6 - m_timestamp < 5) {
+      ImGui::SameLine();
+      ImGui::Text("Saved!");
+    }
+  }
+
+  // Handle exceptions.
+  ImGui::SetNextWindowSize(ImVec2(480.f, 0.0f));
+  if (ImGui::BeginPopupModal("Exception Caught!")) {
+    ImGui::PushTextWrapPos(0.0f);
+    ImGui::Text("An error occurred when reading the data log.");
+    ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s",
+                       m_exception.c_str());
+    ImGui::PopTextWrapPos();
+    if (ImGui::Button("Close")) {
+      ImGui::CloseCurrentPopup();
+    }
+    ImGui::EndPopup();
+  }
+}
@@ -6,6 +6,7 @@
 
 #include <exception>
 
+#include <fmt/format.h>
 #include <glass/Context.h>
 #include <glass/Storage.h>
 #include <imgui.h>
@@ -23,43 +24,101 @@ using namespace sysid;
 
 Logger::Logger(glass::Storage& storage, wpi::Logger& logger)
     : m_logger{logger}, m_ntSettings{storage} {
-  // Add an NT connection listener to update the GUI's state.
-  auto instance = nt::GetDefaultInstance();
-  auto poller = nt::CreateConnectionListenerPoller(instance);
-
-  nt::AddPolledConnectionListener(poller, true);
-  wpi::gui::AddEarlyExecute([poller, &connected = m_ntConnected] {
-    bool timedOut;
-    for (auto&& event : nt::PollConnectionListener(poller, 0, &timedOut)) {
-      connected = event.connected;
-    }
-  });
+  // The first robot is connected with the NetworkTables settings.
+  m_sessions.push_back({std::make_unique<CaptureSession>(
+      fmt::format("Robot {}", ++m_sessionCount), m_logger,
+      nt::GetDefaultInstance())});
 
   m_ntSettings.EnableServerOption(false);
 }
 
 void Logger::Display() {
+  if (ImGui::BeginTabBar("Robots", ImGuiTabBarFlags_AutoSelectNewTabs)) {
+    for (auto it = m_sessions.begin(); it != m_sessions.end();) {
+      auto& session = *it->session;
+      bool open = true;
+      {
+        auto lock = session.Lock();
+
+        // Show the progress of each robot in its tab so that it's visible from
+        // the other tabs.
+        auto label = fmt::format(
+            "{} ({}/4{})###{}", session.GetName(), session.GetCompletedTests(),
+            session.GetManager().IsActive() ? ", running" : "",
+            static_cast<void*>(&session));
+        bool canClose = it != m_sessions.begin();
+        if (ImGui::BeginTabItem(label.c_str(), canClose ? &open : nullptr)) {
+          DisplaySession(*it);
+          ImGui::EndTabItem();
+        }
+      }
+      session.Update();
+
+      if (open) {
+        ++it;
+      } else {
+        it = m_sessions.erase(it);
+      }
+    }
+
+    // Add a tab for another robot.
+    if (ImGui::TabItemButton("+", ImGuiTabItemFlags_Trailing)) {
+      m_sessions.push_back({std::make_unique<CaptureSession>(
+          fmt::format("Robot {}", ++m_sessionCount), m_logger)});
+    }
+    ImGui::EndTabBar();
+  }
+
+  // Run periodic methods.
+  SelectDataFolder();
+  m_ntSettings.Update();
+}
+
+void Logger::DisplaySession(SessionView& view) {
+  auto& session = *view.session;
+  auto& settings = session.GetSettings();
+  bool connected = session.IsConnected();
+
   // Get the current width of the window. This will be used to scale
   // our UI elements.
   float width = ImGui::GetContentRegionAvail().x;
 
+  // Add the name of the robot, which is used in the names of saved files.
+  std::string name = session.GetName();
+  ImGui::SetNextItemWidth(ImGui::GetFontSize() * 12);
+  if (ImGui::InputText("Robot Name", &name) && !name.empty()) {
+    session.SetName(name);
+  }
+
   // Add team number input and apply button for NT connection.
-  m_ntSettings.Display();
+  if (session.OwnsInstance()) {
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 12);
+    ImGui::InputText("Team/IP", &view.server);
+    ImGui::SameLine();
+    if (ImGui::Button("Connect")) {
+      session.Connect(view.server);
+    }
+  } else {
+    m_ntSettings.Display();
+  }
 
   // Reset and clear the internal manager state.
   ImGui::SameLine();
   if (ImGui::Button("Reset Telemetry")) {
-    m_settings = TelemetryManager::Settings{};
-    m_manager = std::make_unique<TelemetryManager>(m_settings, m_logger);
-    m_selectedType = 0;
+    session.Reset();
+    view.selectedType = 0;
+    view.selectedUnit = 0;
   }
 
+  // The manager is looked up after the reset, which replaces it.
+  auto& manager = session.GetManager();
+
   // Add NT connection indicator.
   static ImVec4 kColorDisconnected{1.0f, 0.4f, 0.4f, 1.0f};
   static ImVec4 kColorConnected{0.2f, 1.0f, 0.2f, 1.0f};
   ImGui::SameLine();
-  ImGui::TextColored(m_ntConnected ? kColorConnected : kColorDisconnected,
-                     m_ntConnected ? "NT Connected" : "NT Disconnected");
+  ImGui::TextColored(connected ? kColorConnected : kColorDisconnected,
+                     connected ? "NT Connected" : "NT Disconnected");
 
   // Create a Section for project configuration
   ImGui::Separator();
@@ -69,16 +128,16 @@ void Logger::Display() {
   // Add a dropdown for mechanism type.
   ImGui::SetNextItemWidth(ImGui::GetFontSize() * 12);
 
-  if (ImGui::Combo("Mechanism", &m_selectedType, kTypes,
+  if (ImGui::Combo("Mechanism", &view.selectedType, kTypes,
                    IM_ARRAYSIZE(kTypes))) {
-    m_settings.mechanism = analysis::FromName(kTypes[m_selectedType]);
+    settings.mechanism = analysis::FromName(kTypes[view.selectedType]);
   }
 
   // Add Dropdown for Units
   ImGui::SetNextItemWidth(ImGui::GetFontSize() * 12);
-  if (ImGui::Combo("Unit Type", &m_selectedUnit, kUnits,
+  if (ImGui::Combo("Unit Type", &view.selectedUnit, kUnits,
                    IM_ARRAYSIZE(kUnits))) {
-    m_settings.units = kUnits[m_selectedUnit];
+    settings.units = kUnits[view.selectedUnit];
   }
 
   sysid::CreateTooltip(
@@ -88,23 +147,23 @@ void Logger::Display() {
       "choose meters.");
 
   // Rotational units have fixed Units per rotations
-  m_isRotationalUnits =
-      (m_settings.units == "Rotations" || m_settings.units == "Degrees" ||
-       m_settings.units == "Radians");
-  if (m_settings.units == "Degrees") {
-    m_settings.unitsPerRotation = 360.0;
-  } else if (m_settings.units == "Radians") {
-    m_settings.unitsPerRotation = 2 * wpi::numbers::pi;
-  } else if (m_settings.units == "Rotations") {
-    m_settings.unitsPerRotation = 1.0;
+  bool isRotationalUnits =
+      (settings.units == "Rotations" || settings.units == "Degrees" ||
+       settings.units == "Radians");
+  if (settings.units == "Degrees") {
+    settings.unitsPerRotation = 360.0;
+  } else if (settings.units == "Radians") {
+    settings.unitsPerRotation = 2 * wpi::numbers::pi;
+  } else if (settings.units == "Rotations") {
+    settings.unitsPerRotation = 1.0;
   }
 
   // Units Per Rotations entry
   ImGui::SetNextItemWidth(ImGui::GetFontSize() * 12);
-  ImGui::InputDouble("Units Per Rotation", &m_settings.unitsPerRotation, 0.0f,
+  ImGui::InputDouble("Units Per Rotation", &settings.unitsPerRotation, 0.0f,
                      0.0f, "%.4f",
-                     m_isRotationalUnits ? ImGuiInputTextFlags_ReadOnly
-                                         : ImGuiInputTextFlags_None);
+                     isRotationalUnits ? ImGuiInputTextFlags_ReadOnly
+                                       : ImGuiInputTextFlags_None);
   sysid::CreateTooltip(
       "The logger assumes that the code will be sending recorded output shaft "
       "rotations over NetworkTables. This value will then be multiplied by the "
@@ -116,11 +175,10 @@ void Logger::Display() {
   ImGui::Spacing();
   ImGui::Text("Voltage Parameters");
 
-  auto CreateVoltageParameters = [this](const char* text, double* data,
-                                        float min, float max) {
+  auto CreateVoltageParameters = [&manager](const char* text, double* data,
+                                            float min, float max) {
     ImGui::SetNextItemWidth(ImGui::GetFontSize() * 6);
-    ImGui::PushItemFlag(ImGuiItemFlags_Disabled,
-                        m_manager && m_manager->IsActive());
+    ImGui::PushItemFlag(ImGuiItemFlags_Disabled, manager.IsActive());
     float value = static_cast<float>(*data);
     if (ImGui::SliderFloat(text, &value, min, max, "%.2f")) {
       *data = value;
@@ -129,12 +187,12 @@ void Logger::Display() {
   };
 
   CreateVoltageParameters("Quasistatic Ramp Rate (V/s)",
-                          &m_settings.quasistaticRampRate, 0.10f, 0.60f);
+                          &settings.quasistaticRampRate, 0.10f, 0.60f);
   sysid::CreateTooltip(
       "This is the rate at which the voltage will increase during the "
       "quasistatic test.");
 
-  CreateVoltageParameters("Dynamic Step Voltage (V)", &m_settings.stepVoltage,
+  CreateVoltageParameters("Dynamic Step Voltage (V)", &settings.stepVoltage,
                           2.0f, 10.0f);
   sysid::CreateTooltip(
       "This is the voltage that will be applied for the "
@@ -145,22 +203,22 @@ void Logger::Display() {
   ImGui::Spacing();
   ImGui::Text("Tests");
 
-  auto CreateTest = [this, width](const char* text, const char* itext) {
+  auto CreateTest = [&](const char* text, const char* itext) {
     // Display buttons if we have an NT connection.
-    if (m_ntConnected) {
+    if (connected) {
       // Create button to run tests.
       if (ImGui::Button(text)) {
         // Open the warning message.
         ImGui::OpenPopup("Warning");
-        m_manager->BeginTest(itext);
-        m_opened = text;
+        manager.BeginTest(itext);
+        view.opened = text;
       }
-      if (m_opened == text && ImGui::BeginPopupModal("Warning")) {
-        ImGui::TextWrapped("%s", m_popupText.c_str());
-        if (ImGui::Button(m_manager->IsActive() ? "End Test" : "Close")) {
-          m_manager->EndTest();
+      if (view.opened == text && ImGui::BeginPopupModal("Warning")) {
+        ImGui::TextWrapped("%s", session.GetMessage().c_str());
+        if (ImGui::Button(manager.IsActive() ? "End Test" : "Close")) {
+          manager.EndTest();
           ImGui::CloseCurrentPopup();
-          m_opened = "";
+          view.opened = "";
         }
         ImGui::EndPopup();
       }
@@ -170,7 +228,7 @@ void Logger::Display() {
     }
 
     // Show whether the tests were run or not.
-    bool run = m_manager->HasRunTest(itext);
+    bool run = manager.HasRunTest(itext);
     ImGui::SameLine(width * 0.7);
     ImGui::Text(run ? "Run" : "Not Run");
   };
@@ -180,8 +238,34 @@ void Logger::Display() {
   CreateTest("Dynamic Forward", "fast-forward");
   CreateTest("Dynamic Backward", "fast-backward");
 
-  m_manager->RegisterDisplayCallback(
-      [this](const auto& str) { m_popupText = str; });
+  // Show the live estimate of the gains with their 95% confidence intervals.
+  ImGui::Separator();
+  ImGui::Spacing();
+  ImGui::Text("Live Estimate");
+  sysid::CreateTooltip(
+      "These gains are estimated while the tests run if the robot program "
+      "streams its samples, and otherwise after each test. They aren't "
+      "trimmed like in the analyzer, so use them to tell when enough data has "
+      "been collected rather than as the final gains.");
+
+  const auto& estimator = manager.GetLiveEstimator();
+  auto estimate = estimator.GetEstimate();
+  if (estimate.gains.empty()) {
+    ImGui::TextDisabled("Waiting for data (%zu points)", estimate.points);
+  } else {
+    auto names = estimator.GetGainNames();
+    for (size_t i = 0; i < estimate.gains.size(); ++i) {
+      ImGui::Text("%s", names[i].c_str());
+      ImGui::SameLine(width * 0.15);
+      ImGui::Text("%.4f +/- %.4f", estimate.gains[i],
+                  2 * estimate.stddevs[i]);
+    }
+    bool converged = estimator.IsConverged();
+    ImGui::Text("%zu points", estimate.points);
+    ImGui::SameLine(width * 0.7);
+    ImGui::TextColored(converged ? kColorConnected : kColorDisconnected,
+                       converged ? "Enough Data" : "Collecting");
+  }
 
   // Display the path to where the JSON will be saved and a button to select the
   // location.
@@ -195,11 +279,16 @@ void Logger::Display() {
   ImGui::InputText("##savelocation", &m_jsonLocation,
                    ImGuiInputTextFlags_ReadOnly);
 
-  // Add button to save.
+  // Add button to save. The files of different robots are told apart by the
+  // robot names.
   ImGui::SameLine(width * 0.9);
   if (ImGui::Button("Save")) {
     try {
-      m_manager->SaveJSON(m_jsonLocation);
+      if (m_sessions.size() > 1) {
+        session.SaveJSON(m_jsonLocation);
+      } else {
+        manager.SaveJSON(m_jsonLocation);
+      }
     } catch (const std::exception& e) {
       ImGui::OpenPopup("Exception Caught!");
       m_exception = e.what();
@@ -214,11 +303,6 @@ void Logger::Display() {
     }
     ImGui::EndPopup();
   }
-
-  // Run periodic methods.
-  SelectDataFolder();
-  m_ntSettings.Update();
-  m_manager->Update();
 }
 
 void Logger::SelectDataFolder() {
@@ -38,6 +38,9 @@ namespace sysid {
 static constexpr const char* kUnits[] = {"Meters",  "Feet",      "Inches",
                                          "Radians", "Rotations", "Degrees"};
 
+// The widgets are defined in view/Widgets.cpp, which only the application
+// builds; the analysis library has the other helpers.
+
 /**
  * Displays a tooltip beside the widget that this method is called after with
  * the provided text.
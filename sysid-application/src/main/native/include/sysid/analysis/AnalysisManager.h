@@ -5,7 +5,10 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <iterator>
 #include <limits>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -18,9 +21,14 @@
 #include <wpi/json.h>
 
 #include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/Arena.h"
+#include "sysid/analysis/AutoTune.h"
 #include "sysid/analysis/FeedbackAnalysis.h"
 #include "sysid/analysis/FeedbackControllerPreset.h"
 #include "sysid/analysis/FeedforwardAnalysis.h"
+#include "sysid/analysis/ModelTerms.h"
+#include "sysid/analysis/MotorChannels.h"
+#include "sysid/analysis/ResultCache.h"
 #include "sysid/analysis/Storage.h"
 
 namespace sysid {
@@ -63,6 +71,12 @@ class AnalysisManager {
      */
     int windowSize = 9;
 
+    /**
+     * Whether velocity and acceleration should be estimated with a Kalman
+     * smoother instead of the median filter and finite differences.
+     */
+    bool useKalmanSmoother = false;
+
     /**
      * The dataset that is being analyzed.
      */
@@ -89,6 +103,17 @@ class AnalysisManager {
      * in a smart motor controller).
      */
     bool convertGainsToEncTicks = false;
+
+    /**
+     * The model terms to identify in addition to Ks, Kv, Ka, and the terms
+     * implied by the analysis type (Kg or Kcos).
+     */
+    std::vector<ModelTerm> modelTerms;
+
+    /**
+     * The shape parameters of the nonlinear model terms.
+     */
+    ModelTermParameters modelTermParameters;
   };
 
   /**
@@ -111,6 +136,26 @@ class AnalysisManager {
     std::optional<double> trackWidth;
   };
 
+  /**
+   * Stores the steady-state Kalman filter of a dataset.
+   */
+  struct EstimatorDesign {
+    /**
+     * The name of the dataset (e.g. "Left Combined").
+     */
+    std::string dataset;
+
+    /**
+     * The noise that was measured in the raw data of the dataset.
+     */
+    NoiseCovariances noise;
+
+    /**
+     * The Kalman gains for the noise and the fitted model.
+     */
+    KalmanGains gains;
+  };
+
   /**
    * The keys (which contain sysid data) that are in the JSON to analyze.
    */
@@ -125,6 +170,41 @@ class AnalysisManager {
       "Left Forward",  "Left Backward",  "Left Combined",
       "Right Forward", "Right Backward", "Right Combined"};
 
+  /**
+   * The names of the various datasets to analyze for swerve drives. The pooled
+   * datasets of all modules come first, followed by the datasets of each
+   * module.
+   */
+  static constexpr const char* kSwerveDatasets[] = {
+      "Combined",          "Forward",           "Backward",
+      "Module 1 Forward",  "Module 1 Backward", "Module 1 Combined",
+      "Module 2 Forward",  "Module 2 Backward", "Module 2 Combined",
+      "Module 3 Forward",  "Module 3 Backward", "Module 3 Combined",
+      "Module 4 Forward",  "Module 4 Backward", "Module 4 Combined"};
+
+  static_assert(std::size(kSwerveDatasets) ==
+                    3 * (1 + analysis::kSwerveModuleCount),
+                "Each swerve module needs a set of datasets");
+
+  /**
+   * The values of a test that are stored in columns (e.g. by a program that
+   * analyzes data it has in memory). There's a column for each value in a row
+   * of the test in the JSON, e.g. the timestamp, voltage, position, and
+   * velocity of general mechanisms.
+   */
+  struct Columns {
+    /**
+     * The columns. They're read in place, so they have to stay valid while the
+     * data is prepared.
+     */
+    std::vector<const double*> columns;
+
+    /**
+     * The number of values in each column.
+     */
+    size_t size = 0;
+  };
+
   /**
    * Constructs an instance of the analysis manager with the given path (to the
    * JSON) and analysis manager settings.
@@ -137,10 +217,78 @@ class AnalysisManager {
                   wpi::Logger& logger);
 
   /**
-   * Prepares data from the JSON and stores the output in the StringMap.
+   * Constructs an instance of the analysis manager with the given path. Paths
+   * in strings would otherwise be ambiguous with the JSON constructor.
+   *
+   * @param path     The path to the JSON containing the sysid data.
+   * @param settings The settings for this instance of the analysis manager.
+   * @param logger   The logger instance to use for log data.
+   */
+  AnalysisManager(const std::string& path, Settings& settings,
+                  wpi::Logger& logger)
+      : AnalysisManager(std::string_view{path}, settings, logger) {}
+
+  /**
+   * Constructs an instance of the analysis manager with the contents of a
+   * sysid JSON (e.g. one that was received over the network) and analysis
+   * manager settings.
+   *
+   * @param json     The sysid data.
+   * @param settings The settings for this instance of the analysis manager.
+   * @param logger   The logger instance to use for log data.
+   */
+  AnalysisManager(wpi::json json, Settings& settings, wpi::Logger& logger);
+
+  /**
+   * Constructs an instance of the analysis manager with tests that are stored
+   * in columns instead of a JSON, so that they aren't copied into one.
+   *
+   * @param test             The name of the analysis type (e.g. "Simple").
+   * @param unit             The units of the positions and velocities.
+   * @param unitsPerRotation The conversion factor between rotations and the
+   *                         units.
+   * @param tests            The columns of each test, in the order of
+   *                         kJsonDataKeys.
+   * @param settings         The settings for this instance of the analysis
+   *                         manager.
+   * @param logger           The logger instance to use for log data.
+   */
+  AnalysisManager(std::string_view test, std::string_view unit,
+                  double unitsPerRotation, std::array<Columns, 4> tests,
+                  Settings& settings, wpi::Logger& logger);
+
+  /**
+   * Enables the persistent result cache. The prepared datasets, the last
+   * feedforward gains, and the auto-tuned settings are stored in the cache
+   * keyed by a hash of the capture and the settings they depend on, so
+   * analyzing the same capture with the same settings again (in this or any
+   * other process) loads them instead of running the analysis.
+   *
+   * @param directory The directory of the cache.
+   */
+  void SetCacheDirectory(std::string_view directory);
+
+  /**
+   * Prepares data from the JSON and stores the output in the StringMap. The
+   * datasets are loaded from the result cache if it's enabled and contains
+   * them.
    */
   void PrepareData();
 
+  /**
+   * Picks the motion threshold and step test duration from the data and
+   * prepares the data with them.
+   *
+   * The velocity noise floor is estimated from the quasistatic tests and the
+   * steady-state onset from the dynamic tests. Motion thresholds around the
+   * noise floor and durations around the onset are then evaluated in
+   * parallel, and the pair whose feedforward fit of the selected dataset has
+   * the highest r-squared is stored in the settings.
+   *
+   * @return The selected settings and the estimates they were derived from.
+   */
+  AutoTuneResult AutoTune();
+
   /**
    * Calculates the gains with the latest data (from the pointers in the
    * settings struct that this instance was constructed with).
@@ -149,9 +297,48 @@ class AnalysisManager {
    */
   Gains Calculate();
 
+  /**
+   * Calculates the feedforward gains of each swerve module separately. The
+   * modules are fit in parallel using the combined dataset of each module.
+   *
+   * @return The feedforward gains and r-squared of each module, in module
+   *         order. This is empty if the analysis type isn't a swerve type.
+   */
+  std::vector<std::tuple<std::vector<double>, double>> CalculateSwerveModules();
+
+  /**
+   * Analyzes each motor of a multi-motor capture separately. Each motor is fit
+   * with its own applied voltage and built-in encoder, and motors whose
+   * velocity ratio, Kv, or current deviates from the others are flagged as
+   * slipping or mismatched. The motors are fit in parallel.
+   *
+   * @return The diagnostics of each motor, in motor order. This is empty if
+   *         the capture doesn't contain per-motor channels.
+   */
+  std::vector<MotorDiagnostics> CalculateMotorChannels();
+
+  /**
+   * Designs a steady-state Kalman filter for each combined dataset (e.g. each
+   * side of a drivetrain) to go with the feedback gains. The process and
+   * measurement noise are measured from the residuals of the fitted model on
+   * the raw data, and the Kalman gains of all datasets are solved together
+   * for the loop type and period of the feedback controller preset.
+   *
+   * @return The estimator of each combined dataset, in dataset order.
+   */
+  std::vector<EstimatorDesign> CalculateEstimators();
+
   /**
    * Overrides the units in the JSON with the user-provided ones.
    *
+   * Positions, velocities, and accelerations scale linearly with the units, so
+   * the prepared data isn't rebuilt. Instead, the stored datasets are rescaled
+   * the next time they're accessed and the last feedforward gains are
+   * converted analytically. The settings that are in units (the motion
+   * threshold, the LQR tolerances, and the model term shape parameters) are
+   * converted as well so that the trimming is unchanged. The data is only
+   * prepared again if the cosine of arm positions would change.
+   *
    * @param unit             The unit to output gains in.
    * @param unitsPerRotation The conversion factor between rotations and the
    *                         selected unit.
@@ -170,6 +357,15 @@ class AnalysisManager {
    */
   const AnalysisType& GetAnalysisType() const { return m_type; }
 
+  /**
+   * Returns the model terms that are identified on top of Ks, Kv, and Ka. These
+   * are the terms implied by the analysis type followed by the terms selected
+   * in the settings.
+   *
+   * @return The extra model terms, in the order their gains are returned.
+   */
+  std::vector<ModelTerm> GetModelTerms() const;
+
   /**
    * Returns the units of analysis.
    *
@@ -184,6 +380,21 @@ class AnalysisManager {
    */
   double GetFactor() const { return m_factor; }
 
+  /**
+   * Returns the number of motors whose channels were recorded in the capture.
+   *
+   * @return The number of motors with per-motor channels.
+   */
+  size_t GetMotorCount() const { return m_motorCount; }
+
+  /**
+   * Returns the names of the datasets that are available for the analysis
+   * type. The dataset index in the settings refers to this list.
+   *
+   * @return The dataset names.
+   */
+  const std::vector<const char*>& GetDatasets() const { return m_datasets; }
+
   /**
    * Returns a reference to the iterator of the currently selected raw datset.
    * Unfortunately, due to ImPlot internals, the reference cannot be const so
@@ -191,7 +402,10 @@ class AnalysisManager {
    *
    * @return A reference to the raw internal data.
    */
-  Storage& GetRawData() { return m_rawDatasets[kDatasets[m_settings.dataset]]; }
+  Storage& GetRawData() {
+    ApplyPendingScale();
+    return m_rawDatasets[m_datasets[m_settings.dataset]];
+  }
 
   /**
    * Returns a reference to the iterator of the currently selected filtered
@@ -201,7 +415,8 @@ class AnalysisManager {
    * @return A reference to the filtered internal data.
    */
   Storage& GetFilteredData() {
-    return m_filteredDatasets[kDatasets[m_settings.dataset]];
+    ApplyPendingScale();
+    return m_filteredDatasets[m_datasets[m_settings.dataset]];
   }
 
   /**
@@ -210,7 +425,8 @@ class AnalysisManager {
    * @return The original (untouched) dataset
    */
   Storage& GetOriginalData() {
-    return m_originalDatasets[kDatasets[m_settings.dataset]];
+    ApplyPendingScale();
+    return m_originalDatasets[m_datasets[m_settings.dataset]];
   }
 
   /**
@@ -237,12 +453,122 @@ class AnalysisManager {
   const std::array<units::second_t, 4> GetStartTimes() { return m_startTimes; }
 
  private:
+  /**
+   * The feedforward gains of the last Calculate() call, along with the fit
+   * settings they were calculated with.
+   */
+  struct FeedforwardCache {
+    int dataset;
+    std::vector<ModelTerm> terms;
+    ModelTermParameters params;
+    std::tuple<std::vector<double>, double> gains;
+  };
+
+  /**
+   * Reads the analysis type, datasets, and units from the JSON, and splits
+   * continuous captures into tests.
+   */
+  void Initialize();
+
+  /**
+   * Multiplies the positions, velocities, and accelerations of all stored
+   * datasets by the scale left over from unit overrides.
+   */
+  void ApplyPendingScale();
+
+  /**
+   * Prepares the datasets of the JSON with the given settings. This doesn't
+   * touch the stored datasets, so candidate settings can be evaluated in
+   * parallel. The arena is reset first.
+   *
+   * @param settings          The settings to trim and filter the data with.
+   * @param originalDatasets  Where to store the original datasets.
+   * @param rawDatasets       Where to store the raw datasets.
+   * @param filteredDatasets  Where to store the filtered datasets.
+   * @param startTimes        Where to store the start times of the tests.
+   * @param minDuration       Where to store the minimum step test duration.
+   * @param maxDuration       Where to store the maximum step test duration.
+   * @param trackWidth        Where to store the track width of angular
+   *                          drivetrain tests.
+   * @param motorDiagnostics  Where to store the per-motor diagnostics.
+   * @param arena             The arena to allocate transient buffers from.
+   * @param logger            The logger instance to use for log data.
+   */
+  void PrepareDatasets(Settings& settings,
+                       wpi::StringMap<Storage>& originalDatasets,
+                       wpi::StringMap<Storage>& rawDatasets,
+                       wpi::StringMap<Storage>& filteredDatasets,
+                       std::array<units::second_t, 4>& startTimes,
+                       units::second_t& minDuration,
+                       units::second_t& maxDuration,
+                       std::optional<double>& trackWidth,
+                       std::vector<MotorDiagnostics>& motorDiagnostics,
+                       Arena& arena, wpi::Logger& logger) const;
+
+  /**
+   * Returns the key of the prepared datasets in the result cache, which
+   * hashes the capture and the settings that data preparation depends on.
+   */
+  uint64_t GetPreparedDataKey() const;
+
+  /**
+   * Returns the key of the auto-tuned settings in the result cache, which
+   * hashes the capture and the settings that the candidates are evaluated
+   * with.
+   */
+  uint64_t GetAutoTuneKey() const;
+
+  /**
+   * Loads the prepared datasets and the feedforward gains that were fit to
+   * them from the result cache. Nothing is changed on a miss.
+   *
+   * @param key The key of the prepared datasets.
+   * @return True if the datasets were loaded.
+   */
+  bool LoadCachedData(uint64_t key);
+
+  /**
+   * Stores the prepared datasets and the last feedforward gains in the result
+   * cache.
+   *
+   * @param key The key of the prepared datasets.
+   */
+  void StoreCachedData(uint64_t key);
+
+  /**
+   * Calculates the feedforward gains of a dataset with the model terms of the
+   * analysis type and settings.
+   *
+   * @param data     The dataset to fit.
+   * @param resource The memory resource to allocate the design matrix from.
+   * @return The feedforward gains and the r-squared of the fit.
+   */
+  std::tuple<std::vector<double>, double> CalculateFeedforward(
+      const Storage& data,
+      std::pmr::memory_resource* resource =
+          std::pmr::get_default_resource()) const;
+
+  /**
+   * Calculates the feedforward gains of several filtered datasets, each on its
+   * own thread.
+   *
+   * @param names The names of the datasets (e.g. "Module 1 Combined").
+   * @return The feedforward gains and the r-squared of the fit of each
+   *         dataset, in the order of the names.
+   */
+  std::vector<std::tuple<std::vector<double>, double>> CalculateFeedforwards(
+      const std::vector<std::string>& names);
+
   wpi::Logger& m_logger;
 
   // This is used to store the various datasets (i.e. Combined, Forward,
   // Backward, etc.)
   wpi::json m_json;
 
+  // The columns of the tests if they weren't read from a JSON. The JSON only
+  // contains the analysis type and units then.
+  std::optional<std::array<Columns, 4>> m_columns;
+
   wpi::StringMap<Storage> m_originalDatasets;
   wpi::StringMap<Storage> m_rawDatasets;
   wpi::StringMap<Storage> m_filteredDatasets;
@@ -257,13 +583,43 @@ class AnalysisManager {
   // Miscellaneous data from the JSON -- the analysis type, the units, and the
   // units per rotation.
   AnalysisType m_type;
+  std::vector<const char*> m_datasets;
+  std::vector<std::string> m_motorDatasets;
   std::string m_unit;
   double m_factor;
 
+  // The scale from unit overrides that hasn't been applied to the stored
+  // datasets yet.
+  double m_pendingScale = 1.0;
+
+  // The last feedforward gains, which are converted on unit overrides instead
+  // of being refit.
+  std::optional<FeedforwardCache> m_feedforwardCache;
+
+  // The transient buffers of data preparation and fitting, which are freed at
+  // once before the next run.
+  Arena m_arena;
+
   units::second_t m_minDuration;
   units::second_t m_maxDuration;
 
+  // The path of the JSON that was read (if it was read from a file) and the
+  // hash of its contents, which key the results in the result cache.
+  std::string m_path;
+  uint64_t m_captureHash = 0;
+
+  // The result cache, if it's enabled, and the key of the stored datasets in
+  // it. The key is reset when the datasets no longer match it (e.g. after
+  // they're rescaled by unit overrides).
+  std::optional<ResultCache> m_cache;
+  std::optional<uint64_t> m_cacheKey;
+
   // Stores an optional track width if we are doing the drivetrain angular test.
   std::optional<double> m_trackWidth;
+
+  // The number of motors with per-motor channels, along with the velocity
+  // ratio and mean current of each motor from the raw data.
+  size_t m_motorCount = 0;
+  std::vector<MotorDiagnostics> m_motorDiagnostics;
 };
 }  // namespace sysid
@@ -0,0 +1,77 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <wpi/EventLoopRunner.h>
+#include <wpi/Logger.h>
+
+#include "sysid/analysis/AnalysisService.h"
+#include "sysid/analysis/BatchAnalysis.h"
+
+namespace wpi::uv {
+class Tcp;
+}  // namespace wpi::uv
+
+namespace sysid {
+
+/**
+ * A local HTTP server that lets other tools (e.g. trajectory planners and
+ * dashboards) run analyses in one long-running process, so that they don't
+ * have to link the analysis and can share its result cache.
+ *
+ * The server only listens on the loopback interface and serves:
+ *
+ * - POST /analyze: runs an AnalysisService request from the JSON body and
+ *   responds with the JSON response. A 503 response has a Retry-After header.
+ * - GET /status: responds with AnalysisService::GetStatus().
+ */
+class AnalysisServer {
+ public:
+  /**
+   * The default port of the server.
+   */
+  static constexpr unsigned int kDefaultPort = 5830;
+
+  /**
+   * The largest request body that is accepted, in bytes.
+   */
+  static constexpr size_t kMaxRequestSize = 64 << 20;
+
+  /**
+   * Starts the server.
+   *
+   * @param defaults      The settings to analyze captures with.
+   * @param workers       The number of requests to run in parallel.
+   * @param queueCapacity The number of requests that can wait for a worker.
+   * @param port          The port to listen on.
+   * @param logger        The logger instance to use for log data.
+   * @throws std::runtime_error if the port can't be listened on.
+   */
+  AnalysisServer(BatchSettings defaults, size_t workers, size_t queueCapacity,
+                 unsigned int port, wpi::Logger& logger);
+
+  /**
+   * Stops the server. The listener is closed and new requests are rejected
+   * first, then the requests that the service is still running are answered,
+   * and the event loop is stopped last.
+   */
+  ~AnalysisServer();
+
+  AnalysisServer(const AnalysisServer&) = delete;
+  AnalysisServer& operator=(const AnalysisServer&) = delete;
+
+ private:
+  wpi::EventLoopRunner m_runner;
+  std::unique_ptr<AnalysisService> m_service;
+
+  // These are only used from the event loop.
+  std::shared_ptr<wpi::uv::Tcp> m_listener;
+  bool m_closed = false;
+};
+
+}  // namespace sysid
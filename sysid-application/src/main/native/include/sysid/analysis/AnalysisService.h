@@ -0,0 +1,127 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <wpi/Logger.h>
+#include <wpi/json.h>
+
+#include "sysid/analysis/BatchAnalysis.h"
+
+namespace sysid {
+
+/**
+ * Runs analysis requests from other tools (e.g. through the analysis server)
+ * on a pool of workers.
+ *
+ * A request is a JSON object with either a "path" to a capture on this machine
+ * or the sysid JSON of a "capture", and optional "settings" with the keys of
+ * ParseBatchSettings() that override the defaults of the service. The
+ * response is the result of AnalyzeCapture(), or an object with an "error".
+ *
+ * The queue of requests is bounded. Requests that don't fit are rejected right
+ * away so that clients back off instead of piling up work.
+ */
+class AnalysisService {
+ public:
+  /**
+   * A response to a request, with an HTTP status code.
+   */
+  struct Response {
+    /**
+     * 200 if the capture was analyzed, 400 if the request is malformed, 422 if
+     * the capture couldn't be analyzed, and 503 if the queue is full.
+     */
+    int status;
+
+    /**
+     * The results or the error.
+     */
+    wpi::json body;
+  };
+
+  /**
+   * The function that receives the response to a request.
+   */
+  using Callback = std::function<void(Response)>;
+
+  /**
+   * Creates the service and starts its workers.
+   *
+   * @param defaults      The settings to analyze captures with.
+   * @param workers       The number of requests to run in parallel.
+   * @param queueCapacity The number of requests that can wait for a worker.
+   * @param logger        The logger instance to use for log data. It's only
+   *                      used by one thread at a time.
+   */
+  AnalysisService(BatchSettings defaults, size_t workers, size_t queueCapacity,
+                  wpi::Logger& logger);
+
+  /**
+   * Stops the workers once the requests that are running finish. Queued
+   * requests are rejected.
+   */
+  ~AnalysisService();
+
+  AnalysisService(const AnalysisService&) = delete;
+  AnalysisService& operator=(const AnalysisService&) = delete;
+
+  /**
+   * Queues a request.
+   *
+   * @param request  The request.
+   * @param callback The function that receives the response. It's called from
+   *                 a worker, or from this call if the request is rejected.
+   */
+  void Submit(wpi::json request, Callback callback);
+
+  /**
+   * Returns the state of the service: the number of "queued" and "active"
+   * requests, the number of "workers", the "queueCapacity", and the number of
+   * requests that were "completed" and "rejected".
+   */
+  wpi::json GetStatus();
+
+ private:
+  /**
+   * Runs queued requests until the service is destroyed.
+   */
+  void Work();
+
+  /**
+   * Runs a request.
+   *
+   * @param request The request.
+   * @param logger  The logger instance of the worker.
+   */
+  Response Handle(const wpi::json& request, wpi::Logger& logger);
+
+  BatchSettings m_defaults;
+  size_t m_queueCapacity;
+
+  // The logger is shared by the workers, which log through it one at a time.
+  wpi::Logger& m_logger;
+  std::mutex m_logMutex;
+
+  std::mutex m_mutex;
+  std::condition_variable m_queueChanged;
+  std::deque<std::pair<wpi::json, Callback>> m_queue;
+  size_t m_active = 0;
+  size_t m_completed = 0;
+  size_t m_rejected = 0;
+  bool m_stopping = false;
+
+  std::vector<std::thread> m_workers;
+};
+
+}  // namespace sysid
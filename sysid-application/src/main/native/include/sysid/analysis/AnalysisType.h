@@ -58,6 +58,26 @@ constexpr AnalysisType kElevator{4, 4, "Elevator"};
 constexpr AnalysisType kArm{4, 4, "Arm"};
 constexpr AnalysisType kSimple{3, 4, "Simple"};
 
+/**
+ * The number of modules recorded in a swerve drive capture.
+ */
+constexpr size_t kSwerveModuleCount = 4;
+
+constexpr AnalysisType kSwerveDrive{3, 2 + 2 * kSwerveModuleCount,
+                                    "Swerve Drive"};
+constexpr AnalysisType kSwerveSteer{3, 2 + 2 * kSwerveModuleCount,
+                                    "Swerve Steer"};
+
+/**
+ * Returns whether the analysis type records every module of a swerve drive.
+ *
+ * @param type The analysis type.
+ * @return True if the analysis type is a swerve drive or steer analysis.
+ */
+constexpr bool IsSwerve(const AnalysisType& type) {
+  return type == kSwerveDrive || type == kSwerveSteer;
+}
+
 AnalysisType FromName(std::string_view name);
 }  // namespace analysis
 }  // namespace sysid
@@ -0,0 +1,89 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace sysid {
+
+/**
+ * A monotonic arena for the transient buffers of one analysis (e.g. the raw
+ * JSON rows and the OLS design matrix).
+ *
+ * Allocations are bump-allocated from a single block and are only freed all
+ * at once by Reset(). When a run doesn't fit in the block, the overflow is
+ * allocated from the heap and the block is grown to the total size on the next
+ * reset, so repeating the same analysis (e.g. when a slider is dragged)
+ * doesn't allocate from the heap at all.
+ *
+ * The arena isn't thread-safe, so each thread needs its own arena.
+ */
+class Arena {
+ public:
+  /**
+   * Creates an arena.
+   *
+   * @param capacity The initial size of the block in bytes.
+   */
+  explicit Arena(size_t capacity = 0);
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /**
+   * Returns the memory resource that allocates from the arena, for use with
+   * std::pmr containers.
+   */
+  std::pmr::memory_resource* GetResource() { return &*m_resource; }
+
+  /**
+   * Frees everything that was allocated from the arena. Nothing allocated
+   * from the arena may be used afterwards.
+   */
+  void Reset();
+
+  /**
+   * Returns the size of the block in bytes.
+   */
+  size_t GetCapacity() const { return m_capacity; }
+
+  /**
+   * Returns the number of heap allocations since the last reset, which is
+   * zero when the allocations fit in the block.
+   */
+  size_t GetHeapAllocations() const { return m_heap.allocations; }
+
+ private:
+  /**
+   * Allocates overflow from the heap and keeps track of how much was
+   * allocated.
+   */
+  class HeapResource : public std::pmr::memory_resource {
+   public:
+    size_t allocations = 0;
+    size_t bytes = 0;
+
+   private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override;
+  };
+
+  /**
+   * Creates the monotonic resource that allocates from the block.
+   */
+  void CreateResource();
+
+  HeapResource m_heap;
+  std::unique_ptr<std::byte[]> m_block;
+  size_t m_capacity = 0;
+  std::optional<std::pmr::monotonic_buffer_resource> m_resource;
+};
+
+}  // namespace sysid
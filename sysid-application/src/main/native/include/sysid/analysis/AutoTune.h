@@ -0,0 +1,201 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <units/time.h>
+
+#include "sysid/analysis/ModelTerms.h"
+#include "sysid/analysis/Storage.h"
+
+namespace sysid {
+
+/**
+ * The motion threshold and step test duration picked by the auto-tuner, along
+ * with the estimates they were derived from.
+ */
+struct AutoTuneResult {
+  /**
+   * The selected motion threshold (units/s).
+   */
+  double motionThreshold = 0.0;
+
+  /**
+   * The selected step test duration.
+   */
+  units::second_t stepTestDuration = 0_s;
+
+  /**
+   * The r-squared of the feedforward fit with the selected settings.
+   */
+  double rSquared = 0.0;
+
+  /**
+   * The cross-validated RMSE (V) of the voltage that the gains of the
+   * selected settings predict, which is what the candidates are ranked by.
+   */
+  double rmse = 0.0;
+
+  /**
+   * The estimated noise floor (units/s) of the velocity measurements.
+   */
+  double velocityNoiseFloor = 0.0;
+
+  /**
+   * The estimated time after the start of the dynamic tests at which the
+   * mechanism reaches steady state.
+   */
+  units::second_t steadyStateOnset = 0_s;
+
+  /**
+   * The number of candidate settings that were evaluated.
+   */
+  size_t candidates = 0;
+};
+
+/**
+ * Splits the concatenated tests of a dataset (e.g. the forward and backward
+ * tests of a combined dataset) wherever the timestamps jump backwards or
+ * pause for more than half a second.
+ *
+ * @param data The concatenated tests.
+ * @return The individual tests.
+ */
+std::vector<std::vector<PreparedData>> SplitTests(
+    const std::vector<PreparedData>& data);
+
+/**
+ * Estimates the noise floor of the velocity measurements of a test.
+ *
+ * This is the larger of the velocity quantization step and the standard
+ * deviation of the velocity noise. Encoders report velocity in multiples of a
+ * small step at low speeds, so most nonzero changes between samples are a
+ * single step, which is found with a low percentile of those changes. The
+ * white noise is estimated with the median absolute deviation of the second
+ * differences of velocity, which cancel out smooth motion.
+ *
+ * @param data The raw data of a test.
+ * @return The velocity noise floor (units/s).
+ */
+double EstimateVelocityNoiseFloor(const std::vector<PreparedData>& data);
+
+/**
+ * Estimates the standard deviation of the acceleration noise of a test from
+ * the median absolute deviation of the acceleration from a centered moving
+ * average. Unlike GetAccelNoiseFloor(), this isn't inflated by a few large
+ * spikes (e.g. when the mechanism hits a hard stop).
+ *
+ * @param data   The data of a test with acceleration.
+ * @param window The size of the moving average window.
+ * @return The standard deviation of the acceleration noise.
+ */
+double EstimateAccelNoise(const std::vector<PreparedData>& data, int window);
+
+/**
+ * Finds the sample at which a dynamic test reaches steady state.
+ *
+ * Treats the acceleration after the change point as zero-mean noise. Scanning
+ * from the peak acceleration, every sample adds its squared acceleration minus
+ * twice the noise variance to a running cost, so samples during the transient
+ * raise the cost and samples that are explained by noise lower it. The change
+ * point is where the cost peaks. The scan stops once the cost has dropped well
+ * below its peak, so that later events (e.g. a hard stop) are ignored. This
+ * runs in linear time.
+ *
+ * @param data       The raw data of a dynamic test with acceleration.
+ * @param accelNoise The standard deviation of the acceleration noise.
+ * @return The index of the first steady-state sample.
+ */
+size_t FindSteadyStateOnset(const std::vector<PreparedData>& data,
+                            double accelNoise);
+
+/**
+ * The largest motion threshold that is tried other than the configured one, as
+ * a fraction of the largest velocity of the quasistatic tests. The velocity of
+ * a quasistatic test ramps up linearly once the mechanism breaks away, so this
+ * is about the fraction of the moving samples that the threshold trims.
+ * Higher thresholds throw away the slow samples that Ks is identified from.
+ */
+inline constexpr double kMaxQuasistaticTrim = 0.25;
+
+/**
+ * The number of folds that the candidate settings are cross-validated with.
+ */
+inline constexpr size_t kValidationFolds = 5;
+
+/**
+ * Returns the candidate motion thresholds for a velocity noise floor. These
+ * are the multiples of the noise floor up to kMaxQuasistaticTrim of the
+ * largest velocity, and the configured threshold.
+ *
+ * @param noiseFloor  The velocity noise floor (units/s).
+ * @param maxVelocity The largest velocity of the quasistatic tests.
+ * @param configured  The configured motion threshold (units/s), which is
+ *                    always tried so that auto-tuning can keep it. Noise-free
+ *                    data needs it, since the velocity chatters while static
+ *                    friction holds the mechanism and the noise floor doesn't
+ *                    see that.
+ * @return The candidate motion thresholds, in increasing order.
+ */
+std::vector<double> GetMotionThresholdCandidates(double noiseFloor,
+                                                 double maxVelocity,
+                                                 double configured = 0.0);
+
+/**
+ * Returns the candidate step test durations for a steady-state onset. These
+ * are multiples of the onset, limited to the durations of the tests.
+ *
+ * @param onset       The time at which the dynamic tests reach steady state.
+ * @param minDuration The minimum step test duration.
+ * @param maxDuration The maximum step test duration.
+ * @return The candidate durations, in increasing order.
+ */
+std::vector<units::second_t> GetStepDurationCandidates(
+    units::second_t onset, units::second_t minDuration,
+    units::second_t maxDuration);
+
+/**
+ * Returns the cross-validation fold of a sample. The folds take turns every
+ * quarter second, so that each fold covers every test while neighboring
+ * samples, whose errors are correlated by the filters, stay together.
+ *
+ * @param timestamp The timestamp of the sample.
+ * @return The fold, less than kValidationFolds.
+ */
+size_t GetValidationFold(units::second_t timestamp);
+
+/**
+ * Returns the samples of a dataset that aren't in a cross-validation fold,
+ * i.e. the training data of the fold.
+ *
+ * @param data The dataset.
+ * @param fold The fold to leave out.
+ */
+Storage ExcludeValidationFold(const Storage& data, size_t fold);
+
+/**
+ * Adds the squared errors of the voltage that feedforward gains predict for
+ * the samples of a cross-validation fold. Unlike the r-squared of a fit, the
+ * errors over a fixed set of samples don't improve when a candidate trims
+ * the samples that are hard to fit.
+ *
+ * @param data   The validation samples, with acceleration.
+ * @param fold   The fold to add the errors of.
+ * @param gains  The feedforward gains (Ks, Kv, Ka, followed by the gains of
+ *               the model terms).
+ * @param terms  The model terms after Ks, Kv, and Ka.
+ * @param params The shape parameters of the nonlinear model terms.
+ * @param sum    The sum of the squared errors.
+ * @param count  The number of errors.
+ */
+void AddVoltageErrors(const std::vector<PreparedData>& data, size_t fold,
+                      const std::vector<double>& gains,
+                      const std::vector<ModelTerm>& terms,
+                      const ModelTermParameters& params, double* sum,
+                      size_t* count);
+
+}  // namespace sysid
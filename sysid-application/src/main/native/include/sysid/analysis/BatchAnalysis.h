@@ -0,0 +1,164 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include <wpi/Logger.h>
+#include <wpi/json.h>
+
+#include "sysid/analysis/AnalysisManager.h"
+
+namespace sysid {
+
+/**
+ * The settings that captures are analyzed with when nobody is at the analyzer
+ * to pick them (e.g. by the watch service).
+ */
+struct BatchSettings {
+  /**
+   * The analysis settings. The motion threshold and step test duration are
+   * only used if auto-tuning is disabled.
+   */
+  AnalysisManager::Settings analysis;
+
+  /**
+   * Whether the motion threshold and step test duration are auto-tuned.
+   */
+  bool autoTune = true;
+
+  /**
+   * The name of the dataset to report the gains of.
+   */
+  std::string dataset = "Combined";
+
+  /**
+   * The directory of the result cache, or empty to disable the cache.
+   */
+  std::string cacheDirectory;
+};
+
+/**
+ * The time that each stage of RunAnalysis() took.
+ */
+struct AnalysisTimings {
+  /**
+   * Filtering and trimming the data, including auto-tuning, in seconds.
+   */
+  double prepare = 0;
+
+  /**
+   * Fitting the feedforward and feedback gains, in seconds.
+   */
+  double calculate = 0;
+};
+
+/**
+ * Reads batch settings from JSON. Every key is optional and defaults to the
+ * given settings:
+ *
+ * - "preset": the name of a gain preset, as listed in the analyzer.
+ * - "loopType": "Position" or "Velocity".
+ * - "lqr": an object with "qp", "qv", and "r".
+ * - "autoTune": whether to auto-tune the motion threshold and test duration.
+ * - "motionThreshold" and "stepTestDuration": the values to use otherwise.
+ * - "windowSize" and "useKalmanSmoother": the velocity estimation settings.
+ * - "dataset": the name of the dataset to report the gains of.
+ * - "modelTerms": the gain names (e.g. "Kstribeck") of the extra model terms.
+ * - "stribeckVelocity" and "backlashWidth": the positive shape parameters of
+ *   those terms.
+ * - "convertGainsToEncTicks", "cpr", and "gearing": the encoder conversion.
+ *
+ * @param json     The settings to read.
+ * @param defaults The settings to use for missing keys.
+ * @return The settings.
+ */
+BatchSettings ParseBatchSettings(const wpi::json& json,
+                                 BatchSettings defaults = {});
+
+/**
+ * Reads batch settings from a JSON file with the keys described in
+ * ParseBatchSettings(). Missing keys default to the analyzer's defaults.
+ *
+ * @param path The path of the settings file.
+ * @return The settings.
+ */
+BatchSettings LoadBatchSettings(std::string_view path);
+
+/**
+ * Selects the dataset of the settings, prepares the data (auto-tuning the
+ * motion threshold and test duration if the settings ask for it), and
+ * calculates the gains, the way the analyzer does when a capture is opened.
+ *
+ * @param manager          The analysis manager of the capture.
+ * @param analysisSettings The settings that the manager was constructed with.
+ *                         The auto-tuned values are stored in them.
+ * @param settings         The batch settings.
+ * @param logger           The logger instance to use for log data.
+ * @param timings          If not null, the time that each stage took is
+ *                         stored in it.
+ * @return The gains of the selected dataset.
+ * @throws std::runtime_error if the dataset doesn't exist or the data can't
+ *         be analyzed.
+ */
+AnalysisManager::Gains RunAnalysis(AnalysisManager& manager,
+                                   AnalysisManager::Settings& analysisSettings,
+                                   const BatchSettings& settings,
+                                   wpi::Logger& logger,
+                                   AnalysisTimings* timings = nullptr);
+
+/**
+ * Analyzes a capture without the GUI, the same way the analyzer does when the
+ * capture is opened.
+ *
+ * @param path     The path of the capture.
+ * @param settings The settings to analyze the capture with.
+ * @param logger   The logger instance to use for log data.
+ * @return The results, with the analysis type and units, the settings that
+ *         were used, the feedforward gains by name with the r-squared, the
+ *         feedback gains, and the per-module or per-motor gains when the
+ *         capture has them.
+ */
+wpi::json AnalyzeCapture(std::string_view path, const BatchSettings& settings,
+                         wpi::Logger& logger);
+
+/**
+ * Analyzes the contents of a capture without the GUI, like AnalyzeCapture().
+ *
+ * @param capture  The sysid data of the capture.
+ * @param settings The settings to analyze the capture with.
+ * @param logger   The logger instance to use for log data.
+ * @return The results, which don't have a capture file name.
+ */
+wpi::json AnalyzeCaptureData(wpi::json capture,
+                             const BatchSettings& settings,
+                             wpi::Logger& logger);
+
+/**
+ * Returns the path that the results of a capture are written to, which is
+ * next to the capture.
+ *
+ * @param capturePath The path of the capture.
+ */
+std::string GetResultPath(std::string_view capturePath);
+
+/**
+ * Returns the path of the summary of the captures in a directory, which lists
+ * the latest results.
+ *
+ * @param directory The directory of the captures.
+ */
+std::string GetSummaryPath(std::string_view directory);
+
+/**
+ * Returns whether a file looks like a capture, i.e. it's a JSON file that
+ * isn't a result or summary written by the batch tools.
+ *
+ * @param path The path of the file.
+ */
+bool IsCapturePath(std::string_view path);
+
+}  // namespace sysid
@@ -0,0 +1,156 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <wpi/Logger.h>
+#include <wpi/json.h>
+
+#include "sysid/analysis/BatchAnalysis.h"
+
+namespace sysid {
+
+/**
+ * A headless service that watches directories for new captures (e.g. the ones
+ * that the logger saves) and analyzes them on a pool of workers as soon as
+ * they're written. The results of each capture are written next to it, and
+ * the latest results in each directory are listed in a summary.
+ *
+ * Directories are watched with inotify on Linux and polled elsewhere.
+ */
+class CaptureWatcher {
+ public:
+  /**
+   * The number of results that are kept in the summary of a directory.
+   */
+  static constexpr size_t kSummarySize = 50;
+
+  /**
+   * Creates the service. Nothing is watched until Start() is called.
+   *
+   * @param directories The directories to watch.
+   * @param settings    The settings to analyze captures with.
+   * @param workers     The number of captures to analyze in parallel.
+   * @param logger      The logger instance to use for log data. It's only
+   *                    used by one thread at a time.
+   */
+  CaptureWatcher(std::vector<std::string> directories, BatchSettings settings,
+                 size_t workers, wpi::Logger& logger);
+
+  ~CaptureWatcher();
+
+  CaptureWatcher(const CaptureWatcher&) = delete;
+  CaptureWatcher& operator=(const CaptureWatcher&) = delete;
+
+  /**
+   * Starts watching. Captures that were written while the service wasn't
+   * running (i.e. they don't have results or their results are older) are
+   * analyzed first.
+   */
+  void Start();
+
+  /**
+   * Stops watching and waits for the captures that are being analyzed.
+   * Captures that are still queued are picked up by the next Start().
+   */
+  void Stop();
+
+  /**
+   * Waits until no captures are queued or being analyzed.
+   */
+  void WaitUntilIdle();
+
+  /**
+   * Returns the number of captures that were analyzed, including the ones
+   * that couldn't be analyzed.
+   */
+  size_t GetAnalyzedCount();
+
+ private:
+  /**
+   * Queues the captures in the watched directories that need to be analyzed.
+   */
+  void Scan();
+
+  /**
+   * Queues captures as they're written until the service is stopped.
+   */
+  void Watch();
+
+  /**
+   * Polls the watched directories for captures until the service is stopped.
+   * This is used where inotify isn't available.
+   */
+  void Poll();
+
+  /**
+   * Analyzes queued captures until the service is stopped.
+   */
+  void Work();
+
+  /**
+   * Queues a capture unless it's already queued or being analyzed.
+   *
+   * @param path The path of the capture.
+   */
+  void Enqueue(const std::string& path);
+
+  /**
+   * Analyzes a capture and writes its results and the summary.
+   *
+   * @param path   The path of the capture.
+   * @param logger The logger instance of the worker.
+   */
+  void Analyze(const std::string& path, wpi::Logger& logger);
+
+  /**
+   * Adds the results of a capture to the summary of its directory.
+   *
+   * @param path   The path of the capture.
+   * @param result The results of the capture.
+   */
+  void UpdateSummary(const std::string& path, const wpi::json& result);
+
+  std::vector<std::string> m_directories;
+  BatchSettings m_settings;
+  size_t m_workerCount;
+
+  // The logger is shared by the workers, which log through it one at a time.
+  wpi::Logger& m_logger;
+  std::mutex m_logMutex;
+
+  // The queue of captures, along with the captures that are queued or being
+  // analyzed so that they aren't queued twice.
+  std::mutex m_mutex;
+  std::condition_variable m_queueChanged;
+  std::condition_variable m_idle;
+  std::deque<std::string> m_queue;
+  std::set<std::string> m_pending;
+  size_t m_active = 0;
+  size_t m_analyzed = 0;
+  bool m_stopping = false;
+
+  // Guards the summaries, which are read, updated, and rewritten.
+  std::mutex m_summaryMutex;
+
+  // The inotify instance on Linux and the directories of its watches.
+  int m_inotify = -1;
+  std::map<int, std::string> m_watches;
+
+  std::thread m_watcher;
+  std::vector<std::thread> m_workers;
+};
+
+}  // namespace sysid
@@ -0,0 +1,193 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <wpi/Logger.h>
+
+#include "sysid/analysis/AnalysisType.h"
+
+namespace sysid {
+
+/**
+ * An entry of a WPILib data log, as described by its start control record.
+ */
+struct DataLogEntry {
+  /**
+   * The id of the entry in data records.
+   */
+  uint32_t id;
+
+  /**
+   * The name of the entry (e.g. "/drive/leftVoltage").
+   */
+  std::string name;
+
+  /**
+   * The type of the entry (e.g. "double").
+   */
+  std::string type;
+};
+
+/**
+ * A data record of a WPILib data log. The payload points into the mapped log
+ * and is only valid while the reader that returned it is alive.
+ */
+struct DataLogRecord {
+  /**
+   * The entry that the record belongs to.
+   */
+  const DataLogEntry* entry;
+
+  /**
+   * The timestamp of the record in microseconds.
+   */
+  int64_t timestamp;
+
+  /**
+   * The payload of the record.
+   */
+  const uint8_t* data;
+
+  /**
+   * The size of the payload in bytes.
+   */
+  size_t size;
+};
+
+class MappedFile;
+
+/**
+ * A streaming reader for WPILib data log (.wpilog) files. The file is memory
+ * mapped and records are decoded in place one at a time, so logs of whole
+ * matches can be read without copying them into memory first.
+ */
+class DataLogReader {
+ public:
+  /**
+   * Opens a data log and checks its header.
+   *
+   * @param path The path of the data log.
+   */
+  explicit DataLogReader(std::string_view path);
+
+  ~DataLogReader();
+
+  DataLogReader(const DataLogReader&) = delete;
+  DataLogReader& operator=(const DataLogReader&) = delete;
+
+  /**
+   * Reads the next data record. Control records are handled internally, and
+   * records of entries that were never started are skipped.
+   *
+   * @param record Where to store the record.
+   * @return False once the end of the log is reached.
+   */
+  bool Next(DataLogRecord* record);
+
+  /**
+   * Returns the numeric value of a record of a "double", "float", "int64", or
+   * "boolean" entry.
+   *
+   * @param record The record to decode.
+   * @return The value of the record.
+   */
+  static double GetNumber(const DataLogRecord& record);
+
+  /**
+   * Returns whether records of the given entry type can be decoded with
+   * GetNumber().
+   *
+   * @param type The type of the entry.
+   * @return True if the type is numeric.
+   */
+  static bool IsNumeric(std::string_view type);
+
+ private:
+  void HandleControlRecord(const uint8_t* data, size_t size);
+
+  std::string m_path;
+  std::unique_ptr<MappedFile> m_file;
+  size_t m_pos = 0;
+  std::unordered_map<uint32_t, DataLogEntry> m_entries;
+};
+
+/**
+ * The settings used to import a data log as a sysid capture.
+ */
+struct DataLogImportSettings {
+  /**
+   * The analysis type of the capture.
+   */
+  AnalysisType type = analysis::kSimple;
+
+  /**
+   * The name of the units of the positions and velocities.
+   */
+  std::string units = "Rotations";
+
+  /**
+   * The number of units per rotation of the output.
+   */
+  double unitsPerRotation = 1.0;
+
+  /**
+   * The names of the entries that make up the telemetry columns after the
+   * timestamp, in the telemetry format of the analysis type.
+   */
+  std::vector<std::string> entries;
+};
+
+/**
+ * Returns the names of the telemetry columns after the timestamp for an
+ * analysis type (e.g. "Voltage", "Position", "Velocity").
+ *
+ * @param type The analysis type.
+ * @return The names of the columns.
+ */
+std::vector<std::string> GetTelemetryColumns(const AnalysisType& type);
+
+/**
+ * Lists the numeric entries of a data log, in the order they were started.
+ *
+ * @param path The path of the data log.
+ * @return The numeric entries.
+ */
+std::vector<DataLogEntry> ListDataLogEntries(std::string_view path);
+
+/**
+ * Reads rows in telemetry format from a data log. A row is emitted for every
+ * record of the first entry (the voltage), holding the latest value of each
+ * other entry, once all the entries have been logged at least once.
+ *
+ * @param path    The path of the data log.
+ * @param entries The names of the entries for each column after the
+ *                timestamp.
+ * @return The rows of the capture.
+ */
+std::vector<std::vector<double>> ReadDataLogCapture(
+    std::string_view path, const std::vector<std::string>& entries);
+
+/**
+ * Imports a data log as a sysid JSON containing a continuous capture, which
+ * is split into tests when it is analyzed. The JSON is saved next to the log.
+ *
+ * @param path     The path of the data log.
+ * @param settings The entries and units of the capture.
+ * @param logger   The logger instance for log messages.
+ * @return The full file path of the newly saved JSON.
+ */
+std::string ImportDataLog(std::string_view path,
+                          const DataLogImportSettings& settings,
+                          wpi::Logger& logger);
+
+}  // namespace sysid
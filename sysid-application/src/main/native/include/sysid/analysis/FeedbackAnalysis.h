@@ -4,9 +4,16 @@
 
 #pragma once
 
-namespace sysid {
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/LU>
 
-struct FeedbackControllerPreset;
+#include "sysid/analysis/FeedbackControllerPreset.h"
+#include "sysid/analysis/ModelTerms.h"
+#include "sysid/analysis/Storage.h"
+
+namespace sysid {
 
 /**
  * Represents parameters used to calculate optimal feedback gains using a
@@ -44,6 +51,130 @@ struct FeedbackGains {
   double Kd;
 };
 
+/**
+ * Stores the noise of a mechanism, estimated from the residuals of its model.
+ */
+struct NoiseCovariances {
+  /**
+   * The spectral density of the velocity disturbances that the model doesn't
+   * explain, in (units/s)² per second. A filter that runs with a period T
+   * sees a velocity variance of this times T per step.
+   */
+  double process = 0.0;
+
+  /**
+   * The variance of the position measurements (units²).
+   */
+  double position = 0.0;
+
+  /**
+   * The variance of the velocity measurements ((units/s)²).
+   */
+  double velocity = 0.0;
+};
+
+/**
+ * Stores the gains of a steady-state Kalman filter. Each gain is how much the
+ * estimate of a state moves per unit of measurement residual. Position loops
+ * measure the position, and velocity loops measure the velocity. The gains
+ * don't depend on the units of the states, so they apply to encoder units
+ * too.
+ */
+struct KalmanGains {
+  /**
+   * The gain of the position estimate (zero for velocity loops).
+   */
+  double position = 0.0;
+
+  /**
+   * The gain of the velocity estimate.
+   */
+  double velocity = 0.0;
+};
+
+/**
+ * The model of a mechanism that a Kalman filter is designed for.
+ */
+struct EstimatorModel {
+  /**
+   * Velocity feedforward gain.
+   */
+  double Kv;
+
+  /**
+   * Acceleration feedforward gain.
+   */
+  double Ka;
+
+  /**
+   * The noise of the mechanism.
+   */
+  NoiseCovariances noise;
+};
+
+namespace detail {
+/**
+ * A discrete system with one measurement for which a steady-state Kalman
+ * filter is designed: x_k+1 = A x_k + w_k, y_k = C x_k + v_k, where w and v
+ * have the covariances Q and R.
+ */
+template <int States>
+struct KalmanProblem {
+  Eigen::Matrix<double, States, States> A;
+  Eigen::Matrix<double, 1, States> C;
+  Eigen::Matrix<double, States, States> Q;
+  double R;
+};
+
+/**
+ * Solves the discrete algebraic Riccati equation of the Kalman filter,
+ *
+ * P = A P Aᵀ − A P Cᵀ (C P Cᵀ + R)⁻¹ C P Aᵀ + Q,
+ *
+ * for a batch of systems with the structure-preserving doubling algorithm,
+ * and returns the steady-state gains K = P Cᵀ (C P Cᵀ + R)⁻¹. Each doubling
+ * step squares the convergence factor, so a solve takes a few dozen small
+ * matrix products even for slow systems.
+ *
+ * @param problems The systems, which must be detectable, with R > 0.
+ * @return The Kalman gain of each system, in order.
+ */
+template <int States>
+std::vector<Eigen::Matrix<double, States, 1>> SolveKalmanGains(
+    const std::vector<KalmanProblem<States>>& problems) {
+  using Matrix = Eigen::Matrix<double, States, States>;
+  constexpr int kMaxIterations = 64;
+
+  std::vector<Eigen::Matrix<double, States, 1>> gains;
+  gains.reserve(problems.size());
+  for (const auto& problem : problems) {
+    // The filter equation is the control equation of the dual system (Aᵀ,
+    // Cᵀ), which is what the doubling algorithm solves.
+    Matrix A = problem.A.transpose();
+    Matrix G = problem.C.transpose() * problem.C / problem.R;
+    Matrix H = problem.Q;
+    for (int i = 0; i < kMaxIterations; ++i) {
+      Eigen::PartialPivLU<Matrix> W{Matrix::Identity() + G * H};
+      Matrix V1 = W.solve(A);
+      Matrix V2 = W.solve(G);
+      Matrix nextH = H + A.transpose() * H * V1;
+      G += A * V2 * A.transpose();
+      A = A * V1;
+      bool converged = (nextH - H).norm() <= 1e-12 * nextH.norm();
+      H = nextH;
+      if (converged) {
+        break;
+      }
+    }
+
+    const Matrix& P = H;
+    double S = (problem.C * P * problem.C.transpose())(0, 0) + problem.R;
+    gains.emplace_back(P * problem.C.transpose() / S);
+  }
+  return gains;
+}
+}  // namespace detail
+
 /**
  * Calculates position feedback gains for the given controller preset, LQR
  * controller gain parameters and feedforward gains.
@@ -78,4 +209,47 @@ FeedbackGains CalculatePositionFeedbackGains(
 FeedbackGains CalculateVelocityFeedbackGains(
     const FeedbackControllerPreset& preset, const LQRParameters& params,
     double Kv, double Ka, double encFactor = 1.0);
+
+/**
+ * Estimates the noise of a mechanism from the residuals of its model over the
+ * unfiltered data. The one-step velocity prediction residual of each sample,
+ * r_k = w_k + n_k+1 − A n_k, mixes the process noise w with the measurement
+ * noise n. Consecutive residuals share the measurement noise of their common
+ * sample, so their covariance (−A σₙ²) tells the two apart. The position
+ * noise follows the same way from the residuals of integrating the velocity.
+ *
+ * Samples are chained to the sample that continues them (in time and
+ * velocity), so datasets that interleave drivetrain sides or swerve modules
+ * can be used as they are.
+ *
+ * @param data   The unfiltered data.
+ * @param gains  The feedforward gains (Ks, Kv, Ka, followed by the gains of
+ *               the model terms).
+ * @param terms  The model terms after Ks, Kv, and Ka.
+ * @param params The shape parameters of the nonlinear model terms.
+ * @return The estimated noise. Each variance is at least a small fraction of
+ *         the variance of its residuals, so that the filter never trusts
+ *         either the model or the measurements completely.
+ */
+NoiseCovariances EstimateNoiseCovariances(
+    const Storage& data, const std::vector<double>& gains,
+    const std::vector<ModelTerm>& terms = {},
+    const ModelTermParameters& params = {});
+
+/**
+ * Designs steady-state Kalman filters for a batch of mechanisms (e.g. every
+ * dataset of a capture) with the controller preset's period. Position loops
+ * estimate the position and velocity from position measurements, and
+ * velocity loops estimate the velocity from velocity measurements. Like the
+ * feedback gains, mechanisms whose acceleration requires no effort are
+ * modeled with the velocity as an input.
+ *
+ * @param preset The feedback controller preset.
+ * @param type   The feedback controller loop type.
+ * @param models The models of the mechanisms.
+ * @return The Kalman gains of each mechanism, in order.
+ */
+std::vector<KalmanGains> CalculateKalmanGains(
+    const FeedbackControllerPreset& preset, FeedbackControllerLoopType type,
+    const std::vector<EstimatorModel>& models);
 }  // namespace sysid
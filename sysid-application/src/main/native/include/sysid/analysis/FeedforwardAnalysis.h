@@ -4,14 +4,135 @@
 
 #pragma once
 
+#include <cmath>
+#include <cstddef>
+#include <memory_resource>
 #include <tuple>
+#include <utility>
 #include <vector>
 
+#include <Eigen/Core>
+
 #include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/MechanismDescriptor.h"
+#include "sysid/analysis/ModelTerms.h"
 #include "sysid/analysis/Storage.h"
 
 namespace sysid {
 
+namespace detail {
+/**
+ * Populates the descriptor term columns of one row of the OLS design matrix.
+ * Descriptors without terms (e.g. of simple mechanisms) populate nothing.
+ */
+template <typename Descriptor, size_t... I>
+void PopulateDescriptorTerms([[maybe_unused]] const PreparedData& pt,
+                             [[maybe_unused]] Eigen::Ref<Eigen::MatrixXd>& X,
+                             [[maybe_unused]] Eigen::Index row,
+                             std::index_sequence<I...>) {
+  ((X(row, 3 + I) = EvaluateModelTerm<Descriptor::kTerms[I]>(pt)), ...);
+}
+
+/**
+ * Populates the OLS design matrix rows for x_k+1 - x_k / tau = alpha x_k +
+ * beta u_k + gamma sgn(x_k) + Σ delta_i f_i(x_k), followed by the columns of
+ * the extra model terms.
+ *
+ * @param d          List of characterization data.
+ * @param extraTerms The extra model terms that aren't part of the descriptor.
+ * @param params     The shape parameters of the nonlinear model terms.
+ * @param X          The block of the design matrix to populate.
+ * @param y          The block of the dependent variable to populate.
+ */
+template <typename Descriptor>
+void PopulateOLSMatrix(const std::vector<PreparedData>& d,
+                       const std::vector<ModelTerm>& extraTerms,
+                       const ModelTermParameters& params,
+                       Eigen::Ref<Eigen::MatrixXd> X,
+                       Eigen::Ref<Eigen::VectorXd> y) {
+  constexpr auto kTerms = Descriptor::kTerms.size();
+  for (size_t i = 0; i < d.size(); ++i) {
+    const auto& pt = d[i];
+
+    // Add the dependent variable (acceleration)
+    y(i) = pt.acceleration;
+
+    // Add the velocity term (for alpha)
+    X(i, 0) = pt.velocity;
+
+    // Add the voltage term (for beta)
+    X(i, 1) = pt.voltage;
+
+    // Add the intercept term (for gamma)
+    X(i, 2) = std::copysign(1, pt.velocity);
+
+    // Add the mechanism-specific terms (e.g. gravity for elevators)
+    PopulateDescriptorTerms<Descriptor>(pt, X, i,
+                                        std::make_index_sequence<kTerms>{});
+  }
+
+  // Add the extra model terms, one column at a time
+  for (size_t j = 0; j < extraTerms.size(); ++j) {
+    EvaluateModelTerm(extraTerms[j], d, params, X.col(3 + kTerms + j));
+  }
+}
+
+/**
+ * Performs OLS on the populated design matrix and converts the coefficients
+ * to feedforward gains.
+ *
+ * @param X The design matrix.
+ * @param y The dependent variable (acceleration).
+ * @return The gains (Ks, Kv, Ka, followed by one gain per extra column) and
+ *         the r-squared of the fit.
+ */
+std::tuple<std::vector<double>, double> SolveFeedforwardGains(
+    const Eigen::Ref<const Eigen::MatrixXd>& X,
+    const Eigen::Ref<const Eigen::VectorXd>& y);
+}  // namespace detail
+
+/**
+ * Calculates feedforward gains given the data and the mechanism descriptor.
+ *
+ * @tparam Descriptor The mechanism descriptor (see MechanismDescriptor).
+ * @param data       The data to fit.
+ * @param extraTerms Model terms to identify on top of the descriptor terms.
+ * @param params     The shape parameters of the nonlinear model terms.
+ * @param resource   The memory resource to allocate the design matrix from
+ *                   (e.g. the arena of an analysis).
+ *
+ * @return Tuple containing the coefficients of the analysis along with the
+ *         r-squared (coefficient of determination) of the fit. The
+ *         coefficients are Ks, Kv, Ka, followed by the gain of each descriptor
+ *         term and then each extra term in order.
+ */
+template <typename Descriptor>
+std::tuple<std::vector<double>, double> CalculateFeedforwardGains(
+    const Storage& data, const std::vector<ModelTerm>& extraTerms = {},
+    const ModelTermParameters& params = {},
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+  const auto& [slow, fast] = data;
+
+  // 1 dependent variable, 3 + n independent variables in each observation
+  Eigen::Index rows = slow.size() + fast.size();
+  Eigen::Index cols = Descriptor::kGainCount + extraTerms.size();
+  std::pmr::vector<double> storage(rows * (cols + 1), resource);
+  Eigen::Map<Eigen::MatrixXd> X(storage.data(), rows, cols);
+  Eigen::Map<Eigen::VectorXd> y(storage.data() + rows * cols, rows);
+
+  // Perform OLS with accel = alpha*vel + beta*voltage + gamma*signum(vel)
+  // OLS performs best with the noisiest variable as the dependent var,
+  // so we regress accel in terms of the other variables.
+  detail::PopulateOLSMatrix<Descriptor>(slow, extraTerms, params,
+                                        X.topRows(slow.size()),
+                                        y.head(slow.size()));
+  detail::PopulateOLSMatrix<Descriptor>(fast, extraTerms, params,
+                                        X.bottomRows(fast.size()),
+                                        y.tail(fast.size()));
+
+  return detail::SolveFeedforwardGains(X, y);
+}
+
 /**
  * Calculates feedforward gains given the data and the type of analysis to
  * perform.
@@ -21,4 +142,21 @@ namespace sysid {
  */
 std::tuple<std::vector<double>, double> CalculateFeedforwardGains(
     const Storage& data, const AnalysisType& type);
+
+/**
+ * Calculates feedforward gains given the data and the extra model terms to
+ * identify on top of Ks, Kv, and Ka.
+ *
+ * @param data   The data to fit.
+ * @param terms  The extra model terms (e.g. gravity or drag).
+ * @param params The shape parameters of the nonlinear model terms.
+ *
+ * @return Tuple containing the coefficients of the analysis along with the
+ *         r-squared (coefficient of determination) of the fit. The
+ *         coefficients are Ks, Kv, Ka, followed by the gain of each extra
+ *         model term in order.
+ */
+std::tuple<std::vector<double>, double> CalculateFeedforwardGains(
+    const Storage& data, const std::vector<ModelTerm>& terms,
+    const ModelTermParameters& params = {});
 }  // namespace sysid
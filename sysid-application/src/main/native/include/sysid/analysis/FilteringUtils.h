@@ -41,6 +41,15 @@ double GetAccelNoiseFloor(const std::vector<PreparedData>& data, int window);
  */
 void ApplyMedianFilter(std::vector<PreparedData>* data, int window);
 
+/**
+ * Returns the number of radians in one unit of an angular unit. This is used to
+ * calculate the cosine of arm positions.
+ *
+ * @param unit The name of the unit (e.g. "Degrees").
+ * @return The radians per unit, or zero if the unit isn't angular.
+ */
+double GetRadiansPerUnit(std::string_view unit);
+
 /**
  * Trims the step voltage data to discard all points before the maximum
  * acceleration and after reaching stead-state velocity. Also trims the end of
@@ -0,0 +1,84 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "sysid/analysis/Storage.h"
+
+namespace sysid {
+
+/**
+ * The noise parameters of the constant-acceleration model used by the Kalman
+ * smoother.
+ */
+struct SmootherNoise {
+  /**
+   * The standard deviation (units) of the position measurements.
+   */
+  double position = 0.0;
+
+  /**
+   * The standard deviation (units/s) of the velocity measurements.
+   */
+  double velocity = 0.0;
+
+  /**
+   * The spectral density (units²/s⁵) of the white jerk that drives the
+   * acceleration state.
+   */
+  double jerk = 0.0;
+};
+
+/**
+ * The number of samples that the smoother noise can be estimated from.
+ * Shorter datasets are filtered with the median filter instead.
+ */
+inline constexpr size_t kMinSmootherSamples = 4;
+
+/**
+ * Estimates the smoother noise parameters from a dataset.
+ *
+ * The measurement noise is estimated with the median absolute deviation of the
+ * second differences of velocity and the third differences of position, which
+ * cancel out the constant-acceleration motion and leave (mostly) noise. The
+ * jerk density is then chosen to maximize the likelihood of the measurements,
+ * which is searched on a bounded number of samples so that the cost doesn't
+ * grow with the dataset.
+ *
+ * @param data The dataset. Its timestamps must be increasing, and it needs at
+ *             least kMinSmootherSamples samples.
+ * @return The estimated noise parameters.
+ * @throws std::runtime_error if the dataset is too short.
+ */
+SmootherNoise EstimateSmootherNoise(const std::vector<PreparedData>& data);
+
+/**
+ * Replaces the velocity and acceleration of a dataset with estimates from a
+ * constant-acceleration Kalman filter followed by a Rauch–Tung–Striebel
+ * backward pass. Position and velocity are both used as measurements, and the
+ * time step is taken from the timestamps of consecutive samples, so gaps left
+ * by trimming are handled.
+ *
+ * This runs in linear time with fixed-size (3x3) matrices.
+ *
+ * @param data  The dataset to smooth. Its timestamps must be increasing.
+ * @param noise The noise parameters of the model.
+ */
+void ApplyKalmanSmoother(std::vector<PreparedData>* data,
+                         const SmootherNoise& noise);
+
+/**
+ * Replaces the velocity and acceleration of a dataset with Kalman smoother
+ * estimates, using noise parameters estimated from the dataset itself.
+ *
+ * @param data The dataset to smooth. Its timestamps must be increasing, and it
+ *             needs at least kMinSmootherSamples samples.
+ * @throws std::runtime_error if the dataset is too short.
+ */
+void ApplyKalmanSmoother(std::vector<PreparedData>* data);
+
+}  // namespace sysid
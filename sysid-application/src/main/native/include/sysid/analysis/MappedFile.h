@@ -0,0 +1,55 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace sysid {
+
+/**
+ * A read-only memory mapping of a whole file.
+ */
+class MappedFile {
+ public:
+  /**
+   * Maps a file into memory.
+   *
+   * @param path       The path of the file.
+   * @param sequential Whether the file is read front to back exactly once,
+   *                   which lets the OS read ahead aggressively.
+   */
+  explicit MappedFile(std::string_view path, bool sequential = true);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+   * Returns the contents of the file. This is null if the file is empty.
+   */
+  const uint8_t* data() const { return m_data; }
+
+  /**
+   * Returns the size of the file in bytes.
+   */
+  size_t size() const { return m_size; }
+
+ private:
+  const uint8_t* m_data = nullptr;
+  size_t m_size = 0;
+#ifdef _WIN32
+  // The file and mapping HANDLEs, which are kept as void* so that windows.h
+  // isn't included here.
+  void* m_file = nullptr;
+  void* m_mapping = nullptr;
+#else
+  int m_fd = -1;
+#endif
+};
+
+}  // namespace sysid
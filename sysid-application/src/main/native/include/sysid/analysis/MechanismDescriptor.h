@@ -0,0 +1,110 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/ArmSim.h"
+#include "sysid/analysis/ElevatorSim.h"
+#include "sysid/analysis/ModelTerms.h"
+#include "sysid/analysis/SimpleMotorSim.h"
+
+namespace sysid {
+
+/**
+ * Describes the feedforward model of a mechanism at compile time. The
+ * descriptor lists the model terms that are always identified on top of Ks,
+ * Kv, and Ka, and the simulation model used for the time-domain diagnostics.
+ * Analysis kernels are instantiated per descriptor, so the per-sample loops
+ * don't branch on the mechanism type.
+ *
+ * A new mechanism (e.g. a turret with a cable chain spring) is added by
+ * defining a descriptor for it and mapping its AnalysisType in
+ * VisitDescriptor().
+ *
+ * @tparam Sim   The simulation model. It must be constructible from Ks, Kv, Ka,
+ *               followed by the gain of each term.
+ * @tparam Terms The model terms. Only pointwise terms are allowed.
+ */
+template <typename Sim, ModelTerm... Terms>
+struct MechanismDescriptor {
+  static_assert((IsPointwiseModelTerm(Terms) && ...),
+                "Descriptor terms must only depend on the current sample");
+
+  /**
+   * The simulation model of the mechanism.
+   */
+  using SimModel = Sim;
+
+  /**
+   * The model terms identified on top of Ks, Kv, and Ka, in gain order.
+   */
+  static constexpr std::array<ModelTerm, sizeof...(Terms)> kTerms{Terms...};
+
+  /**
+   * The number of feedforward gains (Ks, Kv, Ka, and one per term).
+   */
+  static constexpr size_t kGainCount = 3 + sizeof...(Terms);
+
+  /**
+   * Creates the simulation model for a set of feedforward gains.
+   *
+   * @param gains The feedforward gains (Ks, Kv, Ka, followed by the gains of
+   *              the descriptor terms).
+   * @return The simulation model.
+   */
+  static Sim MakeSim(const std::vector<double>& gains) {
+    return MakeSim(gains, std::make_index_sequence<sizeof...(Terms)>{});
+  }
+
+ private:
+  template <size_t... I>
+  static Sim MakeSim(const std::vector<double>& gains,
+                     std::index_sequence<I...>) {
+    return Sim{gains[0], gains[1], gains[2], gains[3 + I]...};
+  }
+};
+
+namespace descriptors {
+/**
+ * Flywheels, turrets, and drivetrains: V = Ks sgn(v) + Kv v + Ka a.
+ */
+using Simple = MechanismDescriptor<SimpleMotorSim>;
+
+/**
+ * Elevators: V = Ks sgn(v) + Kv v + Ka a + Kg.
+ */
+using Elevator = MechanismDescriptor<ElevatorSim, ModelTerm::kGravity>;
+
+/**
+ * Arms: V = Ks sgn(v) + Kv v + Ka a + Kcos cos(θ).
+ */
+using Arm = MechanismDescriptor<ArmSim, ModelTerm::kCosine>;
+}  // namespace descriptors
+
+/**
+ * Calls a function with the mechanism descriptor of an analysis type. This is
+ * the single place where the analysis type is branched on; the function is
+ * instantiated once per descriptor.
+ *
+ * @param type The analysis type.
+ * @param f    The function to call with a default-constructed descriptor.
+ * @return The result of the function.
+ */
+template <typename F>
+decltype(auto) VisitDescriptor(const AnalysisType& type, F&& f) {
+  if (type == analysis::kElevator) {
+    return f(descriptors::Elevator{});
+  } else if (type == analysis::kArm) {
+    return f(descriptors::Arm{});
+  } else {
+    return f(descriptors::Simple{});
+  }
+}
+}  // namespace sysid
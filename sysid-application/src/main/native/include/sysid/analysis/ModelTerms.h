@@ -0,0 +1,178 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cmath>
+#include <string_view>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/Storage.h"
+
+namespace sysid {
+
+/**
+ * A term of the feedforward model that is identified in addition to the
+ * Ks·sgn(v) + Kv·v + Ka·a base model. Each term contributes one regressor
+ * column fᵢ(x, v) to the OLS design matrix, and one gain Kᵢ such that the
+ * modelled voltage is
+ *
+ * V = Ks·sgn(v) + Kv·v + Ka·a + Σ Kᵢ·fᵢ(x, v).
+ */
+enum class ModelTerm {
+  /// Constant gravity (elevators), f = 1. Gain: Kg.
+  kGravity,
+  /// Arm gravity, f = cos(θ). Gain: Kcos.
+  kCosine,
+  /// Stribeck friction, f = sgn(v)·exp(-(v/vₛ)²). Gain: Kstribeck.
+  kStribeck,
+  /// Quadratic (aerodynamic/fluid) drag, f = v·|v|. Gain: Kdrag.
+  kDrag,
+  /// Backlash dead-band, f = play operator on position normalized to [-1, 1].
+  /// Gain: Kbacklash.
+  kBacklash,
+  /// Position-dependent gravity (counterweights, constant-force springs),
+  /// f = x. Gain: Kx.
+  kPosition
+};
+
+/**
+ * All model terms, in declaration order.
+ */
+inline constexpr ModelTerm kModelTerms[] = {
+    ModelTerm::kGravity, ModelTerm::kCosine,   ModelTerm::kStribeck,
+    ModelTerm::kDrag,    ModelTerm::kBacklash, ModelTerm::kPosition};
+
+/**
+ * Shape parameters of the nonlinear model terms. These are not identified by
+ * the regression and have to be supplied by the user.
+ */
+struct ModelTermParameters {
+  /**
+   * The Stribeck velocity vₛ (units/s) at which breakaway friction has decayed
+   * to 1/e of its peak.
+   */
+  double stribeckVelocity = 0.1;
+
+  /**
+   * The total width (units) of the backlash dead-band.
+   */
+  double backlashWidth = 0.01;
+};
+
+/**
+ * Returns whether a model term only depends on the current sample (as opposed
+ * to the history of the dataset, like backlash) and has no shape parameters.
+ *
+ * @param term The model term.
+ * @return True if the term can be evaluated from a single sample.
+ */
+constexpr bool IsPointwiseModelTerm(ModelTerm term) {
+  return term == ModelTerm::kGravity || term == ModelTerm::kCosine ||
+         term == ModelTerm::kDrag || term == ModelTerm::kPosition;
+}
+
+/**
+ * Evaluates a pointwise model term for a single sample. This is used by the
+ * per-mechanism kernels, where the term is known at compile time.
+ *
+ * @tparam Term The model term. It must be pointwise.
+ * @param pt The sample.
+ * @return The regressor value of the term.
+ */
+template <ModelTerm Term>
+double EvaluateModelTerm(const PreparedData& pt) {
+  static_assert(IsPointwiseModelTerm(Term),
+                "Only pointwise terms can be evaluated per sample");
+  if constexpr (Term == ModelTerm::kGravity) {
+    return 1.0;
+  } else if constexpr (Term == ModelTerm::kCosine) {
+    return pt.cos;
+  } else if constexpr (Term == ModelTerm::kDrag) {
+    return pt.velocity * std::abs(pt.velocity);
+  } else {
+    return pt.position;
+  }
+}
+
+/**
+ * Returns the display name of the gain that corresponds to a model term.
+ *
+ * @param term The model term.
+ * @return The gain name (e.g. "Kg").
+ */
+std::string_view GetGainName(ModelTerm term);
+
+/**
+ * Returns the power of the position unit in the regressor of a model term (e.g.
+ * 2 for drag, since v·|v| is in units²/s²). The gain of the term is in volts
+ * per that power of the unit.
+ *
+ * This assumes the shape parameters of the nonlinear terms are converted along
+ * with the unit, so the Stribeck and backlash regressors are unitless.
+ *
+ * @param term The model term.
+ * @return The power of the position unit.
+ */
+constexpr int GetModelTermUnitPower(ModelTerm term) {
+  switch (term) {
+    case ModelTerm::kDrag:
+      return 2;
+    case ModelTerm::kPosition:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * Converts feedforward gains to a new position unit. Ks is unitless, Kv and Ka
+ * are per unit, and the extra model terms follow GetModelTermUnitPower().
+ *
+ * @param gains The gains (Ks, Kv, Ka, followed by one gain per term).
+ * @param terms The extra model terms.
+ * @param ratio The number of new units per old unit.
+ */
+void ScaleFeedforwardGains(std::vector<double>* gains,
+                           const std::vector<ModelTerm>& terms, double ratio);
+
+/**
+ * Returns the model terms that are always identified for an analysis type on
+ * top of Ks, Kv, and Ka (i.e. Kg for elevators and Kcos for arms).
+ *
+ * @param type The analysis type.
+ * @return The default extra model terms.
+ */
+std::vector<ModelTerm> GetDefaultModelTerms(const AnalysisType& type);
+
+/**
+ * Evaluates the regressor column of a model term over a dataset.
+ *
+ * @param term   The model term to evaluate.
+ * @param data   The dataset.
+ * @param params The shape parameters of the nonlinear terms.
+ * @param out    The output column. It must have as many rows as the dataset.
+ */
+void EvaluateModelTerm(ModelTerm term, const std::vector<PreparedData>& data,
+                       const ModelTermParameters& params,
+                       Eigen::Ref<Eigen::VectorXd> out);
+
+/**
+ * Calculates the voltage contributed by a set of model terms for every point
+ * of a dataset, i.e. Σ Kᵢ·fᵢ(x, v).
+ *
+ * @param terms  The model terms.
+ * @param gains  The gains of the model terms, in the same order as the terms.
+ * @param data   The dataset.
+ * @param params The shape parameters of the nonlinear terms.
+ * @return The voltage contributed by the terms for each data point.
+ */
+Eigen::VectorXd CalculateTermVoltages(const std::vector<ModelTerm>& terms,
+                                      const double* gains,
+                                      const std::vector<PreparedData>& data,
+                                      const ModelTermParameters& params);
+}  // namespace sysid
@@ -0,0 +1,145 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace sysid {
+
+/**
+ * The number of channels that are recorded for every motor of a multi-motor
+ * capture. The channels of each motor follow the timestamp, voltage,
+ * position, and velocity columns of a general mechanism in the order: motor
+ * position, motor velocity, motor current, motor applied voltage.
+ */
+inline constexpr size_t kMotorChannelSize = 4;
+
+/**
+ * The offsets of the channels of a motor within its block of columns.
+ */
+namespace motorchannel {
+inline constexpr size_t kPosition = 0;
+inline constexpr size_t kVelocity = 1;
+inline constexpr size_t kCurrent = 2;
+inline constexpr size_t kAppliedVoltage = 3;
+}  // namespace motorchannel
+
+/**
+ * Returns the column of a motor channel in a raw multi-motor data row.
+ *
+ * @param motor   The index of the motor.
+ * @param channel The offset of the channel (e.g. motorchannel::kCurrent).
+ * @return The column of the channel.
+ */
+constexpr size_t MotorChannelColumn(size_t motor, size_t channel) {
+  return 4 + kMotorChannelSize * motor + channel;
+}
+
+/**
+ * The samples of a multi-motor capture, stored by column so that each channel
+ * of each motor is contiguous.
+ */
+struct MotorChannelData {
+  /**
+   * The columns, in the order of the columns of a raw data row (see
+   * MotorChannelColumn()). All columns have the same length.
+   */
+  std::vector<std::vector<double>> columns;
+};
+
+/**
+ * The relative deviations from the median motor at which a motor is flagged.
+ */
+struct MotorOutlierTolerances {
+  /**
+   * The relative deviation of the motor to mechanism velocity ratio at which a
+   * motor is considered to be slipping.
+   */
+  double velocityRatio = 0.05;
+
+  /**
+   * The relative deviation of Kv at which a motor is considered mismatched.
+   * Kv is compared in mechanism units (i.e. scaled by the velocity ratio).
+   */
+  double Kv = 0.15;
+
+  /**
+   * The relative deviation of the mean current at which a motor is considered
+   * mismatched.
+   */
+  double current = 0.25;
+};
+
+/**
+ * The results of analyzing a single motor of a multi-motor capture.
+ */
+struct MotorDiagnostics {
+  /**
+   * The feedforward gains fit to the motor's applied voltage and encoder.
+   */
+  std::vector<double> ffGains;
+
+  /**
+   * The r-squared of the motor's feedforward fit.
+   */
+  double rSquared = 0.0;
+
+  /**
+   * The least-squares ratio of the motor's velocity to the mechanism velocity.
+   * This is 1 for a motor that is rigidly coupled to the mechanism.
+   */
+  double velocityRatio = 0.0;
+
+  /**
+   * The mean absolute current drawn by the motor while the mechanism moves.
+   */
+  double meanCurrent = 0.0;
+
+  /**
+   * True if the motor's velocity ratio deviates from the other motors.
+   */
+  bool slipping = false;
+
+  /**
+   * True if the motor's Kv or current deviates from the other motors.
+   */
+  bool mismatched = false;
+};
+
+/**
+ * Calculates the least-squares ratio of a motor's velocity to the mechanism
+ * velocity over the samples in which the mechanism moves.
+ *
+ * @param data      The raw multi-motor data.
+ * @param motor     The index of the motor.
+ * @param threshold The mechanism velocity below which samples are ignored.
+ * @return The velocity ratio, or 0 if the mechanism never moved.
+ */
+double CalculateVelocityRatio(const MotorChannelData& data, size_t motor,
+                              double threshold);
+
+/**
+ * Calculates the mean absolute current drawn by a motor over the samples in
+ * which the mechanism moves.
+ *
+ * @param data      The raw multi-motor data.
+ * @param motor     The index of the motor.
+ * @param threshold The mechanism velocity below which samples are ignored.
+ * @return The mean current, or 0 if the mechanism never moved.
+ */
+double CalculateMeanCurrent(const MotorChannelData& data, size_t motor,
+                            double threshold);
+
+/**
+ * Flags the motors whose velocity ratio, Kv, or current deviates from the
+ * median motor. At least two motors are needed for a comparison.
+ *
+ * @param motors     The motor diagnostics to flag.
+ * @param tolerances The relative deviations at which motors are flagged.
+ */
+void FlagMotorOutliers(std::vector<MotorDiagnostics>* motors,
+                       const MotorOutlierTolerances& tolerances = {});
+}  // namespace sysid
@@ -8,6 +8,8 @@
 #include <tuple>
 #include <vector>
 
+#include <Eigen/Core>
+
 namespace sysid {
 /**
  * Performs ordinary least squares multiple regression on the provided data and
@@ -18,7 +20,24 @@ namespace sysid {
  *                             must be formatted as y, x₀, x₁, x₂, ..., y, ...
  *                             in the vector.
  * @param independentVariables The number of independent variables (x values).
+ * @throws std::runtime_error if the independent variables are linearly
+ *         dependent, so the coefficients aren't unique.
  */
 std::tuple<std::vector<double>, double> OLS(const std::vector<double>& data,
                                             size_t independentVariables);
+
+/**
+ * Performs ordinary least squares multiple regression on the provided design
+ * matrix and returns a vector of coefficients along with the r-squared
+ * (coefficient of determination) of the fit.
+ *
+ * @param X The design matrix, with one row per observation and one column per
+ *          independent variable.
+ * @param y The dependent variable, with one row per observation.
+ * @throws std::runtime_error if the columns of the design matrix are linearly
+ *         dependent, so the coefficients aren't unique.
+ */
+std::tuple<std::vector<double>, double> OLS(
+    const Eigen::Ref<const Eigen::MatrixXd>& X,
+    const Eigen::Ref<const Eigen::VectorXd>& y);
 }  // namespace sysid
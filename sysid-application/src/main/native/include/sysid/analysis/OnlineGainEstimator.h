@@ -0,0 +1,201 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Eigen/Core>
+#include <frc/filter/MedianFilter.h>
+#include <wpi/span.h>
+
+#include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/ModelTerms.h"
+#include "sysid/analysis/Storage.h"
+
+namespace sysid {
+
+/**
+ * Estimates the feedforward gains while the samples of the tests arrive, so
+ * that the operator can see when enough data has been collected.
+ *
+ * Each channel of the samples (e.g. each side of a drivetrain) is filtered
+ * like the analysis does: the velocity goes through a median filter and is
+ * differentiated with a central finite difference. The points are then added
+ * to the normal equations (XᵀX and Xᵀy) of the same regression that the
+ * analysis solves, so the work per sample is constant and no samples are
+ * stored. Unlike the analysis, the dynamic tests aren't trimmed, so the
+ * estimate is a preview rather than a replacement for it.
+ */
+class OnlineGainEstimator {
+ public:
+  /**
+   * The estimated gains and their standard deviations.
+   */
+  struct Estimate {
+    /**
+     * Ks, Kv, Ka, followed by the gain of each default model term of the
+     * mechanism (e.g. Kg for elevators). Empty if there isn't enough data.
+     */
+    std::vector<double> gains;
+
+    /**
+     * The standard deviations of the gains, from the residuals of the fit.
+     * They assume uncorrelated residuals, so they are optimistic.
+     */
+    std::vector<double> stddevs;
+
+    /**
+     * The number of points that the estimate is based on.
+     */
+    size_t points = 0;
+  };
+
+  /**
+   * Creates an estimator for the samples of a mechanism.
+   *
+   * @param type             The mechanism.
+   * @param unitsPerRotation The units per rotation of the positions.
+   * @param units            The name of the units (e.g. "Meters"), which
+   *                         arms need to compute the cosine.
+   * @param windowSize       The window size of the median filter.
+   * @param motionThreshold  The velocity (units/s) below which points are
+   *                         skipped.
+   */
+  explicit OnlineGainEstimator(const AnalysisType& type = analysis::kSimple,
+                               double unitsPerRotation = 1.0,
+                               std::string_view units = "Rotations",
+                               int windowSize = 9,
+                               double motionThreshold = 0.2);
+
+  /**
+   * Returns whether the estimator is set up for the given mechanism and units.
+   */
+  bool IsConfiguredFor(const AnalysisType& type, double unitsPerRotation,
+                       std::string_view units) const {
+    return type == m_type && unitsPerRotation == m_unitsPerRotation &&
+           units == m_units;
+  }
+
+  /**
+   * Forgets all points.
+   */
+  void Reset();
+
+  /**
+   * Starts a new run of samples, e.g. a new test or the samples after a gap.
+   * The points that are still in the filters are dropped.
+   */
+  void BeginRun();
+
+  /**
+   * Adds samples in the column order of the mechanism's raw data. Samples
+   * that are further apart in time than a few periods start a new run.
+   *
+   * @param values  The values of the samples, one row after another.
+   * @param rowSize The number of values per sample, which may include motor
+   *                channels after the mechanism data.
+   */
+  void AddSamples(wpi::span<const double> values, size_t rowSize);
+
+  /**
+   * Adds samples that are stored as rows.
+   *
+   * @param rows The samples.
+   */
+  void AddSamples(const std::vector<std::vector<double>>& rows);
+
+  /**
+   * Solves the normal equations for the current estimate.
+   */
+  Estimate GetEstimate() const;
+
+  /**
+   * Returns the names of the gains of the estimate (e.g. "Ks").
+   */
+  std::vector<std::string> GetGainNames() const;
+
+  /**
+   * Returns whether the estimate of Kv and Ka is known to within a fraction
+   * of their values with about 95% confidence (two standard deviations).
+   *
+   * @param tolerance The fraction of the gains.
+   */
+  bool IsConverged(double tolerance = 0.05) const;
+
+ private:
+  /**
+   * The longest time between samples of a run, in seconds.
+   */
+  static constexpr double kMaxPeriod = 0.1;
+
+  /**
+   * Where a channel of the samples is.
+   */
+  struct ChannelColumns {
+    size_t voltage;
+    size_t position;
+    size_t velocity;
+  };
+
+  /**
+   * The filter state of a channel.
+   */
+  struct Channel {
+    Channel(ChannelColumns columns, int windowSize)
+        : columns{columns}, filter{static_cast<size_t>(windowSize)} {}
+
+    ChannelColumns columns;
+    frc::MedianFilter<double> filter;
+
+    // Whether the filter was loaded with the first velocity of the run.
+    bool primed = false;
+
+    // The points that wait for their filtered velocity, and the filtered
+    // points that wait for their neighbors.
+    std::deque<PreparedData> raw;
+    std::deque<PreparedData> filtered;
+  };
+
+  /**
+   * Adds a sample to the filters of a channel.
+   */
+  void AddPoint(Channel& channel, double timestamp, const double* row);
+
+  /**
+   * Adds a filtered point to the normal equations, with the acceleration from
+   * its neighbors.
+   */
+  void Accumulate(const PreparedData& prev, PreparedData pt,
+                  const PreparedData& next);
+
+  AnalysisType m_type;
+  double m_unitsPerRotation;
+  std::string m_units;
+  double m_radiansPerUnit;
+  int m_windowSize;
+  double m_motionThreshold;
+
+  std::vector<ModelTerm> m_terms;
+  std::vector<Channel> m_channels;
+
+  // Whether the voltage has to be flipped to the direction of each channel,
+  // like the analysis does for drivetrain sides and swerve modules.
+  bool m_directional = false;
+
+  double m_lastTimestamp = 0.0;
+  bool m_hasLast = false;
+
+  // The normal equations and the sum of the squared accelerations.
+  Eigen::MatrixXd m_XtX;
+  Eigen::VectorXd m_Xty;
+  double m_yty = 0.0;
+  size_t m_points = 0;
+};
+
+}  // namespace sysid
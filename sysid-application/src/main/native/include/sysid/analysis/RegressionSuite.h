@@ -0,0 +1,242 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <wpi/Logger.h>
+#include <wpi/json.h>
+
+#include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/BatchAnalysis.h"
+
+namespace sysid {
+/**
+ * A capture that the regression suite runs through the analysis.
+ */
+struct RegressionCase {
+  /**
+   * The name of the case, which identifies it in the baseline.
+   */
+  std::string name;
+
+  /**
+   * The capture, as written by the logger.
+   */
+  wpi::json capture;
+
+  /**
+   * The true feedforward gains by name (e.g. "Kv"), or empty if they aren't
+   * known.
+   */
+  std::map<std::string, double> truth;
+};
+
+/**
+ * The outcome of running a case through the analysis.
+ */
+struct RegressionResult {
+  /**
+   * The name of the case.
+   */
+  std::string name;
+
+  /**
+   * The feedforward gains by name.
+   */
+  std::map<std::string, double> gains;
+
+  /**
+   * The largest relative error of a gain against the true gains, or NaN if
+   * they aren't known.
+   */
+  double gainError = 0;
+
+  /**
+   * The RMSE of the velocity simulated with the gains against the raw
+   * velocity.
+   */
+  double rmse = 0;
+
+  /**
+   * The time that loading the capture took in seconds.
+   */
+  double load = 0;
+
+  /**
+   * The time that the stages of the analysis took.
+   */
+  AnalysisTimings timings;
+};
+
+/**
+ * How much worse than the baseline a result may be before it fails.
+ */
+struct RegressionThresholds {
+  /**
+   * The relative change of a gain. Optimizations shouldn't change the gains,
+   * so this only allows for rounding.
+   */
+  double gainChange = 1E-4;
+
+  /**
+   * The increase of the relative gain error against the true gains.
+   */
+  double gainError = 1E-3;
+
+  /**
+   * The relative increase of the RMSE.
+   */
+  double rmse = 0.01;
+
+  /**
+   * The ratio of the time of a stage to its baseline. Timings aren't checked
+   * if this isn't positive.
+   */
+  double timeRatio = 1.5;
+
+  /**
+   * The increase of the time of a stage in seconds that is always allowed,
+   * since short stages are dominated by noise.
+   */
+  double timeSlack = 0.005;
+};
+
+/**
+ * Makes a capture of a simulated mechanism, with the quasistatic and dynamic
+ * tests that the logger runs.
+ *
+ * @param type  The analysis type. Only drivetrains and general mechanisms are
+ *              supported.
+ * @param gains The feedforward gains in the order of the analysis type's model
+ *              terms.
+ * @param units The units of the capture, e.g. "Radians" for arms.
+ * @param noise The amplitude of the uniform noise added to the velocity, in
+ *              units per second. Positions are also quantized to 1/4096 of a
+ *              unit if this is positive.
+ * @param seed  The seed of the noise.
+ * @throws std::runtime_error if the analysis type isn't supported or the
+ *         number of gains doesn't match it.
+ */
+wpi::json MakeSyntheticCapture(const AnalysisType& type,
+                               const std::vector<double>& gains,
+                               std::string_view units, double noise = 0,
+                               unsigned int seed = 1);
+
+/**
+ * Returns the synthetic cases that the regression suite always runs: clean
+ * and noisy captures of each kind of mechanism, with known gains. These
+ * include simple mechanisms and drivetrains with a Ks of 1 V or more, which
+ * only move in the second half of the quasistatic tests.
+ */
+std::vector<RegressionCase> MakeSyntheticCorpus();
+
+/**
+ * Loads a recorded capture as a regression case named after the file. The
+ * true gains can be given in a "truth" object of the capture, e.g.
+ * {"Ks": 0.5, "Kv": 2.0}.
+ *
+ * @param path The path of the capture.
+ * @throws std::runtime_error if the capture can't be read.
+ */
+RegressionCase LoadRegressionCase(std::string_view path);
+
+/**
+ * Runs a case through the full analysis: loading, preparing the data, and
+ * calculating the gains. The result cache is never used.
+ *
+ * @param regressionCase The case.
+ * @param settings       The settings to analyze the case with.
+ * @param repeats        How many times to run the case. The shortest time of
+ *                       each stage is reported.
+ * @param logger         The logger instance to use for log data.
+ * @throws std::runtime_error if the case can't be analyzed.
+ */
+RegressionResult RunRegressionCase(const RegressionCase& regressionCase,
+                                   const BatchSettings& settings,
+                                   int repeats, wpi::Logger& logger);
+
+/**
+ * Compares a result with its baseline.
+ *
+ * @param result     The result.
+ * @param baseline   The baseline result of the same case.
+ * @param thresholds The thresholds.
+ * @return A description of each regression, or nothing if there are none.
+ */
+std::vector<std::string> CompareResult(const RegressionResult& result,
+                                       const RegressionResult& baseline,
+                                       const RegressionThresholds& thresholds);
+
+/**
+ * Compares the results of a run with the baseline. Cases without a baseline
+ * pass, but cases of the baseline that weren't run fail.
+ *
+ * @param results    The results.
+ * @param baseline   The baseline results.
+ * @param thresholds The thresholds.
+ * @return A description of each regression, starting with the case name.
+ */
+std::vector<std::string> CompareToBaseline(
+    const std::vector<RegressionResult>& results,
+    const std::vector<RegressionResult>& baseline,
+    const RegressionThresholds& thresholds);
+
+/**
+ * Formats the results as a Markdown table, with the baseline value of each
+ * metric next to it and the status of each case.
+ *
+ * @param results    The results.
+ * @param baseline   The baseline results.
+ * @param thresholds The thresholds.
+ */
+std::string FormatRegressionTable(
+    const std::vector<RegressionResult>& results,
+    const std::vector<RegressionResult>& baseline,
+    const RegressionThresholds& thresholds);
+
+/**
+ * Converts results to JSON, e.g. to store them as the baseline.
+ *
+ * @param results The results.
+ * @param timings Whether to include the timings. They depend on the machine,
+ *                so a baseline without them can be shared, and only checks
+ *                the gains and their accuracy.
+ */
+wpi::json ToJSON(const std::vector<RegressionResult>& results,
+                 bool timings = true);
+
+/**
+ * Converts JSON from ToJSON() back to results. Timings that weren't stored
+ * are NaN, which never regresses.
+ *
+ * @param json The JSON.
+ * @throws std::runtime_error if the JSON isn't a set of results.
+ */
+std::vector<RegressionResult> RegressionResultsFromJSON(const wpi::json& json);
+
+/**
+ * Saves results to a file.
+ *
+ * @param results The results.
+ * @param path    The path of the file.
+ * @param timings Whether to include the timings.
+ * @throws std::runtime_error if the file can't be written.
+ */
+void SaveRegressionResults(const std::vector<RegressionResult>& results,
+                           std::string_view path, bool timings = true);
+
+/**
+ * Loads results from a file.
+ *
+ * @param path The path of the file.
+ * @throws std::runtime_error if the file can't be read or doesn't contain
+ *         results.
+ */
+std::vector<RegressionResult> LoadRegressionResults(std::string_view path);
+}  // namespace sysid
@@ -0,0 +1,85 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <wpi/Logger.h>
+
+#include "sysid/analysis/AnalysisManager.h"
+#include "sysid/analysis/BatchAnalysis.h"
+#include "sysid/analysis/SvgChart.h"
+
+namespace sysid {
+
+/**
+ * The titles of the charts that the analyzer and reports show.
+ */
+inline constexpr const char* kChartTitles[] = {
+    "Quasistatic Velocity vs. Velocity-Portion Voltage",
+    "Dynamic Acceleration vs. Acceleration-Portion Voltage",
+    "Quasistatic Velocity vs. Time",
+    "Quasistatic Acceleration vs. Time",
+    "Dynamic Velocity vs. Time",
+    "Dynamic Acceleration vs. Time",
+    "Timesteps vs. Time"};
+
+/**
+ * The format of a report.
+ */
+enum class ReportFormat {
+  /// A single HTML file with the charts inline.
+  kHTML,
+  /// A Markdown file with the charts as SVG files in a directory next to it.
+  kMarkdown
+};
+
+/**
+ * Creates the charts that the analyzer shows for the selected dataset (see
+ * kChartTitles), followed by the voltage residuals of the quasistatic and
+ * dynamic tests.
+ *
+ * @param manager  The analysis manager, with the data prepared.
+ * @param gains    The gains that were calculated from the data.
+ * @param settings The settings that the manager was constructed with.
+ * @return The charts.
+ */
+std::vector<SvgChart> MakeReportCharts(
+    AnalysisManager& manager, const AnalysisManager::Gains& gains,
+    const AnalysisManager::Settings& settings);
+
+/**
+ * Returns the path of the report of a capture, e.g. "sysid_data.report.html"
+ * for "sysid_data.json".
+ *
+ * @param path      The path of the capture.
+ * @param format    The format of the report.
+ * @param directory The directory to write the report to, or empty to write it
+ *                  next to the capture.
+ */
+std::string GetReportPath(std::string_view path, ReportFormat format,
+                          std::string_view directory = {});
+
+/**
+ * Analyzes a capture the same way as AnalyzeCapture() and writes a report
+ * with its gains and charts.
+ *
+ * @param path      The path of the capture.
+ * @param settings  The settings to analyze the capture with.
+ * @param format    The format of the report.
+ * @param directory The directory to write the report to, or empty to write it
+ *                  next to the capture.
+ * @param logger    The logger instance to use for log data.
+ * @return The path of the report.
+ * @throws std::runtime_error if the capture can't be analyzed or the report
+ *         can't be written.
+ */
+std::string WriteReport(std::string_view path, const BatchSettings& settings,
+                        ReportFormat format, std::string_view directory,
+                        wpi::Logger& logger);
+
+}  // namespace sysid
@@ -0,0 +1,273 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace sysid {
+
+/**
+ * A 64-bit FNV-1a hash, which is used to key cached results by the contents
+ * of a capture and the settings it was analyzed with.
+ */
+class Fnv1aHash {
+ public:
+  /**
+   * Adds bytes to the hash.
+   *
+   * @param data The bytes to add.
+   * @param size The number of bytes.
+   */
+  void AddBytes(const void* data, size_t size);
+
+  /**
+   * Adds the bytes of a value to the hash.
+   *
+   * @param value The value to add.
+   */
+  template <typename T>
+  void AddValue(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable values can be hashed as bytes");
+    AddBytes(&value, sizeof(T));
+  }
+
+  /**
+   * Adds a string and its length to the hash, so that adjacent strings can't
+   * run into each other.
+   *
+   * @param str The string to add.
+   */
+  void AddString(std::string_view str) {
+    AddValue<uint64_t>(str.size());
+    AddBytes(str.data(), str.size());
+  }
+
+  /**
+   * Returns the hash of everything that was added.
+   */
+  uint64_t Get() const { return m_hash; }
+
+ private:
+  uint64_t m_hash = 0xcbf29ce484222325;
+};
+
+/**
+ * Serializes a cache entry. Values are stored as raw bytes in the native byte
+ * order, and each value is padded to 8 bytes so that arrays of doubles are
+ * aligned in the memory mapped entry.
+ */
+class CacheWriter {
+ public:
+  /**
+   * Writes a value.
+   *
+   * @param value The value to write.
+   */
+  template <typename T>
+  void Write(const T& value) {
+    WriteArray(&value, 1);
+  }
+
+  /**
+   * Writes an array of values without its length.
+   *
+   * @param data  The values to write.
+   * @param count The number of values.
+   */
+  template <typename T>
+  void WriteArray(const T* data, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable values can be cached as bytes");
+    Append(data, count * sizeof(T));
+  }
+
+  /**
+   * Writes a vector of values, prefixed by its length.
+   *
+   * @param data The values to write.
+   */
+  template <typename T>
+  void WriteVector(const std::vector<T>& data) {
+    Write<uint64_t>(data.size());
+    WriteArray(data.data(), data.size());
+  }
+
+  /**
+   * Writes a string, prefixed by its length.
+   *
+   * @param str The string to write.
+   */
+  void WriteString(std::string_view str) {
+    Write<uint64_t>(str.size());
+    Append(str.data(), str.size());
+  }
+
+  /**
+   * Returns the serialized entry.
+   */
+  std::string_view GetData() const { return m_data; }
+
+ private:
+  void Append(const void* data, size_t size);
+
+  std::string m_data;
+};
+
+/**
+ * Deserializes a cache entry that was serialized by CacheWriter. Reading past
+ * the end of the entry throws a std::runtime_error, so truncated or corrupt
+ * entries never produce out-of-bounds reads.
+ */
+class CacheReader {
+ public:
+  /**
+   * Creates a reader over a serialized entry.
+   *
+   * @param data The serialized entry, which must outlive the reader.
+   * @param size The size of the entry in bytes.
+   */
+  CacheReader(const uint8_t* data, size_t size) : m_data{data}, m_size{size} {}
+
+  /**
+   * Reads a value.
+   */
+  template <typename T>
+  T Read() {
+    T value;
+    ReadArray(&value, 1);
+    return value;
+  }
+
+  /**
+   * Reads an array of values whose length is known.
+   *
+   * @param data  Where to store the values.
+   * @param count The number of values.
+   */
+  template <typename T>
+  void ReadArray(T* data, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable values can be cached as bytes");
+    if (count > (m_size - m_pos) / sizeof(T)) {
+      throw std::runtime_error("Truncated cache entry");
+    }
+    std::memcpy(data, Consume(count * sizeof(T)), count * sizeof(T));
+  }
+
+  /**
+   * Reads a vector of values that was written by CacheWriter::WriteVector().
+   *
+   * @param data Where to store the values.
+   */
+  template <typename T>
+  void ReadVector(std::vector<T>* data) {
+    auto count = Read<uint64_t>();
+    if (count > (m_size - m_pos) / sizeof(T)) {
+      throw std::runtime_error("Truncated cache entry");
+    }
+    data->resize(count);
+    ReadArray(data->data(), count);
+  }
+
+  /**
+   * Reads a string that was written by CacheWriter::WriteString().
+   */
+  std::string ReadString();
+
+ private:
+  /**
+   * Returns the next bytes and advances past them and their padding.
+   *
+   * @param size The number of bytes, which must be available.
+   */
+  const uint8_t* Consume(size_t size);
+
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_pos = 0;
+};
+
+/**
+ * A persistent cache of analysis results in a directory. Each entry is a file
+ * named after its key, which is a hash of everything the result depends on,
+ * so entries never have to be invalidated; entries that are no longer used are
+ * evicted oldest first once the directory exceeds its size limit.
+ *
+ * Entries are memory mapped when they're loaded and are replaced atomically
+ * when they're stored, so several processes (e.g. the GUI and the batch tool)
+ * can share a cache directory.
+ */
+class ResultCache {
+ public:
+  /**
+   * The default limit of the total size of the cache in bytes.
+   */
+  static constexpr uintmax_t kDefaultMaxSize = 256 << 20;
+
+  /**
+   * Creates a cache in a directory, which is created on the first store.
+   *
+   * @param directory The directory of the cache.
+   * @param maxSize   The limit of the total size of the entries in bytes.
+   */
+  explicit ResultCache(std::string_view directory,
+                       uintmax_t maxSize = kDefaultMaxSize);
+
+  /**
+   * Loads an entry. Entries that are truncated, corrupt, or from another
+   * version of the format are removed and treated as misses.
+   *
+   * @param key  The key of the entry.
+   * @param read The function that deserializes the entry. It may throw a
+   *             std::runtime_error if the entry is invalid, so it should only
+   *             commit the results once everything has been read.
+   * @return True if the entry was found and read.
+   */
+  bool Load(uint64_t key, const std::function<void(CacheReader&)>& read);
+
+  /**
+   * Stores an entry, replacing any entry with the same key. Failures (e.g. a
+   * read-only directory) are ignored since the cache is only an optimization.
+   *
+   * @param key   The key of the entry.
+   * @param entry The serialized entry.
+   * @return True if the entry was stored.
+   */
+  bool Store(uint64_t key, const CacheWriter& entry);
+
+  /**
+   * Returns the path of the file of an entry.
+   *
+   * @param key The key of the entry.
+   */
+  std::string GetPath(uint64_t key) const;
+
+ private:
+  /**
+   * Removes the least recently used entries until the cache fits in its size
+   * limit.
+   */
+  void Prune();
+
+  std::string m_directory;
+  uintmax_t m_maxSize;
+};
+
+/**
+ * Returns the default directory of the result cache, which is shared by all
+ * sysid tools of the user.
+ */
+std::string GetDefaultCacheDirectory();
+
+}  // namespace sysid
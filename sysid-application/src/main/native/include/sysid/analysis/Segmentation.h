@@ -0,0 +1,166 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <wpi/json.h>
+
+namespace sysid {
+
+/**
+ * The kinds of tests that can be found in a continuous capture.
+ */
+enum class SegmentType {
+  /// A voltage ramp starting from rest.
+  kQuasistatic,
+  /// A voltage step starting from rest.
+  kDynamic
+};
+
+/**
+ * A test that was found in a continuous capture.
+ */
+struct Segment {
+  /**
+   * The kind of test.
+   */
+  SegmentType type;
+
+  /**
+   * True if the voltage is positive.
+   */
+  bool forward;
+
+  /**
+   * The index of the first row of the test.
+   */
+  size_t begin;
+
+  /**
+   * The index one past the last row of the test.
+   */
+  size_t end;
+
+  /**
+   * Returns the key of the test in the sysid JSON (e.g. "slow-forward").
+   */
+  const char* GetKey() const;
+};
+
+/**
+ * The thresholds used to split a continuous capture into tests.
+ */
+struct SegmentationSettings {
+  /**
+   * The deviation (V) from the linear fit of the current segment at which a
+   * sample is considered a voltage change point.
+   */
+  double voltageTolerance = 0.25;
+
+  /**
+   * The deviation from the linear fit of the current segment, relative to the
+   * fitted voltage, at which a sample is considered a voltage change point.
+   * This keeps battery sag from splitting dynamic tests.
+   */
+  double relativeVoltageTolerance = 0.1;
+
+  /**
+   * The number of consecutive change points that start a new segment. Shorter
+   * deviations are treated as noise.
+   */
+  size_t breakSamples = 3;
+
+  /**
+   * The deviation from the linear fit of the current segment, relative to the
+   * voltage tolerance, above which a sample counts towards a biased run.
+   */
+  double biasFraction = 0.2;
+
+  /**
+   * The number of consecutive samples deviating to the same side of the linear
+   * fit that start a new segment. This finds slow ramps out of rest, which
+   * would otherwise tilt the fit without ever exceeding the voltage tolerance.
+   */
+  size_t biasSamples = 20;
+
+  /**
+   * The largest voltage (V) that is considered to be at rest. Ramps must start
+   * below it, and steps must jump from below it.
+   */
+  double restVoltage = 0.5;
+
+  /**
+   * The largest velocity that is considered to be at rest, as a fraction of
+   * the largest velocity in the capture.
+   */
+  double restVelocityFraction = 0.05;
+
+  /**
+   * The smallest voltage (V) of a dynamic test.
+   */
+  double minStepVoltage = 2.0;
+
+  /**
+   * The largest voltage change over a dynamic test, relative to its voltage.
+   */
+  double maxStepDrift = 0.25;
+
+  /**
+   * The smallest duration (s) of a dynamic test.
+   */
+  double minStepDuration = 0.5;
+
+  /**
+   * The range of ramp rates (V/s) of a quasistatic test.
+   */
+  double minRampRate = 0.05;
+  double maxRampRate = 3.0;
+
+  /**
+   * The smallest duration (s) of a quasistatic test.
+   */
+  double minRampDuration = 2.0;
+};
+
+/**
+ * Finds quasistatic and dynamic tests in a continuous capture (e.g. a log of a
+ * practice match).
+ *
+ * The voltage is split into segments that are each well described by a line,
+ * using a greedy change point detector that maintains a running least-squares
+ * fit. Segments are then classified as ramps or steps from their fit, and the
+ * velocity is used to check that each test starts from rest and to end it when
+ * the mechanism stops (e.g. at a hard stop). Every row is visited a constant
+ * number of times, so this runs in linear time.
+ *
+ * @param rows        The rows of the capture, in telemetry format, sorted by
+ *                    timestamp. The timestamp must be the first column.
+ * @param voltageCol  The column of the voltage.
+ * @param velocityCol The column of the velocity.
+ * @param settings    The segmentation thresholds.
+ * @return The tests that were found, in capture order.
+ */
+std::vector<Segment> SegmentCapture(
+    const std::vector<std::vector<double>>& rows, size_t voltageCol,
+    size_t velocityCol, const SegmentationSettings& settings = {});
+
+/**
+ * Splits the "continuous" capture of a sysid JSON into the four test datasets
+ * that the analysis expects. The longest test of each kind is stored under the
+ * usual keys (e.g. "slow-forward"), and any other tests are stored under
+ * numbered keys (e.g. "slow-forward-2"). The "continuous" array is removed.
+ *
+ * @param json        The JSON to split.
+ * @param voltageCol  The column of the voltage.
+ * @param velocityCol The column of the velocity.
+ * @param settings    The segmentation thresholds.
+ */
+void SplitContinuousCapture(wpi::json* json, size_t voltageCol,
+                            size_t velocityCol,
+                            const SegmentationSettings& settings = {});
+
+}  // namespace sysid
@@ -0,0 +1,113 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sysid {
+
+/**
+ * A point of a chart, as (x, y).
+ */
+using ChartPoint = std::array<double, 2>;
+
+/**
+ * Reduces a series to at most the given number of points.
+ *
+ * Lines are split into buckets along the series, and the points with the
+ * smallest and largest y of each bucket are kept so that peaks survive.
+ * Scatter series are sampled at a fixed stride.
+ *
+ * @param points    The points of the series.
+ * @param maxPoints The largest number of points to keep.
+ * @param isLine    Whether the series is drawn as a line.
+ * @return The decimated points, in their original order.
+ */
+std::vector<ChartPoint> DecimatePoints(const std::vector<ChartPoint>& points,
+                                       size_t maxPoints, bool isLine);
+
+/**
+ * A chart that is rendered to SVG without the GUI, e.g. for reports.
+ *
+ * Series are decimated when they're added, so rendering only depends on the
+ * size of the chart.
+ */
+class SvgChart {
+ public:
+  /**
+   * The largest number of points that are kept per series.
+   */
+  static constexpr size_t kMaxPoints = 1000;
+
+  /**
+   * The default width of the chart, in pixels.
+   */
+  static constexpr int kDefaultWidth = 640;
+
+  /**
+   * The default height of the chart, in pixels.
+   */
+  static constexpr int kDefaultHeight = 400;
+
+  /**
+   * Creates an empty chart.
+   *
+   * @param title  The title of the chart.
+   * @param xLabel The label of the x axis.
+   * @param yLabel The label of the y axis.
+   */
+  SvgChart(std::string title, std::string xLabel, std::string yLabel);
+
+  /**
+   * Adds a series that is drawn as points.
+   *
+   * @param name   The name of the series in the legend. Series with the same
+   *               name share a color and a legend entry.
+   * @param points The points.
+   */
+  void AddScatter(std::string_view name, const std::vector<ChartPoint>& points);
+
+  /**
+   * Adds a series that is drawn as a line through its points.
+   *
+   * @param name   The name of the series in the legend. Series with the same
+   *               name share a color and a legend entry.
+   * @param points The points.
+   */
+  void AddLine(std::string_view name, const std::vector<ChartPoint>& points);
+
+  /**
+   * Returns the title of the chart.
+   */
+  const std::string& GetTitle() const { return m_title; }
+
+  /**
+   * Renders the chart as a standalone SVG document. The axes are fit to the
+   * data.
+   *
+   * @param width  The width of the chart, in pixels.
+   * @param height The height of the chart, in pixels.
+   */
+  std::string Render(int width = kDefaultWidth,
+                     int height = kDefaultHeight) const;
+
+ private:
+  struct Series {
+    std::string name;
+    bool isLine;
+    std::vector<ChartPoint> points;
+  };
+
+  std::string m_title;
+  std::string m_xLabel;
+  std::string m_yLabel;
+  std::vector<Series> m_series;
+};
+
+}  // namespace sysid
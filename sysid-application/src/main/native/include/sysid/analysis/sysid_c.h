@@ -0,0 +1,192 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @defgroup sysid_c_api SysId Analysis C API
+ *
+ * A C API of the analysis for programs that have data in memory. It's built
+ * into the sysidAnalysis shared library.
+ *
+ * The API is stable: functions and enum values are only added, and the
+ * structs only grow at the end. Callers set the structSize of each struct they
+ * pass so that older callers keep working with newer libraries.
+ *
+ * @{
+ */
+
+#ifdef _WIN32
+#if defined(SYSID_EXPORTS)
+#define SYSID_API __declspec(dllexport)
+#elif defined(SYSID_STATIC)
+// The analysis is built into the program rather than loaded from a DLL.
+#define SYSID_API
+#else
+#define SYSID_API __declspec(dllimport)
+#endif
+#else
+#define SYSID_API __attribute__((visibility("default")))
+#endif
+
+/**
+ * The version of the API that this header describes.
+ */
+#define SYSID_API_VERSION 1
+
+/**
+ * The largest number of feedforward gains in a result.
+ */
+#define SYSID_MAX_GAINS 16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The status of an API call.
+ */
+enum SysId_Status {
+  /** The call succeeded. */
+  SYSID_OK = 0,
+  /** An argument is invalid (e.g. a null pointer or an unknown name). */
+  SYSID_INVALID_ARGUMENT = -1,
+  /** The data couldn't be analyzed. */
+  SYSID_ANALYSIS_FAILED = -2
+};
+
+/**
+ * The feedback controller loop type.
+ */
+enum SysId_LoopType { SYSID_LOOP_POSITION = 0, SYSID_LOOP_VELOCITY = 1 };
+
+/**
+ * The values of a test, stored in columns. There's a column for each value in
+ * a row of the test in a sysid JSON, e.g. the timestamp (s), voltage (V),
+ * position (rotations), and velocity (rotations/s) of general mechanisms, or
+ * the timestamp, left and right voltages, left and right positions, left and
+ * right velocities, gyro angle (rad), and gyro rate (rad/s) of drivetrains.
+ *
+ * The columns are read in place and only have to stay valid during the call.
+ */
+struct SysId_Test {
+  /** The columns. */
+  const double* const* columns;
+  /** The number of columns. */
+  size_t columnCount;
+  /** The number of values in each column. */
+  size_t size;
+};
+
+/**
+ * The settings of an analysis.
+ */
+struct SysId_Settings {
+  /** sizeof(struct SysId_Settings). */
+  uint32_t structSize;
+  /** The gain preset (as named in the analyzer), or null for the default. */
+  const char* preset;
+  /** The feedback controller loop type. */
+  enum SysId_LoopType loopType;
+  /** The LQR position or velocity tolerance. */
+  double lqrQp;
+  /** The LQR velocity or acceleration tolerance. */
+  double lqrQv;
+  /** The LQR control effort tolerance. */
+  double lqrR;
+  /** The dataset to analyze (e.g. "Forward"), or null for "Combined". */
+  const char* dataset;
+  /**
+   * Whether the motion threshold and step test duration are picked from the
+   * data. If they are, the values below are only used if that fails.
+   */
+  int autoTune;
+  /** The motion threshold for trimming quasistatic tests, in units/s. */
+  double motionThreshold;
+  /** The duration of the dynamic tests to use in s, or 0 for all of it. */
+  double stepTestDuration;
+  /** The window size for computing acceleration. */
+  int windowSize;
+  /** Whether a Kalman smoother estimates velocity and acceleration. */
+  int useKalmanSmoother;
+};
+
+/**
+ * The results of an analysis.
+ */
+struct SysId_Result {
+  /** sizeof(struct SysId_Result). */
+  uint32_t structSize;
+  /**
+   * The feedforward gains: Ks, Kv, and Ka, followed by the gains of the model
+   * terms of the analysis type (e.g. Kg for elevators).
+   */
+  double gains[SYSID_MAX_GAINS];
+  /** The names of the feedforward gains. They're valid forever. */
+  const char* gainNames[SYSID_MAX_GAINS];
+  /** The number of feedforward gains. */
+  size_t gainCount;
+  /** The r-squared of the feedforward fit. */
+  double rSquared;
+  /** The proportional feedback gain. */
+  double kp;
+  /** The derivative feedback gain. */
+  double kd;
+  /** The track width of angular drivetrain tests, or NaN. */
+  double trackWidth;
+  /** The motion threshold that was used, in units/s. */
+  double motionThreshold;
+  /** The step test duration that was used, in s. */
+  double stepTestDuration;
+};
+
+/**
+ * Returns SYSID_API_VERSION of the library.
+ */
+SYSID_API int SysId_GetAPIVersion(void);
+
+/**
+ * Fills the settings with the defaults of the analyzer and sets structSize.
+ *
+ * @param settings   The settings.
+ * @param structSize sizeof(struct SysId_Settings).
+ */
+SYSID_API void SysId_InitSettings(struct SysId_Settings* settings,
+                                  size_t structSize);
+
+/**
+ * Analyzes the tests of a capture.
+ *
+ * @param test             The analysis type (e.g. "Simple", "Elevator", "Arm",
+ *                         or "Drivetrain").
+ * @param unit             The units of positions and velocities in the output
+ *                         (e.g. "Meters").
+ * @param unitsPerRotation The number of units in a rotation.
+ * @param tests            The slow forward, slow backward, fast forward, and
+ *                         fast backward tests.
+ * @param settings         The settings, or null for the defaults.
+ * @param result           The results. Its structSize has to be set, and
+ *                         it's only written if the analysis succeeds.
+ * @return SYSID_OK, or an error whose message SysId_GetLastError() returns.
+ */
+SYSID_API int SysId_Analyze(const char* test, const char* unit,
+                            double unitsPerRotation,
+                            const struct SysId_Test tests[4],
+                            const struct SysId_Settings* settings,
+                            struct SysId_Result* result);
+
+/**
+ * Returns the message of the last error on this thread. It's valid until the
+ * next call on this thread.
+ */
+SYSID_API const char* SysId_GetLastError(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+/** @} */
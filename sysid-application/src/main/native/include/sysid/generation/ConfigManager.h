@@ -130,6 +130,13 @@ struct ConfigSettings {
    * If the configuration is for a drivetrain.
    */
   bool isDrive = false;
+
+  /**
+   * If the built-in encoder, current, and applied voltage of every motor
+   * should be logged alongside the mechanism encoder (general mechanisms
+   * only).
+   */
+  bool logMotorChannels = false;
 };
 
 // Pre-built configuration for the Romi -- all Romis have the same setup.
@@ -0,0 +1,182 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <ntcore_c.h>
+#include <wpi/Logger.h>
+
+#include "sysid/telemetry/TelemetryManager.h"
+
+namespace sysid {
+/**
+ * A capture session collects the tests of one robot. Each session has its own
+ * telemetry manager and a thread that updates it, so that several robots can
+ * be characterized at the same time and sessions that aren't shown keep
+ * collecting data.
+ *
+ * The telemetry manager isn't thread-safe, so it and the settings may only be
+ * used while holding the lock returned by Lock().
+ */
+class CaptureSession {
+ public:
+  /**
+   * How often the telemetry thread updates the telemetry manager.
+   */
+  static constexpr std::chrono::milliseconds kUpdatePeriod{5};
+
+  /**
+   * Creates a session with its own NT client instance. Call Connect() to
+   * connect it to a robot.
+   *
+   * @param name   The name of the robot, which is used in log messages and the
+   *               names of saved files.
+   * @param logger The logger instance to forward log data to from Update().
+   */
+  CaptureSession(std::string_view name, wpi::Logger& logger);
+
+  /**
+   * Creates a session on an NT instance that is connected elsewhere, e.g. the
+   * default instance that the NetworkTables settings connect.
+   *
+   * @param name     The name of the robot.
+   * @param logger   The logger instance to forward log data to from Update().
+   * @param instance The NT instance to collect data over.
+   */
+  CaptureSession(std::string_view name, wpi::Logger& logger,
+                 NT_Inst instance);
+
+  ~CaptureSession();
+
+  CaptureSession(const CaptureSession&) = delete;
+  CaptureSession& operator=(const CaptureSession&) = delete;
+
+  /**
+   * Connects the NT client to a robot. This is only valid for sessions with
+   * their own NT instance.
+   *
+   * @param server The team number or the address of the robot.
+   */
+  void Connect(std::string_view server);
+
+  /**
+   * Returns whether the NT instance is connected to a robot.
+   */
+  bool IsConnected() const;
+
+  /**
+   * Returns whether the session has its own NT instance.
+   */
+  bool OwnsInstance() const { return m_ownsInstance; }
+
+  /**
+   * Returns the name of the robot.
+   */
+  const std::string& GetName() const { return m_name; }
+
+  /**
+   * Sets the name of the robot.
+   *
+   * @param name The name.
+   */
+  void SetName(std::string_view name) { m_name = name; }
+
+  /**
+   * Returns the team number or address that the session was last connected
+   * to.
+   */
+  const std::string& GetServer() const { return m_server; }
+
+  /**
+   * Locks the telemetry manager and the settings.
+   */
+  std::unique_lock<std::mutex> Lock() {
+    return std::unique_lock<std::mutex>{m_mutex};
+  }
+
+  /**
+   * Returns the telemetry manager. Requires the lock.
+   */
+  TelemetryManager& GetManager() { return *m_manager; }
+
+  /**
+   * Returns the settings of the telemetry manager. Requires the lock.
+   */
+  TelemetryManager::Settings& GetSettings() { return m_settings; }
+
+  /**
+   * Returns the last message of the telemetry manager for the user. Requires
+   * the lock.
+   */
+  const std::string& GetMessage() const { return m_message; }
+
+  /**
+   * Returns the number of tests that have been run. Requires the lock.
+   */
+  size_t GetCompletedTests() const;
+
+  /**
+   * Resets the settings and discards the collected data. Requires the lock.
+   */
+  void Reset();
+
+  /**
+   * Saves the collected data with the name of the robot in the file name.
+   * Requires the lock.
+   *
+   * @param location The folder to save the JSON in.
+   * @return The full file path of the saved JSON.
+   */
+  std::string SaveJSON(std::string_view location);
+
+  /**
+   * Forwards the log data of the telemetry thread to the logger. This must be
+   * called periodically on the thread that owns the logger.
+   */
+  void Update();
+
+ private:
+  /**
+   * Creates the telemetry manager and starts the telemetry thread.
+   */
+  void Start();
+
+  std::string m_name;
+  std::string m_server;
+  wpi::Logger& m_logger;
+
+  NT_Inst m_instance;
+  bool m_ownsInstance;
+
+  // A log message of the telemetry thread.
+  struct LogMessage {
+    unsigned int level;
+    const char* file;
+    unsigned int line;
+    std::string msg;
+  };
+
+  // The log data of the telemetry thread, which is forwarded by Update().
+  wpi::Logger m_threadLogger;
+  std::mutex m_logMutex;
+  std::vector<LogMessage> m_logs;
+
+  std::mutex m_mutex;
+  TelemetryManager::Settings m_settings;
+  std::unique_ptr<TelemetryManager> m_manager;
+  std::string m_message;
+
+  std::atomic<bool> m_running{true};
+  std::thread m_thread;
+};
+}  // namespace sysid
@@ -0,0 +1,128 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include <units/time.h>
+#include <wpi/json.h>
+
+namespace sysid {
+/**
+ * Estimates the offset between the robot clock (the FPGA timestamp of the
+ * samples) and the host clock (wpi::Now()) from ping/echo exchanges.
+ *
+ * The host sends a ping, the robot echoes it with its clock, and the host
+ * notes when the echo arrives. Assuming the delay is the same both ways, the
+ * robot read its clock halfway through the round trip. Exchanges with short
+ * round trips are the least affected by queueing, so the offset is taken from
+ * the exchange with the shortest round trip among the latest ones. Using the
+ * latest exchanges follows the drift of the clocks.
+ */
+class ClockSync {
+ public:
+  /**
+   * A ping/echo exchange. All times are in seconds.
+   */
+  struct Sample {
+    /**
+     * The host time at which the ping was sent.
+     */
+    double hostSend;
+
+    /**
+     * The robot time at which the robot echoed the ping.
+     */
+    double robotTime;
+
+    /**
+     * The host time at which the echo arrived.
+     */
+    double hostReceive;
+
+    /**
+     * Returns the round trip time of the exchange.
+     */
+    double GetRoundTrip() const { return hostReceive - hostSend; }
+  };
+
+  /**
+   * The estimate of the clock offset and the latency.
+   */
+  struct Estimate {
+    /**
+     * The robot time minus the host time.
+     */
+    units::second_t offset;
+
+    /**
+     * The shortest round trip time.
+     */
+    units::second_t minRoundTrip;
+
+    /**
+     * The mean round trip time.
+     */
+    units::second_t meanRoundTrip;
+
+    /**
+     * The longest round trip time.
+     */
+    units::second_t maxRoundTrip;
+  };
+
+  /**
+   * The number of latest exchanges that the estimate is based on.
+   */
+  static constexpr size_t kWindowSize = 32;
+
+  /**
+   * How often the host sends a ping.
+   */
+  static constexpr units::second_t kPingPeriod = 100_ms;
+
+  /**
+   * Adds an exchange. Exchanges that end before they start are ignored.
+   *
+   * @param sample The exchange.
+   */
+  void AddSample(const Sample& sample);
+
+  /**
+   * Returns the estimate from the latest exchanges, or nothing if there are
+   * none.
+   */
+  const std::optional<Estimate>& GetEstimate() const { return m_estimate; }
+
+  /**
+   * Converts a host time to robot time.
+   *
+   * @param hostTime The host time.
+   * @return The robot time, or nothing if the clocks aren't synchronized yet.
+   */
+  std::optional<units::second_t> ToRobotTime(units::second_t hostTime) const;
+
+  /**
+   * Returns all exchanges since the last reset.
+   */
+  const std::vector<Sample>& GetSamples() const { return m_samples; }
+
+  /**
+   * Discards all exchanges.
+   */
+  void Reset();
+
+  /**
+   * Returns the estimate and the exchanges for storing with a capture.
+   */
+  wpi::json ToJSON() const;
+
+ private:
+  std::vector<Sample> m_samples;
+  std::optional<Estimate> m_estimate;
+};
+}  // namespace sysid
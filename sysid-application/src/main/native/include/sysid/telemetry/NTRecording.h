@@ -0,0 +1,217 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <ntcore_c.h>
+#include <ntcore_cpp.h>
+#include <wpi/StringMap.h>
+#include <wpi/json.h>
+
+namespace sysid {
+/**
+ * An entry update of a recorded NT session.
+ */
+struct NTRecordedEvent {
+  /**
+   * The time of the update in seconds since the recording started.
+   */
+  double time = 0;
+
+  /**
+   * The name of the entry.
+   */
+  std::string name;
+
+  /**
+   * The new value of the entry.
+   */
+  std::shared_ptr<nt::Value> value;
+
+  /**
+   * Whether the update was made by the recording program (e.g. the Logger)
+   * rather than by the robot.
+   */
+  bool local = false;
+
+  /**
+   * Whether this is the value that the entry had when the recording started.
+   */
+  bool initial = false;
+};
+
+/**
+ * A recorded NT session, with the updates in the order that they happened.
+ */
+struct NTRecording {
+  std::vector<NTRecordedEvent> events;
+
+  /**
+   * Returns the time of the last update.
+   */
+  double GetDuration() const {
+    return events.empty() ? 0.0 : events.back().time;
+  }
+};
+
+/**
+ * Converts a recording to JSON. Raw values are stored as Base64.
+ *
+ * @param recording The recording.
+ */
+wpi::json ToJSON(const NTRecording& recording);
+
+/**
+ * Converts JSON from ToJSON() back to a recording.
+ *
+ * @param json The JSON.
+ * @throws std::runtime_error if the JSON isn't a recording.
+ */
+NTRecording NTRecordingFromJSON(const wpi::json& json);
+
+/**
+ * Saves a recording to a file.
+ *
+ * @param recording The recording.
+ * @param path      The path of the file.
+ * @throws std::runtime_error if the file can't be written.
+ */
+void SaveRecording(const NTRecording& recording, std::string_view path);
+
+/**
+ * Loads a recording from a file.
+ *
+ * @param path The path of the file.
+ * @throws std::runtime_error if the file can't be read or isn't a recording.
+ */
+NTRecording LoadRecording(std::string_view path);
+
+/**
+ * Records the updates of the NT entries of an instance, both those made by
+ * the robot and those made locally.
+ */
+class NTRecorder {
+ public:
+  /**
+   * Starts recording. The current values of the entries are recorded as the
+   * initial values.
+   *
+   * @param instance The NT instance to record.
+   * @param prefix   Only entries whose names start with this are recorded.
+   */
+  explicit NTRecorder(NT_Inst instance, std::string_view prefix = "");
+
+  ~NTRecorder();
+
+  NTRecorder(const NTRecorder&) = delete;
+  NTRecorder& operator=(const NTRecorder&) = delete;
+
+  /**
+   * Adds the updates since the last call to the recording. This must be
+   * called periodically.
+   */
+  void Update();
+
+  /**
+   * Returns the recording so far.
+   */
+  const NTRecording& GetRecording() const { return m_recording; }
+
+ private:
+  NT_EntryListenerPoller m_poller;
+  double m_start;
+  NTRecording m_recording;
+};
+
+/**
+ * Publishes the updates of a recording made by the robot on an NT instance,
+ * e.g. one that runs a server that the Logger connects to.
+ *
+ * The robot only reacts to the Logger, so replaying is gated on the Logger:
+ * when the recording reaches a local update of a gate entry (by default the
+ * test type, which the Logger sets when a test begins), replaying waits until
+ * the entry is updated on the instance again.
+ */
+class NTReplayer {
+ public:
+  /**
+   * Creates a replayer.
+   *
+   * @param instance  The NT instance to publish the updates on.
+   * @param recording The recording. It must outlive the replayer.
+   * @param gates     The names of the entries that replaying waits for. The
+   *                  updates of these entries are never published.
+   */
+  NTReplayer(NT_Inst instance, const NTRecording& recording,
+             std::vector<std::string> gates = {
+                 "/SmartDashboard/SysIdTestType"});
+
+  ~NTReplayer();
+
+  NTReplayer(const NTReplayer&) = delete;
+  NTReplayer& operator=(const NTReplayer&) = delete;
+
+  /**
+   * Publishes the updates up to the given time of the recording, without
+   * waiting for gates.
+   *
+   * @param time The time in seconds since the recording started.
+   * @return The number of published updates.
+   */
+  size_t PublishUntil(double time);
+
+  /**
+   * Returns whether all updates have been published.
+   */
+  bool IsDone() const { return m_next == m_recording.events.size(); }
+
+  /**
+   * Replays the rest of the recording, waiting for gates.
+   *
+   * @param speed How many times faster than real time to replay. Updates are
+   *              published as fast as possible if this isn't positive.
+   * @param stop  Stops replaying when it becomes true.
+   * @return The number of published updates.
+   */
+  size_t Run(double speed, const std::atomic<bool>& stop);
+
+ private:
+  /**
+   * Returns whether replaying waits for updates of the entry.
+   */
+  bool IsGate(const std::string& name) const;
+
+  /**
+   * Publishes an update if it was made by the robot.
+   *
+   * @return Whether the update was published.
+   */
+  bool Publish(const NTRecordedEvent& event);
+
+  /**
+   * Returns whether the gate entry has been updated on the instance since the
+   * last time that it was passed, and marks it as passed.
+   */
+  bool PassGate(const std::string& name);
+
+  NT_Inst m_instance;
+  const NTRecording& m_recording;
+  std::vector<std::string> m_gates;
+  NT_EntryListenerPoller m_gatePoller;
+
+  // The number of updates of each gate entry on the instance that haven't
+  // passed a gate yet.
+  wpi::StringMap<size_t> m_gateUpdates;
+
+  wpi::StringMap<NT_Entry> m_entries;
+  size_t m_next = 0;
+};
+}  // namespace sysid
@@ -0,0 +1,42 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace sysid {
+
+/**
+ * Samples that were decoded from the packed telemetry of the robot.
+ */
+struct DecodedSamples {
+  /**
+   * The number of columns of each sample.
+   */
+  size_t columns = 0;
+
+  /**
+   * The values of the samples, one sample after the other.
+   */
+  std::vector<double> values;
+};
+
+/**
+ * Decodes the packed samples that the SampleEncoder of the sysid library sends
+ * on SysIdTelemetryPacked. The format is described in
+ * docs/data-collection.md.
+ *
+ * The stream is parsed into integers in one pass, and the integers are then
+ * accumulated and scaled column by column.
+ *
+ * @param data The packed samples.
+ * @return The samples.
+ * @throws std::runtime_error if the data isn't valid packed samples.
+ */
+DecodedSamples DecodeSamples(std::string_view data);
+
+}  // namespace sysid
@@ -18,8 +18,11 @@
 #include <wpi/Logger.h>
 #include <wpi/SmallVector.h>
 #include <wpi/json.h>
+#include <wpi/span.h>
 
 #include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/OnlineGainEstimator.h"
+#include "sysid/telemetry/ClockSync.h"
 
 namespace sysid {
 /**
@@ -105,7 +108,7 @@ class TelemetryManager {
   /**
    * Updates the telemetry manager -- this adds a new autospeed entry and
    * collects newest data from the robot. This must be called periodically by
-   * the user.
+   * the user. The robot clock is synchronized even when no test is running.
    */
   void Update();
 
@@ -124,9 +127,11 @@ class TelemetryManager {
    *
    * @param location The location to save the JSON at (this is the folder that
    *                 should contain the saved JSON).
+   * @param name     The name of the robot to add to the file name, or empty
+   *                 for none.
    * @return The full file path of the saved JSON.
    */
-  std::string SaveJSON(std::string_view location);
+  std::string SaveJSON(std::string_view location, std::string_view name = {});
 
   /**
    * Returns whether a test is currently running.
@@ -153,9 +158,44 @@ class TelemetryManager {
    */
   size_t GetCurrentDataSize() const { return m_params.data.size(); }
 
+  /**
+   * Returns the synchronization of the robot clock with the host clock.
+   */
+  const ClockSync& GetClockSync() const { return m_clockSync; }
+
+  /**
+   * Returns the live estimate of the gains over the tests of the mechanism.
+   * Robot programs that stream their samples update it while the tests run,
+   * and otherwise it's updated when the data of a test arrives.
+   */
+  const OnlineGainEstimator& GetLiveEstimator() const {
+    return m_liveEstimator;
+  }
+
  private:
   enum class State { WaitingForEnable, RunningTest, WaitingForData };
 
+  /**
+   * Sends pings to the robot and adds its echoes to the clock
+   * synchronization.
+   */
+  void UpdateClockSync();
+
+  /**
+   * Returns the number of values per sample of the current mechanism,
+   * including the motor channels that the robot program publishes, and
+   * stores the number of motors in the test parameters.
+   */
+  size_t GetRowSize();
+
+  /**
+   * Adds a chunk of streamed samples to the live estimate.
+   *
+   * @param chunk The index of the first sample in the test, followed by the
+   *              values of the samples.
+   */
+  void AddChunk(wpi::span<const double> chunk);
+
   /**
    * Stores information about a currently running test. This information
    * includes whether the robot will be traveling quickly (dynamic) or slowly
@@ -172,15 +212,24 @@ class TelemetryManager {
 
     double enableStart = 0.0;
     double disableStart = 0.0;
+    double receiveTime = 0.0;
 
     bool enabled = false;
     double speed = 0.0;
 
     std::string raw;
+    std::string packed;
     std::vector<std::vector<double>> data{};
     bool overflow = false;
     bool mechError = false;
 
+    // Whether the robot program is still sending the data.
+    bool sending = false;
+    size_t motorCount = 0;
+
+    // The number of samples that were streamed while the test ran.
+    size_t streamed = 0;
+
     TestParameters() = default;
     TestParameters(bool fast, bool forward, bool rotate, State state)
         : fast{fast}, forward{forward}, rotate{rotate}, state{state} {}
@@ -202,20 +251,57 @@ class TelemetryManager {
   // Stores the test data.
   wpi::json m_data;
 
+  // The number of motors with per-motor channels in the test data.
+  size_t m_motorCount = 0;
+
+  // Estimates the gains from the streamed samples, or from the data of each
+  // test if the robot program doesn't stream.
+  OnlineGainEstimator m_liveEstimator;
+
+  // How long to wait for the data after the robot disables, in seconds, and
+  // how long to wait while the robot reports that it's still sending it.
+  static constexpr double kDataTimeout = 5.0;
+  static constexpr double kSendingTimeout = 30.0;
+
+  // The most pings that wait for an echo. Older pings are dropped, e.g. if the
+  // robot program doesn't echo them.
+  static constexpr size_t kMaxPendingPings = 16;
+
+  // Synchronizes the robot clock, with the sequence numbers and host times of
+  // the pings that haven't been echoed yet.
+  ClockSync m_clockSync;
+  std::vector<std::pair<double, double>> m_pings;
+  double m_pingSequence = 0;
+  double m_lastPing = 0;
+
+  // The host events of each test in robot time (enable, disable, and receipt
+  // of the data).
+  wpi::json m_events;
+
   // Display callbacks.
   wpi::SmallVector<std::function<void(std::string_view)>, 1> m_callbacks;
 
   // NetworkTables instance and entries.
   NT_Inst m_inst;
   NT_EntryListenerPoller m_poller;
+  NT_EntryListenerPoller m_pongPoller;
+  NT_EntryListenerPoller m_chunkPoller;
   NT_Entry m_voltageCommand;
   NT_Entry m_testType;
   NT_Entry m_rotate;
   NT_Entry m_telemetry;
+  NT_Entry m_telemetryPacked;
+  NT_Entry m_packedRequest;
+  NT_Entry m_telemetryChunk;
+  NT_Entry m_streamRequest;
   NT_Entry m_overflow;
+  NT_Entry m_sending;
   NT_Entry m_telemetryOld;
   NT_Entry m_mechanism;
   NT_Entry m_mechError;
+  NT_Entry m_motorCountEntry;
   NT_Entry m_fieldInfo;
+  NT_Entry m_ping;
+  NT_Entry m_pong;
 };
 }  // namespace sysid
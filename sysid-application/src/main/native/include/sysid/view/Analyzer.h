@@ -9,6 +9,7 @@
 #include <optional>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 #include <glass/View.h>
@@ -23,6 +24,8 @@
 #include "sysid/analysis/AnalysisType.h"
 #include "sysid/analysis/FeedbackAnalysis.h"
 #include "sysid/analysis/FeedbackControllerPreset.h"
+#include "sysid/analysis/ModelTerms.h"
+#include "sysid/analysis/MotorChannels.h"
 #include "sysid/view/AnalyzerPlot.h"
 
 struct ImPlotPoint;
@@ -84,6 +87,13 @@ class Analyzer : public glass::View {
    */
   void PrepareData();
 
+  /**
+   * Picks the velocity threshold and step test duration that fit the data
+   * best, then prepares the data with them. Falls back to preparing the data
+   * with the current settings if no settings fit the data.
+   */
+  void AutoTune();
+
   /**
    * Calculates feedback and feedforward gains.
    */
@@ -118,6 +128,29 @@ class Analyzer : public glass::View {
    */
   void DisplayFeedforwardGains(bool combined = false);
 
+  /**
+   * Handles the logic for selecting the extra model terms (e.g. drag or
+   * backlash) to identify.
+   */
+  void DisplayModelTerms();
+
+  /**
+   * Handles the logic for comparing the feedforward gains of each swerve
+   * module with the pooled gains.
+   */
+  void DisplaySwerveModules();
+
+  /**
+   * Handles the logic for comparing the analysis of each motor of a
+   * multi-motor capture.
+   */
+  void DisplayMotorChannels();
+
+  /**
+   * Handles the logic for displaying the Kalman filter of each dataset.
+   */
+  void DisplayKalmanFilters();
+
   /**
    * Estimates ideal step test duration, qp, and qv for the LQR based off of the
    * data given
@@ -164,7 +197,11 @@ class Analyzer : public glass::View {
 
   // Feedforward and feedback gains.
   std::vector<double> m_ff;
+  std::vector<ModelTerm> m_modelTerms;
   double m_rSquared;
+  std::vector<std::tuple<std::vector<double>, double>> m_moduleGains;
+  std::vector<MotorDiagnostics> m_motorDiagnostics;
+  std::vector<AnalysisManager::EstimatorDesign> m_estimators;
   double m_Kp;
   double m_Kd;
 
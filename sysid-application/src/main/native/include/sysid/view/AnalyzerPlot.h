@@ -21,6 +21,8 @@
 #include "sysid/analysis/AnalysisManager.h"
 #include "sysid/analysis/AnalysisType.h"
 #include "sysid/analysis/FeedforwardAnalysis.h"
+#include "sysid/analysis/ModelTerms.h"
+#include "sysid/analysis/ReportGenerator.h"
 
 namespace sysid {
 /**
@@ -29,16 +31,10 @@ namespace sysid {
 class AnalyzerPlot {
  public:
   /**
-   * The chart titles of the plots that we wil create.
+   * The chart titles of the plots that we wil create. Reports show the same
+   * charts.
    */
-  static constexpr const char* kChartTitles[] = {
-      "Quasistatic Velocity vs. Velocity-Portion Voltage",
-      "Dynamic Acceleration vs. Acceleration-Portion Voltage",
-      "Quasistatic Velocity vs. Time",
-      "Quasistatic Acceleration vs. Time",
-      "Dynamic Velocity vs. Time",
-      "Dynamic Acceleration vs. Time",
-      "Timesteps vs. Time"};
+  static constexpr const auto& kChartTitles = sysid::kChartTitles;
 
   /**
    * Size of plots when put in combined mode (for screenshotting).
@@ -59,17 +55,20 @@ class AnalyzerPlot {
    * @param rawData      Raw data storage.
    * @param filteredData Filtered data storage.
    * @param unit         Unit of the dataset
-   * @param ff           List of feedforward gains (Ks, Kv, Ka, and optionally
-   *                     either Kg or Kcos).
+   * @param ff           List of feedforward gains (Ks, Kv, Ka, followed by the
+   *                     gains of the extra model terms).
    * @param startTimes   Array of dataset start times.
    * @param type         Type of analysis.
+   * @param terms        The extra model terms the gains were identified with.
+   * @param params       The shape parameters of the nonlinear model terms.
    * @param abort        Aborts analysis early if set to true from another
    *                     thread.
    */
   void SetData(const Storage& rawData, const Storage& filteredData,
                std::string_view unit, const std::vector<double>& ff,
                const std::array<units::second_t, 4>& startTimes,
-               AnalysisType type, std::atomic<bool>& abort);
+               AnalysisType type, const std::vector<ModelTerm>& terms,
+               const ModelTermParameters& params, std::atomic<bool>& abort);
 
   /**
    * Utility method to plot the raw time series data
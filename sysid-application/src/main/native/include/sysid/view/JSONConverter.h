@@ -8,6 +8,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <glass/View.h>
 #include <portable-file-dialogs.h>
@@ -17,7 +18,8 @@ namespace sysid {
 /**
  * Helps with converting different JSONs into different formats. Primarily
  * enables users to convert an old 2020 FRC-Characterization JSON into a SysId
- * JSON or a SysId JSON into a CSV file.
+ * JSON or a SysId JSON into a CSV file, and to import a WPILib data log as a
+ * SysId JSON.
  */
 class JSONConverter {
  public:
@@ -33,6 +35,11 @@ class JSONConverter {
    */
   void DisplayCSVConvert();
 
+  /**
+   * Function to display the WPILib data log importer.
+   */
+  void DisplayDataLogImport();
+
  private:
   /**
    * Helper method to display a specific JSON converter
@@ -53,5 +60,13 @@ class JSONConverter {
   std::string m_exception;
 
   double m_timestamp = 0;
+
+  std::unique_ptr<pfd::open_file> m_logOpener;
+  std::string m_logLocation;
+  std::vector<std::string> m_logEntries;
+  std::vector<int> m_selectedEntries;
+  int m_selectedType = 0;
+  int m_selectedUnit = 0;
+  double m_unitsPerRotation = 1.0;
 };
 }  // namespace sysid
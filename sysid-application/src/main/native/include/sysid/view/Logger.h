@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <glass/DataSource.h>
 #include <glass/View.h>
@@ -13,7 +14,7 @@
 #include <portable-file-dialogs.h>
 #include <wpi/Logger.h>
 
-#include "sysid/telemetry/TelemetryManager.h"
+#include "sysid/telemetry/CaptureSession.h"
 
 namespace glass {
 class Storage;
@@ -24,6 +25,10 @@ namespace sysid {
  * The logger GUI takes care of running the system idenfitication tests over
  * NetworkTables and logging the data. This data is then stored in a JSON file
  * which can be used for analysis.
+ *
+ * Each robot has a tab with its own capture session, so several robots can run
+ * tests at the same time. The first robot is connected with the NetworkTables
+ * settings, and the others connect their own NT clients.
  */
 class Logger : public glass::View {
  public:
@@ -43,8 +48,9 @@ class Logger : public glass::View {
   /**
    * The different mechanism / analysis types that are supported.
    */
-  static constexpr const char* kTypes[] = {"Drivetrain", "Drivetrain (Angular)",
-                                           "Arm", "Elevator", "Simple"};
+  static constexpr const char* kTypes[] = {
+      "Drivetrain", "Drivetrain (Angular)", "Arm",         "Elevator",
+      "Simple",     "Swerve Drive",         "Swerve Steer"};
 
   /**
    * The different units that are supported.
@@ -53,6 +59,24 @@ class Logger : public glass::View {
                                            "Radians", "Rotations", "Degrees"};
 
  private:
+  /**
+   * The GUI state of a robot's tab.
+   */
+  struct SessionView {
+    std::unique_ptr<CaptureSession> session;
+    int selectedType = 0;
+    int selectedUnit = 0;
+    std::string server;
+    std::string opened;
+  };
+
+  /**
+   * Displays the tab of a robot. The session must be locked.
+   *
+   * @param view The tab of the robot.
+   */
+  void DisplaySession(SessionView& view);
+
   /**
    * Handles the logic of selecting a folder to save the SysId JSON to
    */
@@ -60,24 +84,14 @@ class Logger : public glass::View {
 
   wpi::Logger& m_logger;
 
-  TelemetryManager::Settings m_settings;
-  int m_selectedType = 0;
-  int m_selectedUnit = 0;
-
-  std::unique_ptr<TelemetryManager> m_manager =
-      std::make_unique<TelemetryManager>(m_settings, m_logger);
+  std::vector<SessionView> m_sessions;
+  int m_sessionCount = 0;
 
   std::unique_ptr<pfd::select_folder> m_selector;
   std::string m_jsonLocation;
 
   glass::NetworkTablesSettings m_ntSettings;
-  bool m_ntConnected = false;
-
-  bool m_isRotationalUnits = false;
-
-  std::string m_popupText;
 
-  std::string m_opened;
   std::string m_exception;
 };
 }  // namespace sysid
@@ -0,0 +1,167 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <wpi/Logger.h>
+#include <wpi/fs.h>
+#include <wpi/json.h>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/AnalysisManager.h"
+#include "sysid/analysis/AnalysisService.h"
+#include "sysid/analysis/BatchAnalysis.h"
+
+/**
+ * Returns a capture of a simple motor with Ks = 0.5, Kv = 2, and Ka = 0.3.
+ */
+static wpi::json MakeCapture() {
+  constexpr double Ks = 0.5;
+  constexpr double Kv = 2.0;
+  constexpr double Ka = 0.3;
+  constexpr double dt = 0.005;
+
+  wpi::json json = {{"sysid", true},
+                    {"test", "Simple"},
+                    {"units", "Rotations"},
+                    {"unitsPerRotation", 1.0}};
+  double startTime = 0.0;
+  for (std::string key : sysid::AnalysisManager::kJsonDataKeys) {
+    bool fast = key.find("fast") != std::string::npos;
+    double sign = key.find("backward") != std::string::npos ? -1.0 : 1.0;
+    std::vector<std::vector<double>> rows;
+    double position = 0.0;
+    double velocity = 0.0;
+    startTime += 100.0;
+    for (int i = 0; i < (fast ? 600 : 2400); ++i) {
+      double t = i * dt;
+      double voltage = sign * (fast ? 7.0 : 0.25 * t);
+      rows.push_back({startTime + t, voltage, position, velocity});
+      double acceleration = 0.0;
+      if (velocity != 0.0 || std::abs(voltage) > Ks) {
+        double direction = std::copysign(1.0, velocity != 0 ? velocity : sign);
+        acceleration = (voltage - Ks * direction - Kv * velocity) / Ka;
+      }
+      position += velocity * dt + acceleration * dt * dt / 2;
+      velocity += acceleration * dt;
+    }
+    json[key] = rows;
+  }
+  return json;
+}
+
+/**
+ * Runs a request and waits for its response.
+ */
+static sysid::AnalysisService::Response Request(
+    sysid::AnalysisService& service, wpi::json request) {
+  std::promise<sysid::AnalysisService::Response> promise;
+  auto future = promise.get_future();
+  service.Submit(std::move(request),
+                 [&](auto response) { promise.set_value(response); });
+  return future.get();
+}
+
+/**
+ * Returns settings that analyze captures quickly.
+ */
+static sysid::BatchSettings MakeSettings() {
+  sysid::BatchSettings settings;
+  settings.autoTune = false;
+  return settings;
+}
+
+TEST(AnalysisServiceTest, AnalyzesCaptures) {
+  wpi::Logger logger;
+  sysid::AnalysisService service{MakeSettings(), 2, 4, logger};
+
+  auto response = Request(service, {{"capture", MakeCapture()}});
+  ASSERT_EQ(200, response.status) << response.body.dump();
+  const auto& ff = response.body.at("feedforward");
+  EXPECT_NEAR(0.5, ff.at("Ks").get<double>(), 0.05);
+  EXPECT_NEAR(2.0, ff.at("Kv").get<double>(), 0.05);
+  EXPECT_NEAR(0.3, ff.at("Ka").get<double>(), 0.05);
+  EXPECT_EQ("Velocity", response.body.at("loopType"));
+
+  // Captures can also be read from a path, and the settings can be
+  // overridden by each request.
+  auto path = fs::temp_directory_path() / "sysid-service.json";
+  std::ofstream{path} << MakeCapture();
+  response = Request(service, {{"path", path.string()},
+                           {"settings", {{"loopType", "Position"}}}});
+  ASSERT_EQ(200, response.status) << response.body.dump();
+  EXPECT_EQ("sysid-service.json", response.body.at("capture"));
+  EXPECT_EQ("Position", response.body.at("loopType"));
+
+  auto status = service.GetStatus();
+  EXPECT_EQ(2u, status.at("completed").get<size_t>());
+  EXPECT_EQ(0u, status.at("rejected").get<size_t>());
+}
+
+TEST(AnalysisServiceTest, ReportsErrors) {
+  wpi::Logger logger;
+  sysid::AnalysisService service{MakeSettings(), 1, 4, logger};
+
+  EXPECT_EQ(400, Request(service, wpi::json::array()).status);
+  EXPECT_EQ(400, Request(service, wpi::json::object()).status);
+  EXPECT_EQ(400, Request(service, {{"capture", MakeCapture()},
+                               {"settings", {{"loopType", "Torque"}}}})
+                     .status);
+  // Non-positive shape parameters would make the model terms singular.
+  EXPECT_EQ(400, Request(service, {{"capture", MakeCapture()},
+                               {"settings", {{"backlashWidth", 0.0}}}})
+                     .status);
+  EXPECT_EQ(400, Request(service, {{"capture", MakeCapture()},
+                               {"settings", {{"stribeckVelocity", -1.0}}}})
+                     .status);
+
+  auto response = Request(service, {{"capture", {{"sysid", true}}}});
+  EXPECT_EQ(422, response.status);
+  EXPECT_TRUE(response.body.contains("error"));
+  response = Request(service, {{"path", "/nonexistent/sysid_data.json"}});
+  EXPECT_EQ(422, response.status);
+}
+
+TEST(AnalysisServiceTest, RejectsRequestsWhenFull) {
+  wpi::Logger logger;
+  sysid::AnalysisService service{MakeSettings(), 1, 1, logger};
+
+  // Keep the only worker busy with a request whose callback blocks.
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::promise<int> first;
+  service.Submit(wpi::json::object(), [&](auto response) {
+    released.wait();
+    first.set_value(response.status);
+  });
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+  while (service.GetStatus().at("active") != 1 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  }
+
+  // One request fits in the queue and the next one is rejected right away.
+  std::promise<int> second;
+  service.Submit(wpi::json::object(),
+                 [&](auto response) { second.set_value(response.status); });
+  int rejected = 0;
+  service.Submit(wpi::json::object(),
+                 [&](auto response) { rejected = response.status; });
+  EXPECT_EQ(503, rejected);
+
+  auto status = service.GetStatus();
+  EXPECT_EQ(1u, status.at("active").get<size_t>());
+  EXPECT_EQ(1u, status.at("queued").get<size_t>());
+  EXPECT_EQ(1u, status.at("rejected").get<size_t>());
+
+  release.set_value();
+  EXPECT_EQ(400, first.get_future().get());
+  EXPECT_EQ(400, second.get_future().get());
+}
@@ -13,5 +13,16 @@ TEST(AnalysisTypeTest, FromName) {
   EXPECT_EQ(sysid::analysis::kElevator, sysid::analysis::FromName("Elevator"));
   EXPECT_EQ(sysid::analysis::kArm, sysid::analysis::FromName("Arm"));
   EXPECT_EQ(sysid::analysis::kSimple, sysid::analysis::FromName("Simple"));
+  EXPECT_EQ(sysid::analysis::kSwerveDrive,
+            sysid::analysis::FromName("Swerve Drive"));
+  EXPECT_EQ(sysid::analysis::kSwerveSteer,
+            sysid::analysis::FromName("Swerve Steer"));
   EXPECT_EQ(sysid::analysis::kSimple, sysid::analysis::FromName("Random"));
 }
+
+TEST(AnalysisTypeTest, IsSwerve) {
+  EXPECT_TRUE(sysid::analysis::IsSwerve(sysid::analysis::kSwerveDrive));
+  EXPECT_TRUE(sysid::analysis::IsSwerve(sysid::analysis::kSwerveSteer));
+  EXPECT_FALSE(sysid::analysis::IsSwerve(sysid::analysis::kDrivetrain));
+  EXPECT_FALSE(sysid::analysis::IsSwerve(sysid::analysis::kSimple));
+}
@@ -0,0 +1,49 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/Arena.h"
+
+/**
+ * Allocates buffers like a run of the analysis, including a vector that grows
+ * one element at a time.
+ */
+static void AllocateRun(sysid::Arena* arena) {
+  std::pmr::vector<double> fixed(30000, 1.0, arena->GetResource());
+  std::pmr::vector<double> growing{arena->GetResource()};
+  for (int i = 0; i < 20000; ++i) {
+    growing.push_back(i);
+  }
+  EXPECT_EQ(1.0, fixed.back());
+  EXPECT_EQ(19999.0, growing.back());
+}
+
+TEST(ArenaTest, GrowsToFitRun) {
+  sysid::Arena arena;
+  AllocateRun(&arena);
+  EXPECT_GT(arena.GetHeapAllocations(), 0u);
+  EXPECT_EQ(0u, arena.GetCapacity());
+
+  // The block grows to fit the first run, so repeating it doesn't allocate
+  // from the heap.
+  arena.Reset();
+  size_t capacity = arena.GetCapacity();
+  EXPECT_GE(capacity, (30000 + 20000) * sizeof(double));
+  for (int i = 0; i < 3; ++i) {
+    AllocateRun(&arena);
+    EXPECT_EQ(0u, arena.GetHeapAllocations());
+    arena.Reset();
+    EXPECT_EQ(capacity, arena.GetCapacity());
+  }
+}
+
+TEST(ArenaTest, InitialCapacity) {
+  sysid::Arena arena{1 << 20};
+  AllocateRun(&arena);
+  EXPECT_EQ(0u, arena.GetHeapAllocations());
+  arena.Reset();
+  EXPECT_EQ(1u << 20, arena.GetCapacity());
+}
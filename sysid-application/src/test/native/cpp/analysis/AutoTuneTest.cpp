@@ -0,0 +1,177 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <random>
+#include <vector>
+
+#include <units/time.h>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/AutoTune.h"
+#include "sysid/analysis/RegressionSuite.h"
+#include "sysid/analysis/Storage.h"
+
+static constexpr double kDt = 0.005;
+
+/**
+ * Creates a dynamic test of a mechanism with a time constant of 0.15 s that
+ * accelerates towards 6 units/s and, optionally, hits a hard stop.
+ */
+static std::vector<sysid::PreparedData> CreateDynamicTest(double noise,
+                                                          double stopTime) {
+  std::mt19937 gen{1};
+  std::normal_distribution<double> dist{0.0, noise};
+
+  std::vector<sysid::PreparedData> data;
+  for (double t = 0; t < 2.0; t += kDt) {
+    double velocity = 6.0 * (1 - std::exp(-t / 0.15));
+    double acceleration = 40.0 * std::exp(-t / 0.15) + dist(gen);
+    if (t >= stopTime) {
+      velocity = 0.0;
+      acceleration = std::abs(t - stopTime) < kDt / 2 ? -1200.0 : dist(gen);
+    }
+    data.push_back({units::second_t{t}, 7.0, 0.0, velocity});
+    data.back().acceleration = acceleration;
+  }
+  return data;
+}
+
+TEST(AutoTuneTest, SplitTests) {
+  std::vector<sysid::PreparedData> data;
+  for (double t : {0.0, 0.005, 0.01, 0.0, 0.005, 1.0, 1.005}) {
+    data.push_back({units::second_t{t}, 0.0, 0.0, 0.0});
+  }
+
+  auto tests = sysid::SplitTests(data);
+  ASSERT_EQ(3u, tests.size());
+  EXPECT_EQ(3u, tests[0].size());
+  EXPECT_EQ(2u, tests[1].size());
+  EXPECT_EQ(2u, tests[2].size());
+}
+
+TEST(AutoTuneTest, QuantizedNoiseFloor) {
+  // A slow ramp reported in multiples of 0.05 units/s.
+  std::vector<sysid::PreparedData> data;
+  for (int i = 0; i < 1000; ++i) {
+    double velocity = std::round(0.004 * i / 0.05) * 0.05;
+    data.push_back({units::second_t{i * kDt}, 0.0, 0.0, velocity});
+  }
+
+  EXPECT_NEAR(0.05, sysid::EstimateVelocityNoiseFloor(data), 1e-9);
+}
+
+TEST(AutoTuneTest, WhiteNoiseFloor) {
+  std::mt19937 gen{2};
+  std::normal_distribution<double> dist{0.0, 0.02};
+
+  std::vector<sysid::PreparedData> data;
+  for (int i = 0; i < 4000; ++i) {
+    data.push_back(
+        {units::second_t{i * kDt}, 0.0, 0.0, 0.001 * i + dist(gen)});
+  }
+
+  EXPECT_NEAR(0.02, sysid::EstimateVelocityNoiseFloor(data), 0.002);
+}
+
+TEST(AutoTuneTest, SteadyStateOnset) {
+  for (double stopTime : {10.0, 1.0}) {
+    auto data = CreateDynamicTest(0.5, stopTime);
+    double noise = sysid::EstimateAccelNoise(data, 9);
+    EXPECT_NEAR(0.5, noise, 0.15);
+
+    // The transient decays into the noise after about 0.65 s, and the hard
+    // stop doesn't extend it.
+    auto onset = data[sysid::FindSteadyStateOnset(data, noise)].timestamp;
+    EXPECT_GT(onset, 0.4_s);
+    EXPECT_LT(onset, 0.9_s);
+  }
+}
+
+TEST(AutoTuneTest, Candidates) {
+  // Thresholds above a quarter of the largest velocity aren't tried.
+  std::vector<double> expected{0.075, 0.1, 0.15, 0.2};
+  auto thresholds = sysid::GetMotionThresholdCandidates(0.05, 1.0);
+  ASSERT_EQ(expected.size(), thresholds.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_DOUBLE_EQ(expected[i], thresholds[i]);
+  }
+
+  // Unless they are the configured threshold.
+  expected = {0.075, 0.1, 0.15, 0.2, 0.3};
+  thresholds = sysid::GetMotionThresholdCandidates(0.05, 1.0, 0.3);
+  ASSERT_EQ(expected.size(), thresholds.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_DOUBLE_EQ(expected[i], thresholds[i]);
+  }
+  EXPECT_EQ(4u, sysid::GetMotionThresholdCandidates(0.05, 1.0, 0.1).size());
+
+  // Noise-free data still gets a threshold.
+  thresholds = sysid::GetMotionThresholdCandidates(0.0, 10.0);
+  ASSERT_FALSE(thresholds.empty());
+  EXPECT_GT(thresholds[0], 0.0);
+
+  auto durations = sysid::GetStepDurationCandidates(0.5_s, 0.3_s, 1.6_s);
+  ASSERT_EQ(5u, durations.size());
+  EXPECT_DOUBLE_EQ(0.5, durations[0].to<double>());
+  EXPECT_DOUBLE_EQ(1.5, durations[3].to<double>());
+  EXPECT_DOUBLE_EQ(1.6, durations[4].to<double>());
+}
+
+TEST(AutoTuneTest, ValidationFolds) {
+  // Consecutive blocks of samples go to consecutive folds.
+  EXPECT_EQ(sysid::GetValidationFold(0_s), sysid::GetValidationFold(0.2_s));
+  EXPECT_NE(sysid::GetValidationFold(0_s), sysid::GetValidationFold(0.3_s));
+  EXPECT_EQ(sysid::GetValidationFold(0_s), sysid::GetValidationFold(1.25_s));
+  EXPECT_LT(sysid::GetValidationFold(-0.1_s), sysid::kValidationFolds);
+
+  sysid::Storage data;
+  for (int i = 0; i < 1000; ++i) {
+    data.slow.push_back({units::second_t{i * kDt}, 0.0, 0.0, 0.0});
+  }
+  size_t excluded = 0;
+  for (size_t fold = 0; fold < sysid::kValidationFolds; ++fold) {
+    excluded += data.slow.size() -
+                sysid::ExcludeValidationFold(data, fold).slow.size();
+  }
+  EXPECT_EQ(data.slow.size(), excluded);
+}
+
+/**
+ * Checks that auto-tuning recovers the gains of a mechanism with a lot of
+ * static friction, where keeping the samples that barely move matters most.
+ */
+static void CheckHighStaticFriction(const sysid::AnalysisType& type,
+                                    double noise) {
+  std::vector<double> gains{1.2, 1.8, 0.35};
+  sysid::RegressionCase regressionCase{
+      std::string{type.name},
+      sysid::MakeSyntheticCapture(type, gains, "Meters", noise),
+      {{"Ks", gains[0]}, {"Kv", gains[1]}, {"Ka", gains[2]}}};
+
+  wpi::Logger logger;
+  sysid::BatchSettings settings;
+  settings.autoTune = true;
+  auto result = sysid::RunRegressionCase(regressionCase, settings, 1, logger);
+  EXPECT_NEAR(gains[0], result.gains["Ks"], 0.03 * gains[0]);
+  EXPECT_NEAR(gains[1], result.gains["Kv"], 0.03 * gains[1]);
+  EXPECT_NEAR(gains[2], result.gains["Ka"], 0.05 * gains[2]);
+
+  // Auto-tuning shouldn't do worse than the configured settings.
+  settings.autoTune = false;
+  auto configured =
+      sysid::RunRegressionCase(regressionCase, settings, 1, logger);
+  EXPECT_LT(result.gainError, configured.gainError + 0.01);
+}
+
+TEST(AutoTuneTest, HighStaticFrictionSimple) {
+  CheckHighStaticFriction(sysid::analysis::kSimple, 0.0);
+}
+
+TEST(AutoTuneTest, HighStaticFrictionDrivetrain) {
+  CheckHighStaticFriction(sysid::analysis::kDrivetrain, 0.01);
+}
@@ -0,0 +1,147 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <wpi/Logger.h>
+#include <wpi/json.h>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/AnalysisManager.h"
+#include "sysid/analysis/BatchAnalysis.h"
+#include "sysid/analysis/sysid_c.h"
+
+/**
+ * The columns of a simulated test of a simple motor with Ks = 0.5, Kv = 2,
+ * and Ka = 0.3.
+ */
+struct TestColumns {
+  std::vector<double> time;
+  std::vector<double> voltage;
+  std::vector<double> position;
+  std::vector<double> velocity;
+  std::array<const double*, 4> columns;
+
+  TestColumns(bool fast, double sign, double startTime) {
+    constexpr double Ks = 0.5;
+    constexpr double Kv = 2.0;
+    constexpr double Ka = 0.3;
+    constexpr double dt = 0.005;
+
+    double p = 0.0;
+    double v = 0.0;
+    for (int i = 0; i < (fast ? 600 : 2400); ++i) {
+      double t = i * dt;
+      double u = sign * (fast ? 7.0 : 0.25 * t);
+      time.push_back(startTime + t);
+      voltage.push_back(u);
+      position.push_back(p);
+      velocity.push_back(v);
+      double a = 0.0;
+      if (v != 0.0 || std::abs(u) > Ks) {
+        a = (u - Ks * std::copysign(1.0, v != 0 ? v : sign) - Kv * v) / Ka;
+      }
+      p += v * dt + a * dt * dt / 2;
+      v += a * dt;
+    }
+    columns = {time.data(), voltage.data(), position.data(), velocity.data()};
+  }
+
+  SysId_Test GetTest() const {
+    return {columns.data(), columns.size(), time.size()};
+  }
+};
+
+TEST(CAPITest, Analyze) {
+  EXPECT_EQ(SYSID_API_VERSION, SysId_GetAPIVersion());
+
+  TestColumns slowForward{false, 1.0, 100.0};
+  TestColumns slowBackward{false, -1.0, 200.0};
+  TestColumns fastForward{true, 1.0, 300.0};
+  TestColumns fastBackward{true, -1.0, 400.0};
+  SysId_Test tests[] = {slowForward.GetTest(), slowBackward.GetTest(),
+                        fastForward.GetTest(), fastBackward.GetTest()};
+
+  SysId_Settings settings;
+  SysId_InitSettings(&settings, sizeof(settings));
+  settings.autoTune = 0;
+  SysId_Result result;
+  result.structSize = sizeof(result);
+  ASSERT_EQ(SYSID_OK, SysId_Analyze("Simple", "Rotations", 1.0, tests,
+                                    &settings, &result))
+      << SysId_GetLastError();
+
+  ASSERT_EQ(3u, result.gainCount);
+  EXPECT_EQ(std::string{"Ks"}, result.gainNames[0]);
+  EXPECT_EQ(std::string{"Ka"}, result.gainNames[2]);
+  EXPECT_NEAR(0.5, result.gains[0], 0.05);
+  EXPECT_NEAR(2.0, result.gains[1], 0.05);
+  EXPECT_NEAR(0.3, result.gains[2], 0.05);
+  EXPECT_GT(result.rSquared, 0.99);
+  EXPECT_GT(result.kp, 0.0);
+  EXPECT_TRUE(std::isnan(result.trackWidth));
+
+  // The gains match the ones of the same capture in a JSON.
+  wpi::json json = {{"sysid", true},
+                    {"test", "Simple"},
+                    {"units", "Rotations"},
+                    {"unitsPerRotation", 1.0}};
+  for (size_t i = 0; i < 4; ++i) {
+    auto& rows = json[sysid::AnalysisManager::kJsonDataKeys[i]];
+    for (size_t row = 0; row < tests[i].size; ++row) {
+      rows.push_back({tests[i].columns[0][row], tests[i].columns[1][row],
+                      tests[i].columns[2][row], tests[i].columns[3][row]});
+    }
+  }
+  sysid::BatchSettings batchSettings;
+  batchSettings.autoTune = false;
+  wpi::Logger logger;
+  auto expected = sysid::AnalyzeCaptureData(json, batchSettings, logger);
+  EXPECT_DOUBLE_EQ(expected.at("feedforward").at("Ks").get<double>(),
+                   result.gains[0]);
+  EXPECT_DOUBLE_EQ(expected.at("feedforward").at("Kv").get<double>(),
+                   result.gains[1]);
+  EXPECT_DOUBLE_EQ(expected.at("feedback").at("Kp").get<double>(), result.kp);
+}
+
+TEST(CAPITest, ReportsErrors) {
+  TestColumns test{false, 1.0, 100.0};
+  SysId_Test tests[] = {test.GetTest(), test.GetTest(), test.GetTest(),
+                        test.GetTest()};
+  SysId_Result result;
+  result.structSize = sizeof(result);
+
+  EXPECT_EQ(SYSID_INVALID_ARGUMENT,
+            SysId_Analyze("Simple", "Rotations", 1.0, tests, nullptr, nullptr));
+  EXPECT_NE(std::string{}, SysId_GetLastError());
+
+  SysId_Settings settings;
+  SysId_InitSettings(&settings, sizeof(settings));
+  settings.preset = "Unknown";
+  EXPECT_EQ(SYSID_INVALID_ARGUMENT, SysId_Analyze("Simple", "Rotations", 1.0,
+                                                  tests, &settings, &result));
+  EXPECT_EQ(std::string{"Unknown gain preset: Unknown"}, SysId_GetLastError());
+
+  // The structs have to be at least as large as in the first version.
+  result.structSize = offsetof(SysId_Result, stepTestDuration);
+  EXPECT_EQ(SYSID_INVALID_ARGUMENT,
+            SysId_Analyze("Simple", "Rotations", 1.0, tests, nullptr,
+                          &result));
+  EXPECT_EQ(std::string{"The struct sizes aren't set"}, SysId_GetLastError());
+  result.structSize = sizeof(result);
+
+  // Drivetrains need more columns than general mechanisms.
+  EXPECT_EQ(SYSID_ANALYSIS_FAILED,
+            SysId_Analyze("Drivetrain", "Meters", 1.0, tests, nullptr,
+                          &result));
+
+  tests[1].size = 1;
+  EXPECT_EQ(SYSID_INVALID_ARGUMENT,
+            SysId_Analyze("Simple", "Rotations", 1.0, tests, nullptr,
+                          &result));
+}
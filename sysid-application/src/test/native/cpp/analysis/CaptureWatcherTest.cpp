@@ -0,0 +1,159 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <wpi/Logger.h>
+#include <wpi/fs.h>
+#include <wpi/json.h>
+#include <wpi/raw_istream.h>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/AnalysisManager.h"
+#include "sysid/analysis/BatchAnalysis.h"
+#include "sysid/analysis/CaptureWatcher.h"
+
+/**
+ * Writes a capture of a simple motor with Ks = 0.5, Kv = 2, and Ka = 0.3.
+ */
+static void WriteCapture(const fs::path& path) {
+  constexpr double Ks = 0.5;
+  constexpr double Kv = 2.0;
+  constexpr double Ka = 0.3;
+  constexpr double dt = 0.005;
+
+  wpi::json json = {{"sysid", true},
+                    {"test", "Simple"},
+                    {"units", "Rotations"},
+                    {"unitsPerRotation", 1.0}};
+  double startTime = 0.0;
+  for (std::string key : sysid::AnalysisManager::kJsonDataKeys) {
+    bool fast = key.find("fast") != std::string::npos;
+    double sign = key.find("backward") != std::string::npos ? -1.0 : 1.0;
+    std::vector<std::vector<double>> rows;
+    double position = 0.0;
+    double velocity = 0.0;
+    startTime += 100.0;
+    for (int i = 0; i < (fast ? 600 : 2400); ++i) {
+      double t = i * dt;
+      double voltage = sign * (fast ? 7.0 : 0.25 * t);
+      rows.push_back({startTime + t, voltage, position, velocity});
+      double acceleration = 0.0;
+      if (velocity != 0.0 || std::abs(voltage) > Ks) {
+        double direction = std::copysign(1.0, velocity != 0 ? velocity : sign);
+        acceleration = (voltage - Ks * direction - Kv * velocity) / Ka;
+      }
+      position += velocity * dt + acceleration * dt * dt / 2;
+      velocity += acceleration * dt;
+    }
+    json[key] = rows;
+  }
+  std::ofstream{path} << json;
+}
+
+/**
+ * Creates an empty directory for a test.
+ */
+static fs::path MakeDirectory(std::string_view name) {
+  auto directory = fs::temp_directory_path() / name;
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  return directory;
+}
+
+/**
+ * Reads a JSON file.
+ */
+static wpi::json ReadJSON(const std::string& path) {
+  std::error_code ec;
+  wpi::raw_fd_istream is{path, ec};
+  EXPECT_FALSE(ec) << path;
+  wpi::json json;
+  if (!ec) {
+    is >> json;
+  }
+  return json;
+}
+
+TEST(CaptureWatcherTest, Paths) {
+  EXPECT_EQ("dir/sysid_data1.results.json",
+            sysid::GetResultPath("dir/sysid_data1.json"));
+  EXPECT_TRUE(sysid::IsCapturePath("dir/sysid_data1.json"));
+  EXPECT_FALSE(sysid::IsCapturePath("dir/sysid_data1.results.json"));
+  EXPECT_FALSE(sysid::IsCapturePath(sysid::GetSummaryPath("dir")));
+  EXPECT_FALSE(sysid::IsCapturePath("dir/sysid_data1.json.tmp"));
+}
+
+TEST(CaptureWatcherTest, AnalyzeCapture) {
+  auto path = MakeDirectory("sysid-batch") / "sysid_data.json";
+  WriteCapture(path);
+
+  sysid::BatchSettings settings;
+  settings.autoTune = false;
+  wpi::Logger logger;
+  auto result = sysid::AnalyzeCapture(path.string(), settings, logger);
+  EXPECT_EQ("Simple", result.at("test"));
+  EXPECT_EQ("Combined", result.at("dataset"));
+  const auto& ff = result.at("feedforward");
+  EXPECT_NEAR(0.5, ff.at("Ks").get<double>(), 0.05);
+  EXPECT_NEAR(2.0, ff.at("Kv").get<double>(), 0.05);
+  EXPECT_NEAR(0.3, ff.at("Ka").get<double>(), 0.05);
+  EXPECT_GT(result.at("rSquared").get<double>(), 0.99);
+  EXPECT_TRUE(result.at("feedback").contains("Kp"));
+
+  settings.dataset = "Left Forward";
+  EXPECT_THROW(sysid::AnalyzeCapture(path.string(), settings, logger),
+               std::runtime_error);
+}
+
+TEST(CaptureWatcherTest, AnalyzesNewCaptures) {
+  auto directory = MakeDirectory("sysid-watch");
+  auto existing = directory / "sysid_data1.json";
+  WriteCapture(existing);
+
+  sysid::BatchSettings settings;
+  settings.autoTune = false;
+  wpi::Logger logger;
+  sysid::CaptureWatcher watcher{{directory.string()}, settings, 2, logger};
+  watcher.Start();
+
+  // The capture that was there before the watcher started is analyzed, and
+  // so are the captures that are written afterwards.
+  auto created = directory / "sysid_data2.json";
+  WriteCapture(created);
+  auto invalid = directory / "sysid_data3.json";
+  std::ofstream{invalid} << "{\"sysid\": true}";
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{30};
+  while (watcher.GetAnalyzedCount() < 3 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  }
+  watcher.WaitUntilIdle();
+  watcher.Stop();
+  ASSERT_EQ(3u, watcher.GetAnalyzedCount());
+
+  for (auto&& path : {existing, created}) {
+    auto result = ReadJSON(sysid::GetResultPath(path.string()));
+    EXPECT_EQ(path.filename().string(), result.at("capture"));
+    EXPECT_NEAR(2.0, result.at("feedforward").at("Kv").get<double>(), 0.05);
+  }
+  EXPECT_TRUE(
+      ReadJSON(sysid::GetResultPath(invalid.string())).contains("error"));
+
+  auto summary = ReadJSON(sysid::GetSummaryPath(directory.string()));
+  EXPECT_EQ(3u, summary.at("captures").size());
+
+  // Captures with up-to-date results aren't analyzed again.
+  sysid::CaptureWatcher restarted{{directory.string()}, settings, 1, logger};
+  restarted.Start();
+  restarted.WaitUntilIdle();
+  restarted.Stop();
+  EXPECT_EQ(0u, restarted.GetAnalyzedCount());
+}
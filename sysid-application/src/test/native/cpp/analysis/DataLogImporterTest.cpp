@@ -0,0 +1,180 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <wpi/fs.h>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/DataLogImporter.h"
+
+static std::string SaveFile(std::string_view name, std::string_view data) {
+  auto path = (fs::temp_directory_path() / name).string();
+  std::ofstream{path, std::ios::binary} << data;
+  return path;
+}
+
+/**
+ * Writes data logs in the WPILib data log format.
+ */
+class LogWriter {
+ public:
+  LogWriter() {
+    m_data += "WPILOG";
+    AppendInteger(0x0100, 2);
+    AppendInteger(5, 4);
+    m_data += "extra";
+  }
+
+  void Start(uint32_t id, std::string_view name, std::string_view type,
+             int64_t timestamp = 0) {
+    std::string payload(1, '\0');
+    AppendTo(&payload, id, 4);
+    AppendTo(&payload, name.size(), 4);
+    payload += name;
+    AppendTo(&payload, type.size(), 4);
+    payload += type;
+    AppendTo(&payload, 0, 4);
+    Record(0, timestamp, payload);
+  }
+
+  void Finish(uint32_t id, int64_t timestamp) {
+    std::string payload(1, '\1');
+    AppendTo(&payload, id, 4);
+    Record(0, timestamp, payload);
+  }
+
+  void Double(uint32_t id, int64_t timestamp, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    std::string payload;
+    AppendTo(&payload, bits, 8);
+    Record(id, timestamp, payload);
+  }
+
+  void Float(uint32_t id, int64_t timestamp, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    std::string payload;
+    AppendTo(&payload, bits, 4);
+    Record(id, timestamp, payload);
+  }
+
+  void Record(uint32_t id, int64_t timestamp, std::string_view payload) {
+    // Use the smallest field lengths, like the robot-side writer does.
+    size_t idLength = Length(id);
+    size_t sizeLength = Length(payload.size());
+    size_t timestampLength = Length(timestamp);
+    m_data += static_cast<char>((idLength - 1) | ((sizeLength - 1) << 2) |
+                                ((timestampLength - 1) << 4));
+    AppendInteger(id, idLength);
+    AppendInteger(payload.size(), sizeLength);
+    AppendInteger(timestamp, timestampLength);
+    m_data += payload;
+  }
+
+  std::string Save(std::string_view name) const {
+    return SaveFile(name, m_data);
+  }
+
+  const std::string& GetData() const { return m_data; }
+
+ private:
+  static size_t Length(uint64_t value) {
+    size_t length = 1;
+    while (length < 8 && (value >> (8 * length)) != 0) {
+      ++length;
+    }
+    return length;
+  }
+
+  static void AppendTo(std::string* data, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      *data += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+  }
+
+  void AppendInteger(uint64_t value, size_t size) {
+    AppendTo(&m_data, value, size);
+  }
+
+  std::string m_data;
+};
+
+static LogWriter WriteCapture() {
+  LogWriter log;
+  log.Start(1, "/arm/voltage", "double");
+  log.Start(2, "/arm/position", "float");
+  log.Start(300, "/arm/velocity", "double");
+  log.Start(4, "/arm/name", "string");
+
+  // The voltage isn't recorded until the other entries have been logged.
+  log.Double(1, 1000, 1.0);
+  log.Record(4, 1500, "arm");
+  log.Float(2, 2000, 0.5f);
+  log.Double(300, 3000, 0.25);
+  log.Double(1, 20000, 2.0);
+  log.Double(300, 25000, 0.75);
+  log.Double(1, 70000000000, 3.0);
+  return log;
+}
+
+TEST(DataLogImporterTest, ReadCapture) {
+  auto path = WriteCapture().Save("sysid-capture.wpilog");
+  auto rows = sysid::ReadDataLogCapture(
+      path, {"/arm/voltage", "/arm/position", "/arm/velocity"});
+
+  ASSERT_EQ(2u, rows.size());
+  EXPECT_EQ((std::vector<double>{0.02, 2.0, 0.5, 0.25}), rows[0]);
+  EXPECT_EQ((std::vector<double>{70000.0, 3.0, 0.5, 0.75}), rows[1]);
+}
+
+TEST(DataLogImporterTest, ListEntries) {
+  auto path = WriteCapture().Save("sysid-list.wpilog");
+  auto entries = sysid::ListDataLogEntries(path);
+
+  ASSERT_EQ(3u, entries.size());
+  EXPECT_EQ("/arm/voltage", entries[0].name);
+  EXPECT_EQ("float", entries[1].type);
+  EXPECT_EQ(300u, entries[2].id);
+}
+
+TEST(DataLogImporterTest, FinishedEntry) {
+  LogWriter log;
+  log.Start(1, "/voltage", "double");
+  log.Double(1, 1000, 1.0);
+  log.Finish(1, 2000);
+  log.Double(1, 3000, 2.0);
+  auto path = log.Save("sysid-finish.wpilog");
+
+  sysid::DataLogReader reader{path};
+  sysid::DataLogRecord record;
+  ASSERT_TRUE(reader.Next(&record));
+  EXPECT_EQ(1.0, sysid::DataLogReader::GetNumber(record));
+  EXPECT_FALSE(reader.Next(&record));
+}
+
+TEST(DataLogImporterTest, InvalidLogs) {
+  auto path = SaveFile("sysid-invalid.json", "{\"sysid\": true}");
+  EXPECT_THROW(sysid::DataLogReader{path}, std::runtime_error);
+
+  // Cut off the last byte of the last record.
+  auto data = WriteCapture().GetData();
+  data.pop_back();
+  path = SaveFile("sysid-truncated.wpilog", data);
+  EXPECT_THROW(sysid::ReadDataLogCapture(path, {"/arm/voltage"}),
+               std::runtime_error);
+
+  path = WriteCapture().Save("sysid-missing.wpilog");
+  EXPECT_THROW(sysid::ReadDataLogCapture(path, {"/arm/voltage", "/arm/accel"}),
+               std::runtime_error);
+  EXPECT_THROW(sysid::ReadDataLogCapture(path, {"/arm/voltage", "/arm/name"}),
+               std::runtime_error);
+}
@@ -2,9 +2,181 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "sysid/analysis/FeedbackAnalysis.h"
 #include "sysid/analysis/FeedbackControllerPreset.h"
+#include "sysid/analysis/Storage.h"
+
+/**
+ * Simulates a simple motor with process and measurement noise, as unfiltered
+ * data points.
+ *
+ * @param Ks, Kv, Ka     The feedforward gains.
+ * @param processStdDev  The standard deviation of the velocity disturbance per
+ *                       sample.
+ * @param velocityStdDev The standard deviation of the velocity measurements.
+ * @param positionStdDev The standard deviation of the position measurements.
+ * @param start          The timestamp of the first sample.
+ */
+static std::vector<sysid::PreparedData> SimulateNoisyMotor(
+    double Ks, double Kv, double Ka, double processStdDev,
+    double velocityStdDev, double positionStdDev, double start) {
+  constexpr double kDt = 0.005;
+  constexpr int kSamples = 10000;
+  std::mt19937 generator{static_cast<unsigned int>(start)};
+  std::normal_distribution<double> process{0.0, processStdDev};
+  std::normal_distribution<double> velocityNoise{0.0, velocityStdDev};
+  std::normal_distribution<double> positionNoise{0.0, positionStdDev};
+
+  double decay = std::exp(-Kv / Ka * kDt);
+  double position = 0.0;
+  double velocity = 1.0;
+  std::vector<double> times, voltages, positions, velocities;
+  for (int i = 0; i < kSamples; ++i) {
+    double t = start + i * kDt;
+    double voltage = 4.0 + 0.5 * std::sin(t);
+    times.push_back(t);
+    voltages.push_back(voltage);
+    positions.push_back(position + positionNoise(generator));
+    velocities.push_back(velocity + velocityNoise(generator));
+
+    double next = decay * velocity + (1 - decay) / Kv * (voltage - Ks) +
+                  process(generator);
+    position += kDt * (velocity + next) / 2;
+    velocity = next;
+  }
+
+  std::vector<sysid::PreparedData> data;
+  for (int i = 0; i < kSamples - 1; ++i) {
+    data.push_back({units::second_t{times[i]}, voltages[i], positions[i],
+                    velocities[i], velocities[i + 1],
+                    units::second_t{times[i + 1] - times[i]}});
+  }
+  return data;
+}
+
+TEST(FeedbackAnalysisTest, ScalarKalmanGain) {
+  // The scalar equation P = A²PR / (P + R) + Q has the closed-form solution
+  // P = (−b + √(b² + 4QR)) / 2 with b = R(1 − A²) − Q.
+  double A = 0.9;
+  double Q = 0.1;
+  double R = 0.5;
+  double b = R * (1 - A * A) - Q;
+  double P = (-b + std::sqrt(b * b + 4 * Q * R)) / 2;
+
+  auto gains = sysid::detail::SolveKalmanGains<1>(
+      {{Eigen::Matrix<double, 1, 1>{A}, Eigen::Matrix<double, 1, 1>{1.0},
+        Eigen::Matrix<double, 1, 1>{Q}, R}});
+  ASSERT_EQ(1u, gains.size());
+  EXPECT_NEAR(P / (P + R), gains[0](0), 1E-9);
+}
+
+TEST(FeedbackAnalysisTest, BatchedKalmanGains) {
+  // Each system of a batch should match the fixed point of the Riccati
+  // recursion.
+  std::vector<sysid::detail::KalmanProblem<2>> problems;
+  for (double Q : {1E-4, 1E-2, 1.0}) {
+    sysid::detail::KalmanProblem<2> problem;
+    problem.A << 1, 0.019, 0, 0.9;
+    problem.C << 1, 0;
+    problem.Q << Q * 1E-3, 0, 0, Q;
+    problem.R = 1E-2;
+    problems.push_back(problem);
+  }
+  auto gains = sysid::detail::SolveKalmanGains(problems);
+  ASSERT_EQ(problems.size(), gains.size());
+
+  for (size_t i = 0; i < problems.size(); ++i) {
+    const auto& [A, C, Q, R] = problems[i];
+    Eigen::Matrix2d P = Q;
+    for (int k = 0; k < 100000; ++k) {
+      double S = (C * P * C.transpose())(0, 0) + R;
+      P = A * P * A.transpose() -
+          A * P * C.transpose() * C * P * A.transpose() / S + Q;
+    }
+    Eigen::Vector2d K = P * C.transpose() / ((C * P * C.transpose())(0, 0) + R);
+    EXPECT_NEAR(K(0), gains[i](0), 1E-6);
+    EXPECT_NEAR(K(1), gains[i](1), 1E-6);
+  }
+}
+
+TEST(FeedbackAnalysisTest, KalmanGainsFollowNoise) {
+  sysid::NoiseCovariances noise{1.0, 1E-4, 1E-2};
+  sysid::EstimatorModel model{2.0, 0.3, noise};
+  auto quietModel = model;
+  quietModel.noise.process = 1E-2;
+
+  auto velocity = sysid::CalculateKalmanGains(
+      sysid::presets::kDefault, sysid::FeedbackControllerLoopType::kVelocity,
+      {model, quietModel});
+  ASSERT_EQ(2u, velocity.size());
+  EXPECT_EQ(0.0, velocity[0].position);
+  EXPECT_GT(velocity[0].velocity, 0.0);
+  EXPECT_LT(velocity[0].velocity, 1.0);
+
+  // A quieter mechanism trusts its model more.
+  EXPECT_LT(velocity[1].velocity, velocity[0].velocity);
+
+  auto position = sysid::CalculateKalmanGains(
+      sysid::presets::kDefault, sysid::FeedbackControllerLoopType::kPosition,
+      {model, {2.0, 0.0, noise}});
+  ASSERT_EQ(2u, position.size());
+  EXPECT_GT(position[0].position, 0.0);
+  EXPECT_LT(position[0].position, 1.0);
+  EXPECT_GT(position[0].velocity, 0.0);
+
+  // Without acceleration, the velocity is an input rather than a state.
+  EXPECT_GT(position[1].position, 0.0);
+  EXPECT_EQ(0.0, position[1].velocity);
+}
+
+TEST(FeedbackAnalysisTest, NoiseCovariances) {
+  double Ks = 0.5;
+  double Kv = 2.0;
+  double Ka = 0.3;
+  double processStdDev = 0.05;
+  double velocityStdDev = 0.03;
+  double positionStdDev = 1E-3;
+
+  sysid::Storage data{
+      SimulateNoisyMotor(Ks, Kv, Ka, processStdDev, velocityStdDev,
+                         positionStdDev, 1.0),
+      SimulateNoisyMotor(Ks, Kv, Ka, processStdDev, velocityStdDev,
+                         positionStdDev, 100.0)};
+  auto noise = sysid::EstimateNoiseCovariances(data, {Ks, Kv, Ka});
+
+  double dt = 0.005;
+  double process = processStdDev * processStdDev / dt;
+  double velocity = velocityStdDev * velocityStdDev;
+  double position = positionStdDev * positionStdDev;
+  EXPECT_NEAR(process, noise.process, 0.2 * process);
+  EXPECT_NEAR(velocity, noise.velocity, 0.1 * velocity);
+  EXPECT_NEAR(position, noise.position, 0.1 * position);
+
+  // Interleaving the samples of two mechanisms (like drivetrain sides) gives
+  // the same estimate.
+  auto left = data.slow;
+  auto right = SimulateNoisyMotor(Ks, Kv, Ka, processStdDev, velocityStdDev,
+                                  positionStdDev, 1.0);
+  for (auto& pt : right) {
+    pt.velocity += 0.001;
+    pt.nextVelocity += 0.001;
+  }
+  sysid::Storage interleaved;
+  for (size_t i = 0; i < left.size(); ++i) {
+    interleaved.slow.push_back(left[i]);
+    interleaved.slow.push_back(right[i]);
+  }
+  auto interleavedNoise =
+      sysid::EstimateNoiseCovariances(interleaved, {Ks, Kv, Ka});
+  EXPECT_NEAR(velocity, interleavedNoise.velocity, 0.15 * velocity);
+  EXPECT_NEAR(position, interleavedNoise.position, 0.15 * position);
+}
 
 TEST(FeedbackAnalysisTest, Velocity1) {
   auto Kv = 3.060;
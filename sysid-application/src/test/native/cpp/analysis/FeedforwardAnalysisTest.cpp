@@ -2,18 +2,66 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <algorithm>
 #include <cmath>
+#include <string_view>
+#include <vector>
 
 #include <units/time.h>
 #include <units/voltage.h>
+#include <wpi/Logger.h>
+#include <wpi/json.h>
 
 #include "gtest/gtest.h"
 #include "sysid/analysis/AnalysisManager.h"
 #include "sysid/analysis/ArmSim.h"
 #include "sysid/analysis/ElevatorSim.h"
 #include "sysid/analysis/FeedforwardAnalysis.h"
+#include "sysid/analysis/ModelTerms.h"
 #include "sysid/analysis/SimpleMotorSim.h"
 
+/**
+ * Simulates a mechanism with quadratic drag and a position-dependent gravity
+ * term (e.g. an elevator with a counterweight) on top of the simple motor
+ * model.
+ */
+class NonlinearSim {
+ public:
+  NonlinearSim(double Ks, double Kv, double Ka, double Kdrag, double Kx)
+      : m_Ks{Ks}, m_Kv{Kv}, m_Ka{Ka}, m_Kdrag{Kdrag}, m_Kx{Kx} {}
+
+  void Update(units::volt_t voltage, units::second_t dt) {
+    double acceleration = GetAcceleration(voltage);
+    m_position += m_velocity * dt.value();
+    m_velocity += acceleration * dt.value();
+  }
+
+  double GetPosition() const { return m_position; }
+
+  double GetVelocity() const { return m_velocity; }
+
+  double GetAcceleration(units::volt_t voltage) const {
+    return (voltage.value() - std::copysign(m_Ks, m_velocity) -
+            m_Kv * m_velocity - m_Kdrag * m_velocity * std::abs(m_velocity) -
+            m_Kx * m_position) /
+           m_Ka;
+  }
+
+  void Reset(double position = 0.0, double velocity = 0.0) {
+    m_position = position;
+    m_velocity = velocity;
+  }
+
+ private:
+  double m_Ks;
+  double m_Kv;
+  double m_Ka;
+  double m_Kdrag;
+  double m_Kx;
+  double m_position = 0.0;
+  double m_velocity = 0.0;
+};
+
 /**
  * Return simulated test data for a given simulation model.
  *
@@ -243,3 +291,105 @@ TEST(FeedforwardAnalysisTest, Simple2) {
   EXPECT_NEAR(gains[1], Kv, 0.003);
   EXPECT_NEAR(gains[2], Ka, 0.003);
 }
+
+TEST(FeedforwardAnalysisTest, Nonlinear) {
+  constexpr double Ks = 0.547;
+  constexpr double Kv = 0.0693;
+  constexpr double Ka = 0.1170;
+  constexpr double Kdrag = 0.0125;
+  constexpr double Kx = 0.0412;
+
+  NonlinearSim model{Ks, Kv, Ka, Kdrag, Kx};
+  auto ff = sysid::CalculateFeedforwardGains(
+      CollectData(model),
+      {sysid::ModelTerm::kDrag, sysid::ModelTerm::kPosition});
+  auto& gains = std::get<0>(ff);
+
+  ASSERT_EQ(gains.size(), 5u);
+  EXPECT_NEAR(gains[0], Ks, 0.003);
+  EXPECT_NEAR(gains[1], Kv, 0.003);
+  EXPECT_NEAR(gains[2], Ka, 0.003);
+  EXPECT_NEAR(gains[3], Kdrag, 0.003);
+  EXPECT_NEAR(gains[4], Kx, 0.003);
+}
+
+TEST(FeedforwardAnalysisTest, UnusedTermIsZero) {
+  constexpr double Ks = 1.01;
+  constexpr double Kv = 3.060;
+  constexpr double Ka = 0.327;
+
+  NonlinearSim model{Ks, Kv, Ka, 0.0, 0.0};
+  auto ff = sysid::CalculateFeedforwardGains(CollectData(model),
+                                             {sysid::ModelTerm::kStribeck});
+  auto& gains = std::get<0>(ff);
+
+  ASSERT_EQ(gains.size(), 4u);
+  EXPECT_NEAR(gains[0], Ks, 0.003);
+  EXPECT_NEAR(gains[1], Kv, 0.003);
+  EXPECT_NEAR(gains[2], Ka, 0.003);
+  EXPECT_NEAR(gains[3], 0.0, 0.003);
+}
+
+TEST(FeedforwardAnalysisTest, SwerveModulesArePooledAsRuns) {
+  constexpr double Kv = 2.0;
+  constexpr double Ka = 0.3;
+  constexpr double dt = 0.005;
+  // The modules start moving at different times of the quasistatic tests.
+  constexpr double Ks[] = {0.3, 0.5, 0.7, 0.9};
+
+  wpi::json json = {{"sysid", true},
+                    {"test", "Swerve Drive"},
+                    {"units", "Meters"},
+                    {"unitsPerRotation", 1.0}};
+  double startTime = 0.0;
+  for (auto&& key : sysid::AnalysisManager::kJsonDataKeys) {
+    bool fast = std::string_view{key}.find("fast") != std::string_view::npos;
+    double sign =
+        std::string_view{key}.find("backward") != std::string_view::npos
+            ? -1.0
+            : 1.0;
+    std::vector<sysid::SimpleMotorSim> modules;
+    for (double moduleKs : Ks) {
+      modules.emplace_back(moduleKs, Kv, Ka);
+    }
+    startTime += 100.0;
+    auto& rows = json[key];
+    for (int i = 0; i < (fast ? 600 : 2400); ++i) {
+      double voltage = sign * (fast ? 7.0 : 0.25 * i * dt);
+      std::vector<double> row{startTime + i * dt, voltage};
+      for (auto& module : modules) {
+        row.push_back(module.GetPosition());
+        row.push_back(module.GetVelocity());
+        module.Update(units::volt_t{voltage}, units::second_t{dt});
+      }
+      rows.push_back(row);
+    }
+  }
+
+  sysid::AnalysisManager::Settings settings;
+  wpi::Logger logger;
+  sysid::AnalysisManager manager{json, settings, logger};
+  manager.PrepareData();
+
+  // Each module is a contiguous run that starts at the start time of its test.
+  auto startTimes = manager.GetStartTimes();
+  const auto& raw = manager.GetRawData();
+  for (const auto* data : {&raw.slow, &raw.fast}) {
+    size_t runs = 0;
+    for (size_t i = 0; i < data->size(); ++i) {
+      auto timestamp = (*data)[i].timestamp;
+      if (std::find(startTimes.begin(), startTimes.end(), timestamp) !=
+          startTimes.end()) {
+        ++runs;
+      } else {
+        ASSERT_GT(i, 0u);
+        EXPECT_GT(timestamp, (*data)[i - 1].timestamp);
+      }
+    }
+    EXPECT_EQ(2 * sysid::analysis::kSwerveModuleCount, runs);
+  }
+
+  auto gains = std::get<0>(manager.Calculate().ffGains);
+  EXPECT_NEAR(Kv, gains[1], 0.05);
+  EXPECT_NEAR(Ka, gains[2], 0.05);
+}
@@ -68,6 +68,37 @@ TEST(FilterTest, StepTrim) {
   EXPECT_EQ(2, minTime.value());
 }
 
+TEST(FilterTest, StepTrimHardStop) {
+  // A dynamic test that ends at a hard stop, where the mechanism decelerates
+  // harder than it accelerated. Trimming to the largest |acceleration| would
+  // keep only the impact at 7 s, so the trim has to start at the largest
+  // acceleration in the direction of motion instead.
+  for (double direction : {1.0, -1.0}) {
+    std::vector<sysid::PreparedData> testData = {
+        {0_s, 1, 2, 0, 0, 5_ms, 0, 0},
+        {1_s, 1, 2, 1 * direction, 0, 5_ms, 2 * direction, 0},
+        {2_s, 1, 2, 3 * direction, 0, 5_ms, 4 * direction, 0},
+        {3_s, 1, 2, 5 * direction, 0, 5_ms, 3 * direction, 0},
+        {4_s, 1, 2, 6 * direction, 0, 5_ms, 2 * direction, 0},
+        {5_s, 1, 2, 7 * direction, 0, 5_ms, 1 * direction, 0},
+        {6_s, 1, 2, 7 * direction, 0, 5_ms, 0.5 * direction, 0},
+        {7_s, 1, 2, 0, 0, 5_ms, -10 * direction, 0},
+        {8_s, 1, 2, 0, 0, 5_ms, 0, 0},
+    };
+
+    auto maxTime = 9_s;
+    auto minTime = maxTime;
+
+    sysid::AnalysisManager::Settings settings;
+    minTime =
+        sysid::TrimStepVoltageData(&testData, &settings, minTime, maxTime);
+
+    EXPECT_EQ(2, testData[0].timestamp.value());
+    EXPECT_EQ(4 * direction, testData[0].acceleration);
+    EXPECT_EQ(2, minTime.value());
+  }
+}
+
 TEST(FilterTest, CentralFiniteDifference) {
   constexpr double h = 0.05;
 
@@ -0,0 +1,122 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <units/time.h>
+#include <wpi/StringMap.h>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/AnalysisManager.h"
+#include "sysid/analysis/FilteringUtils.h"
+#include "sysid/analysis/KalmanSmoother.h"
+#include "sysid/analysis/Storage.h"
+
+/**
+ * Generates a noisy trajectory whose acceleration decays exponentially, like
+ * a dynamic test, with jittered time steps.
+ */
+static std::vector<sysid::PreparedData> GenerateData(
+    double positionNoise, double velocityNoise,
+    std::vector<double>* trueAccel) {
+  std::mt19937 gen{1234};
+  std::normal_distribution<double> posDist{0.0, positionNoise};
+  std::normal_distribution<double> velDist{0.0, velocityNoise};
+  std::uniform_real_distribution<double> jitter{-0.001, 0.001};
+
+  constexpr double kTau = 0.5;
+  constexpr double kVmax = 3.0;
+
+  std::vector<sysid::PreparedData> data;
+  double t = 0.0;
+  for (int i = 0; i < 600; ++i) {
+    double x = kVmax * (t - kTau * (1 - std::exp(-t / kTau)));
+    double v = kVmax * (1 - std::exp(-t / kTau));
+    double a = kVmax / kTau * std::exp(-t / kTau);
+    trueAccel->push_back(a);
+    data.push_back({units::second_t{t}, 0.0, x + posDist(gen), v + velDist(gen),
+                    0.0, 5_ms});
+    t += 0.005 + jitter(gen);
+  }
+  return data;
+}
+
+static double RMSE(const std::vector<sysid::PreparedData>& data,
+                   const std::vector<double>& trueAccel, size_t begin,
+                   size_t end) {
+  double sum = 0.0;
+  for (size_t i = begin; i < end; ++i) {
+    sum += std::pow(data[i].acceleration - trueAccel[i], 2);
+  }
+  return std::sqrt(sum / (end - begin));
+}
+
+TEST(KalmanSmootherTest, EstimateNoise) {
+  std::vector<double> trueAccel;
+  auto data = GenerateData(0.001, 0.02, &trueAccel);
+  auto noise = sysid::EstimateSmootherNoise(data);
+
+  EXPECT_NEAR(0.02, noise.velocity, 0.005);
+  EXPECT_NEAR(0.001, noise.position, 0.0005);
+  EXPECT_GT(noise.jerk, 0.0);
+}
+
+TEST(KalmanSmootherTest, Acceleration) {
+  std::vector<double> trueAccel;
+  auto data = GenerateData(0.001, 0.02, &trueAccel);
+
+  // Finite difference acceleration for comparison
+  auto differenced = data;
+  for (size_t i = 1; i + 1 < differenced.size(); ++i) {
+    differenced[i].acceleration = sysid::CentralFiniteDifference<2>(
+        [&](size_t j) { return data[j].velocity; }, i, 0.005);
+  }
+
+  sysid::ApplyKalmanSmoother(&data);
+
+  // Skip the first samples where the acceleration jumps from zero.
+  double smoothedError = RMSE(data, trueAccel, 20, data.size() - 1);
+  double differencedError = RMSE(differenced, trueAccel, 20, data.size() - 1);
+  EXPECT_LT(smoothedError, 0.5);
+  EXPECT_LT(smoothedError, differencedError / 5);
+}
+
+TEST(KalmanSmootherTest, Gaps) {
+  std::vector<double> trueAccel;
+  auto data = GenerateData(0.001, 0.02, &trueAccel);
+
+  // Remove a chunk of samples like the quasistatic motion threshold does.
+  data.erase(data.begin() + 200, data.begin() + 300);
+  trueAccel.erase(trueAccel.begin() + 200, trueAccel.begin() + 300);
+
+  sysid::ApplyKalmanSmoother(&data);
+  EXPECT_LT(RMSE(data, trueAccel, 20, data.size()), 0.5);
+}
+
+TEST(KalmanSmootherTest, TooFewSamples) {
+  std::vector<sysid::PreparedData> data{{0_s, 0, 0, 0}, {5_ms, 0, 0, 0}};
+  EXPECT_THROW(sysid::EstimateSmootherNoise(data), std::runtime_error);
+
+  std::vector<sysid::PreparedData> empty;
+  sysid::ApplyKalmanSmoother(&empty, sysid::SmootherNoise{1, 1, 1});
+  EXPECT_TRUE(empty.empty());
+}
+
+TEST(KalmanSmootherTest, ShortDatasetsUseMedianFilter) {
+  wpi::StringMap<std::vector<sysid::PreparedData>> data;
+  data["slow-forward"] = {{0_s, 1.0, 0.0, 1.0, 0.0, 5_ms},
+                          {5_ms, 1.0, 0.005, 1.0, 0.0, 5_ms},
+                          {10_ms, 1.0, 0.01, 1.0, 0.0, 5_ms}};
+  sysid::AnalysisManager::Settings settings;
+  settings.useKalmanSmoother = true;
+  settings.windowSize = 3;
+  units::second_t minStepTime = 0_s;
+  units::second_t maxStepTime = 0_s;
+  EXPECT_NO_THROW(sysid::InitialTrimAndFilter(&data, settings, minStepTime,
+                                              maxStepTime, "Meters"));
+  EXPECT_FALSE(data["slow-forward"].empty());
+}
@@ -0,0 +1,125 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <cmath>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/ModelTerms.h"
+#include "sysid/analysis/Storage.h"
+
+/**
+ * Creates a dataset from lists of positions and velocities.
+ */
+static std::vector<sysid::PreparedData> MakeData(
+    const std::vector<double>& positions,
+    const std::vector<double>& velocities) {
+  std::vector<sysid::PreparedData> data;
+  for (size_t i = 0; i < positions.size(); ++i) {
+    data.emplace_back(sysid::PreparedData{
+        units::second_t{i * 0.005}, 0.0, positions[i], velocities[i], 0.0,
+        units::second_t{0.005}, 0.0, std::cos(positions[i])});
+  }
+  return data;
+}
+
+TEST(ModelTermsTest, DefaultTerms) {
+  EXPECT_EQ(sysid::GetDefaultModelTerms(sysid::analysis::kElevator),
+            std::vector{sysid::ModelTerm::kGravity});
+  EXPECT_EQ(sysid::GetDefaultModelTerms(sysid::analysis::kArm),
+            std::vector{sysid::ModelTerm::kCosine});
+  EXPECT_TRUE(sysid::GetDefaultModelTerms(sysid::analysis::kSimple).empty());
+}
+
+TEST(ModelTermsTest, Columns) {
+  auto data = MakeData({0.0, 0.5, 1.0}, {-2.0, 0.0, 3.0});
+  sysid::ModelTermParameters params;
+  params.stribeckVelocity = 2.0;
+  Eigen::VectorXd out(data.size());
+
+  sysid::EvaluateModelTerm(sysid::ModelTerm::kGravity, data, params, out);
+  EXPECT_EQ(out, Eigen::Vector3d(1.0, 1.0, 1.0));
+
+  sysid::EvaluateModelTerm(sysid::ModelTerm::kCosine, data, params, out);
+  EXPECT_EQ(out, Eigen::Vector3d(1.0, std::cos(0.5), std::cos(1.0)));
+
+  sysid::EvaluateModelTerm(sysid::ModelTerm::kPosition, data, params, out);
+  EXPECT_EQ(out, Eigen::Vector3d(0.0, 0.5, 1.0));
+
+  sysid::EvaluateModelTerm(sysid::ModelTerm::kDrag, data, params, out);
+  EXPECT_EQ(out, Eigen::Vector3d(-4.0, 0.0, 9.0));
+
+  sysid::EvaluateModelTerm(sysid::ModelTerm::kStribeck, data, params, out);
+  EXPECT_DOUBLE_EQ(out(0), -std::exp(-1.0));
+  EXPECT_DOUBLE_EQ(out(1), 1.0);
+  EXPECT_DOUBLE_EQ(out(2), std::exp(-2.25));
+}
+
+TEST(ModelTermsTest, Backlash) {
+  // Move forward through the dead-band, then reverse.
+  auto data = MakeData({0.0, 0.05, 0.2, 0.3, 0.25, 0.1, 0.0},
+                       {0.0, 1.0, 1.0, 1.0, -1.0, -1.0, -1.0});
+  sysid::ModelTermParameters params;
+  params.backlashWidth = 0.2;
+  Eigen::VectorXd out(data.size());
+
+  sysid::EvaluateModelTerm(sysid::ModelTerm::kBacklash, data, params, out);
+  EXPECT_DOUBLE_EQ(out(0), 0.0);
+  EXPECT_DOUBLE_EQ(out(1), 0.5);
+  EXPECT_DOUBLE_EQ(out(2), 1.0);
+  EXPECT_DOUBLE_EQ(out(3), 1.0);
+  EXPECT_DOUBLE_EQ(out(4), 0.5);
+  EXPECT_DOUBLE_EQ(out(5), -1.0);
+  EXPECT_DOUBLE_EQ(out(6), -1.0);
+}
+
+TEST(ModelTermsTest, TermVoltages) {
+  auto data = MakeData({0.0, 0.5, 1.0}, {-2.0, 0.0, 3.0});
+  std::vector<double> gains{0.5, 2.0};
+
+  auto voltages = sysid::CalculateTermVoltages(
+      {sysid::ModelTerm::kGravity, sysid::ModelTerm::kPosition}, gains.data(),
+      data, {});
+  EXPECT_DOUBLE_EQ(voltages(0), 0.5);
+  EXPECT_DOUBLE_EQ(voltages(1), 1.5);
+  EXPECT_DOUBLE_EQ(voltages(2), 2.5);
+}
+
+TEST(ModelTermsTest, ScaleGains) {
+  std::vector<sysid::ModelTerm> terms{
+      sysid::ModelTerm::kGravity, sysid::ModelTerm::kStribeck,
+      sysid::ModelTerm::kDrag, sysid::ModelTerm::kBacklash,
+      sysid::ModelTerm::kPosition};
+  std::vector<double> gains{0.1, 2.0, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8};
+  auto data = MakeData({0.0, 0.01, 0.03, 0.02}, {-2.0, 0.1, 3.0, 1.0});
+  sysid::ModelTermParameters params;
+
+  // Convert to a unit that is three times smaller.
+  constexpr double kRatio = 3.0;
+  auto scaledData = data;
+  for (auto& pt : scaledData) {
+    pt.position *= kRatio;
+    pt.velocity *= kRatio;
+  }
+  auto scaledParams = params;
+  scaledParams.stribeckVelocity *= kRatio;
+  scaledParams.backlashWidth *= kRatio;
+  auto scaledGains = gains;
+  sysid::ScaleFeedforwardGains(&scaledGains, terms, kRatio);
+
+  EXPECT_DOUBLE_EQ(gains[0], scaledGains[0]);
+  EXPECT_DOUBLE_EQ(gains[1] / kRatio, scaledGains[1]);
+  EXPECT_DOUBLE_EQ(gains[2] / kRatio, scaledGains[2]);
+
+  // The modelled voltages must not depend on the unit.
+  auto voltages = sysid::CalculateTermVoltages(terms, &gains[3], data, params);
+  auto scaledVoltages = sysid::CalculateTermVoltages(
+      terms, &scaledGains[3], scaledData, scaledParams);
+  for (Eigen::Index i = 0; i < voltages.size(); ++i) {
+    EXPECT_NEAR(voltages(i), scaledVoltages(i), 1e-12);
+  }
+}
@@ -0,0 +1,132 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+#include <units/time.h>
+#include <units/voltage.h>
+#include <wpi/Logger.h>
+#include <wpi/json.h>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/AnalysisManager.h"
+#include "sysid/analysis/MotorChannels.h"
+#include "sysid/analysis/SimpleMotorSim.h"
+
+/**
+ * Creates multi-motor data where each motor turns at a multiple of the
+ * mechanism velocity and draws a constant current.
+ */
+static sysid::MotorChannelData MakeData(const std::vector<double>& ratios,
+                                        const std::vector<double>& currents) {
+  sysid::MotorChannelData data;
+  data.columns.resize(4 + sysid::kMotorChannelSize * ratios.size());
+  for (int i = 0; i < 100; ++i) {
+    double velocity = i < 10 ? 0.0 : 0.1 * i;
+    std::vector<double> row{0.005 * i, 6.0, 0.0, velocity};
+    for (size_t motor = 0; motor < ratios.size(); ++motor) {
+      row.insert(row.end(), {0.0, ratios[motor] * velocity,
+                             velocity == 0.0 ? 0.0 : currents[motor], 6.0});
+    }
+    for (size_t col = 0; col < row.size(); ++col) {
+      data.columns[col].push_back(row[col]);
+    }
+  }
+  return data;
+}
+
+TEST(MotorChannelsTest, Columns) {
+  EXPECT_EQ(4u, sysid::MotorChannelColumn(0, sysid::motorchannel::kPosition));
+  EXPECT_EQ(9u, sysid::MotorChannelColumn(1, sysid::motorchannel::kVelocity));
+  EXPECT_EQ(15u,
+            sysid::MotorChannelColumn(2, sysid::motorchannel::kAppliedVoltage));
+}
+
+TEST(MotorChannelsTest, VelocityRatioAndCurrent) {
+  auto data = MakeData({1.0, 0.8}, {20.0, 30.0});
+
+  EXPECT_NEAR(1.0, sysid::CalculateVelocityRatio(data, 0, 0.05), 1E-9);
+  EXPECT_NEAR(0.8, sysid::CalculateVelocityRatio(data, 1, 0.05), 1E-9);
+
+  // Samples where the mechanism is stopped don't count towards the current.
+  EXPECT_NEAR(20.0, sysid::CalculateMeanCurrent(data, 0, 0.05), 1E-9);
+  EXPECT_NEAR(30.0, sysid::CalculateMeanCurrent(data, 1, 0.05), 1E-9);
+}
+
+TEST(MotorChannelsTest, FlagOutliers) {
+  std::vector<sysid::MotorDiagnostics> motors{
+      {{0.1, 2.0, 0.2}, 0.99, 1.0, 20.0},
+      // Fit against its own (slipping) encoder, so its Kv appears higher.
+      {{0.1, 2.5, 0.2}, 0.99, 0.8, 20.0},
+      {{0.1, 2.5, 0.2}, 0.99, 1.0, 20.0},
+      {{0.1, 2.0, 0.2}, 0.99, 1.0, 20.0}};
+  sysid::FlagMotorOutliers(&motors);
+
+  EXPECT_FALSE(motors[0].slipping);
+  EXPECT_FALSE(motors[0].mismatched);
+  EXPECT_TRUE(motors[1].slipping);
+  EXPECT_FALSE(motors[1].mismatched);
+  EXPECT_FALSE(motors[2].slipping);
+  EXPECT_TRUE(motors[2].mismatched);
+}
+
+TEST(MotorChannelsTest, SingleMotorIsNeverFlagged) {
+  std::vector<sysid::MotorDiagnostics> motors{
+      {{0.1, 2.0, 0.2}, 0.99, 0.5, 20.0}};
+  sysid::FlagMotorOutliers(&motors);
+
+  EXPECT_FALSE(motors[0].slipping);
+  EXPECT_FALSE(motors[0].mismatched);
+}
+
+TEST(MotorChannelsTest, AnalyzeCapture) {
+  constexpr double dt = 0.005;
+  constexpr double kRatios[] = {1.0, 0.8};
+
+  wpi::json json = {{"sysid", true},
+                    {"test", "Simple"},
+                    {"units", "Rotations"},
+                    {"unitsPerRotation", 1.0},
+                    {"motors", std::size(kRatios)}};
+  double startTime = 0.0;
+  for (auto&& key : sysid::AnalysisManager::kJsonDataKeys) {
+    bool fast = std::string_view{key}.find("fast") != std::string_view::npos;
+    double sign =
+        std::string_view{key}.find("backward") != std::string_view::npos
+            ? -1.0
+            : 1.0;
+    sysid::SimpleMotorSim sim{0.5, 2.0, 0.3};
+    startTime += 100.0;
+    auto& rows = json[key];
+    for (int i = 0; i < (fast ? 600 : 2400); ++i) {
+      double voltage = sign * (fast ? 7.0 : 0.25 * i * dt);
+      double position = sim.GetPosition();
+      double velocity = sim.GetVelocity();
+      std::vector<double> row{startTime + i * dt, voltage, position, velocity};
+      for (double ratio : kRatios) {
+        row.insert(row.end(), {ratio * position, ratio * velocity,
+                               velocity == 0.0 ? 0.0 : 20.0, voltage});
+      }
+      rows.push_back(row);
+      sim.Update(units::volt_t{voltage}, units::second_t{dt});
+    }
+  }
+
+  sysid::AnalysisManager::Settings settings;
+  wpi::Logger logger;
+  sysid::AnalysisManager manager{json, settings, logger};
+  manager.PrepareData();
+  auto motors = manager.CalculateMotorChannels();
+
+  ASSERT_EQ(2u, motors.size());
+  EXPECT_NEAR(1.0, motors[0].velocityRatio, 1E-9);
+  EXPECT_NEAR(0.8, motors[1].velocityRatio, 1E-9);
+  EXPECT_NEAR(20.0, motors[0].meanCurrent, 1E-9);
+
+  // The second motor's encoder turns slower, so its Kv is higher.
+  EXPECT_NEAR(2.0, motors[0].ffGains[1], 0.05);
+  EXPECT_NEAR(2.0 / 0.8, motors[1].ffGains[1], 0.1);
+}
@@ -2,6 +2,7 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <stdexcept>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -38,3 +39,20 @@ TEST(OLSTest, MalformedData) {
   EXPECT_DEATH(sysid::OLS(data, 2), "");
 }
 #endif
+
+TEST(OLSTest, DuplicateVariablesThrow) {
+  // The second and third variables are the same (like a backlash term with
+  // zero width next to the static friction term), so the coefficients aren't
+  // unique.
+  std::vector<double> data{1, 1, 1, 1, 2, 2, 1, 1, 0, 1, -1, -1, 4, 3, 1, 1};
+
+  EXPECT_THROW(sysid::OLS(data, 3), std::runtime_error);
+}
+
+TEST(OLSTest, ZeroVariableThrows) {
+  // The second variable is always zero (like a Stribeck term with zero
+  // velocity).
+  std::vector<double> data{4, 1, 0, 5, 2, 0, 7, 3, 0, 10, 4, 0};
+
+  EXPECT_THROW(sysid::OLS(data, 2), std::runtime_error);
+}
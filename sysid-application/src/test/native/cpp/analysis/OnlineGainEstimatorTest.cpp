@@ -0,0 +1,130 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <wpi/json.h>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/AnalysisManager.h"
+#include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/OnlineGainEstimator.h"
+#include "sysid/analysis/RegressionSuite.h"
+
+/**
+ * Feeds the tests of a capture to an estimator in chunks of samples, like
+ * they arrive from the robot.
+ */
+static void FeedCapture(sysid::OnlineGainEstimator& estimator,
+                        const wpi::json& capture, size_t chunkSize) {
+  for (auto&& key : sysid::AnalysisManager::kJsonDataKeys) {
+    auto rows = capture.at(key).get<std::vector<std::vector<double>>>();
+    estimator.BeginRun();
+    for (size_t i = 0; i < rows.size(); i += chunkSize) {
+      size_t rowSize = rows[i].size();
+      std::vector<double> chunk;
+      for (size_t j = i; j < std::min(i + chunkSize, rows.size()); ++j) {
+        chunk.insert(chunk.end(), rows[j].begin(), rows[j].end());
+      }
+      estimator.AddSamples(chunk, rowSize);
+    }
+  }
+}
+
+TEST(OnlineGainEstimatorTest, SyntheticCorpus) {
+  for (auto&& regressionCase : sysid::MakeSyntheticCorpus()) {
+    const auto& capture = regressionCase.capture;
+    auto type =
+        sysid::analysis::FromName(capture.at("test").get<std::string>());
+    sysid::OnlineGainEstimator estimator{
+        type, capture.at("unitsPerRotation").get<double>(),
+        capture.at("units").get<std::string>()};
+    FeedCapture(estimator, capture, 20);
+
+    auto estimate = estimator.GetEstimate();
+    auto names = estimator.GetGainNames();
+    ASSERT_EQ(regressionCase.truth.size(), estimate.gains.size())
+        << regressionCase.name;
+    ASSERT_EQ(names.size(), estimate.gains.size()) << regressionCase.name;
+    for (size_t i = 0; i < names.size(); ++i) {
+      double truth = regressionCase.truth.at(names[i]);
+      EXPECT_NEAR(truth, estimate.gains[i], 0.1 * std::abs(truth) + 0.02)
+          << regressionCase.name << " " << names[i];
+      EXPECT_GE(estimate.stddevs[i], 0.0);
+    }
+  }
+}
+
+TEST(OnlineGainEstimatorTest, ChunkSizeDoesNotMatter) {
+  auto capture = sysid::MakeSyntheticCapture(
+      sysid::analysis::kDrivetrain, {0.6, 1.8, 0.35}, "Meters", 0.01);
+  sysid::OnlineGainEstimator single{sysid::analysis::kDrivetrain, 1.0,
+                                    "Meters"};
+  sysid::OnlineGainEstimator chunked{sysid::analysis::kDrivetrain, 1.0,
+                                     "Meters"};
+  FeedCapture(single, capture, 1);
+  FeedCapture(chunked, capture, 37);
+
+  auto a = single.GetEstimate();
+  auto b = chunked.GetEstimate();
+  EXPECT_EQ(a.points, b.points);
+  ASSERT_EQ(a.gains.size(), b.gains.size());
+  for (size_t i = 0; i < a.gains.size(); ++i) {
+    EXPECT_DOUBLE_EQ(a.gains[i], b.gains[i]);
+  }
+}
+
+TEST(OnlineGainEstimatorTest, ConvergesWithMoreData) {
+  auto capture = sysid::MakeSyntheticCapture(
+      sysid::analysis::kSimple, {0.5, 2.0, 0.3}, "Rotations", 0.02);
+  sysid::OnlineGainEstimator estimator;
+  EXPECT_TRUE(estimator.GetEstimate().gains.empty());
+  EXPECT_FALSE(estimator.IsConverged());
+
+  // A few samples aren't enough for every coefficient.
+  auto rows =
+      capture.at("fast-forward").get<std::vector<std::vector<double>>>();
+  estimator.AddSamples({rows.begin(), rows.begin() + 10});
+  EXPECT_FALSE(estimator.IsConverged());
+
+  estimator.Reset();
+  FeedCapture(estimator, capture, 50);
+  auto estimate = estimator.GetEstimate();
+  EXPECT_GT(estimate.points, 0u);
+  EXPECT_TRUE(estimator.IsConverged(0.1));
+}
+
+TEST(OnlineGainEstimatorTest, GapStartsNewRun) {
+  // Samples that are far apart aren't differentiated across the gap.
+  sysid::OnlineGainEstimator estimator;
+  std::vector<double> samples;
+  for (int i = 0; i < 20; ++i) {
+    double t = i < 10 ? i * 0.005 : 10.0 + i * 0.005;
+    samples.insert(samples.end(), {t, 6.0, 0.0, i < 10 ? 1.0 : 5.0});
+  }
+  estimator.AddSamples(samples, 4);
+
+  // The velocity only steps across the gap, so there is no acceleration
+  // within either run, and such points are dropped like in the analysis.
+  EXPECT_EQ(0u, estimator.GetEstimate().points);
+}
+
+TEST(OnlineGainEstimatorTest, GainNames) {
+  sysid::OnlineGainEstimator elevator{sysid::analysis::kElevator, 1.0,
+                                      "Meters"};
+  EXPECT_EQ((std::vector<std::string>{"Ks", "Kv", "Ka", "Kg"}),
+            elevator.GetGainNames());
+  EXPECT_TRUE(elevator.IsConfiguredFor(sysid::analysis::kElevator, 1.0,
+                                       "Meters"));
+  EXPECT_FALSE(elevator.IsConfiguredFor(sysid::analysis::kArm, 1.0,
+                                        "Meters"));
+
+  sysid::OnlineGainEstimator arm{sysid::analysis::kArm, 2 * 3.14159,
+                                 "Radians"};
+  EXPECT_EQ((std::vector<std::string>{"Ks", "Kv", "Ka", "Kcos"}),
+            arm.GetGainNames());
+}
@@ -0,0 +1,230 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+#include <wpi/Logger.h>
+#include <wpi/fs.h>
+#include <wpi/json.h>
+
+#include "gtest/gtest.h"
+#include "sysid/Util.h"
+#include "sysid/analysis/AnalysisType.h"
+#include "sysid/analysis/RegressionSuite.h"
+
+static sysid::RegressionResult MakeResult(std::string name) {
+  sysid::RegressionResult result;
+  result.name = std::move(name);
+  result.gains = {{"Ks", 0.5}, {"Kv", 2.0}, {"Ka", 0.3}};
+  result.gainError = 0.01;
+  result.rmse = 0.05;
+  result.load = 0.010;
+  result.timings = {0.020, 0.030};
+  return result;
+}
+
+TEST(RegressionSuiteTest, SyntheticCorpus) {
+  wpi::Logger logger;
+  sysid::BatchSettings settings;
+  for (auto&& regressionCase : sysid::MakeSyntheticCorpus()) {
+    auto result = sysid::RunRegressionCase(regressionCase, settings, 1, logger);
+    EXPECT_EQ(regressionCase.name, result.name);
+    EXPECT_EQ(regressionCase.truth.size(), result.gains.size())
+        << result.name;
+    EXPECT_LT(result.gainError, 0.05) << result.name;
+    EXPECT_LT(result.rmse, 0.2) << result.name;
+    EXPECT_GT(result.timings.calculate, 0.0) << result.name;
+  }
+}
+
+TEST(RegressionSuiteTest, Baseline) {
+  // The committed baseline has no timings, so this checks that the gains and
+  // their accuracy don't change. After an intended change, update it with
+  // sysid --regression --update --no-timings --baseline <path>.
+  auto path = fmt::format(
+      "{}/sysid-application/src/test/native/resources/sysid-regression.json",
+      EXPAND_STRINGIZE(PROJECT_ROOT_DIR));
+  auto baseline = sysid::LoadRegressionResults(path);
+
+  wpi::Logger logger;
+  std::vector<sysid::RegressionResult> results;
+  for (auto&& regressionCase : sysid::MakeSyntheticCorpus()) {
+    results.push_back(sysid::RunRegressionCase(regressionCase, {}, 1, logger));
+  }
+  sysid::RegressionThresholds thresholds;
+  for (auto&& regression :
+       sysid::CompareToBaseline(results, baseline, thresholds)) {
+    ADD_FAILURE() << regression;
+  }
+}
+
+TEST(RegressionSuiteTest, Deterministic) {
+  wpi::Logger logger;
+  sysid::BatchSettings settings;
+  auto corpus = sysid::MakeSyntheticCorpus();
+  auto a = sysid::RunRegressionCase(corpus[1], settings, 1, logger);
+  auto b = sysid::RunRegressionCase(corpus[1], settings, 2, logger);
+  EXPECT_EQ(a.gains, b.gains);
+  EXPECT_EQ(a.rmse, b.rmse);
+
+  // Without timings, a rerun never regresses.
+  sysid::RegressionThresholds thresholds;
+  thresholds.timeRatio = 0;
+  EXPECT_TRUE(sysid::CompareResult(b, a, thresholds).empty());
+}
+
+TEST(RegressionSuiteTest, UnsupportedCapture) {
+  EXPECT_THROW(sysid::MakeSyntheticCapture(sysid::analysis::kSwerveDrive,
+                                           {0.5, 2.0, 0.3}, "Meters"),
+               std::runtime_error);
+  EXPECT_THROW(sysid::MakeSyntheticCapture(sysid::analysis::kArm,
+                                           {0.5, 2.0, 0.3}, "Radians"),
+               std::runtime_error);
+}
+
+TEST(RegressionSuiteTest, LoadCase) {
+  auto capture = sysid::MakeSyntheticCapture(sysid::analysis::kSimple,
+                                             {0.5, 2.0, 0.3}, "Rotations");
+  capture["truth"] = {{"Ks", 0.5}, {"Kv", 2.0}};
+  auto path = fs::temp_directory_path() / "sysid-regression-case.json";
+  std::ofstream{path} << capture;
+
+  auto regressionCase = sysid::LoadRegressionCase(path.string());
+  EXPECT_EQ("sysid-regression-case.json", regressionCase.name);
+  EXPECT_EQ(2u, regressionCase.truth.size());
+  EXPECT_EQ(2.0, regressionCase.truth["Kv"]);
+
+  wpi::Logger logger;
+  auto result = sysid::RunRegressionCase(regressionCase, {}, 1, logger);
+  EXPECT_LT(result.gainError, 0.05);
+  fs::remove(path);
+}
+
+TEST(RegressionSuiteTest, CompareGains) {
+  sysid::RegressionThresholds thresholds;
+  auto baseline = MakeResult("simple");
+  auto result = baseline;
+  EXPECT_TRUE(sysid::CompareResult(result, baseline, thresholds).empty());
+
+  result.gains["Kv"] = 2.0001;
+  EXPECT_TRUE(sysid::CompareResult(result, baseline, thresholds).empty());
+
+  result.gains["Kv"] = 2.01;
+  auto regressions = sysid::CompareResult(result, baseline, thresholds);
+  ASSERT_EQ(1u, regressions.size());
+  EXPECT_EQ("Kv changed from 2 to 2.01", regressions[0]);
+
+  result.gains.erase("Kv");
+  regressions = sysid::CompareResult(result, baseline, thresholds);
+  ASSERT_EQ(1u, regressions.size());
+  EXPECT_EQ("Kv is no longer identified", regressions[0]);
+}
+
+TEST(RegressionSuiteTest, CompareAccuracy) {
+  sysid::RegressionThresholds thresholds;
+  auto baseline = MakeResult("simple");
+  auto result = baseline;
+  result.gainError = 0.0105;
+  EXPECT_TRUE(sysid::CompareResult(result, baseline, thresholds).empty());
+
+  result.gainError = 0.02;
+  result.rmse = 0.06;
+  EXPECT_EQ(2u, sysid::CompareResult(result, baseline, thresholds).size());
+
+  result = baseline;
+  result.rmse = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_EQ(1u, sysid::CompareResult(result, baseline, thresholds).size());
+
+  // Recorded captures without true gains only compare the gains and RMSE.
+  baseline.gainError = std::numeric_limits<double>::quiet_NaN();
+  result = baseline;
+  EXPECT_TRUE(sysid::CompareResult(result, baseline, thresholds).empty());
+}
+
+TEST(RegressionSuiteTest, CompareTimings) {
+  sysid::RegressionThresholds thresholds;
+  auto baseline = MakeResult("simple");
+  auto result = baseline;
+  result.timings.prepare = 0.034;
+  EXPECT_TRUE(sysid::CompareResult(result, baseline, thresholds).empty());
+
+  result.timings.prepare = 0.040;
+  auto regressions = sysid::CompareResult(result, baseline, thresholds);
+  ASSERT_EQ(1u, regressions.size());
+  EXPECT_EQ("Preparing took 40.0 ms instead of 20.0 ms", regressions[0]);
+
+  thresholds.timeRatio = 0;
+  EXPECT_TRUE(sysid::CompareResult(result, baseline, thresholds).empty());
+}
+
+TEST(RegressionSuiteTest, CompareToBaseline) {
+  sysid::RegressionThresholds thresholds;
+  std::vector<sysid::RegressionResult> baseline{MakeResult("a"),
+                                                MakeResult("b")};
+  std::vector<sysid::RegressionResult> results{MakeResult("b"),
+                                               MakeResult("c")};
+  results[0].gains["Ka"] = 0.4;
+
+  auto regressions =
+      sysid::CompareToBaseline(results, baseline, thresholds);
+  ASSERT_EQ(2u, regressions.size());
+  EXPECT_EQ("b: Ka changed from 0.3 to 0.4", regressions[0]);
+  EXPECT_EQ("a: wasn't run", regressions[1]);
+
+  auto table = sysid::FormatRegressionTable(results, baseline, thresholds);
+  EXPECT_NE(std::string::npos,
+            table.find("| b | 1.000% (1.000%) | 0.05 (0.05) | 10.0 (10.0) | "
+                       "20.0 (20.0) | 30.0 (30.0) | REGRESSED |"))
+      << table;
+  EXPECT_NE(std::string::npos,
+            table.find("| c | 1.000% | 0.05 | 10.0 | 20.0 | 30.0 | new |"))
+      << table;
+}
+
+TEST(RegressionSuiteTest, JSONRoundTrip) {
+  std::vector<sysid::RegressionResult> results{MakeResult("a"),
+                                               MakeResult("b")};
+  results[1].gainError = std::numeric_limits<double>::quiet_NaN();
+  results[1].gains["Kcos"] = -0.2;
+
+  auto path = fs::temp_directory_path() / "sysid-regression-results.json";
+  sysid::SaveRegressionResults(results, path.string());
+  auto loaded = sysid::LoadRegressionResults(path.string());
+  fs::remove(path);
+
+  ASSERT_EQ(2u, loaded.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(results[i].name, loaded[i].name);
+    EXPECT_EQ(results[i].gains, loaded[i].gains);
+    EXPECT_EQ(results[i].rmse, loaded[i].rmse);
+    EXPECT_EQ(results[i].load, loaded[i].load);
+    EXPECT_EQ(results[i].timings.prepare, loaded[i].timings.prepare);
+    EXPECT_EQ(results[i].timings.calculate, loaded[i].timings.calculate);
+  }
+  EXPECT_EQ(0.01, loaded[0].gainError);
+  EXPECT_TRUE(std::isnan(loaded[1].gainError));
+
+  // Baselines without timings don't check them.
+  sysid::SaveRegressionResults(results, path.string(), false);
+  loaded = sysid::LoadRegressionResults(path.string());
+  fs::remove(path);
+  ASSERT_EQ(2u, loaded.size());
+  EXPECT_EQ(results[0].gains, loaded[0].gains);
+  EXPECT_TRUE(std::isnan(loaded[0].load));
+  EXPECT_TRUE(std::isnan(loaded[0].timings.prepare));
+  EXPECT_TRUE(std::isnan(loaded[0].timings.calculate));
+  EXPECT_TRUE(sysid::CompareResult(results[0], loaded[0], {}).empty());
+
+  EXPECT_THROW(sysid::RegressionResultsFromJSON(wpi::json::array()),
+               std::runtime_error);
+  EXPECT_THROW(sysid::RegressionResultsFromJSON(
+                   {{"sysidRegression", 1}, {"results", {{{"name", "a"}}}}}),
+               std::runtime_error);
+}
@@ -0,0 +1,137 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <wpi/Logger.h>
+#include <wpi/fs.h>
+#include <wpi/json.h>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/AnalysisManager.h"
+#include "sysid/analysis/ReportGenerator.h"
+
+/**
+ * Writes a capture of a simple motor with Ks = 0.5, Kv = 2, and Ka = 0.3 to a
+ * new directory and returns its path.
+ */
+static fs::path MakeCapture(std::string_view name) {
+  constexpr double Ks = 0.5;
+  constexpr double Kv = 2.0;
+  constexpr double Ka = 0.3;
+  constexpr double dt = 0.005;
+
+  wpi::json json = {{"sysid", true},
+                    {"test", "Simple"},
+                    {"units", "Rotations"},
+                    {"unitsPerRotation", 1.0}};
+  double startTime = 0.0;
+  for (std::string key : sysid::AnalysisManager::kJsonDataKeys) {
+    bool fast = key.find("fast") != std::string::npos;
+    double sign = key.find("backward") != std::string::npos ? -1.0 : 1.0;
+    std::vector<std::vector<double>> rows;
+    double position = 0.0;
+    double velocity = 0.0;
+    startTime += 100.0;
+    for (int i = 0; i < (fast ? 600 : 2400); ++i) {
+      double t = i * dt;
+      double voltage = sign * (fast ? 7.0 : 0.25 * t);
+      rows.push_back({startTime + t, voltage, position, velocity});
+      double acceleration = 0.0;
+      if (velocity != 0.0 || std::abs(voltage) > Ks) {
+        double direction = std::copysign(1.0, velocity != 0 ? velocity : sign);
+        acceleration = (voltage - Ks * direction - Kv * velocity) / Ka;
+      }
+      position += velocity * dt + acceleration * dt * dt / 2;
+      velocity += acceleration * dt;
+    }
+    json[key] = rows;
+  }
+
+  auto directory = fs::temp_directory_path() / name;
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  auto path = directory / "sysid_data.json";
+  std::ofstream{path} << json;
+  return path;
+}
+
+static std::string ReadFile(const fs::path& path) {
+  std::ifstream file{path};
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+static size_t Count(std::string_view text, std::string_view needle) {
+  size_t count = 0;
+  for (auto pos = text.find(needle); pos != std::string_view::npos;
+       pos = text.find(needle, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+/**
+ * Returns settings that analyze captures quickly.
+ */
+static sysid::BatchSettings MakeSettings() {
+  sysid::BatchSettings settings;
+  settings.autoTune = false;
+  return settings;
+}
+
+TEST(ReportGeneratorTest, GetReportPath) {
+  EXPECT_EQ((fs::path{"captures"} / "arm.report.html").string(),
+            sysid::GetReportPath((fs::path{"captures"} / "arm.json").string(),
+                                 sysid::ReportFormat::kHTML));
+  EXPECT_EQ((fs::path{"reports"} / "arm.report.md").string(),
+            sysid::GetReportPath((fs::path{"captures"} / "arm.json").string(),
+                                 sysid::ReportFormat::kMarkdown, "reports"));
+}
+
+TEST(ReportGeneratorTest, HTML) {
+  wpi::Logger logger;
+  auto path = MakeCapture("sysid-report-html");
+  auto report =
+      sysid::WriteReport(path.string(), MakeSettings(),
+                         sysid::ReportFormat::kHTML, {}, logger);
+  EXPECT_EQ(sysid::GetReportPath(path.string(), sysid::ReportFormat::kHTML),
+            report);
+
+  auto html = ReadFile(report);
+  EXPECT_NE(std::string::npos, html.find("<th>Kv</th>"));
+  EXPECT_NE(std::string::npos, html.find("<th>Kp</th>"));
+  // The charts of the analyzer and the two residual charts.
+  EXPECT_EQ(std::size(sysid::kChartTitles) + 2, Count(html, "<svg"));
+  for (auto&& title : sysid::kChartTitles) {
+    EXPECT_NE(std::string::npos, html.find(title)) << title;
+  }
+}
+
+TEST(ReportGeneratorTest, Markdown) {
+  wpi::Logger logger;
+  auto path = MakeCapture("sysid-report-md");
+  auto directory = path.parent_path() / "reports";
+  auto report =
+      sysid::WriteReport(path.string(), MakeSettings(),
+                         sysid::ReportFormat::kMarkdown,
+                         directory.string(), logger);
+  EXPECT_EQ((directory / "sysid_data.report.md").string(), report);
+
+  auto markdown = ReadFile(report);
+  EXPECT_NE(std::string::npos, markdown.find("| Kv |"));
+  size_t charts = std::size(sysid::kChartTitles) + 2;
+  EXPECT_EQ(charts, Count(markdown, "](sysid_data.report/chart-"));
+  for (size_t i = 1; i <= charts; ++i) {
+    auto chart =
+        directory / "sysid_data.report" / fmt::format("chart-{}.svg", i);
+    EXPECT_TRUE(fs::exists(chart)) << chart;
+  }
+}
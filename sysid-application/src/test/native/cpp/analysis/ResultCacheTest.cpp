@@ -0,0 +1,135 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <wpi/fs.h>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/ResultCache.h"
+
+/**
+ * Creates an empty cache directory for a test.
+ */
+static std::string MakeCacheDirectory(std::string_view name) {
+  auto directory = fs::temp_directory_path() / name;
+  fs::remove_all(directory);
+  return directory.string();
+}
+
+/**
+ * Serializes an entry with a string, a vector, and a value.
+ */
+static sysid::CacheWriter MakeEntry(double value) {
+  sysid::CacheWriter writer;
+  writer.WriteString("dataset");
+  writer.WriteVector(std::vector<double>{1.0, 2.0, value});
+  writer.Write<int>(3);
+  return writer;
+}
+
+TEST(ResultCacheTest, Fnv1aHash) {
+  // Reference values of 64-bit FNV-1a.
+  EXPECT_EQ(0xcbf29ce484222325u, sysid::Fnv1aHash{}.Get());
+  sysid::Fnv1aHash hash;
+  hash.AddBytes("a", 1);
+  EXPECT_EQ(0xaf63dc4c8601ec8cu, hash.Get());
+  hash.AddBytes("bc", 2);
+  sysid::Fnv1aHash whole;
+  whole.AddBytes("abc", 3);
+  EXPECT_EQ(whole.Get(), hash.Get());
+
+  // Adjacent strings don't run into each other.
+  sysid::Fnv1aHash first;
+  first.AddString("ab");
+  first.AddString("c");
+  sysid::Fnv1aHash second;
+  second.AddString("a");
+  second.AddString("bc");
+  EXPECT_NE(first.Get(), second.Get());
+}
+
+TEST(ResultCacheTest, RoundTrip) {
+  sysid::ResultCache cache{MakeCacheDirectory("sysid-cache-round-trip")};
+  auto read = [](sysid::CacheReader& reader) {
+    EXPECT_EQ("dataset", reader.ReadString());
+    std::vector<double> data;
+    reader.ReadVector(&data);
+    EXPECT_EQ((std::vector<double>{1.0, 2.0, 4.0}), data);
+    EXPECT_EQ(3, reader.Read<int>());
+  };
+  EXPECT_FALSE(cache.Load(1, read));
+
+  EXPECT_TRUE(cache.Store(1, MakeEntry(4.0)));
+  EXPECT_TRUE(cache.Load(1, read));
+
+  // Another key is a miss.
+  EXPECT_FALSE(cache.Load(2, read));
+}
+
+TEST(ResultCacheTest, RejectsInvalidEntries) {
+  sysid::ResultCache cache{MakeCacheDirectory("sysid-cache-invalid")};
+  ASSERT_TRUE(cache.Store(1, MakeEntry(4.0)));
+  auto path = cache.GetPath(1);
+  auto size = fs::file_size(path);
+
+  // A truncated entry is a miss and is removed.
+  fs::resize_file(path, size - 8);
+  bool called = false;
+  EXPECT_FALSE(cache.Load(1, [&](auto&) { called = true; }));
+  EXPECT_FALSE(called);
+  EXPECT_FALSE(fs::exists(path));
+
+  // So is an entry with a flipped byte.
+  ASSERT_TRUE(cache.Store(1, MakeEntry(4.0)));
+  {
+    std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+    file.seekp(-1, std::ios::end);
+    file.put('\x7f');
+  }
+  EXPECT_FALSE(cache.Load(1, [&](auto&) { called = true; }));
+  EXPECT_FALSE(called);
+
+  // Reading past the end of a valid entry is an error, which is a miss.
+  ASSERT_TRUE(cache.Store(1, MakeEntry(4.0)));
+  EXPECT_FALSE(cache.Load(1, [](sysid::CacheReader& reader) {
+    reader.ReadString();
+    std::vector<double> data;
+    reader.ReadVector(&data);
+    reader.Read<int>();
+    reader.Read<int>();
+  }));
+}
+
+TEST(ResultCacheTest, EvictsLeastRecentlyUsed) {
+  auto directory = MakeCacheDirectory("sysid-cache-evict");
+  auto entrySize = [&] {
+    sysid::ResultCache cache{directory};
+    cache.Store(0, MakeEntry(0.0));
+    auto size = fs::file_size(cache.GetPath(0));
+    fs::remove_all(directory);
+    return size;
+  }();
+
+  // Only three entries fit in the cache.
+  sysid::ResultCache cache{directory, 3 * entrySize};
+  auto now = fs::file_time_type::clock::now();
+  for (uint64_t key = 1; key <= 3; ++key) {
+    ASSERT_TRUE(cache.Store(key, MakeEntry(key)));
+    fs::last_write_time(cache.GetPath(key),
+                        now - std::chrono::hours{10 - key});
+  }
+
+  // Using the oldest entry makes the second one the least recently used.
+  EXPECT_TRUE(cache.Load(1, [](auto&) {}));
+  ASSERT_TRUE(cache.Store(4, MakeEntry(4.0)));
+  EXPECT_TRUE(fs::exists(cache.GetPath(1)));
+  EXPECT_FALSE(fs::exists(cache.GetPath(2)));
+  EXPECT_TRUE(fs::exists(cache.GetPath(3)));
+  EXPECT_TRUE(fs::exists(cache.GetPath(4)));
+}
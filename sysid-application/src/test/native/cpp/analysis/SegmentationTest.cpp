@@ -0,0 +1,151 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <cmath>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <wpi/json.h>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/Segmentation.h"
+
+/**
+ * Simulates a continuous capture of a simple motor driven by a sequence of
+ * voltage profiles.
+ */
+class CaptureSim {
+ public:
+  static constexpr double kDt = 0.005;
+
+  /**
+   * Runs a voltage profile for a duration and returns the row index at which
+   * it started.
+   */
+  size_t Run(double duration, std::function<double(double)> voltage) {
+    size_t start = m_rows.size();
+    for (double t = 0; t < duration; t += kDt) {
+      double u = voltage(t);
+      m_rows.push_back({m_t, u, m_x, m_v + m_noise(m_gen)});
+
+      double a = 0.0;
+      if (m_v != 0.0 || std::abs(u) > kS) {
+        double friction = kS * std::copysign(1.0, m_v != 0.0 ? m_v : u);
+        a = (u - friction - kV * m_v) / kA;
+      }
+      double v = m_v + a * kDt;
+      // Friction stops the motor instead of reversing it.
+      if (u == 0.0 && std::signbit(v) != std::signbit(m_v)) {
+        v = 0.0;
+      }
+      m_x += (m_v + v) / 2 * kDt;
+      m_v = v;
+      m_t += kDt;
+    }
+    return start;
+  }
+
+  size_t Idle(double duration) {
+    return Run(duration, [](double) { return 0.0; });
+  }
+
+  const std::vector<std::vector<double>>& GetRows() const { return m_rows; }
+
+ private:
+  static constexpr double kS = 0.5;
+  static constexpr double kV = 2.0;
+  static constexpr double kA = 0.3;
+
+  std::vector<std::vector<double>> m_rows;
+  double m_t = 100.0;
+  double m_x = 0.0;
+  double m_v = 0.0;
+  std::mt19937 m_gen{42};
+  std::normal_distribution<double> m_noise{0.0, 0.005};
+};
+
+/**
+ * Runs the four tests, some driving that shouldn't be detected, and a second
+ * (longer) dynamic forward test.
+ */
+static CaptureSim SimulateMatch(std::vector<size_t>* starts) {
+  CaptureSim sim;
+  sim.Idle(2.0);
+  starts->push_back(sim.Run(8.0, [](double t) { return 0.25 * t; }));
+  sim.Idle(3.0);
+  starts->push_back(sim.Run(8.0, [](double t) { return -0.25 * t; }));
+  sim.Idle(3.0);
+  starts->push_back(sim.Run(2.0, [](double) { return 7.0; }));
+  sim.Idle(3.0);
+  starts->push_back(sim.Run(2.0, [](double) { return -7.0; }));
+  sim.Idle(3.0);
+  sim.Run(10.0, [](double t) { return 3.0 * std::sin(3.0 * t); });
+  sim.Idle(3.0);
+  starts->push_back(sim.Run(3.0, [](double) { return 7.0; }));
+  sim.Idle(2.0);
+  return sim;
+}
+
+TEST(SegmentationTest, FindTests) {
+  std::vector<size_t> starts;
+  auto sim = SimulateMatch(&starts);
+  auto segments = sysid::SegmentCapture(sim.GetRows(), 1, 3);
+
+  ASSERT_EQ(5u, segments.size());
+  EXPECT_STREQ("slow-forward", segments[0].GetKey());
+  EXPECT_STREQ("slow-backward", segments[1].GetKey());
+  EXPECT_STREQ("fast-forward", segments[2].GetKey());
+  EXPECT_STREQ("fast-backward", segments[3].GetKey());
+  EXPECT_STREQ("fast-forward", segments[4].GetKey());
+
+  // Ramps are found where the fitted ramp crosses zero, and steps at the
+  // first sample of the step.
+  const auto& rows = sim.GetRows();
+  for (size_t i = 0; i < segments.size(); ++i) {
+    double tolerance = i < 2 ? 0.1 : 1e-9;
+    EXPECT_NEAR(rows[starts[i]][0], rows[segments[i].begin][0], tolerance);
+  }
+
+  // Each test ends when the voltage returns to zero.
+  for (size_t i = 0; i < segments.size(); ++i) {
+    EXPECT_NE(0.0, rows[segments[i].end - 1][1]);
+    EXPECT_EQ(0.0, rows[segments[i].end][1]);
+  }
+}
+
+TEST(SegmentationTest, SplitJSON) {
+  std::vector<size_t> starts;
+  auto sim = SimulateMatch(&starts);
+  wpi::json json;
+  json["continuous"] = sim.GetRows();
+
+  sysid::SplitContinuousCapture(&json, 1, 3);
+
+  EXPECT_EQ(json.end(), json.find("continuous"));
+  for (auto&& key : {"slow-forward", "slow-backward", "fast-forward",
+                     "fast-backward", "fast-forward-2"}) {
+    EXPECT_NE(json.end(), json.find(key)) << key;
+  }
+
+  // The longer dynamic forward test is used for the analysis.
+  EXPECT_GT(json.at("fast-forward").size(), json.at("fast-forward-2").size());
+}
+
+TEST(SegmentationTest, MissingTest) {
+  CaptureSim sim;
+  sim.Idle(1.0);
+  sim.Run(2.0, [](double) { return 7.0; });
+  sim.Idle(1.0);
+  wpi::json json;
+  json["continuous"] = sim.GetRows();
+
+  EXPECT_THROW(sysid::SplitContinuousCapture(&json, 1, 3), std::runtime_error);
+}
+
+TEST(SegmentationTest, NarrowRows) {
+  std::vector<std::vector<double>> rows{{0.0, 1.0}, {0.005, 1.0}};
+  EXPECT_THROW(sysid::SegmentCapture(rows, 1, 3), std::runtime_error);
+}
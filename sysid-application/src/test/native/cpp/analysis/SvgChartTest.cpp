@@ -0,0 +1,77 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sysid/analysis/SvgChart.h"
+
+static std::vector<sysid::ChartPoint> MakeSine(int size) {
+  std::vector<sysid::ChartPoint> points;
+  for (int i = 0; i < size; ++i) {
+    points.push_back({i * 0.01, std::sin(i * 0.01)});
+  }
+  return points;
+}
+
+TEST(SvgChartTest, DecimateKeepsShortSeries) {
+  auto points = MakeSine(100);
+  EXPECT_EQ(points, sysid::DecimatePoints(points, 1000, true));
+  EXPECT_EQ(points, sysid::DecimatePoints(points, 1000, false));
+}
+
+TEST(SvgChartTest, DecimateLineKeepsExtremes) {
+  auto points = MakeSine(100000);
+  auto decimated = sysid::DecimatePoints(points, 1000, true);
+  EXPECT_LE(decimated.size(), 1000u);
+  EXPECT_EQ(points.front(), decimated.front());
+  EXPECT_EQ(points.back(), decimated.back());
+
+  auto byY = [](auto& a, auto& b) { return a[1] < b[1]; };
+  EXPECT_EQ(*std::min_element(points.begin(), points.end(), byY),
+            *std::min_element(decimated.begin(), decimated.end(), byY));
+  EXPECT_EQ(*std::max_element(points.begin(), points.end(), byY),
+            *std::max_element(decimated.begin(), decimated.end(), byY));
+
+  // The points stay in order.
+  EXPECT_TRUE(std::is_sorted(decimated.begin(), decimated.end()));
+}
+
+TEST(SvgChartTest, DecimateScatter) {
+  auto points = MakeSine(100000);
+  auto decimated = sysid::DecimatePoints(points, 1000, false);
+  EXPECT_EQ(1000u, decimated.size());
+  EXPECT_TRUE(std::is_sorted(decimated.begin(), decimated.end()));
+}
+
+TEST(SvgChartTest, Render) {
+  sysid::SvgChart chart{"Velocity <raw> & filtered", "Time (s)",
+                        "Velocity (m / s)"};
+  chart.AddScatter("Raw Data", MakeSine(5000));
+  chart.AddLine("Fit", {{0.0, 0.0}, {1.0, 1.0}});
+  auto svg = chart.Render();
+
+  EXPECT_EQ(0u, svg.find("<svg"));
+  EXPECT_NE(std::string::npos, svg.find("</svg>"));
+  EXPECT_NE(std::string::npos, svg.find("Velocity &lt;raw&gt; &amp; filtered"));
+  EXPECT_NE(std::string::npos, svg.find("Raw Data"));
+  EXPECT_NE(std::string::npos, svg.find("Fit"));
+
+  // The scatter series is decimated before it's drawn.
+  auto dots = 0;
+  for (auto pos = svg.find("h0"); pos != std::string::npos;
+       pos = svg.find("h0", pos + 1)) {
+    ++dots;
+  }
+  EXPECT_EQ(static_cast<int>(sysid::SvgChart::kMaxPoints), dots);
+}
+
+TEST(SvgChartTest, RenderEmpty) {
+  sysid::SvgChart chart{"Empty", "x", "y"};
+  auto svg = chart.Render();
+  EXPECT_NE(std::string::npos, svg.find("No data"));
+}
@@ -0,0 +1,86 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <units/time.h>
+
+#include "gtest/gtest.h"
+#include "sysid/telemetry/ClockSync.h"
+
+// The robot clock runs 1000 s ahead of the host clock.
+static constexpr double kOffset = 1000.0;
+
+/**
+ * Returns an exchange sent at the given host time, which takes the given times
+ * to reach the robot and to come back.
+ */
+static sysid::ClockSync::Sample MakeSample(double hostSend, double there,
+                                           double back,
+                                           double offset = kOffset) {
+  return {hostSend, hostSend + there + offset, hostSend + there + back};
+}
+
+TEST(ClockSyncTest, Empty) {
+  sysid::ClockSync sync;
+  EXPECT_FALSE(sync.GetEstimate());
+  EXPECT_FALSE(sync.ToRobotTime(1_s));
+}
+
+TEST(ClockSyncTest, SymmetricDelay) {
+  sysid::ClockSync sync;
+  sync.AddSample(MakeSample(1.0, 0.01, 0.01));
+
+  auto& estimate = sync.GetEstimate();
+  ASSERT_TRUE(estimate);
+  EXPECT_NEAR(kOffset, estimate->offset.value(), 1E-9);
+  EXPECT_NEAR(0.02, estimate->minRoundTrip.value(), 1E-9);
+  EXPECT_NEAR(1005.0, sync.ToRobotTime(5_s)->value(), 1E-9);
+}
+
+TEST(ClockSyncTest, PrefersShortRoundTrips) {
+  sysid::ClockSync sync;
+  // Queueing delays one way skew the offset of these exchanges.
+  sync.AddSample(MakeSample(1.0, 0.05, 0.005));
+  sync.AddSample(MakeSample(1.1, 0.005, 0.005));
+  sync.AddSample(MakeSample(1.2, 0.005, 0.08));
+
+  auto& estimate = sync.GetEstimate();
+  ASSERT_TRUE(estimate);
+  EXPECT_NEAR(kOffset, estimate->offset.value(), 1E-9);
+  EXPECT_NEAR(0.01, estimate->minRoundTrip.value(), 1E-9);
+  EXPECT_NEAR(0.085, estimate->maxRoundTrip.value(), 1E-9);
+  EXPECT_NEAR((0.055 + 0.01 + 0.085) / 3, estimate->meanRoundTrip.value(),
+              1E-9);
+}
+
+TEST(ClockSyncTest, FollowsDrift) {
+  sysid::ClockSync sync;
+  // An early exchange with the shortest round trip, before the clocks drift.
+  sync.AddSample(MakeSample(0.0, 0.001, 0.001));
+  for (size_t i = 1; i <= sysid::ClockSync::kWindowSize; ++i) {
+    sync.AddSample(MakeSample(i * 0.1, 0.005, 0.005, kOffset + 0.5));
+  }
+  EXPECT_NEAR(kOffset + 0.5, sync.GetEstimate()->offset.value(), 1E-9);
+}
+
+TEST(ClockSyncTest, IgnoresInvalidSamples) {
+  sysid::ClockSync sync;
+  sync.AddSample({2.0, 1002.0, 1.0});
+  EXPECT_FALSE(sync.GetEstimate());
+  EXPECT_TRUE(sync.GetSamples().empty());
+}
+
+TEST(ClockSyncTest, ToJSON) {
+  sysid::ClockSync sync;
+  sync.AddSample(MakeSample(1.0, 0.01, 0.01));
+  sync.AddSample(MakeSample(1.1, 0.01, 0.01));
+
+  auto json = sync.ToJSON();
+  EXPECT_NEAR(kOffset, json.at("offset").get<double>(), 1E-9);
+  EXPECT_EQ(2u, json.at("samples").size());
+  EXPECT_DOUBLE_EQ(1.1, json.at("samples")[1][0].get<double>());
+
+  sync.Reset();
+  EXPECT_FALSE(sync.GetEstimate());
+  EXPECT_TRUE(sync.ToJSON().at("samples").empty());
+}
@@ -0,0 +1,204 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ntcore_cpp.h>
+#include <wpi/fs.h>
+
+#include "gtest/gtest.h"
+#include "sysid/telemetry/NTRecording.h"
+
+/**
+ * Creates an NT instance for a test and destroys it afterwards.
+ */
+class NTRecordingTest : public ::testing::Test {
+ public:
+  NTRecordingTest() : m_instance{nt::CreateInstance()} {}
+  ~NTRecordingTest() override { nt::DestroyInstance(m_instance); }
+
+  void Set(std::string_view name, std::shared_ptr<nt::Value> value) {
+    nt::SetEntryValue(nt::GetEntry(m_instance, name), value);
+  }
+
+  std::shared_ptr<nt::Value> Get(std::string_view name) {
+    return nt::GetEntryValue(nt::GetEntry(m_instance, name));
+  }
+
+ protected:
+  NT_Inst m_instance;
+};
+
+static sysid::NTRecording MakeRecording() {
+  sysid::NTRecording recording;
+  recording.events = {
+      {0.0, "/SmartDashboard/SysIdTelemetry", nt::Value::MakeString(""),
+       false, true},
+      {0.5, "/SmartDashboard/SysIdTestType",
+       nt::Value::MakeString("Quasistatic"), true, false},
+      {0.6, "/FMSInfo/FMSControlData", nt::Value::MakeDouble(33), false,
+       false},
+      {1.0, "/SmartDashboard/SysIdPong",
+       nt::Value::MakeDoubleArray(std::vector<double>{1.0, 2.5}), false,
+       false},
+      {1.5, "/SmartDashboard/SysIdTelemetryPacked",
+       nt::Value::MakeRaw(std::string{"SY\x01\x00\xff", 5}), false, false},
+      {1.5, "/SmartDashboard/SysIdOverflow", nt::Value::MakeBoolean(true),
+       false, false},
+      {2.0, "/SmartDashboard/Flags",
+       nt::Value::MakeBooleanArray(std::vector<int>{1, 0, 1}), false, false},
+      {2.0, "/SmartDashboard/Names",
+       nt::Value::MakeStringArray(std::vector<std::string>{"a", "b"}), false,
+       false}};
+  return recording;
+}
+
+static void ExpectEqual(const sysid::NTRecording& expected,
+                        const sysid::NTRecording& actual) {
+  ASSERT_EQ(expected.events.size(), actual.events.size());
+  for (size_t i = 0; i < expected.events.size(); ++i) {
+    const auto& a = expected.events[i];
+    const auto& b = actual.events[i];
+    EXPECT_DOUBLE_EQ(a.time, b.time);
+    EXPECT_EQ(a.name, b.name);
+    EXPECT_EQ(*a.value, *b.value) << a.name;
+    EXPECT_EQ(a.local, b.local);
+    EXPECT_EQ(a.initial, b.initial);
+  }
+}
+
+TEST_F(NTRecordingTest, JSONRoundTrip) {
+  auto recording = MakeRecording();
+  ExpectEqual(recording,
+              sysid::NTRecordingFromJSON(sysid::ToJSON(recording)));
+}
+
+TEST_F(NTRecordingTest, FileRoundTrip) {
+  auto recording = MakeRecording();
+  auto path = (fs::temp_directory_path() / "sysid-recording.json").string();
+  sysid::SaveRecording(recording, path);
+  ExpectEqual(recording, sysid::LoadRecording(path));
+  fs::remove(path);
+}
+
+TEST_F(NTRecordingTest, InvalidJSON) {
+  EXPECT_THROW(sysid::NTRecordingFromJSON(wpi::json::array()),
+               std::runtime_error);
+  EXPECT_THROW(sysid::NTRecordingFromJSON({{"sysidRecording", 2}}),
+               std::runtime_error);
+  EXPECT_THROW(sysid::NTRecordingFromJSON(
+                   {{"sysidRecording", 1},
+                    {"events", {{{"time", 0.0}, {"name", "/a"}}}}}),
+               std::runtime_error);
+}
+
+TEST_F(NTRecordingTest, Record) {
+  Set("/SmartDashboard/SysIdVoltageCommand", nt::Value::MakeDouble(0.25));
+  sysid::NTRecorder recorder{m_instance, "/SmartDashboard/"};
+  Set("/SmartDashboard/SysIdVoltageCommand", nt::Value::MakeDouble(0.5));
+  Set("/SmartDashboard/SysIdTelemetryPacked", nt::Value::MakeRaw("SY"));
+  Set("/FMSInfo/FMSControlData", nt::Value::MakeDouble(33));
+
+  // Notifications are delivered by another thread.
+  const auto& events = recorder.GetRecording().events;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{2};
+  while (events.size() < 3 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    recorder.Update();
+  }
+
+  ASSERT_EQ(3u, events.size());
+  EXPECT_EQ("/SmartDashboard/SysIdVoltageCommand", events[0].name);
+  EXPECT_EQ(0.25, events[0].value->GetDouble());
+  EXPECT_TRUE(events[0].initial);
+  EXPECT_EQ(0.0, events[0].time);
+
+  EXPECT_EQ("/SmartDashboard/SysIdVoltageCommand", events[1].name);
+  EXPECT_EQ(0.5, events[1].value->GetDouble());
+  EXPECT_TRUE(events[1].local);
+  EXPECT_FALSE(events[1].initial);
+
+  EXPECT_EQ("/SmartDashboard/SysIdTelemetryPacked", events[2].name);
+  EXPECT_EQ("SY", events[2].value->GetRaw());
+  EXPECT_GE(events[2].time, events[1].time);
+}
+
+TEST_F(NTRecordingTest, PublishUntil) {
+  auto recording = MakeRecording();
+  sysid::NTReplayer replayer{m_instance, recording};
+
+  // The initial value is published, but not the local update.
+  EXPECT_EQ(1u, replayer.PublishUntil(0.55));
+  EXPECT_EQ("", Get("/SmartDashboard/SysIdTelemetry")->GetString());
+  EXPECT_EQ(nullptr, Get("/SmartDashboard/SysIdTestType"));
+  EXPECT_EQ(nullptr, Get("/FMSInfo/FMSControlData"));
+
+  EXPECT_EQ(4u, replayer.PublishUntil(1.5));
+  EXPECT_EQ(33, Get("/FMSInfo/FMSControlData")->GetDouble());
+  EXPECT_TRUE(Get("/SmartDashboard/SysIdOverflow")->GetBoolean());
+  EXPECT_FALSE(replayer.IsDone());
+
+  EXPECT_EQ(2u, replayer.PublishUntil(recording.GetDuration()));
+  EXPECT_TRUE(replayer.IsDone());
+  EXPECT_EQ(*recording.events.back().value, *Get("/SmartDashboard/Names"));
+}
+
+TEST_F(NTRecordingTest, ReplayTypeChange) {
+  Set("/FMSInfo/FMSControlData", nt::Value::MakeString("disabled"));
+
+  auto recording = MakeRecording();
+  sysid::NTReplayer replayer{m_instance, recording};
+  replayer.PublishUntil(1.0);
+  EXPECT_EQ(33, Get("/FMSInfo/FMSControlData")->GetDouble());
+}
+
+TEST_F(NTRecordingTest, RunWaitsForGate) {
+  auto recording = MakeRecording();
+  sysid::NTReplayer replayer{m_instance, recording};
+
+  std::atomic<bool> stop{false};
+  size_t published = 0;
+  std::thread thread{[&] { published = replayer.Run(0, stop); }};
+
+  // Nothing after the start of the test is published until it begins.
+  std::this_thread::sleep_for(std::chrono::milliseconds{100});
+  EXPECT_EQ(nullptr, Get("/FMSInfo/FMSControlData"));
+
+  Set("/SmartDashboard/SysIdTestType", nt::Value::MakeString("Quasistatic"));
+  thread.join();
+  EXPECT_EQ(7u, published);
+  EXPECT_TRUE(replayer.IsDone());
+  EXPECT_EQ(33, Get("/FMSInfo/FMSControlData")->GetDouble());
+}
+
+TEST_F(NTRecordingTest, RunStops) {
+  auto recording = MakeRecording();
+  sysid::NTReplayer replayer{m_instance, recording};
+
+  std::atomic<bool> stop{false};
+  std::thread thread{[&] { replayer.Run(1.0, stop); }};
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  stop = true;
+  thread.join();
+  EXPECT_FALSE(replayer.IsDone());
+}
+
+TEST_F(NTRecordingTest, RunSpeed) {
+  auto recording = MakeRecording();
+  sysid::NTReplayer replayer{m_instance, recording, {}};
+
+  std::atomic<bool> stop{false};
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(7u, replayer.Run(10.0, stop));
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  // The recording is 2 s long.
+  EXPECT_GE(elapsed, std::chrono::milliseconds{190});
+  EXPECT_LT(elapsed, std::chrono::seconds{2});
+}
@@ -0,0 +1,223 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sysid/logging/SampleEncoder.h"
+#include "sysid/telemetry/SampleDecoder.h"
+
+// Appends the bytes of the header with the given column types.
+static std::string MakeHeader(std::initializer_list<uint8_t> types,
+                              double quantum = 0.5) {
+  std::string data{"SY\x01"};
+  data.push_back(static_cast<char>(types.size()));
+  for (auto type : types) {
+    data.push_back(static_cast<char>(type));
+    if (type == 2) {
+      uint64_t bits;
+      std::memcpy(&bits, &quantum, sizeof(bits));
+      for (int i = 0; i < 8; ++i) {
+        data.push_back(static_cast<char>(bits >> (8 * i)));
+      }
+    }
+  }
+  return data;
+}
+
+static void AppendVarint(std::string& data, int64_t value) {
+  uint64_t zigzag =
+      (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+  do {
+    uint8_t byte = zigzag & 0x7f;
+    zigzag >>= 7;
+    data.push_back(static_cast<char>(zigzag ? byte | 0x80 : byte));
+  } while (zigzag);
+}
+
+static void AppendInt16(std::string& data, int16_t value) {
+  data.push_back(static_cast<char>(value & 0xff));
+  data.push_back(static_cast<char>((value >> 8) & 0xff));
+}
+
+TEST(SampleDecoderTest, Decode) {
+  auto data = MakeHeader({0, 1, 2}, 0.25);
+  // t = 1.5 s, 12 V, 10 quanta
+  AppendVarint(data, 1500000);
+  AppendInt16(data, 12000);
+  AppendVarint(data, 10);
+  // t = 1.505 s, -3.25 V, 7 quanta
+  AppendVarint(data, 5000);
+  AppendInt16(data, -3250);
+  AppendVarint(data, -3);
+  // t = 1.51 s, 0 V, 207 quanta
+  AppendVarint(data, 5000);
+  AppendInt16(data, 0);
+  AppendVarint(data, 200);
+
+  auto samples = sysid::DecodeSamples(data);
+  ASSERT_EQ(3u, samples.columns);
+  ASSERT_EQ(9u, samples.values.size());
+
+  double expected[] = {1.5, 12, 2.5, 1.505, -3.25, 1.75, 1.51, 0, 51.75};
+  for (size_t i = 0; i < samples.values.size(); ++i) {
+    EXPECT_NEAR(expected[i], samples.values[i], 1E-9);
+  }
+}
+
+TEST(SampleDecoderTest, DecodesEncoder) {
+  constexpr double kPositionQuantum = 1.0 / 4096;
+  constexpr double kVelocityQuantum = 1E-3;
+  constexpr int kSamples = 200;
+
+  sysid::SampleEncoder encoder;
+  encoder.Reset({{sysid::SampleColumnType::kTimestamp},
+                 {sysid::SampleColumnType::kVoltage},
+                 {sysid::SampleColumnType::kScaled, kPositionQuantum},
+                 {sysid::SampleColumnType::kScaled, kVelocityQuantum}},
+                64 + kSamples * 40);
+
+  // The position swings back and forth, so the scaled columns have negative
+  // changes, and the voltage and velocity change sign.
+  std::vector<std::array<double, 4>> samples;
+  for (int i = 0; i < kSamples; ++i) {
+    double t = 12.3456789 + i * 0.0050137;
+    samples.push_back({t, 11.5 * std::sin(i * 0.07), 3.3 * std::cos(i * 0.1),
+                       -65.8 * std::sin(i * 0.1)});
+    ASSERT_TRUE(encoder.Add(samples.back()));
+  }
+  EXPECT_EQ(static_cast<size_t>(kSamples), encoder.GetSampleCount());
+
+  auto decoded = sysid::DecodeSamples(encoder.GetData());
+  ASSERT_EQ(4u, decoded.columns);
+  ASSERT_EQ(4u * kSamples, decoded.values.size());
+
+  // Every value is within half the resolution of its column.
+  std::array<double, 4> quanta = {sysid::SampleEncoder::kTimestampQuantum,
+                                  sysid::SampleEncoder::kVoltageQuantum,
+                                  kPositionQuantum, kVelocityQuantum};
+  for (size_t i = 0; i < samples.size(); ++i) {
+    for (size_t col = 0; col < quanta.size(); ++col) {
+      EXPECT_NEAR(samples[i][col], decoded.values[4 * i + col],
+                  quanta[col] / 2 + 1E-12)
+          << "sample " << i << ", column " << col;
+    }
+  }
+
+  // The last sample is complete.
+  const auto& last = samples.back();
+  const double* lastDecoded = &decoded.values[4 * (kSamples - 1)];
+  EXPECT_NEAR(last[0], lastDecoded[0], 5E-7);
+  EXPECT_NEAR(last[1], lastDecoded[1], 5E-4);
+  EXPECT_NEAR(last[2], lastDecoded[2], kPositionQuantum / 2);
+  EXPECT_NEAR(last[3], lastDecoded[3], kVelocityQuantum / 2);
+}
+
+TEST(SampleDecoderTest, DecodesEncoderExtremes) {
+  sysid::SampleEncoder encoder;
+  encoder.Reset({{sysid::SampleColumnType::kVoltage},
+                 {sysid::SampleColumnType::kScaled, 0.25}},
+                256);
+
+  // Voltages saturate at the range of int16 millivolts, and values that
+  // aren't finite are stored as 0.
+  ASSERT_TRUE(encoder.Add(std::array{40.0, 1E6}));
+  ASSERT_TRUE(encoder.Add(std::array{-40.0, -1E6}));
+  ASSERT_TRUE(encoder.Add(
+      std::array{-12.3456, std::numeric_limits<double>::quiet_NaN()}));
+  ASSERT_TRUE(encoder.Add(std::array{0.0, -0.375}));
+
+  auto decoded = sysid::DecodeSamples(encoder.GetData());
+  ASSERT_EQ(2u, decoded.columns);
+  double expected[] = {32.767, 1E6, -32.768, -1E6, -12.346, 0, 0, -0.5};
+  ASSERT_EQ(std::size(expected), decoded.values.size());
+  for (size_t i = 0; i < decoded.values.size(); ++i) {
+    EXPECT_NEAR(expected[i], decoded.values[i], 1E-9) << "value " << i;
+  }
+}
+
+TEST(SampleDecoderTest, DecodesTakenEncoderData) {
+  sysid::SampleEncoder encoder;
+  encoder.Reset({{sysid::SampleColumnType::kScaled, 0.5}}, 256);
+  ASSERT_TRUE(encoder.Add(std::array{1.0}));
+  ASSERT_TRUE(encoder.Add(std::array{2.5}));
+
+  // The stream is moved out, and the next samples go into the spare buffer
+  // without allocating.
+  std::string spare;
+  spare.reserve(256);
+  const char* spareMemory = spare.data();
+  auto data = encoder.TakeData(std::move(spare));
+  EXPECT_EQ(0u, encoder.GetSampleCount());
+  EXPECT_EQ(spareMemory, encoder.GetData().data());
+  ASSERT_TRUE(encoder.Add(std::array{-1.0}));
+
+  auto decoded = sysid::DecodeSamples(data);
+  ASSERT_EQ(2u, decoded.values.size());
+  EXPECT_EQ(1.0, decoded.values[0]);
+  EXPECT_EQ(2.5, decoded.values[1]);
+
+  decoded = sysid::DecodeSamples(encoder.GetData());
+  ASSERT_EQ(1u, decoded.values.size());
+  EXPECT_EQ(-1.0, decoded.values[0]);
+}
+
+TEST(SampleDecoderTest, LargeChanges) {
+  auto data = MakeHeader({2}, 1E-5);
+  AppendVarint(data, INT64_C(1) << 40);
+  AppendVarint(data, -(INT64_C(1) << 41));
+
+  auto samples = sysid::DecodeSamples(data);
+  ASSERT_EQ(2u, samples.values.size());
+  EXPECT_NEAR((INT64_C(1) << 40) * 1E-5, samples.values[0], 1E-3);
+  EXPECT_NEAR(-(INT64_C(1) << 40) * 1E-5, samples.values[1], 1E-3);
+}
+
+TEST(SampleDecoderTest, NoSamples) {
+  auto samples = sysid::DecodeSamples(MakeHeader({0, 1}));
+  EXPECT_EQ(2u, samples.columns);
+  EXPECT_TRUE(samples.values.empty());
+
+  samples = sysid::DecodeSamples(MakeHeader({}));
+  EXPECT_EQ(0u, samples.columns);
+  EXPECT_TRUE(samples.values.empty());
+}
+
+TEST(SampleDecoderTest, InvalidHeader) {
+  EXPECT_THROW(sysid::DecodeSamples(""), std::runtime_error);
+  EXPECT_THROW(sysid::DecodeSamples("1.0,2.0"), std::runtime_error);
+
+  auto data = MakeHeader({0});
+  data[2] = 2;
+  EXPECT_THROW(sysid::DecodeSamples(data), std::runtime_error);
+
+  EXPECT_THROW(sysid::DecodeSamples(MakeHeader({3})), std::runtime_error);
+
+  // The quantum is cut off.
+  data = MakeHeader({2});
+  data.resize(data.size() - 1);
+  EXPECT_THROW(sysid::DecodeSamples(data), std::runtime_error);
+}
+
+TEST(SampleDecoderTest, Truncated) {
+  auto data = MakeHeader({0, 1});
+  AppendVarint(data, 1000);
+  AppendInt16(data, 100);
+  AppendVarint(data, 1000);
+  EXPECT_THROW(sysid::DecodeSamples(data), std::runtime_error);
+
+  // A varint that doesn't end.
+  data = MakeHeader({0});
+  data.push_back(static_cast<char>(0x80));
+  EXPECT_THROW(sysid::DecodeSamples(data), std::runtime_error);
+}
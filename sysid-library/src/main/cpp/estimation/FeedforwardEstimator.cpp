@@ -0,0 +1,115 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/estimation/FeedforwardEstimator.h"
+
+#include <cmath>
+
+using namespace sysid;
+
+// The initial variance of the regression coefficients, which is large
+// compared to them for any FRC mechanism.
+static constexpr double kInitialVariance = 1e4;
+
+FeedforwardEstimator::FeedforwardEstimator(GravityTerm term,
+                                           double forgettingFactor)
+    : m_term{term}, m_rls{forgettingFactor} {
+  Reset(term);
+}
+
+GravityTerm FeedforwardEstimator::GetGravityTerm(std::string_view mechanism) {
+  if (mechanism == "Elevator") {
+    return GravityTerm::kConstant;
+  } else if (mechanism == "Arm") {
+    return GravityTerm::kCosine;
+  }
+  return GravityTerm::kNone;
+}
+
+void FeedforwardEstimator::Reset(GravityTerm term) {
+  m_term = term;
+  RecursiveLeastSquares<kGainCount>::Vector variance;
+  variance.setConstant(kInitialVariance);
+
+  // Without a gravity term, its coefficient stays at zero.
+  if (term == GravityTerm::kNone) {
+    variance(3) = 0.0;
+  }
+  m_rls.Reset(variance);
+  m_hasLast = false;
+}
+
+bool FeedforwardEstimator::Update(double timestamp, double voltage,
+                                  double position, double velocity) {
+  bool hasLast = m_hasLast;
+  double dt = timestamp - m_lastTimestamp;
+  double lastPosition = m_lastPosition;
+  double lastVelocity = m_lastVelocity;
+  m_hasLast = true;
+  m_lastTimestamp = timestamp;
+  m_lastPosition = position;
+  m_lastVelocity = velocity;
+
+  if (!hasLast || dt <= 0.0 || dt > kMaxPeriod) {
+    return false;
+  }
+
+  // Static friction makes the model discontinuous at rest, so only samples
+  // where the mechanism keeps moving in one direction are used.
+  if (std::abs(lastVelocity) < m_motionThreshold ||
+      std::abs(velocity) < m_motionThreshold ||
+      (lastVelocity > 0) != (velocity > 0)) {
+    return false;
+  }
+
+  // The voltage was applied between the samples, so the acceleration is
+  // regressed on the state in the middle of them.
+  double midVelocity = (lastVelocity + velocity) / 2;
+  double gravity = 0.0;
+  if (m_term == GravityTerm::kConstant) {
+    gravity = 1.0;
+  } else if (m_term == GravityTerm::kCosine) {
+    gravity = std::cos((lastPosition + position) / 2 * m_radiansPerRotation);
+  }
+
+  RecursiveLeastSquares<kGainCount>::Vector x;
+  x << midVelocity, voltage, std::copysign(1.0, midVelocity), gravity;
+  m_rls.Update(x, (velocity - lastVelocity) / dt);
+  return true;
+}
+
+FeedforwardEstimator::Gains FeedforwardEstimator::GetGains() const {
+  const auto& coeffs = m_rls.GetCoefficients();
+  double alpha = coeffs(0);  // -Kv/Ka
+  double beta = coeffs(1);   // 1/Ka
+  double gamma = coeffs(2);  // -Ks/Ka
+  double delta = coeffs(3);  // -Kg/Ka
+
+  Gains gains = Gains::Zero();
+  if (beta != 0.0) {
+    gains << -gamma / beta, -alpha / beta, 1 / beta, -delta / beta;
+  }
+  return gains;
+}
+
+FeedforwardEstimator::Covariance FeedforwardEstimator::GetGainCovariance()
+    const {
+  const auto& coeffs = m_rls.GetCoefficients();
+  double alpha = coeffs(0);
+  double beta = coeffs(1);
+  double gamma = coeffs(2);
+  double delta = coeffs(3);
+  if (beta == 0.0) {
+    return Covariance::Zero();
+  }
+
+  // The Jacobian of the gains with respect to the coefficients.
+  double beta2 = beta * beta;
+  Covariance J;
+  J << 0, gamma / beta2, -1 / beta, 0,  //
+      -1 / beta, alpha / beta2, 0, 0,   //
+      0, -1 / beta2, 0, 0,              //
+      0, delta / beta2, 0, -1 / beta;
+  return J * m_rls.GetCovariance() * J.transpose();
+}
@@ -4,6 +4,7 @@
 
 #include "sysid/generation/SysIdSetup.h"
 
+#include <memory>
 #include <stdexcept>
 
 #include <CANVenom.h>
@@ -11,6 +12,7 @@
 #include <frc/ADXRS450_Gyro.h>
 #include <frc/AnalogGyro.h>
 #include <frc/Filesystem.h>
+#include <frc/RobotController.h>
 #include <frc/TimedRobot.h>
 #include <frc/motorcontrol/Spark.h>
 #include <frc/romi/RomiGyro.h>
@@ -453,6 +455,78 @@ void SetupGyro(
   }
 }
 
+void SetupMotorChannel(std::string_view controllerName,
+                       frc::MotorController* controller, double gearing,
+                       MotorChannel* channel) {
+  // Channels that can't be measured report zero.
+  channel->position = [] { return 0.0; };
+  channel->velocity = [] { return 0.0; };
+  channel->current = [] { return 0.0; };
+  channel->appliedVoltage = [=] {
+    return controller->Get() *
+           frc::RobotController::GetBatteryVoltage().value();
+  };
+
+  if (wpi::starts_with(controllerName, "Talon") ||
+      controllerName == "VictorSPX") {
+    auto* ctreController = dynamic_cast<WPI_BaseMotorController*>(controller);
+    channel->appliedVoltage = [=] {
+      return ctreController->GetMotorOutputVoltage();
+    };
+
+    if (controllerName == "TalonFX") {
+      fmt::print("Setup TalonFX motor channel");
+      auto* talonFX = static_cast<WPI_TalonFX*>(controller);
+      // The integrated sensor has 2048 counts per rotation and reports
+      // velocity in counts per 100 ms.
+      double combinedCPR = 2048 * gearing;
+      channel->position = [=] {
+        return talonFX->GetSensorCollection().GetIntegratedSensorPosition() /
+               combinedCPR;
+      };
+      channel->velocity = [=] {
+        return talonFX->GetSensorCollection().GetIntegratedSensorVelocity() /
+               combinedCPR / 0.1;
+      };
+      channel->current = [=] { return talonFX->GetStatorCurrent(); };
+    } else if (controllerName == "TalonSRX") {
+      fmt::print("Setup TalonSRX motor channel");
+      auto* talonSRX = static_cast<WPI_TalonSRX*>(controller);
+      channel->current = [=] { return talonSRX->GetStatorCurrent(); };
+    } else {
+      fmt::print("Setup VictorSPX motor channel");
+    }
+  } else if (wpi::starts_with(controllerName, "SPARK MAX")) {
+    auto* sparkMax = static_cast<rev::CANSparkMax*>(controller);
+    if (controllerName == "SPARK MAX (Brushless)") {
+      fmt::print("Setup SPARK MAX (Brushless) motor channel");
+      auto encoder =
+          std::make_shared<rev::SparkMaxRelativeEncoder>(sparkMax->GetEncoder(
+              rev::SparkMaxRelativeEncoder::Type::kHallSensor));
+      channel->position = [=] { return encoder->GetPosition() / gearing; };
+      channel->velocity = [=] { return encoder->GetVelocity() / gearing / 60; };
+    } else {
+      fmt::print("Setup SPARK MAX (Brushed) motor channel");
+    }
+    channel->current = [=] { return sparkMax->GetOutputCurrent(); };
+    channel->appliedVoltage = [=] {
+      return sparkMax->GetAppliedOutput() * sparkMax->GetBusVoltage();
+    };
+  } else if (controllerName == "Venom") {
+    fmt::print("Setup Venom motor channel");
+    auto* venom = static_cast<frc::CANVenom*>(controller);
+    channel->position = [=] { return venom->GetPosition() / gearing; };
+    channel->velocity = [=] {
+      return venom->GetSpeed() / gearing /
+             60;  // Conversion from RPM to rotations per second
+    };
+    channel->current = [=] { return venom->GetOutputCurrent(); };
+    channel->appliedVoltage = [=] { return venom->GetOutputVoltage(); };
+  } else {
+    fmt::print("Setup PWM motor channel");
+  }
+}
+
 void SetMotorControllers(
     units::volt_t motorVoltage,
     const std::vector<std::unique_ptr<frc::MotorController>>& controllers) {
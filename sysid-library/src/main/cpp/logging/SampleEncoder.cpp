@@ -0,0 +1,120 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/logging/SampleEncoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+using namespace sysid;
+
+// The largest number of bytes of a varint.
+static constexpr size_t kMaxVarintSize = 10;
+
+/**
+ * Rounds a value to a multiple of a quantum. Values that aren't finite are
+ * stored as 0.
+ */
+static int64_t Quantize(double value, double quantum) {
+  double scaled = std::round(value / quantum);
+  if (!std::isfinite(scaled)) {
+    return 0;
+  }
+  return static_cast<int64_t>(std::clamp(scaled, -9.0e18, 9.0e18));
+}
+
+/**
+ * Appends a signed value as a zigzag varint.
+ */
+static void AppendVarint(std::string& data, int64_t value) {
+  uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^
+                    static_cast<uint64_t>(value >> 63);
+  while (zigzag >= 0x80) {
+    data.push_back(static_cast<char>((zigzag & 0x7f) | 0x80));
+    zigzag >>= 7;
+  }
+  data.push_back(static_cast<char>(zigzag));
+}
+
+void SampleEncoder::Reset(std::vector<SampleColumn> columns, size_t capacity) {
+  m_columns = std::move(columns);
+  m_capacity = capacity;
+  m_data.reserve(m_capacity);
+  Clear();
+}
+
+void SampleEncoder::Clear() {
+  m_data.clear();
+  m_last.assign(m_columns.size(), 0);
+  m_sampleCount = 0;
+
+  // Write the header.
+  m_data.append({'S', 'Y', static_cast<char>(kVersion),
+                 static_cast<char>(m_columns.size())});
+  for (auto&& column : m_columns) {
+    m_data.push_back(static_cast<char>(column.type));
+    if (column.type == SampleColumnType::kScaled) {
+      static_assert(std::numeric_limits<double>::is_iec559);
+      uint64_t bits;
+      std::memcpy(&bits, &column.quantum, sizeof(bits));
+      for (int i = 0; i < 8; ++i) {
+        m_data.push_back(static_cast<char>(bits >> (8 * i)));
+      }
+    }
+  }
+}
+
+std::string SampleEncoder::TakeData(std::string buffer) {
+  m_data.swap(buffer);
+  m_data.reserve(m_capacity);
+  Clear();
+  return buffer;
+}
+
+void SampleEncoder::Release() {
+  m_columns.clear();
+  m_last.clear();
+  m_capacity = 0;
+  m_sampleCount = 0;
+  std::string{}.swap(m_data);
+}
+
+bool SampleEncoder::Add(wpi::span<const double> sample) {
+  if (sample.size() != m_columns.size() ||
+      m_data.size() + m_columns.size() * kMaxVarintSize > m_capacity) {
+    return false;
+  }
+
+  for (size_t i = 0; i < m_columns.size(); ++i) {
+    switch (m_columns[i].type) {
+      case SampleColumnType::kTimestamp: {
+        int64_t ticks = Quantize(sample[i], kTimestampQuantum);
+        AppendVarint(m_data, ticks - m_last[i]);
+        m_last[i] = ticks;
+        break;
+      }
+      case SampleColumnType::kVoltage: {
+        auto millivolts = static_cast<int16_t>(
+            std::clamp<int64_t>(Quantize(sample[i], kVoltageQuantum),
+                                std::numeric_limits<int16_t>::min(),
+                                std::numeric_limits<int16_t>::max()));
+        auto bits = static_cast<uint16_t>(millivolts);
+        m_data.push_back(static_cast<char>(bits));
+        m_data.push_back(static_cast<char>(bits >> 8));
+        break;
+      }
+      case SampleColumnType::kScaled: {
+        int64_t value = Quantize(sample[i], m_columns[i].quantum);
+        AppendVarint(m_data, value - m_last[i]);
+        m_last[i] = value;
+        break;
+      }
+    }
+  }
+  ++m_sampleCount;
+  return true;
+}
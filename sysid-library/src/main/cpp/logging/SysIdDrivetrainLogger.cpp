@@ -20,17 +20,22 @@ void SysIdDrivetrainLogger::Log(double leftPosition, double rightPosition,
                                 double leftVelocity, double rightVelocity,
                                 double measuredAngle, double angularRate) {
   UpdateData();
-  if (m_data.size() < kDataVectorSize) {
-    std::array<double, 9> arr = {m_timestamp,
-                                 m_primaryMotorVoltage.value(),
-                                 m_secondaryMotorVoltage.value(),
-                                 leftPosition,
-                                 rightPosition,
-                                 leftVelocity,
-                                 rightVelocity,
-                                 measuredAngle,
-                                 angularRate};
-    m_data.insert(m_data.end(), arr.cbegin(), arr.cend());
+  std::array<double, 9> arr = {m_timestamp,
+                               m_primaryMotorVoltage.value(),
+                               m_secondaryMotorVoltage.value(),
+                               leftPosition,
+                               rightPosition,
+                               leftVelocity,
+                               rightVelocity,
+                               measuredAngle,
+                               angularRate};
+  AddSample(arr);
+
+  // Only linear tests fit the model that the estimate is for.
+  if (m_mechanism == "Drivetrain" && !m_rotate) {
+    UpdateEstimate(
+        (m_primaryMotorVoltage + m_secondaryMotorVoltage).value() / 2,
+        (leftPosition + rightPosition) / 2, (leftVelocity + rightVelocity) / 2);
   }
 
   m_primaryMotorVoltage = units::volt_t{(m_rotate ? -1 : 1) * m_motorVoltage};
@@ -43,6 +48,18 @@ void SysIdDrivetrainLogger::Reset() {
   m_secondaryMotorVoltage = 0_V;
 }
 
+std::vector<SampleColumn> SysIdDrivetrainLogger::GetColumns() const {
+  return {{SampleColumnType::kTimestamp},
+          {SampleColumnType::kVoltage},
+          {SampleColumnType::kVoltage},
+          {SampleColumnType::kScaled, kPositionQuantum},
+          {SampleColumnType::kScaled, kPositionQuantum},
+          {SampleColumnType::kScaled, kVelocityQuantum},
+          {SampleColumnType::kScaled, kVelocityQuantum},
+          {SampleColumnType::kScaled, kGyroQuantum},
+          {SampleColumnType::kScaled, kGyroQuantum}};
+}
+
 bool SysIdDrivetrainLogger::IsWrongMechanism() const {
   return m_mechanism != "Drivetrain" && m_mechanism != "Drivetrain (Angular)";
 }
@@ -15,11 +15,11 @@ units::volt_t SysIdGeneralMechanismLogger::GetMotorVoltage() const {
 void SysIdGeneralMechanismLogger::Log(double measuredPosition,
                                       double measuredVelocity) {
   UpdateData();
-  if (m_data.size() < kDataVectorSize) {
-    std::array<double, 4> arr = {m_timestamp, m_primaryMotorVoltage.value(),
-                                 measuredPosition, measuredVelocity};
-    m_data.insert(m_data.end(), arr.cbegin(), arr.cend());
-  }
+  std::array<double, 4> arr = {m_timestamp, m_primaryMotorVoltage.value(),
+                               measuredPosition, measuredVelocity};
+  AddSample(arr);
+  UpdateEstimate(m_primaryMotorVoltage.value(), measuredPosition,
+                 measuredVelocity);
 
   m_primaryMotorVoltage = units::volt_t{m_motorVoltage};
 }
@@ -29,6 +29,13 @@ void SysIdGeneralMechanismLogger::Reset() {
   m_primaryMotorVoltage = 0_V;
 }
 
+std::vector<SampleColumn> SysIdGeneralMechanismLogger::GetColumns() const {
+  return {{SampleColumnType::kTimestamp},
+          {SampleColumnType::kVoltage},
+          {SampleColumnType::kScaled, kPositionQuantum},
+          {SampleColumnType::kScaled, kVelocityQuantum}};
+}
+
 bool SysIdGeneralMechanismLogger::IsWrongMechanism() const {
   return m_mechanism != "Arm" && m_mechanism != "Elevator" &&
          m_mechanism != "Simple";
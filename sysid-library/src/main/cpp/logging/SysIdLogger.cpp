@@ -4,9 +4,10 @@
 
 #include "sysid/logging/SysIdLogger.h"
 
+#include <array>
 #include <cstddef>
-#include <sstream>
 #include <stdexcept>
+#include <utility>
 
 #include <fmt/core.h>
 #include <frc/Notifier.h>
@@ -15,6 +16,8 @@
 #include <frc/Timer.h>
 #include <frc/livewindow/LiveWindow.h>
 #include <frc/smartdashboard/SmartDashboard.h>
+#include <networktables/NetworkTableInstance.h>
+#include <ntcore_cpp.h>
 
 using namespace sysid;
 
@@ -29,24 +32,76 @@ void SysIdLogger::InitLogging() {
   m_rotate = frc::SmartDashboard::GetBoolean("SysIdRotate", false);
   m_voltageCommand = frc::SmartDashboard::GetNumber("SysIdVoltageCommand", 0.0);
   m_startTime = frc::Timer::GetFPGATimestamp().value();
-  m_data.clear();
-}
+  m_overflow = false;
 
-void SysIdLogger::SendData() {
-  fmt::print("Collected: {} data points.\n", m_data.size());
-
-  frc::SmartDashboard::PutBoolean("SysIdOverflow",
-                                  m_data.size() >= kDataVectorSize);
+  // The tests of a mechanism refine the same estimate.
+  if (m_mechanism != m_estimateMechanism) {
+    m_estimator.Reset(FeedforwardEstimator::GetGravityTerm(m_mechanism));
+    m_estimateMechanism = m_mechanism;
+    PublishEstimate();
+  }
 
-  std::stringstream ss;
-  for (size_t i = 0; i < m_data.size(); ++i) {
-    ss << std::to_string(m_data[i]);
-    if (i < m_data.size() - 1) {
-      ss << ",";
+  // Stream the samples in chunks if SysId asks for them.
+  m_stream = frc::SmartDashboard::GetBoolean("SysIdStream", false);
+  m_chunk.clear();
+  m_chunkSamples = 0;
+  m_streamed = 0;
+  m_lastChunk = m_startTime;
+
+  // Packed samples use the memory of the unpacked ones, which holds several
+  // times as many samples. Only switching between them allocates, since the
+  // spare buffers are handed back once their data is sent.
+  bool wasPacked = m_packed;
+  m_packed = frc::SmartDashboard::GetBoolean("SysIdPacked", false) &&
+             !GetColumns().empty();
+  size_t packedCapacity = m_dataCapacity * sizeof(double);
+  if (m_packed) {
+    if (!wasPacked) {
+      std::vector<double>{}.swap(m_data);
+      std::vector<double>{}.swap(m_spare);
+      m_publisher.TakeBuffer();
+      m_packedSpare.reserve(packedCapacity);
     }
+    m_encoder.Reset(GetColumns(), packedCapacity);
+  } else {
+    if (wasPacked) {
+      m_encoder.Release();
+      std::string{}.swap(m_packedSpare);
+      m_publisher.TakePackedBuffer();
+      m_spare.reserve(m_dataCapacity);
+    }
+    m_data.clear();
+    m_data.reserve(m_dataCapacity);
   }
+}
 
-  frc::SmartDashboard::PutString("SysIdTelemetry", ss.str());
+void SysIdLogger::SendData() {
+  PublishEstimate();
+  PublishChunk();
+
+  // Hand the data to the publisher thread, which encodes and sends it while
+  // the robot thread goes on.
+  TelemetryPublisher::Upload upload;
+  upload.overflow = m_overflow;
+  upload.packed = m_packed;
+  // The next test logs into the spare buffer while this one is sent. If the
+  // data of the last test is still being sent, there's no spare buffer and a
+  // new one is allocated.
+  if (m_packed) {
+    if (m_packedSpare.capacity() < m_dataCapacity * sizeof(double)) {
+      m_packedSpare = m_publisher.TakePackedBuffer();
+    }
+    upload.samples = m_encoder.GetSampleCount();
+    upload.packedData = m_encoder.TakeData(std::move(m_packedSpare));
+    m_packedSpare.clear();
+  } else {
+    if (m_spare.capacity() < m_dataCapacity) {
+      m_spare = m_publisher.TakeBuffer();
+    }
+    upload.data.swap(m_data);
+    m_data.swap(m_spare);
+  }
+  m_publisher.Send(std::move(upload));
 
   Reset();
 }
@@ -62,7 +117,8 @@ void SysIdLogger::UpdateThreadPriority() {
 
 SysIdLogger::SysIdLogger() {
   fmt::print("Initializing logger\n");
-  m_data.reserve(kDataVectorSize);
+  SetDataCapacity(kDataVectorSize);
+  m_chunk.reserve(kChunkCapacity);
   frc::LiveWindow::DisableAllTelemetry();
   frc::SmartDashboard::PutNumber("SysIdVoltageCommand", 0.0);
   frc::SmartDashboard::PutString("SysIdTestType", "");
@@ -70,6 +126,32 @@ SysIdLogger::SysIdLogger() {
   frc::SmartDashboard::PutBoolean("SysIdRotate", false);
   frc::SmartDashboard::PutBoolean("SysIdOverflow", false);
   frc::SmartDashboard::PutBoolean("SysIdWrongMech", false);
+  frc::SmartDashboard::PutNumber("SysIdMotorCount", 0);
+  frc::SmartDashboard::PutBoolean("SysIdPacked", false);
+  frc::SmartDashboard::PutBoolean("SysIdStream", false);
+  frc::SmartDashboard::PutBoolean("SysIdSending", false);
+  frc::SmartDashboard::PutNumber("SysIdSendProgress", 0.0);
+  PublishEstimate();
+
+  // Echo the pings of SysId with the FPGA timestamp as soon as they arrive so
+  // that it can line up its clock with the timestamps of the data.
+  auto inst = nt::NetworkTableInstance::GetDefault();
+  auto table = inst.GetTable("SmartDashboard");
+  m_pingListener = table->GetEntry("SysIdPing").AddListener(
+      [inst, pong = table->GetEntry("SysIdPong")](
+          const nt::EntryNotification& event) mutable {
+        if (event.value && event.value->IsDouble()) {
+          std::array<double, 2> echo{event.value->GetDouble(),
+                                     frc::Timer::GetFPGATimestamp().value()};
+          pong.SetDoubleArray(echo);
+          inst.Flush();
+        }
+      },
+      NT_NOTIFY_NEW | NT_NOTIFY_UPDATE);
+}
+
+SysIdLogger::~SysIdLogger() {
+  nt::RemoveEntryListener(m_pingListener);
 }
 
 void SysIdLogger::UpdateData() {
@@ -89,9 +171,82 @@ void SysIdLogger::UpdateData() {
   }
 }
 
+void SysIdLogger::SetDataCapacity(size_t capacity) {
+  m_dataCapacity = capacity;
+  m_data.reserve(m_dataCapacity);
+  m_spare.reserve(m_dataCapacity);
+}
+
 void SysIdLogger::Reset() {
   m_motorVoltage = 0.0;
   m_timestamp = 0.0;
   m_startTime = 0.0;
   m_data.clear();
+  m_encoder.Clear();
+  m_chunk.clear();
+  m_chunkSamples = 0;
+}
+
+bool SysIdLogger::AddSample(wpi::span<const double> sample) {
+  bool added;
+  if (m_packed) {
+    added = m_encoder.Add(sample);
+  } else {
+    added = m_data.size() + sample.size() <= m_dataCapacity;
+    if (added) {
+      m_data.insert(m_data.end(), sample.begin(), sample.end());
+    }
+  }
+  m_overflow = m_overflow || !added;
+
+  if (added && m_stream) {
+    if (m_chunk.empty()) {
+      m_chunk.push_back(m_streamed);
+    }
+    m_chunk.insert(m_chunk.end(), sample.begin(), sample.end());
+    ++m_chunkSamples;
+    if (m_timestamp - m_lastChunk >= kChunkPeriod) {
+      PublishChunk();
+    }
+  }
+  return added;
+}
+
+void SysIdLogger::UpdateEstimate(double voltage, double position,
+                                 double velocity) {
+  m_estimator.Update(m_timestamp, voltage, position, velocity);
+  if (m_timestamp - m_lastEstimatePublish >= kEstimatePeriod) {
+    PublishEstimate();
+    m_lastEstimatePublish = m_timestamp;
+  }
+}
+
+void SysIdLogger::PublishEstimate() {
+  auto gains = m_estimator.GetGains();
+  auto covariance = m_estimator.GetGainCovariance();
+  frc::SmartDashboard::PutNumberArray(
+      "SysIdEstimate", wpi::span<const double>(gains.data(), gains.size()));
+
+  // The covariance is symmetric, so its storage order doesn't matter.
+  frc::SmartDashboard::PutNumberArray(
+      "SysIdEstimateCovariance",
+      wpi::span<const double>(covariance.data(), covariance.size()));
+  frc::SmartDashboard::PutNumber("SysIdEstimateSamples",
+                                 m_estimator.GetCount());
+}
+
+void SysIdLogger::PublishChunk() {
+  if (m_chunkSamples == 0) {
+    return;
+  }
+  frc::SmartDashboard::PutNumberArray("SysIdTelemetryChunk", m_chunk);
+
+  // Send the chunk right away, since NetworkTables only sends the latest value
+  // of an entry.
+  nt::NetworkTableInstance::GetDefault().Flush();
+
+  m_streamed += m_chunkSamples;
+  m_chunk.clear();
+  m_chunkSamples = 0;
+  m_lastChunk = m_timestamp;
 }
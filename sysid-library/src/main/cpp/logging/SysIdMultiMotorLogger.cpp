@@ -0,0 +1,68 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/logging/SysIdMultiMotorLogger.h"
+
+#include <algorithm>
+
+#include <frc/smartdashboard/SmartDashboard.h>
+
+using namespace sysid;
+
+SysIdMultiMotorLogger::SysIdMultiMotorLogger(size_t motorCount)
+    : m_motorCount(motorCount) {
+  // Without motor channels, the samples are as narrow as those of the general
+  // mechanism logger, which keeps its larger buffer.
+  SetDataCapacity(std::max(
+      kDataVectorSize, kMaxSamples * (4 + kMotorChannelSize * m_motorCount)));
+  m_sample.reserve(4 + kMotorChannelSize * m_motorCount);
+  frc::SmartDashboard::PutNumber("SysIdMotorCount", m_motorCount);
+}
+
+units::volt_t SysIdMultiMotorLogger::GetMotorVoltage() const {
+  return m_primaryMotorVoltage;
+}
+
+void SysIdMultiMotorLogger::Log(double measuredPosition,
+                                double measuredVelocity,
+                                wpi::span<const MotorSample> motors) {
+  UpdateData();
+  m_sample.assign({m_timestamp, m_primaryMotorVoltage.value(),
+                   measuredPosition, measuredVelocity});
+  for (size_t i = 0; i < m_motorCount; ++i) {
+    MotorSample sample = i < motors.size() ? motors[i] : MotorSample{};
+    m_sample.insert(m_sample.end(), {sample.position, sample.velocity,
+                                     sample.current, sample.appliedVoltage});
+  }
+  AddSample(m_sample);
+  UpdateEstimate(m_primaryMotorVoltage.value(), measuredPosition,
+                 measuredVelocity);
+
+  m_primaryMotorVoltage = units::volt_t{m_motorVoltage};
+}
+
+void SysIdMultiMotorLogger::Reset() {
+  SysIdLogger::Reset();
+  m_primaryMotorVoltage = 0_V;
+}
+
+std::vector<SampleColumn> SysIdMultiMotorLogger::GetColumns() const {
+  std::vector<SampleColumn> columns = {
+      {SampleColumnType::kTimestamp},
+      {SampleColumnType::kVoltage},
+      {SampleColumnType::kScaled, kPositionQuantum},
+      {SampleColumnType::kScaled, kVelocityQuantum}};
+  for (size_t i = 0; i < m_motorCount; ++i) {
+    columns.push_back({SampleColumnType::kScaled, kPositionQuantum});
+    columns.push_back({SampleColumnType::kScaled, kVelocityQuantum});
+    columns.push_back({SampleColumnType::kScaled, kCurrentQuantum});
+    columns.push_back({SampleColumnType::kVoltage});
+  }
+  return columns;
+}
+
+bool SysIdMultiMotorLogger::IsWrongMechanism() const {
+  return m_mechanism != "Arm" && m_mechanism != "Elevator" &&
+         m_mechanism != "Simple";
+}
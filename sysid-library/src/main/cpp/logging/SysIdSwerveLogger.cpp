@@ -0,0 +1,58 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/logging/SysIdSwerveLogger.h"
+
+using namespace sysid;
+
+units::volt_t SysIdSwerveLogger::GetMotorVoltage() const {
+  return m_primaryMotorVoltage;
+}
+
+bool SysIdSwerveLogger::IsSteerTest() const {
+  return m_mechanism == "Swerve Steer";
+}
+
+void SysIdSwerveLogger::Log(const std::array<double, kModules>& positions,
+                            const std::array<double, kModules>& velocities) {
+  UpdateData();
+  std::array<double, 2 + 2 * kModules> arr;
+  arr[0] = m_timestamp;
+  arr[1] = m_primaryMotorVoltage.value();
+  for (size_t i = 0; i < kModules; ++i) {
+    arr[2 + 2 * i] = positions[i];
+    arr[3 + 2 * i] = velocities[i];
+  }
+  AddSample(arr);
+
+  // The modules share a voltage, so the estimate is for the mean module.
+  double position = 0.0;
+  double velocity = 0.0;
+  for (size_t i = 0; i < kModules; ++i) {
+    position += positions[i] / kModules;
+    velocity += velocities[i] / kModules;
+  }
+  UpdateEstimate(m_primaryMotorVoltage.value(), position, velocity);
+
+  m_primaryMotorVoltage = units::volt_t{m_motorVoltage};
+}
+
+void SysIdSwerveLogger::Reset() {
+  SysIdLogger::Reset();
+  m_primaryMotorVoltage = 0_V;
+}
+
+std::vector<SampleColumn> SysIdSwerveLogger::GetColumns() const {
+  std::vector<SampleColumn> columns = {{SampleColumnType::kTimestamp},
+                                       {SampleColumnType::kVoltage}};
+  for (size_t i = 0; i < kModules; ++i) {
+    columns.push_back({SampleColumnType::kScaled, kPositionQuantum});
+    columns.push_back({SampleColumnType::kScaled, kVelocityQuantum});
+  }
+  return columns;
+}
+
+bool SysIdSwerveLogger::IsWrongMechanism() const {
+  return m_mechanism != "Swerve Drive" && m_mechanism != "Swerve Steer";
+}
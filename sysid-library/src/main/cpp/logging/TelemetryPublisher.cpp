@@ -0,0 +1,124 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "sysid/logging/TelemetryPublisher.h"
+
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+#include <fmt/format.h>
+#include <frc/smartdashboard/SmartDashboard.h>
+#include <networktables/NetworkTableInstance.h>
+
+using namespace sysid;
+
+TelemetryPublisher::TelemetryPublisher() {
+  m_thread = std::thread{[this] { Run(); }};
+}
+
+TelemetryPublisher::~TelemetryPublisher() {
+  {
+    std::scoped_lock lock{m_mutex};
+    m_running = false;
+  }
+  m_cv.notify_one();
+  m_thread.join();
+}
+
+void TelemetryPublisher::Send(Upload upload) {
+  {
+    // The flag is set under the lock so that it can't overwrite the flag of
+    // the publisher thread when the data was already sent. SysId waits longer
+    // for the data while it's being sent.
+    std::scoped_lock lock{m_mutex};
+    m_queue.push_back(std::move(upload));
+    m_sending = true;
+    frc::SmartDashboard::PutBoolean("SysIdSending", true);
+  }
+  m_cv.notify_one();
+}
+
+std::vector<double> TelemetryPublisher::TakeBuffer() {
+  std::scoped_lock lock{m_mutex};
+  return std::move(m_spare);
+}
+
+std::string TelemetryPublisher::TakePackedBuffer() {
+  std::scoped_lock lock{m_mutex};
+  return std::move(m_packedSpare);
+}
+
+bool TelemetryPublisher::IsSending() {
+  std::scoped_lock lock{m_mutex};
+  return m_sending;
+}
+
+void TelemetryPublisher::Run() {
+  std::unique_lock lock{m_mutex};
+  while (true) {
+    m_cv.wait(lock, [this] { return !m_queue.empty() || !m_running; });
+    if (m_queue.empty()) {
+      return;
+    }
+    auto upload = std::move(m_queue.front());
+    m_queue.pop_front();
+
+    // Send the data right away, since NetworkTables only sends the latest
+    // value of an entry.
+    lock.unlock();
+    Publish(upload);
+    nt::NetworkTableInstance::GetDefault().Flush();
+    lock.lock();
+
+    // Keep the largest buffers for the next test.
+    if (upload.data.capacity() > m_spare.capacity()) {
+      upload.data.clear();
+      m_spare = std::move(upload.data);
+    }
+    if (upload.packedData.capacity() > m_packedSpare.capacity()) {
+      upload.packedData.clear();
+      m_packedSpare = std::move(upload.packedData);
+    }
+    if (m_queue.empty()) {
+      m_sending = false;
+      frc::SmartDashboard::PutBoolean("SysIdSending", false);
+    }
+  }
+}
+
+void TelemetryPublisher::Publish(Upload& upload) {
+  frc::SmartDashboard::PutNumber("SysIdSendProgress", 0.0);
+
+  // The overflow flag goes with the data of its test.
+  frc::SmartDashboard::PutBoolean("SysIdOverflow", upload.overflow);
+
+  if (upload.packed) {
+    fmt::print("Collected: {} samples packed into {} bytes.\n", upload.samples,
+               upload.packedData.size());
+    frc::SmartDashboard::PutRaw("SysIdTelemetryPacked", upload.packedData);
+    frc::SmartDashboard::PutNumber("SysIdSendProgress", 1.0);
+    return;
+  }
+
+  const auto& data = upload.data;
+  fmt::print("Collected: {} data points.\n", data.size());
+
+  // Format the values like std::to_string() without going through a stream.
+  fmt::memory_buffer buffer;
+  buffer.reserve(data.size() * 12);
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (i > 0) {
+      buffer.push_back(',');
+    }
+    fmt::format_to(std::back_inserter(buffer), "{:f}", data[i]);
+    if ((i + 1) % kProgressStride == 0) {
+      frc::SmartDashboard::PutNumber(
+          "SysIdSendProgress", static_cast<double>(i + 1) / data.size());
+    }
+  }
+  frc::SmartDashboard::PutString(
+      "SysIdTelemetry", std::string_view{buffer.data(), buffer.size()});
+  frc::SmartDashboard::PutNumber("SysIdSendProgress", 1.0);
+}
@@ -0,0 +1,145 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include <Eigen/Core>
+#include <wpi/numbers>
+
+#include "sysid/estimation/RecursiveLeastSquares.h"
+
+namespace sysid {
+
+/**
+ * The gravity term of a mechanism's feedforward model.
+ */
+enum class GravityTerm {
+  /**
+   * No gravity (flywheels, turrets, and drivetrains).
+   */
+  kNone,
+
+  /**
+   * A constant voltage (elevators): Kg.
+   */
+  kConstant,
+
+  /**
+   * A voltage proportional to the cosine of the position (arms): Kcos.
+   */
+  kCosine
+};
+
+/**
+ * Estimates the feedforward gains of a mechanism while it moves, from the
+ * samples that the logger records:
+ *
+ * V = Ks sgn(v) + Kv v + Ka a + Kg (or Kcos cos(θ))
+ *
+ * Like the analysis, the acceleration is regressed on the velocity, voltage,
+ * and friction (a = αv + βV + γ sgn(v) + δ), and the gains are computed from
+ * the coefficients. Each update is a fixed-size recursive least-squares step
+ * that takes a few microseconds.
+ *
+ * Positions and velocities are in rotations, like the logger's, so the gains
+ * are per rotation.
+ */
+class FeedforwardEstimator {
+ public:
+  /**
+   * The number of gains: Ks, Kv, Ka, and the gravity gain (which is zero if
+   * the mechanism has no gravity term).
+   */
+  static constexpr int kGainCount = 4;
+
+  using Gains = Eigen::Matrix<double, kGainCount, 1>;
+  using Covariance = Eigen::Matrix<double, kGainCount, kGainCount>;
+
+  /**
+   * Creates an estimator.
+   *
+   * @param term             The gravity term of the mechanism.
+   * @param forgettingFactor The weight of the past samples at each update,
+   *                         between 0 and 1. Use 1 to estimate the gains of a
+   *                         test and less (e.g. 0.999) to track gains that
+   *                         drift over a match.
+   */
+  explicit FeedforwardEstimator(GravityTerm term = GravityTerm::kNone,
+                                double forgettingFactor = 1.0);
+
+  /**
+   * Returns the gravity term of the mechanism with a given name (e.g. "Arm").
+   */
+  static GravityTerm GetGravityTerm(std::string_view mechanism);
+
+  /**
+   * Forgets all samples.
+   *
+   * @param term The gravity term of the mechanism.
+   */
+  void Reset(GravityTerm term);
+
+  /**
+   * Adds a sample. Samples are skipped while the mechanism is at rest or
+   * changes direction, and the first sample after a gap only starts a new
+   * run of samples.
+   *
+   * @param timestamp The time of the sample in seconds.
+   * @param voltage   The voltage that was applied since the last sample.
+   * @param position  The position in rotations.
+   * @param velocity  The velocity in rotations per second.
+   * @return Whether the estimate was updated.
+   */
+  bool Update(double timestamp, double voltage, double position,
+              double velocity);
+
+  /**
+   * Returns the estimated gains: Ks, Kv, Ka, and the gravity gain.
+   */
+  Gains GetGains() const;
+
+  /**
+   * Returns the estimated covariance of the gains, linearized around the
+   * current estimate.
+   */
+  Covariance GetGainCovariance() const;
+
+  /**
+   * Returns the number of samples that the estimate is based on.
+   */
+  size_t GetCount() const { return m_rls.GetCount(); }
+
+  /**
+   * Sets the velocity below which the mechanism is considered at rest, in
+   * rotations per second.
+   */
+  void SetMotionThreshold(double threshold) { m_motionThreshold = threshold; }
+
+  /**
+   * Sets the radians per rotation of the position, which the cosine term of
+   * arms needs. The position must be zero when the arm is horizontal.
+   */
+  void SetRadiansPerRotation(double radians) { m_radiansPerRotation = radians; }
+
+ private:
+  /**
+   * The longest time between samples that are differentiated, in seconds.
+   */
+  static constexpr double kMaxPeriod = 0.1;
+
+  GravityTerm m_term;
+  RecursiveLeastSquares<kGainCount> m_rls;
+  double m_motionThreshold = 0.01;
+  double m_radiansPerRotation = 2 * wpi::numbers::pi;
+
+  bool m_hasLast = false;
+  double m_lastTimestamp = 0.0;
+  double m_lastPosition = 0.0;
+  double m_lastVelocity = 0.0;
+};
+
+}  // namespace sysid
@@ -0,0 +1,117 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+
+#include <Eigen/Core>
+
+namespace sysid {
+
+/**
+ * Fits y = xᵀθ one sample at a time with exponential forgetting, without
+ * storing the samples. Every update takes a fixed amount of time and never
+ * allocates, so it can run in the robot loop.
+ *
+ * The covariance is only inflated by the forgetting factor while its trace
+ * stays below its initial trace, so it doesn't blow up while the samples
+ * don't excite every coefficient (e.g. while the mechanism is at rest).
+ *
+ * @tparam N The number of coefficients.
+ */
+template <int N>
+class RecursiveLeastSquares {
+ public:
+  using Vector = Eigen::Matrix<double, N, 1>;
+  using Matrix = Eigen::Matrix<double, N, N>;
+
+  /**
+   * Creates an estimator with all coefficients at zero.
+   *
+   * @param forgettingFactor The weight of the past samples at each update,
+   *                         between 0 and 1. Samples are never forgotten if
+   *                         it's 1.
+   * @param initialVariance  The initial variance of the coefficients, which
+   *                         should be large compared to their magnitude.
+   */
+  explicit RecursiveLeastSquares(double forgettingFactor = 1.0,
+                                 double initialVariance = 1e4)
+      : m_forgettingFactor{forgettingFactor} {
+    Reset(Vector::Constant(initialVariance));
+  }
+
+  /**
+   * Forgets all samples.
+   *
+   * @param initialVariance The initial variance of each coefficient. A
+   *                        coefficient with a variance of zero stays at zero.
+   */
+  void Reset(const Vector& initialVariance) {
+    m_coefficients.setZero();
+    m_P = initialVariance.asDiagonal();
+    m_maxTrace = m_P.trace();
+    m_residualSum = 0.0;
+    m_weight = 0.0;
+    m_count = 0;
+  }
+
+  /**
+   * Adds a sample.
+   *
+   * @param x The regressors of the sample.
+   * @param y The output of the sample.
+   */
+  void Update(const Vector& x, double y) {
+    Vector Px = m_P * x;
+    Vector gain = Px / (m_forgettingFactor + x.dot(Px));
+    double residual = y - x.dot(m_coefficients);
+    m_coefficients += gain * residual;
+
+    // Keep P symmetric so that rounding doesn't accumulate.
+    Matrix P = m_P - gain * Px.transpose();
+    P = 0.5 * (P + P.transpose());
+    if (P.trace() < m_maxTrace * m_forgettingFactor) {
+      P /= m_forgettingFactor;
+    }
+    m_P = P;
+
+    m_residualSum = m_forgettingFactor * m_residualSum + residual * residual;
+    m_weight = m_forgettingFactor * m_weight + 1.0;
+    ++m_count;
+  }
+
+  /**
+   * Returns the estimated coefficients.
+   */
+  const Vector& GetCoefficients() const { return m_coefficients; }
+
+  /**
+   * Returns the estimated covariance of the coefficients: the variance of
+   * the residuals scaled by the inverse of the (weighted) information matrix.
+   */
+  Matrix GetCovariance() const {
+    double variance = m_weight > 0.0 ? m_residualSum / m_weight : 0.0;
+    return variance * m_P;
+  }
+
+  /**
+   * Returns the number of samples that have been added since the last reset.
+   */
+  size_t GetCount() const { return m_count; }
+
+ private:
+  double m_forgettingFactor;
+  Vector m_coefficients;
+  Matrix m_P;
+  double m_maxTrace = 0.0;
+
+  // The weighted sum of the squared prior residuals and its total weight.
+  double m_residualSum = 0.0;
+  double m_weight = 0.0;
+
+  size_t m_count = 0;
+};
+
+}  // namespace sysid
@@ -24,6 +24,34 @@
 
 namespace sysid {
 
+/**
+ * Functions that read the per-motor telemetry channels of a single motor
+ * controller. Channels that the controller can't measure return zero.
+ */
+struct MotorChannel {
+  /**
+   * Returns the position of the motor's built-in encoder in rotations of the
+   * output.
+   */
+  std::function<double()> position;
+
+  /**
+   * Returns the velocity of the motor's built-in encoder in rotations of the
+   * output per second.
+   */
+  std::function<double()> velocity;
+
+  /**
+   * Returns the current drawn by the motor in amps.
+   */
+  std::function<double()> current;
+
+  /**
+   * Returns the voltage applied to the motor in volts.
+   */
+  std::function<double()> appliedVoltage;
+};
+
 wpi::json GetConfigJson();
 
 /**
@@ -54,6 +82,20 @@ void SetMotorControllers(
     units::volt_t motorVoltage,
     const std::vector<std::unique_ptr<frc::MotorController>>& controllers);
 
+/**
+ * Sets up the per-motor telemetry channels (built-in encoder, current, and
+ * applied voltage) of a motor controller.
+ *
+ * @param[in] controllerName The type of motor controller, should be one of the
+ *                           types supported by AddMotorController().
+ * @param[in] controller A pointer to the motor controller object.
+ * @param[in] gearing The gearing between the motor and the output.
+ * @param[out] channel The channel functions to set up.
+ */
+void SetupMotorChannel(std::string_view controllerName,
+                       frc::MotorController* controller, double gearing,
+                       MotorChannel* channel);
+
 /**
  * Sets up an encoder for data collection by settings a position and rate
  * function to report the right encoder values.
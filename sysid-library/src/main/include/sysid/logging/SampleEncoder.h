@@ -0,0 +1,144 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <wpi/span.h>
+
+namespace sysid {
+
+/**
+ * How a column of the samples is packed.
+ */
+enum class SampleColumnType : uint8_t {
+  /**
+   * A timestamp in seconds, stored as the change in microseconds (the
+   * resolution of the FPGA timestamp) since the last sample.
+   */
+  kTimestamp = 0,
+
+  /**
+   * A voltage, stored as millivolts in 16 bits.
+   */
+  kVoltage = 1,
+
+  /**
+   * Any other value, stored as the change in multiples of a quantum since the
+   * last sample.
+   */
+  kScaled = 2
+};
+
+/**
+ * A column of the samples.
+ */
+struct SampleColumn {
+  /**
+   * How the column is packed.
+   */
+  SampleColumnType type;
+
+  /**
+   * The resolution of scaled columns, which should be finer than the
+   * resolution of the sensor.
+   */
+  double quantum = 0.0;
+};
+
+/**
+ * Packs samples into a compact byte stream as they're logged.
+ *
+ * The stream starts with a header: the bytes 'S' 'Y', the format version (1),
+ * the number of columns, and for each column its type, followed by its
+ * quantum as a little-endian double if it's scaled. Each sample then stores
+ * its columns in order:
+ *
+ * - Timestamps and scaled values as zigzag varints of the change since the
+ *   last sample (the first sample stores the change from zero).
+ * - Voltages as little-endian int16 millivolts.
+ *
+ * Values are rounded to their resolution once, and the changes are taken
+ * between the rounded values, so the error of every value is at most half its
+ * resolution no matter how long the test runs.
+ */
+class SampleEncoder {
+ public:
+  /**
+   * The version of the format.
+   */
+  static constexpr uint8_t kVersion = 1;
+
+  /**
+   * The resolution of timestamps in seconds.
+   */
+  static constexpr double kTimestampQuantum = 1e-6;
+
+  /**
+   * The resolution of voltages in volts.
+   */
+  static constexpr double kVoltageQuantum = 1e-3;
+
+  /**
+   * Discards the samples and sets up the encoder for new ones.
+   *
+   * @param columns  The columns of each sample.
+   * @param capacity The largest size of the stream in bytes. The memory is
+   *                 reserved up front so that logging never allocates.
+   */
+  void Reset(std::vector<SampleColumn> columns, size_t capacity);
+
+  /**
+   * Discards the samples but keeps the columns and the memory.
+   */
+  void Clear();
+
+  /**
+   * Releases the memory of the stream.
+   */
+  void Release();
+
+  /**
+   * Adds a sample.
+   *
+   * @param sample The values of the sample, one for each column.
+   * @return False if the sample doesn't fit in the capacity (it's dropped).
+   */
+  bool Add(wpi::span<const double> sample);
+
+  /**
+   * Returns the stream.
+   */
+  std::string_view GetData() const { return m_data; }
+
+  /**
+   * Moves the stream out and continues in the memory of the given buffer, so
+   * that the stream can be sent while new samples are added. The samples are
+   * discarded like Clear(). Doesn't allocate if the buffer's capacity is at
+   * least that of the encoder.
+   *
+   * @param buffer The memory for the next samples.
+   * @return The stream.
+   */
+  std::string TakeData(std::string buffer);
+
+  /**
+   * Returns the number of samples in the stream.
+   */
+  size_t GetSampleCount() const { return m_sampleCount; }
+
+ private:
+  std::vector<SampleColumn> m_columns;
+  std::vector<int64_t> m_last;
+  std::string m_data;
+  size_t m_capacity = 0;
+  size_t m_sampleCount = 0;
+};
+
+}  // namespace sysid
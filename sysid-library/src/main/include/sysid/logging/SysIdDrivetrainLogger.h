@@ -53,6 +53,8 @@ class SysIdDrivetrainLogger : public SysIdLogger {
 
   bool IsWrongMechanism() const override;
 
+  std::vector<SampleColumn> GetColumns() const override;
+
  private:
   units::volt_t m_primaryMotorVoltage = 0_V;
   units::volt_t m_secondaryMotorVoltage = 0_V;
@@ -38,6 +38,8 @@ class SysIdGeneralMechanismLogger : public SysIdLogger {
 
   bool IsWrongMechanism() const override;
 
+  std::vector<SampleColumn> GetColumns() const override;
+
  private:
   units::volt_t m_primaryMotorVoltage = 0_V;
 };
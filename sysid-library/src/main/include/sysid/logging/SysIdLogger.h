@@ -8,6 +8,13 @@
 #include <string>
 #include <vector>
 
+#include <ntcore_c.h>
+#include <wpi/span.h>
+
+#include "sysid/estimation/FeedforwardEstimator.h"
+#include "sysid/logging/SampleEncoder.h"
+#include "sysid/logging/TelemetryPublisher.h"
+
 namespace sysid {
 
 /**
@@ -23,7 +30,9 @@ class SysIdLogger {
   void InitLogging();
 
   /**
-   * Sends data after logging is complete.
+   * Sends data after logging is complete. The data is encoded and published
+   * on a background thread, so this returns right away and the next test can
+   * start while the data is still being sent.
    *
    * Called in DisabledInit().
    */
@@ -35,6 +44,16 @@ class SysIdLogger {
    */
   static void UpdateThreadPriority();
 
+  /**
+   * Returns the estimator of the feedforward gains, which is updated with
+   * every sample while the mechanism moves and published as "SysIdEstimate"
+   * (Ks, Kv, Ka, and Kg or Kcos) and "SysIdEstimateCovariance". The estimate
+   * carries over between tests of the same mechanism.
+   */
+  FeedforwardEstimator& GetEstimator() { return m_estimator; }
+
+  virtual ~SysIdLogger();
+
  protected:
   /**
    * The initial size of the data collection vectors, set to be large enough so
@@ -44,6 +63,12 @@ class SysIdLogger {
    */
   static constexpr size_t kDataVectorSize = 36000;
 
+  /**
+   * The number of doubles that can be stored before data collection stops.
+   * Loggers with wider samples set a larger capacity in their constructor.
+   */
+  size_t m_dataCapacity = kDataVectorSize;
+
   /**
    * The commanded motor voltage. Either as a rate (V/s) for the quasistatic
    * test or as a voltage (V) for the dynamic test.
@@ -87,9 +112,31 @@ class SysIdLogger {
    */
   std::vector<double> m_data;
 
+  /**
+   * The resolution of positions in rotations when samples are packed.
+   */
+  static constexpr double kPositionQuantum = 1e-5;
+
+  /**
+   * The resolution of velocities in rotations/second when samples are packed.
+   */
+  static constexpr double kVelocityQuantum = 1e-4;
+
+  /**
+   * The resolution of gyro angles (rad) and rates (rad/s) when samples are
+   * packed.
+   */
+  static constexpr double kGyroQuantum = 1e-5;
+
+  /**
+   * The resolution of currents in amps when samples are packed.
+   */
+  static constexpr double kCurrentQuantum = 1e-2;
+
   /**
    * Creates the SysId logger, disables live view telemetry, sets up the
-   * following NT Entries: "SysIdAutoSpeed", "SysIdRotate", "SysIdTelemetry"
+   * following NT Entries: "SysIdAutoSpeed", "SysIdRotate", "SysIdTelemetry",
+   * and echoes the clock synchronization pings of SysId on "SysIdPong".
    */
   SysIdLogger();
 
@@ -98,11 +145,45 @@ class SysIdLogger {
    */
   void UpdateData();
 
+  /**
+   * Sets the number of doubles that can be stored, and reserves the memory of
+   * the data and of the spare buffer that the next test logs into while the
+   * data of this one is sent.
+   *
+   * @param capacity The number of doubles.
+   */
+  void SetDataCapacity(size_t capacity);
+
   /**
    * Reset data before next test.
    */
   virtual void Reset();
 
+  /**
+   * Stores a sample, packed if SysId asked for packed samples. If SysId asked
+   * for streamed samples, the sample is also published in the next chunk.
+   *
+   * @param sample The values of the sample.
+   * @return False if the sample doesn't fit (it's dropped).
+   */
+  bool AddSample(wpi::span<const double> sample);
+
+  /**
+   * Updates the gain estimate with a sample, and publishes it periodically.
+   * Must be called after UpdateData().
+   *
+   * @param voltage  The voltage that was applied since the last sample.
+   * @param position The position in rotations.
+   * @param velocity The velocity in rotations per second.
+   */
+  void UpdateEstimate(double voltage, double position, double velocity);
+
+  /**
+   * Returns how the columns of the samples are packed. Loggers that return no
+   * columns always send unpacked samples.
+   */
+  virtual std::vector<SampleColumn> GetColumns() const { return {}; }
+
   /**
    * Determines if the logger is collecting data for an unsupported mechanism.
    *
@@ -114,6 +195,63 @@ class SysIdLogger {
  private:
   static constexpr int kThreadPriority = 15;
   static constexpr int kHALThreadPriority = 40;
+
+  NT_EntryListener m_pingListener;
+
+  // Whether the samples of the current test are packed.
+  bool m_packed = false;
+
+  // Whether a sample was dropped because the data was full.
+  bool m_overflow = false;
+
+  SampleEncoder m_encoder;
+
+  // The buffers that the next test logs into while the data of the last one
+  // is sent. They're handed back by the publisher once it has sent the data.
+  std::vector<double> m_spare;
+  std::string m_packedSpare;
+
+  // How often the streamed samples are published, in seconds.
+  static constexpr double kChunkPeriod = 0.1;
+
+  // The number of values that the chunk holds without allocating, which is
+  // enough for the samples of a period at a 5 ms loop.
+  static constexpr size_t kChunkCapacity = 1024;
+
+  // Encodes and sends the data of finished tests.
+  TelemetryPublisher m_publisher;
+
+  // Whether SysId asked for the samples while the test runs.
+  bool m_stream = false;
+
+  // The index of the first sample in the chunk, followed by the samples that
+  // haven't been streamed yet.
+  std::vector<double> m_chunk;
+  size_t m_chunkSamples = 0;
+
+  // The number of samples that have been streamed during the test.
+  size_t m_streamed = 0;
+  double m_lastChunk = 0.0;
+
+  // How often the gain estimate is published, in seconds.
+  static constexpr double kEstimatePeriod = 0.1;
+
+  FeedforwardEstimator m_estimator;
+
+  // The mechanism that the estimate is for.
+  std::string m_estimateMechanism;
+
+  double m_lastEstimatePublish = 0.0;
+
+  /**
+   * Publishes the gain estimate.
+   */
+  void PublishEstimate();
+
+  /**
+   * Publishes the samples that haven't been streamed yet.
+   */
+  void PublishChunk();
 };
 
 }  // namespace sysid
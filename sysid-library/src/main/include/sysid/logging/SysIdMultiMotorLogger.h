@@ -0,0 +1,106 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <units/voltage.h>
+#include <wpi/span.h>
+
+#include "sysid/logging/SysIdLogger.h"
+
+namespace sysid {
+
+/**
+ * A single sample of the per-motor telemetry channels of one motor.
+ */
+struct MotorSample {
+  /**
+   * The recorded rotations of the motor's built-in encoder.
+   */
+  double position = 0.0;
+
+  /**
+   * The recorded rotations per second of the motor's built-in encoder.
+   */
+  double velocity = 0.0;
+
+  /**
+   * The current drawn by the motor in amps.
+   */
+  double current = 0.0;
+
+  /**
+   * The voltage applied to the motor in volts.
+   */
+  double appliedVoltage = 0.0;
+};
+
+/**
+ * Serves to provide methods for robot projects seeking to send and receive data
+ * in occurdence to the SysId general mechanism protocols while also recording
+ * the telemetry of every motor that drives the mechanism.
+ */
+class SysIdMultiMotorLogger : public SysIdLogger {
+ public:
+  /**
+   * The number of channels that are recorded for every motor.
+   */
+  static constexpr size_t kMotorChannelSize = 4;
+
+  /**
+   * The number of samples that are recorded per test at least (20 seconds at
+   * 200 samples/second). The data buffer is reserved up front so that logging
+   * never allocates, and is never smaller than that of the other loggers.
+   */
+  static constexpr size_t kMaxSamples = 4000;
+
+  /**
+   * Creates a logger for a mechanism driven by the given number of motors.
+   *
+   * @param motorCount The number of motors that are recorded.
+   */
+  explicit SysIdMultiMotorLogger(size_t motorCount);
+
+  /**
+   * The users should set their motors to what this returns AFTER calling log.
+   *
+   * @returns The voltage that the mechanism motor(s) should be set to.
+   */
+  units::volt_t GetMotorVoltage() const;
+
+  /**
+   * Logs data for a single-sided mechanism (Elevator, Simple, Arm) along with
+   * the channels of each motor.
+   *
+   * When SendData() is called it outputs data in the form: timestamp, voltage,
+   * position, velocity, followed by motor position, motor velocity, motor
+   * current, and motor applied voltage for each motor.
+   *
+   * @param measuredPosition the recorded rotations of the shaft
+   * @param measuredVelocity the recorded rotations per second of the shaft
+   * @param motors the channels of each motor. Only the first motorCount
+   *               samples are recorded, and missing motors are recorded as
+   *               zero.
+   */
+  void Log(double measuredPosition, double measuredVelocity,
+           wpi::span<const MotorSample> motors);
+
+  void Reset() override;
+
+  bool IsWrongMechanism() const override;
+
+  std::vector<SampleColumn> GetColumns() const override;
+
+ private:
+  size_t m_motorCount;
+  units::volt_t m_primaryMotorVoltage = 0_V;
+
+  // The sample that is being logged, which keeps its memory between samples.
+  std::vector<double> m_sample;
+};
+
+}  // namespace sysid
@@ -0,0 +1,67 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <array>
+
+#include <units/voltage.h>
+
+#include "sysid/logging/SysIdLogger.h"
+
+namespace sysid {
+
+/**
+ * Serves to provide methods for robot projects seeking to send and receive data
+ * in occurdence to the SysId swerve drive protocols.
+ */
+class SysIdSwerveLogger : public SysIdLogger {
+ public:
+  /**
+   * The number of swerve modules that are logged.
+   */
+  static constexpr size_t kModules = 4;
+
+  /**
+   * The users should set the motors under test of every module to what this
+   * returns AFTER calling log.
+   *
+   * @returns The voltage that the module motor(s) should be set to.
+   */
+  units::volt_t GetMotorVoltage() const;
+
+  /**
+   * Returns whether the steer motors are being characterized. If this is
+   * false, the drive motors are being characterized and the modules should be
+   * held pointing straight ahead.
+   *
+   * @returns True if the voltage should be applied to the steer motors.
+   */
+  bool IsSteerTest() const;
+
+  /**
+   * Logs data for a swerve drive.
+   *
+   * When SendData() is called it outputs data in the form: timestamp, voltage,
+   * module 1 position, module 1 velocity, ..., module 4 position, module 4
+   * velocity.
+   *
+   * @param positions the recorded rotations of the shaft of each module
+   * @param velocities the recorded rotations per second of the shaft of each
+   *                   module
+   */
+  void Log(const std::array<double, kModules>& positions,
+           const std::array<double, kModules>& velocities);
+
+  void Reset() override;
+
+  bool IsWrongMechanism() const override;
+
+  std::vector<SampleColumn> GetColumns() const override;
+
+ private:
+  units::volt_t m_primaryMotorVoltage = 0_V;
+};
+
+}  // namespace sysid
@@ -0,0 +1,120 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sysid {
+
+/**
+ * Encodes and publishes the data of finished tests on a background thread, so
+ * that the robot thread doesn't overrun its loop when the robot disables.
+ *
+ * While data is queued or being sent, "SysIdSending" is true and
+ * "SysIdSendProgress" is the fraction of the current test's data that has
+ * been encoded. Tests are sent in the order that they were queued, so the
+ * next test can start while the previous one is still being sent.
+ */
+class TelemetryPublisher {
+ public:
+  /**
+   * The data of a finished test.
+   */
+  struct Upload {
+    /**
+     * Whether samples were dropped because the data was full.
+     */
+    bool overflow = false;
+
+    /**
+     * Whether the samples are packed.
+     */
+    bool packed = false;
+
+    /**
+     * The number of packed samples.
+     */
+    size_t samples = 0;
+
+    /**
+     * The packed samples.
+     */
+    std::string packedData;
+
+    /**
+     * The values of the samples, if they aren't packed.
+     */
+    std::vector<double> data;
+  };
+
+  /**
+   * Starts the publisher thread.
+   */
+  TelemetryPublisher();
+
+  /**
+   * Sends the data that is still queued and stops the publisher thread.
+   */
+  ~TelemetryPublisher();
+
+  TelemetryPublisher(const TelemetryPublisher&) = delete;
+  TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+  /**
+   * Queues the data of a test to be sent, and returns right away.
+   *
+   * @param upload The data of the test.
+   */
+  void Send(Upload upload);
+
+  /**
+   * Returns the buffer of data that was already sent, cleared but with its
+   * memory, so that the next test doesn't allocate. The buffer is empty if
+   * none was returned yet.
+   */
+  std::vector<double> TakeBuffer();
+
+  /**
+   * Returns the buffer of packed data that was already sent, like
+   * TakeBuffer().
+   */
+  std::string TakePackedBuffer();
+
+  /**
+   * Returns whether data is queued or being sent.
+   */
+  bool IsSending();
+
+ private:
+  // How many values are encoded between updates of the progress.
+  static constexpr size_t kProgressStride = 4096;
+
+  /**
+   * Sends the queued data until the publisher is stopped.
+   */
+  void Run();
+
+  /**
+   * Encodes and publishes the data of a test.
+   */
+  void Publish(Upload& upload);
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<Upload> m_queue;
+  std::vector<double> m_spare;
+  std::string m_packedSpare;
+  bool m_sending = false;
+  bool m_running = true;
+  std::thread m_thread;
+};
+
+}  // namespace sysid
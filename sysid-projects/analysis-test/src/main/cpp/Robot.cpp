@@ -2,6 +2,7 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <cstdlib>
 #include <string>
 #include <vector>
 
@@ -10,6 +11,7 @@
 #include <frc/filter/SlewRateLimiter.h>
 #include <frc/simulation/DriverStationSim.h>
 #include <frc/smartdashboard/SmartDashboard.h>
+#include <networktables/NetworkTableInstance.h>
 #include <units/voltage.h>
 
 #include "Arm.h"
@@ -23,7 +25,19 @@
 
 class Robot : public frc::TimedRobot {
  public:
-  Robot() : frc::TimedRobot(5_ms) { m_driveLogger.UpdateThreadPriority(); }
+  Robot() : frc::TimedRobot(5_ms) {
+    m_driveLogger.UpdateThreadPriority();
+
+#ifdef INTEGRATION
+    // The integration tests run several robot programs at once, each of which
+    // serves NT on its own port.
+    if (const char* port = std::getenv("SYSID_NT_PORT")) {
+      auto inst = nt::NetworkTableInstance::GetDefault();
+      inst.StopServer();
+      inst.StartServer("networktables.ini", "", std::atoi(port));
+    }
+#endif
+  }
   void RobotInit() override {
     // Flush NetworkTables every loop. This ensures that robot pose and other
     // values are sent during every iteration.
@@ -55,6 +55,20 @@ Robot::Robot() : frc::TimedRobot(5_ms) {
                          m_controllers.front().get(), encoderInverted,
                          encoderPorts, m_cancoder, m_revEncoderPort,
                          m_revDataPort, m_encoder, m_position, m_rate);
+
+    // Optionally record the channels of every motor. The samples are
+    // allocated up front so that logging doesn't allocate.
+    if (m_json.value("log motor channels", false)) {
+      fmt::print("Initializing motor channels\n");
+      m_motorChannels.resize(m_controllers.size());
+      for (size_t i = 0; i < m_controllers.size(); i++) {
+        sysid::SetupMotorChannel(controllerNames[i], m_controllers[i].get(),
+                                 gearing, &m_motorChannels[i]);
+      }
+      m_motorSamples.resize(m_motorChannels.size());
+    }
+    m_logger =
+        std::make_unique<sysid::SysIdMultiMotorLogger>(m_motorChannels.size());
   } catch (std::exception& e) {
     fmt::print("Project failed: {}\n", e.what());
     std::exit(-1);
@@ -100,15 +114,22 @@ void Robot::RobotPeriodic() {
  * make sure to add them to the chooser code above as well.
  */
 void Robot::AutonomousInit() {
-  m_logger.InitLogging();
+  m_logger->InitLogging();
 }
 
 /**
- * Outputs data in the format: timestamp, voltage, position, velocity
+ * Outputs data in the format: timestamp, voltage, position, velocity, followed
+ * by the position, velocity, current, and applied voltage of each motor if
+ * motor channels are logged.
  */
 void Robot::AutonomousPeriodic() {
-  m_logger.Log(m_position(), m_rate());
-  sysid::SetMotorControllers(m_logger.GetMotorVoltage(), m_controllers);
+  for (size_t i = 0; i < m_motorChannels.size(); i++) {
+    auto& channel = m_motorChannels[i];
+    m_motorSamples[i] = {channel.position(), channel.velocity(),
+                         channel.current(), channel.appliedVoltage()};
+  }
+  m_logger->Log(m_position(), m_rate(), m_motorSamples);
+  sysid::SetMotorControllers(m_logger->GetMotorVoltage(), m_controllers);
 }
 
 void Robot::TeleopInit() {}
@@ -118,7 +139,7 @@ void Robot::TeleopPeriodic() {}
 void Robot::DisabledInit() {
   sysid::SetMotorControllers(0_V, m_controllers);
   fmt::print("Robot Disabled\n");
-  m_logger.SendData();
+  m_logger->SendData();
 }
 
 void Robot::SimulationPeriodic() {
@@ -19,7 +19,8 @@
 #include <wpi/json.h>
 #include <wpi/raw_istream.h>
 
-#include "sysid/logging/SysIdGeneralMechanismLogger.h"
+#include "sysid/generation/SysIdSetup.h"
+#include "sysid/logging/SysIdMultiMotorLogger.h"
 
 class Robot : public frc::TimedRobot {
  public:
@@ -45,5 +46,7 @@ class Robot : public frc::TimedRobot {
   std::unique_ptr<rev::SparkMaxAlternateEncoder> m_revDataPort;
   std::unique_ptr<CANCoder> m_cancoder;
   std::unique_ptr<frc::Encoder> m_encoder;
-  sysid::SysIdGeneralMechanismLogger m_logger;
+  std::vector<sysid::MotorChannel> m_motorChannels;
+  std::vector<sysid::MotorSample> m_motorSamples;
+  std::unique_ptr<sysid::SysIdMultiMotorLogger> m_logger;
 };